@@ -215,6 +215,10 @@ int main(int argc, char** argv) {
                       << ",\"write_attempts\":" << d.writeAttempts
                       << ",\"write_success\":" << d.writeSuccess
                       << ",\"write_failure\":" << d.writeFailure
+                      << ",\"cyclic_reference_reads\":" << d.cyclicReferenceReads
+                      << ",\"cyclic_reference_failures\":" << d.cyclicReferenceFailures
+                      << ",\"cyclic_offset_writes\":" << d.cyclicOffsetWrites
+                      << ",\"cyclic_offset_failures\":" << d.cyclicOffsetFailures
                       << ",\"controller_clamp_hits\":" << controllerClampHits
                       << ",\"step_clamp_hits\":" << stepClampHits
                       << ",\"slew_clamp_hits\":" << slewClampHits
@@ -229,6 +233,10 @@ int main(int argc, char** argv) {
                       << " write_attempts=" << d.writeAttempts
                       << " write_success=" << d.writeSuccess
                       << " write_failure=" << d.writeFailure
+                      << " cyclic_reference_reads=" << d.cyclicReferenceReads
+                      << " cyclic_reference_failures=" << d.cyclicReferenceFailures
+                      << " cyclic_offset_writes=" << d.cyclicOffsetWrites
+                      << " cyclic_offset_failures=" << d.cyclicOffsetFailures
                       << " controller_clamp_hits=" << controllerClampHits
                       << " step_clamp_hits=" << stepClampHits
                       << " slew_clamp_hits=" << slewClampHits
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "openethercat/master/coe_mailbox.hpp"
+#include "openethercat/transport/coe_mailbox_protocol.hpp"
 #include "openethercat/transport/linux_raw_socket_transport.hpp"
 #include "openethercat/transport/transport_factory.hpp"
 
@@ -140,6 +141,8 @@ int main(int argc, char** argv) {
         latenciesUs.reserve(cycles);
         std::size_t success = 0U;
         std::size_t failed = 0U;
+        std::size_t uploadedBytes = 0U;
+        double uploadUsTotal = 0.0;
 
         for (std::size_t i = 0; i < cycles; ++i) {
             // Each iteration performs one full CoE SDO upload transaction.
@@ -151,9 +154,11 @@ int main(int argc, char** argv) {
             const auto end = std::chrono::steady_clock::now();
             const auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
             latenciesUs.push_back(static_cast<double>(us));
+            uploadUsTotal += static_cast<double>(us);
 
             if (ok) {
                 ++success;
+                uploadedBytes += data.size();
             } else {
                 ++failed;
                 if (failed <= 5U) {
@@ -197,6 +202,59 @@ int main(int argc, char** argv) {
             }
         }
 
+        const auto bytesPerSecond = [](std::size_t bytes, double us) {
+            return (us > 0.0) ? (static_cast<double>(bytes) * 1.0e6 / us) : 0.0;
+        };
+        if (jsonMode) {
+            std::cout << "{\"type\":\"sdo_throughput\",\"direction\":\"upload\",\"bytes\":" << uploadedBytes
+                      << ",\"bytes_per_s\":" << std::fixed << std::setprecision(1)
+                      << bytesPerSecond(uploadedBytes, uploadUsTotal) << "}\n";
+        } else {
+            std::cout << "sdo_throughput direction=upload bytes=" << uploadedBytes
+                      << " bytes_per_s=" << std::fixed << std::setprecision(1)
+                      << bytesPerSecond(uploadedBytes, uploadUsTotal) << '\n';
+        }
+
+        // Optional download benchmark: writes N bytes to the object, first with legacy
+        // 7-byte segments, then with full-mailbox segments. Only use on a writable scratch object.
+        const char* downloadEnv = std::getenv("OEC_SOAK_DOWNLOAD_BYTES");
+        if (linux && downloadEnv != nullptr) {
+            const auto downloadBytes = static_cast<std::size_t>(parseUnsigned(downloadEnv, "download bytes"));
+            const std::vector<std::uint8_t> payload(downloadBytes, 0xA5U);
+            const auto previousLimit = linux->sdoSegmentBytesLimit();
+            const std::size_t limits[] = {oec::CoeMailboxProtocol::kMinSegmentBytes, 0U};
+            for (const auto limit : limits) {
+                linux->setSdoSegmentBytesLimit(limit);
+                std::size_t written = 0U;
+                std::size_t downloadFailed = 0U;
+                const auto start = std::chrono::steady_clock::now();
+                for (std::size_t i = 0; i < cycles; ++i) {
+                    std::uint32_t abortCode = 0U;
+                    std::string sdoError;
+                    if (transport->sdoDownload(slavePosition, address, payload, abortCode, sdoError)) {
+                        written += payload.size();
+                    } else {
+                        ++downloadFailed;
+                    }
+                }
+                const auto us = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+                const char* segmentMode = (limit == 0U) ? "mailbox" : "legacy7";
+                if (jsonMode) {
+                    std::cout << "{\"type\":\"sdo_throughput\",\"direction\":\"download\",\"segments\":\""
+                              << segmentMode << "\",\"bytes\":" << written << ",\"failed\":" << downloadFailed
+                              << ",\"bytes_per_s\":" << std::fixed << std::setprecision(1)
+                              << bytesPerSecond(written, us) << "}\n";
+                } else {
+                    std::cout << "sdo_throughput direction=download segments=" << segmentMode
+                              << " bytes=" << written << " failed=" << downloadFailed
+                              << " bytes_per_s=" << std::fixed << std::setprecision(1)
+                              << bytesPerSecond(written, us) << '\n';
+                }
+            }
+            linux->setSdoSegmentBytesLimit(previousLimit);
+        }
+
         if (linux) {
             const auto d = linux->mailboxDiagnostics();
             if (jsonMode) {
@@ -221,6 +279,9 @@ int main(int argc, char** argv) {
                           << ",\"emergencies\":" << d.emergencyQueued
                           << ",\"emergencies_dropped\":" << d.emergencyDropped
                           << ",\"matched\":" << d.matchedResponses
+                          << ",\"repeat_req\":" << d.mailboxRepeatRequests
+                          << ",\"repeat_ack\":" << d.mailboxRepeatAcks
+                          << ",\"repeat_recovered\":" << d.mailboxRepeatRecoveries
                           << ",\"err_timeout\":" << d.errorTimeout
                           << ",\"err_busy\":" << d.errorBusy
                           << ",\"err_parse\":" << d.errorParseReject
@@ -251,6 +312,9 @@ int main(int argc, char** argv) {
                           << " emergencies=" << d.emergencyQueued
                           << " emergencies_dropped=" << d.emergencyDropped
                           << " matched=" << d.matchedResponses
+                          << " repeat_req=" << d.mailboxRepeatRequests
+                          << " repeat_ack=" << d.mailboxRepeatAcks
+                          << " repeat_recovered=" << d.mailboxRepeatRecoveries
                           << " err_timeout=" << d.errorTimeout
                           << " err_busy=" << d.errorBusy
                           << " err_parse=" << d.errorParseReject
@@ -10,6 +10,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 #include <atomic>
 
 #include "openethercat/config/config_loader.hpp"
@@ -38,14 +39,19 @@ int main(int argc, char** argv) {
 
     oec::NetworkConfiguration config;
     std::string error;
+    std::vector<std::string> warnings;
     if (!oec::ConfigurationLoader::loadFromEniAndEsiDirectory(
             eniPath,
             esiDir,
             config,
-            error)) {
+            error,
+            &warnings)) {
         std::cerr << "Config load failed: " << error << '\n';
         return 1;
     }
+    for (const auto& warning : warnings) {
+        std::cerr << "Config warning: " << warning << '\n';
+    }
     // Optional channel remap lets one binary test any EL1004/EL2004 channel pair.
     int selectedChannel = 1;
     if (const char* env = std::getenv("OEC_IO_CHANNEL")) {
@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "openethercat/config/config_loader.hpp"
 #include "openethercat/master/cycle_controller.hpp"
@@ -19,25 +20,30 @@ using namespace std::chrono_literals;
 int main(int argc, char** argv) {
     if (argc < 2) {
         std::cerr << "Usage: " << argv[0] << " <transport-spec|ifname> [eni_file] [esi_dir]\n"
-                  << "  transport-spec: mock | linux:<ifname> | linux:<ifname_primary>,<ifname_secondary>\n";
+                  << "  transport-spec: mock | linux:<ifname> | linux:<ifname_primary>,<ifname_secondary>"
+                  << " | xdp:<ifname>\n";
         return 1;
     }
 
     // Accept either full transport specs or plain interface names for convenience.
     const std::string transportArg = argv[1];
-    const std::string transportSpec = (transportArg.rfind("linux:", 0) == 0 || transportArg == "mock")
-                                          ? transportArg
-                                          : ("linux:" + transportArg);
+    const bool fullSpec = transportArg.rfind("linux:", 0) == 0 || transportArg.rfind("xdp:", 0) == 0 ||
+                          transportArg == "mock";
+    const std::string transportSpec = fullSpec ? transportArg : ("linux:" + transportArg);
     const std::string eniPath = (argc > 2) ? argv[2] : "examples/config/beckhoff_demo.eni.xml";
     const std::string esiDir = (argc > 3) ? argv[3] : "examples/config";
 
     // Load ENI/ESI to obtain process image sizes and logical signal bindings.
     oec::NetworkConfiguration config;
     std::string error;
-    if (!oec::ConfigurationLoader::loadFromEniAndEsiDirectory(eniPath, esiDir, config, error)) {
+    std::vector<std::string> warnings;
+    if (!oec::ConfigurationLoader::loadFromEniAndEsiDirectory(eniPath, esiDir, config, error, &warnings)) {
         std::cerr << "Config load failed: " << error << '\n';
         return 1;
     }
+    for (const auto& warning : warnings) {
+        std::cerr << "Config warning: " << warning << '\n';
+    }
 
     // Build transport through the shared factory used by all examples.
     oec::TransportFactoryConfig transportConfig;
@@ -0,0 +1,58 @@
+/**
+ * @file binary_configuration.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "openethercat/config/eni_esi_models.hpp"
+
+namespace oec {
+
+/**
+ * @brief Precompiled, memory-mappable `NetworkConfiguration` image.
+ *
+ * Layout (all little-endian, every section 8-byte aligned):
+ * - 48-byte header: magic "OECB", version, slave/signal counts, process-image
+ *   sizes, string-table size and an FNV-1a checksum of everything after the header.
+ * - Fixed-size slave records (24 bytes) and signal records (32 bytes) that
+ *   reference names by (offset, length) into the string table.
+ * - String table (raw bytes, not NUL-terminated).
+ *
+ * Decoding is a single pass over fixed-width records with no tokenizing, so a
+ * production image loads in microseconds. Images are produced offline with the
+ * `eni_to_binary_config` tool or `compileToFile()`.
+ */
+class BinaryConfiguration {
+public:
+    static constexpr std::uint32_t kFormatVersion = 1U;
+    static constexpr std::size_t kHeaderBytes = 48U;
+    static constexpr std::size_t kSlaveRecordBytes = 24U;
+    static constexpr std::size_t kSignalRecordBytes = 32U;
+
+    static std::vector<std::uint8_t> encode(const NetworkConfiguration& config);
+    /**
+     * @brief Decode an image already resident in memory (e.g. mmap'ed or linked in).
+     */
+    static bool decode(const std::uint8_t* data, std::size_t size,
+                       NetworkConfiguration& outConfig, std::string& outError);
+    /**
+     * @brief True when @p data starts with the binary image magic.
+     */
+    static bool looksLikeImage(const std::uint8_t* data, std::size_t size);
+
+    static bool compileToFile(const NetworkConfiguration& config, const std::string& path,
+                              std::string& outError);
+    /**
+     * @brief Map @p path read-only and decode it without an intermediate copy.
+     */
+    static bool loadFromFile(const std::string& path, NetworkConfiguration& outConfig,
+                             std::string& outError);
+};
+
+} // namespace oec
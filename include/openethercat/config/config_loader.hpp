@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "openethercat/config/eni_esi_models.hpp"
 
@@ -14,9 +16,10 @@ namespace oec {
 /**
  * @brief Loads network configuration from ENI and optional ESI sources.
  *
- * The loader provides a lightweight XML extraction path tailored for examples
- * and integration tests. It builds `NetworkConfiguration` with slave identities,
- * signal mappings, and process-image sizing used by `EthercatMaster`.
+ * XML sources are read by a single-pass streaming tokenizer (`XmlStreamParser`)
+ * with bounded memory, so large ESI catalogs load without backtracking regexes.
+ * It builds `NetworkConfiguration` with slave identities, signal mappings, and
+ * process-image sizing used by `EthercatMaster`.
  */
 class ConfigurationLoader {
 public:
@@ -36,18 +39,68 @@ public:
      * @brief Load ENI and enrich slave identity fields using ESI files in a directory.
      *
      * This method first parses ENI, then scans ESI XML files for vendor/product
-     * metadata and merges missing values into configured slaves by name.
+     * metadata and merges missing values into configured slaves by name. ESI
+     * files are indexed in parallel (`EsiCatalogIndex`); when `OEC_ESI_INDEX_CACHE`
+     * names a writable file the index is persisted there and only files whose
+     * size or mtime changed are reparsed on later loads. A malformed ESI file
+     * is skipped; the remaining files still contribute.
      *
      * @param eniPath Path to ENI XML file.
      * @param esiDirectory Directory containing ESI XML files.
      * @param outConfig Parsed and merged configuration model on success.
      * @param outError Human-readable parse/IO error on failure.
+     * @param outWarnings Optional; receives one "<file>: <error>" line per skipped ESI file.
      * @return true if parsing and merge succeeded.
      */
     static bool loadFromEniAndEsiDirectory(const std::string& eniPath,
                                            const std::string& esiDirectory,
                                            NetworkConfiguration& outConfig,
-                                           std::string& outError);
+                                           std::string& outError,
+                                           std::vector<std::string>* outWarnings = nullptr);
+
+    /**
+     * @brief Stream-parse one ESI file and append every described device.
+     *
+     * Accepts the compact attribute catalog format and ETG.2000 ESI structure
+     * (vendor id, product code, revision and RxPdo/TxPdo entries). Memory use
+     * is bounded by the parser chunk size, not the file size.
+     *
+     * @param esiPath Path to ESI XML file.
+     * @param outDevices Receives the parsed devices (appended).
+     * @param outError Human-readable parse/IO error on failure.
+     * @return true if parsing succeeded.
+     */
+    static bool loadEsiFile(const std::string& esiPath,
+                            std::vector<EsiDeviceDescription>& outDevices,
+                            std::string& outError);
+
+    /**
+     * @brief Parse only the device whose `<Device>` tag starts at @p byteOffset.
+     *
+     * Used with `EsiCatalogIndex` offsets to fetch one device without
+     * reparsing the whole file. Vendor ids declared only in the file-level
+     * `Vendor/Id` element are not visible from the offset; take them from the
+     * index entry instead.
+     */
+    static bool loadEsiDeviceAt(const std::string& esiPath,
+                                std::uint64_t byteOffset,
+                                EsiDeviceDescription& outDevice,
+                                std::string& outError);
+
+    /**
+     * @brief Load a precompiled binary image (see `BinaryConfiguration`).
+     *
+     * The image is memory-mapped and decoded without XML parsing, then run
+     * through the same validator as the XML paths.
+     *
+     * @param imagePath Path to an image produced by `eni_to_binary_config`.
+     * @param outConfig Decoded configuration model on success.
+     * @param outError Human-readable decode/IO/validation error on failure.
+     * @return true if decoding and validation succeeded.
+     */
+    static bool loadFromBinaryFile(const std::string& imagePath,
+                                   NetworkConfiguration& outConfig,
+                                   std::string& outError);
 };
 
 } // namespace oec
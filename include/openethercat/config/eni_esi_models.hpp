@@ -64,6 +64,48 @@ struct NetworkConfiguration {
     std::size_t processImageOutputBytes = 0;
 };
 
+/**
+ * @brief One mapped object inside an ESI PDO description.
+ */
+struct EsiPdoEntry {
+    /// Object index (0 for padding entries).
+    std::uint16_t index = 0;
+    /// Object sub-index.
+    std::uint8_t subIndex = 0;
+    /// Mapped size in bits.
+    std::uint8_t bitLength = 0;
+    /// Entry name from ESI.
+    std::string name;
+};
+
+/**
+ * @brief ESI RxPdo/TxPdo description.
+ */
+struct EsiPdo {
+    /// PDO mapping object index, e.g. 0x1600 or 0x1A00.
+    std::uint16_t index = 0;
+    /// PDO name from ESI.
+    std::string name;
+    /// Mapped entries in declaration order.
+    std::vector<EsiPdoEntry> entries;
+};
+
+/**
+ * @brief Device description extracted from one ESI `<Device>` element.
+ */
+struct EsiDeviceDescription {
+    /// Name/vendor/product (position and alias are only set by attribute-style catalogs).
+    SlaveIdentity identity;
+    /// Revision number from `<Type RevisionNo="...">`.
+    std::uint32_t revision = 0;
+    /// Output PDOs (master -> slave).
+    std::vector<EsiPdo> rxPdos;
+    /// Input PDOs (slave -> master).
+    std::vector<EsiPdo> txPdos;
+    /// Byte offset of the opening `<Device>` tag in its source file.
+    std::uint64_t sourceOffset = 0;
+};
+
 /**
  * @brief Lightweight ENI/ESI attribute parser helper.
  */
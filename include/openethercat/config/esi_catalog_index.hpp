@@ -0,0 +1,139 @@
+/**
+ * @file esi_catalog_index.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "openethercat/config/eni_esi_models.hpp"
+
+namespace oec {
+
+/**
+ * @brief Identity index over a directory of ESI files.
+ *
+ * `build()` parses the `.xml` files of a directory on a pool of worker threads
+ * and records, per device, the file, the byte offset of its `<Device>` tag and
+ * the file size/mtime it was parsed from. Lookups by
+ * (vendorId, productCode, revision) and by name are hash-map O(1).
+ *
+ * The index can be persisted with `saveCache()`. A later `loadCache()` +
+ * `build()` reuses entries for files whose size and mtime are unchanged and
+ * only reparses new or modified files. Files without devices are recorded by
+ * size/mtime alone, so they are skipped the same way. Full PDO data is fetched on demand with
+ * `loadDevice()`, which parses just the indexed `<Device>` element.
+ */
+class EsiCatalogIndex {
+public:
+    /**
+     * @brief One indexed device.
+     */
+    struct Entry {
+        std::string filePath;
+        std::uint64_t byteOffset = 0;
+        std::uint64_t fileSize = 0;
+        std::int64_t fileMtimeNs = 0;
+        SlaveIdentity identity;
+        std::uint32_t revision = 0;
+    };
+
+    /**
+     * @brief Work counters of the last `build()`.
+     */
+    struct Stats {
+        std::size_t filesScanned = 0;
+        std::size_t filesParsed = 0;
+        std::size_t filesReused = 0;
+        /// Parsed files skipped because they are malformed; see `fileErrors()`.
+        std::size_t filesFailed = 0;
+        std::size_t devices = 0;
+        std::size_t threads = 0;
+    };
+
+    /**
+     * @brief An ESI file the last `build()` could not parse.
+     */
+    struct FileError {
+        std::string filePath;
+        std::string error;
+    };
+
+    static constexpr std::uint32_t kCacheVersion = 2U;
+
+    /**
+     * @brief Index every `.xml` file in @p directory.
+     * @param threads Worker count; 0 selects `std::thread::hardware_concurrency()`.
+     * @return false if the directory cannot be listed or a file cannot be stat'ed. A file
+     *         that fails to parse is skipped, listed in `fileErrors()` and reparsed next time.
+     */
+    bool build(const std::string& directory, std::string& outError, std::size_t threads = 0U);
+
+    bool loadCache(const std::string& path, std::string& outError);
+    /**
+     * @brief Write the index atomically (temporary file + rename).
+     */
+    bool saveCache(const std::string& path, std::string& outError) const;
+
+    /**
+     * @brief Exact identity lookup; nullptr when absent.
+     */
+    const Entry* find(std::uint32_t vendorId, std::uint32_t productCode, std::uint32_t revision) const;
+    /**
+     * @brief Highest indexed revision for vendor/product; nullptr when absent.
+     */
+    const Entry* findLatest(std::uint32_t vendorId, std::uint32_t productCode) const;
+    /**
+     * @brief First device (in file/offset order) with the given name; nullptr when absent.
+     */
+    const Entry* findByName(const std::string& name) const;
+
+    /**
+     * @brief Parse the full description (including PDOs) of an indexed device.
+     */
+    static bool loadDevice(const Entry& entry, EsiDeviceDescription& outDevice, std::string& outError);
+
+    /**
+     * @brief All entries ordered by file path, then byte offset.
+     */
+    const std::vector<Entry>& entries() const;
+    const Stats& stats() const;
+    /**
+     * @brief Files skipped by the last `build()`, in path order.
+     */
+    const std::vector<FileError>& fileErrors() const;
+
+private:
+    struct IdentityKey {
+        std::uint32_t vendorId = 0;
+        std::uint32_t productCode = 0;
+        std::uint32_t revision = 0;
+        bool operator==(const IdentityKey& other) const;
+    };
+    struct IdentityKeyHash {
+        std::size_t operator()(const IdentityKey& key) const;
+    };
+    /// A parsed file that describes no device.
+    struct EmptyFile {
+        std::string filePath;
+        std::uint64_t fileSize = 0;
+        std::int64_t fileMtimeNs = 0;
+    };
+
+    void rebuildLookups();
+
+    std::vector<Entry> entries_;
+    std::vector<EmptyFile> emptyFiles_;
+    std::unordered_map<IdentityKey, std::size_t, IdentityKeyHash> byIdentity_;
+    std::unordered_map<std::uint64_t, std::size_t> latestByProduct_;
+    std::unordered_map<std::string, std::size_t> byName_;
+    Stats stats_;
+    std::vector<FileError> fileErrors_;
+};
+
+} // namespace oec
@@ -0,0 +1,115 @@
+/**
+ * @file xml_stream_parser.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace oec {
+
+/**
+ * @brief One decoded `name="value"` pair of a start tag.
+ */
+struct XmlAttribute {
+    std::string name;
+    std::string value;
+};
+
+/**
+ * @brief Single-pass, push-style (SAX) XML tokenizer for ENI/ESI files.
+ *
+ * Input is fed in arbitrary chunks; only the unfinished tail of the current
+ * token is carried between chunks, so memory stays bounded by
+ * `maxTokenBytes` plus one chunk regardless of document size. Text content is
+ * delivered incrementally and may arrive split across several `onText` calls.
+ *
+ * Supported: elements, attributes (single/double quoted), predefined and
+ * numeric character entities, CDATA. Comments, processing instructions and
+ * DOCTYPE declarations are skipped. Namespaces and DTD validation are not
+ * interpreted.
+ */
+class XmlStreamParser {
+public:
+    /**
+     * @brief Parse event sink. Self-closing elements produce start followed by end.
+     */
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual void onStartElement(const std::string& name, const std::vector<XmlAttribute>& attributes) = 0;
+        virtual void onEndElement(const std::string& name) = 0;
+        virtual void onText(std::string_view text) { (void)text; }
+    };
+
+    static constexpr std::size_t kDefaultMaxTokenBytes = 1024U * 1024U;
+    static constexpr std::size_t kDefaultChunkBytes = 64U * 1024U;
+
+    explicit XmlStreamParser(Handler& handler, std::size_t maxTokenBytes = kDefaultMaxTokenBytes);
+
+    /**
+     * @brief Consume the next chunk of the document.
+     * @return false on malformed input; see error().
+     */
+    bool feed(const char* data, std::size_t size);
+    /**
+     * @brief Signal end of input and check that every element was closed.
+     */
+    bool finish();
+    /**
+     * @brief Feed @p in chunk by chunk until EOF or stop(); does not call finish().
+     */
+    bool feedStream(std::istream& in, std::size_t chunkBytes = kDefaultChunkBytes);
+    /**
+     * @brief Stop delivering events; callable from a handler once it has what it needs.
+     */
+    void stop();
+    bool stopped() const;
+    /**
+     * @brief Absolute byte offset of the markup currently being reported to the handler.
+     */
+    std::uint64_t markupOffset() const;
+
+    const std::string& error() const;
+    /**
+     * @brief Largest carry-over buffer observed so far (bounded-memory diagnostics).
+     */
+    std::size_t peakBufferBytes() const;
+
+    static bool parseFile(const std::string& path, Handler& handler, std::string& outError,
+                          std::size_t chunkBytes = kDefaultChunkBytes);
+    static bool parseString(std::string_view xml, Handler& handler, std::string& outError);
+
+    /**
+     * @brief ASCII case-insensitive attribute lookup; nullptr when absent.
+     */
+    static const std::string* findAttribute(const std::vector<XmlAttribute>& attributes, std::string_view name);
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
+private:
+    bool findMarkupEnd(std::size_t begin, std::size_t& outEnd, bool& outIncomplete) const;
+    bool handleMarkup(std::string_view markup);
+    bool handleStartTag(std::string_view markup);
+    bool fail(std::string message);
+
+    Handler& handler_;
+    std::size_t maxTokenBytes_;
+    std::string buffer_;
+    std::vector<std::string> openElements_;
+    std::vector<XmlAttribute> attributes_;
+    std::string error_;
+    std::size_t peakBufferBytes_ = 0;
+    std::uint64_t consumedBytes_ = 0;
+    std::uint64_t markupOffset_ = 0;
+    bool failed_ = false;
+    bool stopped_ = false;
+    bool finished_ = false;
+};
+
+} // namespace oec
@@ -9,13 +9,18 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "openethercat/core/slave_state.hpp"
 #include "openethercat/transport/i_transport.hpp"
 
 namespace oec {
 
+struct ObjectDictionary;
+
 /**
  * @brief CoE object dictionary address (index/subindex).
  */
@@ -58,6 +63,31 @@ struct EmergencyMessage {
     std::uint8_t errorRegister = 0;
     std::array<std::uint8_t, 5> manufacturerData{};
     std::uint16_t slavePosition = 0;
+    /// Master cycle (CycleStatistics::cyclesTotal) in which the message was collected.
+    std::uint64_t cycleIndex = 0;
+    /// Steady-clock time of reception in ns.
+    std::uint64_t timestampNs = 0;
+    /// Identical messages folded into this one by EmergencyQueue deduplication.
+    std::uint32_t repeatCount = 0;
+};
+
+/**
+ * @brief Caching policy of one CoE object index.
+ */
+enum class SdoCachePolicy {
+    /// Always read from the slave.
+    Volatile,
+    /// Read once, then served from cache until invalidated.
+    Static
+};
+
+/**
+ * @brief Counters of the CoE read-through cache.
+ */
+struct SdoCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t invalidations = 0;
 };
 
 /**
@@ -80,6 +110,50 @@ public:
     SdoResponse download(std::uint16_t slavePosition,
                          SdoAddress address,
                          const std::vector<std::uint8_t>& data) const;
+    /**
+     * @brief SDO upload served from the per-slave cache for objects marked static.
+     *
+     * Identity (0x1018), device type (0x1000), device name (0x1008) and the
+     * hardware/software versions (0x1009/0x100A) are static by default. Volatile
+     * objects are forwarded to upload(); aborts are never cached.
+     */
+    SdoResponse uploadCached(std::uint16_t slavePosition, SdoAddress address);
+    void setCachePolicy(std::uint16_t index, SdoCachePolicy policy);
+    SdoCachePolicy cachePolicy(std::uint16_t index) const;
+    /**
+     * @brief Drop cached objects of one slave when its AL state differs from the last one noted.
+     */
+    void noteSlaveState(std::uint16_t slavePosition, SlaveState state);
+    void invalidateCache();
+    void invalidateCache(std::uint16_t slavePosition);
+    /**
+     * @brief Drop the cached sub-indices of one object, e.g. after a Complete Access write to it.
+     */
+    void invalidateCache(std::uint16_t slavePosition, std::uint16_t index);
+    SdoCacheStats cacheStats() const;
+    /**
+     * @brief Read all entries of an object with Complete Access.
+     *
+     * With @p includeSubIndex0 the data starts with sub-index 0 padded to 16 bits.
+     */
+    SdoResponse uploadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0) const;
+    /**
+     * @brief Write all entries of an object with Complete Access (same layout as uploadComplete()).
+     */
+    SdoResponse downloadComplete(std::uint16_t slavePosition,
+                                 std::uint16_t index,
+                                 const std::vector<std::uint8_t>& data,
+                                 bool includeSubIndex0) const;
+    /**
+     * @brief Enumerate the slave object dictionary with the SDO Information service.
+     *
+     * Issues one OD-list request, then one object description per index and one
+     * entry description per sub-index (0..maxSubIndex). Sub-indices the slave reports
+     * as absent (abort 0x06090011) are gaps; any other refused or malformed entry is
+     * skipped and clears `complete`. A transport error fails the whole scan.
+     */
+    bool readObjectDictionary(std::uint16_t slavePosition, ObjectDictionary& outDictionary,
+                              std::string& outError) const;
     /**
      * @brief Configure standard RxPDO mapping for a slave.
      */
@@ -97,11 +171,27 @@ public:
      * @brief Drain up to `maxMessages` emergency messages from transport queue.
      */
     std::vector<EmergencyMessage> drainEmergencyQueue(std::size_t maxMessages) const;
+    /**
+     * @brief Same as above into a caller-owned buffer, so a cyclic caller reuses its capacity.
+     */
+    void drainEmergencyQueue(std::size_t maxMessages, std::vector<EmergencyMessage>& outMessages) const;
 
 private:
     static std::string describeAbort(std::uint32_t code);
+    static void setFailure(SdoResponse& response, std::uint32_t abortCode, const std::string& error,
+                           const char* fallback);
+
+    struct SlaveCache {
+        bool stateKnown = false;
+        SlaveState state = SlaveState::Init;
+        // Keyed by (index << 8) | subIndex.
+        std::map<std::uint32_t, std::vector<std::uint8_t>> objects;
+    };
 
     ITransport& transport_;
+    std::unordered_map<std::uint16_t, SdoCachePolicy> cachePolicies_;
+    std::unordered_map<std::uint16_t, SlaveCache> cache_;
+    SdoCacheStats cacheStats_{};
 };
 
 } // namespace oec
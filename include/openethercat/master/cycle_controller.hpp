@@ -26,6 +26,73 @@ struct CycleControllerOptions {
     std::size_t maxConsecutiveFailures = 3;
     bool enablePhaseCorrection = false;
     std::function<std::optional<std::int64_t>()> phaseCorrectionNsProvider;
+    /**
+     * @brief Steer wake-ups toward the DC reference clock instead of pushing offsets to slaves.
+     *
+     * Each cycle the reference system time (EthercatMaster::lastDcReferenceSample(),
+     * fed by the cyclic ARMW) is compared with the SYNC0 grid, and a PLL moves
+     * the next wake-up so frames leave `sendLeadBeforeSync0` ahead of SYNC0.
+     * Leave the DC closed loop off in this mode.
+     */
+    bool followDistributedClock = false;
+    /// SYNC0 position within the cycle, as programmed in the slaves (0x0990 start modulo period).
+    std::chrono::nanoseconds sync0Shift{0};
+    std::chrono::nanoseconds sendLeadBeforeSync0{std::chrono::microseconds(100)};
+    double dcFollowKp = 0.1;
+    double dcFollowKi = 0.01;
+    /// Largest wake-up shift per cycle; also bounds the PLL integrator.
+    std::chrono::nanoseconds dcFollowMaxAdjust{std::chrono::microseconds(20)};
+    /**
+     * @brief Receive budget of each cycle, measured from its scheduled wake-up; 0 keeps the transport timeout.
+     *
+     * The transport stops waiting for frames at wake-up + budget, so a lost
+     * frame cannot push the cycle past its period (set below `period`).
+     */
+    std::chrono::nanoseconds receiveBudget{0};
+    /**
+     * @brief Launch time of each cycle's first frame after its scheduled wake-up; 0 sends when ready.
+     *
+     * Needs a transport with scheduled transmit (`OEC_TXTIME=1`). Leave room for
+     * the wake-up latency and the transport's minimum lead, or frames are sent late.
+     * With a receiveBudget it must be shorter than the budget, since a frame
+     * launched at or after the receive deadline can never be answered in time;
+     * start() refuses such options.
+     */
+    std::chrono::nanoseconds launchOffset{0};
+    /// Overrides the master's reference sample (DC time at cycle start); mainly for tests.
+    std::function<std::optional<std::int64_t>()> dcReferenceTimeNsProvider;
+};
+
+/**
+ * @brief PLL aligning the cycle wake-up with the SYNC0 grid of the DC reference clock.
+ */
+class DcFollowLoop {
+public:
+    DcFollowLoop(std::chrono::nanoseconds period, std::chrono::nanoseconds sync0Shift,
+                 std::chrono::nanoseconds sendLead, double kp, double ki, std::chrono::nanoseconds maxAdjust);
+
+    /**
+     * @brief Feed the reference time at cycle start; returns ns to take off the next period.
+     */
+    std::int64_t update(std::int64_t referenceTimeNs);
+    /**
+     * @brief Last phase error, positive when the frame left later than its target.
+     */
+    std::int64_t phaseErrorNs() const noexcept { return phaseErrorNs_; }
+    /**
+     * @brief Integrator state, i.e. the estimated host/DC period mismatch in ns per cycle.
+     */
+    double frequencyOffsetNs() const noexcept { return integral_; }
+    void reset();
+
+private:
+    std::int64_t periodNs_;
+    std::int64_t targetPhaseNs_;
+    double kp_;
+    double ki_;
+    double maxAdjustNs_;
+    double integral_ = 0.0;
+    std::int64_t phaseErrorNs_ = 0;
 };
 
 /**
@@ -36,6 +103,9 @@ struct CycleReport {
     bool success = false;
     std::uint16_t workingCounter = 0;
     std::chrono::microseconds runtime = std::chrono::microseconds(0);
+    /// Set when followDistributedClock steered this cycle's wake-up.
+    bool dcFollowing = false;
+    std::int64_t dcPhaseErrorNs = 0;
 };
 
 /**
@@ -48,6 +118,9 @@ public:
     CycleController() = default;
     ~CycleController();
 
+    /**
+     * @brief Start the worker; false when already running or launchOffset is not below receiveBudget.
+     */
     bool start(EthercatMaster& master,
                CycleControllerOptions options,
                CycleReportCallback callback = {});
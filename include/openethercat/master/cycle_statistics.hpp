@@ -15,6 +15,9 @@ struct CycleStatistics {
     std::uint64_t cyclesFailed = 0;
     std::uint16_t lastWorkingCounter = 0;
     std::chrono::microseconds lastCycleRuntime = std::chrono::microseconds(0);
+    /// Wire round trip of the last cycle's frames from SO_TIMESTAMPING stamps; zero when not stamped.
+    std::chrono::nanoseconds lastWireRoundTrip = std::chrono::nanoseconds(0);
+    std::uint64_t wireTimedCycles = 0;
 };
 
 } // namespace oec
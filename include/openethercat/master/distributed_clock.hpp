@@ -5,8 +5,13 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace oec {
 
@@ -18,6 +23,16 @@ struct DcSyncSample {
     std::int64_t localTimeNs = 0;
 };
 
+/**
+ * @brief Reference-clock time carried by one cyclic frame.
+ */
+struct DcReferenceSample {
+    std::uint64_t cycleIndex = 0;
+    std::int64_t referenceTimeNs = 0;
+    /// Host time at which the cycle's exchange started, or the frame's TX stamp with frame timestamping.
+    std::chrono::steady_clock::time_point hostTime{};
+};
+
 /**
  * @brief Aggregated distributed-clock control statistics.
  */
@@ -28,32 +43,226 @@ struct DcSyncStats {
     std::int64_t maxAbsOffsetNs = 0;
     double jitterRmsNs = 0.0;
     std::uint64_t samples = 0;
+    /// Drift of the uncorrected offset per sample (DriftTracking only).
+    double estimatedDriftNs = 0.0;
 };
 
 /**
- * @brief PI-based distributed-clock correction controller.
+ * @brief Distributed-clock correction controller.
+ *
+ * `Algorithm::Pi` filters the offset with an EMA and runs a PI controller.
+ * `Algorithm::DriftTracking` runs an alpha-beta tracker in Q16 fixed point on
+ * the uncorrected offset (measured offset plus the correction in force). It
+ * estimates offset and drift, and outputs the one-step-ahead prediction, so a
+ * constant drift leaves no steady-state error. The tracker integrates the
+ * measured residual only, and the correction actually applied is fed back
+ * through notifyApplied(), so output clamping cannot wind it up.
  */
 class DistributedClockController {
 public:
+    enum class Algorithm { Pi, DriftTracking };
+
     struct Options {
         double filterAlpha = 0.2;
         double kp = 0.1;
         double ki = 0.01;
         std::int64_t correctionClampNs = 50000;
+        Algorithm algorithm = Algorithm::Pi;
+        /// DriftTracking offset gain (0..1], converted to Q16 once.
+        double trackingAlpha = 0.5;
+        /// DriftTracking drift gain (0..1], converted to Q16 once.
+        double trackingBeta = 0.1;
     };
 
     DistributedClockController();
     explicit DistributedClockController(Options options);
 
     std::optional<std::int64_t> update(const DcSyncSample& sample);
+    /**
+     * @brief Report the correction actually written when it differs from update()'s (step/slew limits).
+     */
+    void notifyApplied(std::int64_t appliedNs);
     DcSyncStats stats() const noexcept;
     void reset();
 
 private:
+    std::int64_t updateDriftTracking(std::int64_t offsetNs);
+    void recordStats(std::int64_t offsetNs);
+
     Options options_;
     DcSyncStats stats_{};
     double integral_ = 0.0;
     double sumSquares_ = 0.0;
+    // DriftTracking state, Q16.
+    std::int64_t alphaQ16_ = 0;
+    std::int64_t betaQ16_ = 0;
+    std::int64_t offsetEstimateQ16_ = 0;
+    std::int64_t driftEstimateQ16_ = 0;
+    std::int64_t appliedNs_ = 0;
+};
+
+/**
+ * @brief Registers latched on one slave during DC bring-up.
+ */
+struct DcPortLatch {
+    std::uint16_t slavePosition = 0;
+    /// ESC feature 0x0008 bit 2.
+    bool dcSupported = false;
+    /// Bit n set when port n has link and an open loop (DL status 0x0110).
+    std::uint8_t activePorts = 0;
+    /// Port receive times 0x0900..0x090F (low 32 bits of local time).
+    std::array<std::uint32_t, 4> portReceiveTimeNs{};
+    /// Local time of the port 0 latch, 0x0918.
+    std::int64_t processingUnitReceiveTimeNs = 0;
+};
+
+/**
+ * @brief Result of the DC bring-up for one slave.
+ */
+struct DcSlaveTiming {
+    std::uint16_t slavePosition = 0;
+    bool dcSupported = false;
+    /// Upstream slave, -1 for the first slave (attached to the master).
+    std::int32_t parentPosition = -1;
+    /// Port of the parent this slave hangs off.
+    std::uint8_t parentPort = 0;
+    /// One-way delay from the reference slave, programmed into 0x0928.
+    std::int64_t propagationDelayNs = 0;
+    /// System time offset programmed into 0x0920.
+    std::int64_t systemTimeOffsetNs = 0;
+    /// Delay-compensated system time minus the reference's, read back after programming.
+    std::int64_t residualNs = 0;
+};
+
+/**
+ * @brief Behavior of the DC bring-up.
+ */
+struct DcInitOptions {
+    /// Start system time at the host clock (ns since 2000-01-01) instead of the reference slave's local time.
+    bool alignToHostClock = true;
+    /// Read 0x0910 of all slaves in one frame after programming and report the spread.
+    bool measureSpread = true;
+};
+
+/**
+ * @brief Outcome of the DC bring-up.
+ */
+struct DcInitReport {
+    bool success = false;
+    std::string error;
+    std::uint16_t referenceSlavePosition = 0;
+    std::vector<DcSlaveTiming> slaves;
+    std::int64_t maxPropagationDelayNs = 0;
+    /// Max minus min residual over DC slaves; valid when spreadMeasured.
+    std::int64_t spreadNs = 0;
+    bool spreadMeasured = false;
+};
+
+/**
+ * @brief Derive topology, propagation delays and offsets from latched port times.
+ *
+ * @p latches must be in auto-increment order. The tree is rebuilt from the
+ * active ports, visited in processing order 0-3-1-2. A slave's delay is its
+ * parent's plus half of the parent's round trip through the branch minus
+ * the round trip through the slave's own subtree. The first DC slave is the
+ * reference; its port 0 latch is mapped to @p referenceSystemTimeNs, and every
+ * other slave's offset accounts for when the latching frame reached it
+ * (including time spent in earlier branches). Non-DC slaves inherit their
+ * parent's timing.
+ */
+bool computeDcTiming(const std::vector<DcPortLatch>& latches, std::int64_t referenceSystemTimeNs,
+                     DcInitReport& outReport);
+
+/**
+ * @brief Decode the system time difference register 0x092C into signed ns (local minus received time).
+ *
+ * Bit 31 set means the local copy is behind the distributed time; bits 30:0
+ * hold the filtered magnitude.
+ */
+std::int64_t decodeDcSystemTimeDifference(std::uint32_t raw);
+
+/**
+ * @brief One slave's answer in a line-wide DC monitor round.
+ */
+struct DcSlaveSyncSample {
+    std::uint16_t slavePosition = 0;
+    /// False when the slave did not answer (WKC 0) or the payload was short.
+    bool valid = false;
+    std::int64_t deviationNs = 0;
+};
+
+/**
+ * @brief Knobs of the line-wide DC monitor.
+ */
+struct DcLineMonitorOptions {
+    bool enabled = false;
+    /// Sample every N-th cycle; the reads ride in the next cycle's input frame.
+    std::size_t decimation = 100;
+    /// Width of one |deviation| histogram bucket.
+    std::int64_t bucketWidthNs = 20;
+    /// Buckets per slave; the last one also collects everything beyond the range.
+    std::size_t bucketCount = 32;
+};
+
+/**
+ * @brief Deviation statistics of one DC slave.
+ */
+struct DcSlaveJitterHistogram {
+    std::uint16_t slavePosition = 0;
+    std::uint64_t samples = 0;
+    /// Rounds in which the slave did not answer.
+    std::uint64_t missed = 0;
+    std::int64_t lastDeviationNs = 0;
+    std::int64_t minDeviationNs = 0;
+    std::int64_t maxDeviationNs = 0;
+    /// Upper bucket edge below which 99 % of |deviation| samples fall; see p99Saturated.
+    std::int64_t p99AbsNs = 0;
+    /// The 99th percentile lies in the overflow bucket: p99AbsNs is then the largest |deviation| seen, an upper bound.
+    bool p99Saturated = false;
+    /// Counts of |deviation| per bucket of DcLineMonitorOptions::bucketWidthNs.
+    std::vector<std::uint64_t> buckets;
+};
+
+/**
+ * @brief Line-wide DC quality, the per-slave counterpart of the reference-only sync snapshot.
+ */
+struct DcLineMonitorSnapshot {
+    bool enabled = false;
+    std::uint64_t rounds = 0;
+    /// Rounds whose frame was lost as a whole.
+    std::uint64_t failedRounds = 0;
+    std::int64_t bucketWidthNs = 0;
+    /// Slave with the largest p99, -1 before the first sample.
+    std::int32_t worstSlavePosition = -1;
+    std::int64_t worstP99AbsNs = 0;
+    bool worstP99Saturated = false;
+    std::vector<DcSlaveJitterHistogram> slaves;
+};
+
+/**
+ * @brief Accumulates per-slave deviation histograms from monitor rounds.
+ */
+class DcLineMonitor {
+public:
+    DcLineMonitor();
+    explicit DcLineMonitor(DcLineMonitorOptions options);
+
+    /**
+     * @brief True on cycles a round is due (every decimation-th call).
+     */
+    bool due();
+    void record(const std::vector<DcSlaveSyncSample>& samples);
+    void recordFailure();
+    DcLineMonitorSnapshot snapshot() const;
+    const DcLineMonitorOptions& options() const { return options_; }
+    void reset();
+
+private:
+    DcLineMonitorOptions options_;
+    std::vector<DcSlaveJitterHistogram> slaves_;
+    std::uint64_t rounds_ = 0;
+    std::uint64_t failedRounds_ = 0;
+    std::size_t cyclesSinceRound_ = 0;
 };
 
 } // namespace oec
@@ -0,0 +1,155 @@
+/**
+ * @file emergency_queue.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "openethercat/master/coe_mailbox.hpp"
+
+namespace oec {
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring of emergencies.
+ *
+ * Each cell carries a sequence number (Vyukov bounded queue): producers claim
+ * a slot with one CAS on the enqueue position, the single consumer never
+ * writes the enqueue side. A full ring rejects the new message instead of
+ * evicting queued ones.
+ */
+class EmergencyRing {
+public:
+    /**
+     * @brief Capacity is rounded up to a power of two (minimum 2).
+     */
+    explicit EmergencyRing(std::size_t capacity);
+    EmergencyRing(const EmergencyRing&) = delete;
+    EmergencyRing& operator=(const EmergencyRing&) = delete;
+
+    /**
+     * @brief Append a message; safe from any number of threads. False when full.
+     */
+    bool tryPush(const EmergencyMessage& message);
+    /**
+     * @brief Take the oldest message; only one thread may consume at a time.
+     */
+    bool tryPop(EmergencyMessage& outMessage);
+    std::size_t capacity() const { return mask_ + 1U; }
+    /**
+     * @brief Messages queued right now; exact only while producers and consumer are idle.
+     */
+    std::size_t sizeApprox() const;
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        EmergencyMessage message{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::atomic<std::size_t> dequeuePos_{0};
+};
+
+/**
+ * @brief Per-slave admission policy of EmergencyQueue; both stages are off by default.
+ */
+struct EmergencyRateLimitOptions {
+    /// Sustained emergencies per second and slave; 0 disables the token bucket.
+    double tokensPerSecond = 0.0;
+    /// Bucket depth, i.e. burst a slave may send after a quiet period.
+    std::size_t burst = 8;
+    /// Repeats of the same slave/error code/register inside this window are folded into repeatCount; 0 disables.
+    std::chrono::milliseconds dedupWindow{0};
+};
+
+/**
+ * @brief Admission and delivery counters of EmergencyQueue.
+ */
+struct EmergencyQueueStats {
+    std::uint64_t accepted = 0;
+    std::uint64_t deduplicated = 0;
+    std::uint64_t rateLimited = 0;
+    /// Admitted but rejected because the ring was full.
+    std::uint64_t overflowDropped = 0;
+    std::uint64_t delivered = 0;
+};
+
+/**
+ * @brief Rate-limited emergency queue shared between the cyclic side and consumers.
+ *
+ * offer() applies deduplication and a token bucket per slave, so one flooding
+ * drive cannot crowd out other slaves, then pushes into an EmergencyRing.
+ * offer() keeps per-slave state and must be called by one producer at a time
+ * (EthercatMaster calls it under its lock); pop()/drain() are lock-free and
+ * may run concurrently in one consumer thread.
+ */
+class EmergencyQueue {
+public:
+    explicit EmergencyQueue(std::size_t capacity = 256U, EmergencyRateLimitOptions options = {});
+
+    /**
+     * @brief Admit one message; a zero timestampNs is stamped with the steady clock.
+     */
+    bool offer(EmergencyMessage message);
+    /**
+     * @brief Publish repeats still folded after their dedup window closed; returns how many were pushed.
+     *
+     * The last suppressed message goes out with repeatCount counting the
+     * others, so a burst that is never followed by another message is not lost.
+     */
+    std::size_t flushSuppressed(std::uint64_t nowNs);
+    bool pop(EmergencyMessage& outMessage);
+    std::vector<EmergencyMessage> drain(std::size_t maxMessages);
+
+    /**
+     * @brief Replace the admission policy; producer side only, resets per-slave state.
+     */
+    void setRateLimit(EmergencyRateLimitOptions options);
+    EmergencyRateLimitOptions rateLimit() const { return options_; }
+    EmergencyQueueStats stats() const;
+    std::size_t capacity() const { return ring_.capacity(); }
+    std::size_t sizeApprox() const { return ring_.sizeApprox(); }
+
+    /**
+     * @brief Current steady-clock time in ns, the clock used for timestampNs.
+     */
+    static std::uint64_t nowNs();
+
+private:
+    struct SlaveBucket {
+        double tokens = 0.0;
+        std::uint64_t lastRefillNs = 0;
+        bool primed = false;
+    };
+    struct DedupEntry {
+        std::uint64_t lastAcceptedNs = 0;
+        std::uint32_t suppressed = 0;
+        EmergencyMessage lastSuppressed{};
+    };
+
+    bool takeToken(std::uint16_t slavePosition, std::uint64_t nowNs);
+
+    EmergencyRing ring_;
+    EmergencyRateLimitOptions options_;
+    std::unordered_map<std::uint16_t, SlaveBucket> buckets_;
+    std::unordered_map<std::uint64_t, DedupEntry> dedup_;
+    // Dedup entries holding suppressed repeats; flushSuppressed() returns at once while zero.
+    std::size_t pendingSuppressed_ = 0;
+    std::atomic<std::uint64_t> accepted_{0};
+    std::atomic<std::uint64_t> deduplicated_{0};
+    std::atomic<std::uint64_t> rateLimited_{0};
+    std::atomic<std::uint64_t> overflowDropped_{0};
+    std::atomic<std::uint64_t> delivered_{0};
+};
+
+} // namespace oec
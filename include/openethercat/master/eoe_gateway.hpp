@@ -0,0 +1,229 @@
+/**
+ * @file eoe_gateway.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "openethercat/transport/i_transport.hpp"
+
+namespace oec {
+
+/**
+ * @brief Decoded 4-byte EoE header (ETG.1000.6).
+ */
+struct EoeFragmentHeader {
+    std::uint8_t frameType = 0;
+    std::uint8_t port = 0;
+    bool lastFragment = false;
+    bool timeAppended = false;
+    std::uint8_t fragmentNumber = 0;
+    /// Fragment 0: frame size in 32-byte blocks (rounded up); later fragments: offset in 32-byte blocks.
+    std::uint8_t offsetBlocks = 0;
+    std::uint8_t frameNumber = 0;
+};
+
+/**
+ * @brief EoE fragment encode/decode helpers.
+ */
+class EoeCodec {
+public:
+    static constexpr std::size_t kHeaderBytes = 4U;
+    static constexpr std::uint8_t kFrameTypeFragment = 0x00U;
+
+    /**
+     * @brief Split an Ethernet frame into EoE mailbox payloads of at most @p maxPayloadBytes.
+     *
+     * Every fragment but the last carries a multiple of 32 data bytes, as the
+     * offset field counts 32-byte blocks.
+     */
+    static std::vector<std::vector<std::uint8_t>> fragment(const std::vector<std::uint8_t>& frame,
+                                                           std::size_t maxPayloadBytes,
+                                                           std::uint8_t frameNumber);
+    static bool parseHeader(const std::vector<std::uint8_t>& payload, EoeFragmentHeader& outHeader);
+};
+
+/**
+ * @brief Reassembles one slave's EoE fragment stream into Ethernet frames.
+ */
+class EoeReassembler {
+public:
+    enum class Result { Incomplete, Complete, Dropped, Ignored };
+
+    /**
+     * @brief Feed one EoE mailbox payload; on Complete, @p outFrame holds the frame.
+     */
+    Result push(const std::vector<std::uint8_t>& payload, std::vector<std::uint8_t>& outFrame);
+    void reset();
+    /**
+     * @brief Frames discarded because a new fragment 0 arrived before their last fragment.
+     */
+    std::uint64_t abandonedFrames() const { return abandonedFrames_; }
+
+private:
+    std::vector<std::uint8_t> buffer_;
+    std::size_t expectedBytes_ = 0;
+    std::uint8_t frameNumber_ = 0;
+    std::uint8_t nextFragment_ = 0;
+    bool active_ = false;
+    std::uint64_t abandonedFrames_ = 0;
+};
+
+/**
+ * @brief One slave's part of ITransport::eoeExchangeBatch().
+ */
+struct EoeBatchSlot {
+    std::uint16_t slavePosition = 0;
+    /// EoE mailbox payload to send this round; empty for receive only.
+    std::vector<std::uint8_t> tx;
+    bool txAccepted = false;
+    bool rxValid = false;
+    std::vector<std::uint8_t> rx;
+};
+
+/**
+ * @brief Host side of an EoE tunnel (TAP device or in-memory queue).
+ */
+class EoeEndpoint {
+public:
+    virtual ~EoeEndpoint() = default;
+    /**
+     * @brief Fetch one frame without blocking; false when none is pending.
+     */
+    virtual bool readFrame(std::vector<std::uint8_t>& outFrame) = 0;
+    virtual bool writeFrame(const std::vector<std::uint8_t>& frame) = 0;
+};
+
+/**
+ * @brief Linux TAP interface endpoint (`/dev/net/tun`, IFF_TAP | IFF_NO_PI, non-blocking).
+ *
+ * Several TAPs can be joined in a Linux bridge to put all EoE slaves on one segment.
+ */
+class TapEndpoint : public EoeEndpoint {
+public:
+    TapEndpoint() = default;
+    ~TapEndpoint() override;
+    TapEndpoint(const TapEndpoint&) = delete;
+    TapEndpoint& operator=(const TapEndpoint&) = delete;
+
+    bool open(const std::string& ifName, std::string& outError);
+    void close();
+    int fd() const { return fd_; }
+    const std::string& name() const { return name_; }
+    bool readFrame(std::vector<std::uint8_t>& outFrame) override;
+    bool writeFrame(const std::vector<std::uint8_t>& frame) override;
+
+private:
+    int fd_ = -1;
+    std::string name_;
+};
+
+/**
+ * @brief Queueing, fragmenting and time limits of an EoeGateway.
+ */
+struct EoeGatewayOptions {
+    /// Frames queued per slave before the gateway stops reading its endpoint (the kernel keeps the rest).
+    std::size_t maxQueuedFrames = 64;
+    /// Largest EoE mailbox payload (header included) for slaves whose SM0 length the transport cannot report.
+    std::size_t maxFragmentBytes = 122;
+    /// Rounds one fragment may be refused (SM0 full, transfer error) before its frame is dropped; 0 = no limit.
+    std::size_t maxFragmentRetries = 1000;
+    /// Time service() may spend per call; at least one round always runs.
+    std::chrono::microseconds budget{500};
+};
+
+/**
+ * @brief EoeGateway counters since construction.
+ */
+struct EoeGatewayStats {
+    /// Host frames whose last fragment a slave accepted.
+    std::uint64_t txFrames = 0;
+    /// Fragments accepted by slave SM0 mailboxes.
+    std::uint64_t txFragments = 0;
+    /// Rounds in which a fragment was refused and kept for the next round.
+    std::uint64_t txFragmentRetries = 0;
+    /// Frames given up after maxFragmentRetries refusals, or too large to fragment for the slave's SM0.
+    std::uint64_t txFramesDropped = 0;
+    /// Frames reassembled from slave fragments (delivered or not).
+    std::uint64_t rxFrames = 0;
+    /// Fragments read from slave SM1 mailboxes.
+    std::uint64_t rxFragments = 0;
+    /// Fragments or partial frames discarded: malformed, out of sequence, oversized or abandoned.
+    std::uint64_t reassemblyDrops = 0;
+    /// Reassembled frames the host endpoint refused or that had no endpoint.
+    std::uint64_t endpointWriteFailures = 0;
+    /// Rounds exchanged through ITransport::eoeExchangeBatch().
+    std::uint64_t batchedRounds = 0;
+    /// Rounds exchanged with per-slave eoeSend()/eoeReceive() calls.
+    std::uint64_t fallbackRounds = 0;
+};
+
+/**
+ * @brief Bridges host Ethernet endpoints to EoE slaves.
+ *
+ * service() moves queued frames fragment by fragment and reassembles received
+ * fragments, running as many rounds as the budget allows. Each round carries
+ * one fragment per slave; with a transport implementing
+ * ITransport::eoeExchangeBatch() all slaves share the same frames. Fragments
+ * are sized to each slave's SM0 window. A frame whose fragment is not accepted
+ * (SM0 still full) stays queued and is retried, up to maxFragmentRetries rounds.
+ */
+class EoeGateway {
+public:
+    explicit EoeGateway(ITransport& transport, EoeGatewayOptions options = {});
+    ~EoeGateway();
+
+    bool addSlave(std::uint16_t slavePosition, EoeEndpoint& endpoint, std::string& outError);
+    /**
+     * @brief Create a TAP interface owned by the gateway and attach it to @p slavePosition.
+     */
+    bool addTapSlave(std::uint16_t slavePosition, const std::string& ifName, std::string& outError);
+    /**
+     * @brief Queue a frame for @p slavePosition; false when the queue is full.
+     */
+    bool enqueueFrame(std::uint16_t slavePosition, std::vector<std::uint8_t> frame);
+    std::size_t queuedFrames(std::uint16_t slavePosition) const;
+    /**
+     * @brief Run transfer rounds until idle or the budget is spent; returns fragments moved.
+     */
+    std::size_t service(std::string& outError);
+    EoeGatewayStats stats() const { return stats_; }
+
+private:
+    struct Lane {
+        EoeEndpoint* endpoint = nullptr;
+        std::deque<std::vector<std::uint8_t>> queue;
+        std::vector<std::vector<std::uint8_t>> fragments;
+        std::size_t nextFragment = 0;
+        std::uint8_t frameNumber = 0;
+        /// Resolved EoE payload limit of the slave; 0 until the transport reports its SM0 length.
+        std::size_t fragmentBytes = 0;
+        std::size_t fragmentRetries = 0;
+        EoeReassembler reassembler;
+    };
+
+    void pullEndpointFrames(Lane& lane);
+    std::size_t fragmentBytes(std::uint16_t slavePosition, Lane& lane);
+    bool prepareFragment(std::uint16_t slavePosition, Lane& lane);
+    void dropFrame(Lane& lane);
+    void deliverFragment(Lane& lane, const std::vector<std::uint8_t>& payload);
+    void acceptFragment(Lane& lane);
+
+    ITransport& transport_;
+    EoeGatewayOptions options_;
+    std::map<std::uint16_t, Lane> lanes_;
+    std::vector<std::unique_ptr<TapEndpoint>> ownedTaps_;
+    bool batchSupported_ = true;
+    EoeGatewayStats stats_{};
+};
+
+} // namespace oec
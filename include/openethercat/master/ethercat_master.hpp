@@ -21,8 +21,12 @@
 #include "openethercat/master/coe_mailbox.hpp"
 #include "openethercat/master/cycle_statistics.hpp"
 #include "openethercat/master/distributed_clock.hpp"
+#include "openethercat/master/emergency_queue.hpp"
+#include "openethercat/master/eoe_gateway.hpp"
+#include "openethercat/master/firmware_update.hpp"
 #include "openethercat/master/foe_eoe.hpp"
 #include "openethercat/master/hil_campaign.hpp"
+#include "openethercat/master/object_dictionary.hpp"
 #include "openethercat/master/slave_diagnostics.hpp"
 #include "openethercat/master/topology_manager.hpp"
 #include "openethercat/mapping/io_mapper.hpp"
@@ -162,6 +166,8 @@ public:
         std::uint64_t recoverEvents = 0;
         std::uint64_t impactedCycles = 0;
         std::int64_t lastDetectionLatencyMs = -1;
+        /// Cycles between the last healthy observation and the detected fault; 1 with parallel redundancy.
+        std::int64_t lastDetectionLatencyCycles = -1;
         std::int64_t lastRecoveryLatencyMs = -1;
         std::int64_t lastPolicyTriggerLatencyMs = -1;
     };
@@ -176,6 +182,22 @@ public:
         RedundancyState to = RedundancyState::PrimaryOnly;
         std::string reason;
     };
+    /**
+     * @brief Wall-clock breakdown of the last start() call, per startup phase.
+     */
+    struct StartupReport {
+        bool completed = false;
+        std::string failedPhase;
+        std::chrono::microseconds initTransition{0};
+        std::chrono::microseconds preOpTransition{0};
+        std::chrono::microseconds processImageConfiguration{0};
+        /// DC bring-up, run when `OEC_DC_INIT=1`.
+        std::chrono::microseconds dcInitialization{0};
+        std::chrono::microseconds safeOpTransition{0};
+        std::chrono::microseconds opTransition{0};
+        std::chrono::microseconds total{0};
+        std::size_t statePolls = 0;
+    };
 
     explicit EthercatMaster(ITransport& transport);
 
@@ -243,7 +265,7 @@ public:
     void clearRecoveryEvents();
     bool isDegraded() const;
     /**
-     * @brief CoE SDO upload convenience wrapper.
+     * @brief CoE SDO upload convenience wrapper; objects marked static are served from cache.
      */
     SdoResponse sdoUpload(std::uint16_t slavePosition, SdoAddress address);
     /**
@@ -251,30 +273,128 @@ public:
      */
     SdoResponse sdoDownload(std::uint16_t slavePosition, SdoAddress address,
                             const std::vector<std::uint8_t>& data);
+    /**
+     * @brief Mark an object index static (cached by sdoUpload()) or volatile.
+     *
+     * Static objects are dropped when topology refresh reports a different slave
+     * at a position, when a slave changes AL state, or when written via sdoDownload().
+     */
+    void setSdoCachePolicy(std::uint16_t index, SdoCachePolicy policy);
+    void invalidateSdoCache();
+    SdoCacheStats sdoCacheStats() const;
+    /**
+     * @brief Read a whole object in one CoE Complete Access transfer.
+     */
+    SdoResponse sdoUploadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0 = true);
+    /**
+     * @brief Write a whole object in one CoE Complete Access transfer.
+     */
+    SdoResponse sdoDownloadComplete(std::uint16_t slavePosition, std::uint16_t index,
+                                    const std::vector<std::uint8_t>& data, bool includeSubIndex0 = true);
+    /**
+     * @brief Object dictionary of a slave, scanned via SDO Information once per device type.
+     *
+     * The cache key is vendor/product (from the configuration, else 0x1018) plus
+     * the revision read from 0x1018:03; slaves of an already scanned type cost a
+     * single SDO upload instead of a full dictionary walk.
+     */
+    bool objectDictionary(std::uint16_t slavePosition, ObjectDictionary& outDictionary, std::string& outError);
+    /**
+     * @brief Cache used by objectDictionary(); load or save it to persist scans across runs.
+     */
+    ObjectDictionaryCache& objectDictionaryCache();
     bool configureRxPdo(std::uint16_t slavePosition, const std::vector<PdoMappingEntry>& entries,
                         std::string& outError);
     bool configureTxPdo(std::uint16_t slavePosition, const std::vector<PdoMappingEntry>& entries,
                         std::string& outError);
+    /**
+     * @brief Collect pending emergencies from the transport, then pop up to @p maxMessages.
+     */
     std::vector<EmergencyMessage> drainEmergencies(std::size_t maxMessages);
+    /**
+     * @brief Rate-limited emergency queue, filled by runCycle() and drainEmergencies().
+     *
+     * Its pop()/drain()/stats() do not take the master lock, so a single
+     * consumer thread can read emergencies while the cyclic thread runs.
+     */
+    EmergencyQueue& emergencyQueue();
+    void setEmergencyRateLimit(EmergencyRateLimitOptions options);
     /**
      * @brief FoE read convenience wrapper.
      */
     FoEResponse foeReadFile(std::uint16_t slavePosition, const FoERequest& request);
     bool foeWriteFile(std::uint16_t slavePosition, const FoERequest& request,
                       const std::vector<std::uint8_t>& data, std::string& outError);
+    /**
+     * @brief FoE read streamed into @p sink, one mailbox packet at a time.
+     */
+    bool foeReadFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                           std::string& outError);
+    /**
+     * @brief FoE write streamed from @p source, one mailbox packet at a time.
+     */
+    bool foeWriteFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                            std::string& outError);
+    /**
+     * @brief FoE writes to several slaves at once; per-slave results are stored in @p jobs.
+     */
+    bool foeWriteFiles(std::vector<FoEWriteJob>& jobs, std::string& outError);
+    /**
+     * @brief Update firmware on many slaves at once (BOOTSTRAP, interleaved FoE, verify, restart).
+     *
+     * Holds the master lock for the whole update; cyclic exchange pauses meanwhile.
+     */
+    FirmwareUpdateReport updateFirmware(std::vector<FirmwareUpdateJob>& jobs, const FirmwareUpdateOptions& options);
     bool eoeSendFrame(std::uint16_t slavePosition, const std::vector<std::uint8_t>& frame,
                       std::string& outError);
     bool eoeReceiveFrame(std::uint16_t slavePosition, std::vector<std::uint8_t>& frame,
                          std::string& outError);
+    /**
+     * @brief Run one EoeGateway::service() pass under the master lock (call between cycles).
+     */
+    std::size_t serviceEoeGateway(EoeGateway& gateway, std::string& outError);
 
+    /**
+     * @brief Measure propagation delays and program offset/delay of every DC slave (Linux transport only).
+     *
+     * start() runs this between process-image setup and SAFEOP when `OEC_DC_INIT=1`.
+     */
+    bool initializeDistributedClocks(const DcInitOptions& options, DcInitReport& outReport);
+    DcInitReport dcInitReport() const;
     std::optional<std::int64_t> updateDistributedClock(std::int64_t referenceTimeNs,
                                                        std::int64_t localTimeNs);
     DcSyncStats distributedClockStats() const;
     DcSyncQualitySnapshot distributedClockQuality() const;
+    /**
+     * @brief Sample 0x092C of all DC slaves every `decimation` cycles (Linux transport only).
+     *
+     * Slaves come from the DC bring-up report when available, else from the
+     * configured slaves whose ESC reports DC support (read once at start() or
+     * here). The reads ride in the next cycle's input frame, so a round adds no
+     * frame to runCycle(); a round whose frame was lost counts as failed. No
+     * rounds run while parallel redundancy is active.
+     */
+    void setDcLineMonitorOptions(const DcLineMonitorOptions& options);
+    /**
+     * @brief Per-slave deviation histograms, next to the reference-only distributedClockQuality().
+     */
+    DcLineMonitorSnapshot distributedClockLineQuality() const;
     /**
      * @brief Last applied DC correction from closed-loop mode (ns).
      */
     std::optional<std::int64_t> lastAppliedDcCorrectionNs() const;
+    /**
+     * @brief Reference time read by the last cycle's ARMW (`OEC_DC_CYCLIC_ARMW=1`); empty otherwise.
+     */
+    std::optional<DcReferenceSample> lastDcReferenceSample() const;
+    /**
+     * @brief Bound the next runCycle()'s frame receive by an absolute time point (cycle start + budget).
+     */
+    void setNextReceiveDeadline(std::chrono::steady_clock::time_point deadline);
+    /**
+     * @brief Launch time of the next runCycle()'s first frame, for transports with scheduled transmit.
+     */
+    void setNextLaunchTime(std::chrono::steady_clock::time_point launchTime);
 
     /**
      * @brief Refresh live topology snapshot from transport discovery.
@@ -296,6 +416,10 @@ public:
     std::string lastError() const;
     RedundancyStatusSnapshot redundancyStatus() const;
     RedundancyKpiSnapshot redundancyKpis() const;
+    /**
+     * @brief Phase timing of the most recent start() (set OEC_TRACE_STARTUP=1 to print it).
+     */
+    StartupReport startupReport() const;
     std::vector<RedundancyTransitionEvent> redundancyTransitions() const;
     void clearRedundancyTransitions();
 
@@ -306,6 +430,8 @@ private:
         std::int64_t targetPhaseNs = 0;
         std::int64_t maxCorrectionStepNs = 20000;
         std::int64_t maxSlewPerCycleNs = 5000;
+        /// Reference time via cyclic ARMW, offset written in the next process-data frame.
+        bool cyclicDistribution = false;
     };
 
     void setError(std::string message);
@@ -317,24 +443,39 @@ private:
                                      std::uint64_t topologyGeneration);
     void transitionRedundancyState(RedundancyState newState, const std::string& reason,
                                    std::uint64_t topologyGeneration);
+    void emitTopologyPolicyEvent(std::uint16_t slavePosition, TopologyPolicyAction policyAction, bool success,
+                                 const std::string& reason, std::uint64_t topologyGeneration);
+    void applyRedundancyPolicyLocked(bool redundancyHealthy, std::uint64_t topologyGeneration);
+    void observeRedundancyLocked(bool ringIntact);
     void updateDcSyncQualityLocked(std::int64_t phaseErrorNs);
     void applyDcPolicyLocked();
     void configureDcClosedLoopFromEnvironment();
     bool runDcClosedLoopUpdate();
+    void runDcLineMonitorLocked();
+    void resolveDcLineMonitorPositionsLocked();
     bool transitionNetworkTo(SlaveState target);
     bool transitionSlaveTo(std::uint16_t position, SlaveState target);
     bool recoverSlave(const SlaveDiagnostic& diagnostic);
     void appendRecoveryEvent(const RecoveryEvent& event);
+    void collectEmergenciesLocked(std::size_t maxMessages);
 
     ITransport& transport_;
     CoeMailboxService mailbox_;
+    EmergencyQueue emergencyQueue_;
+    std::vector<EmergencyMessage> emergencyScratch_;
     FoeEoeService foeEoe_;
+    ObjectDictionaryCache objectDictionaryCache_;
     DistributedClockController dcController_{};
     DcClosedLoopOptions dcClosedLoopOptions_{};
     std::optional<std::int64_t> lastAppliedDcCorrectionNs_;
+    std::optional<DcReferenceSample> lastDcReferenceSample_;
     LinuxRawSocketTransport* dcLinuxTransport_ = nullptr;
     DcSyncQualityOptions dcSyncQualityOptions_{};
     DcSyncQualitySnapshot dcSyncQuality_{};
+    DcInitReport dcInitReport_{};
+    DcLineMonitor dcLineMonitor_{};
+    std::vector<std::uint16_t> dcLineMonitorPositions_;
+    bool dcLineMonitorRoundQueued_ = false;
     std::deque<std::int64_t> dcPhaseErrorAbsHistoryNs_;
     bool dcPolicyLatched_ = false;
     bool traceDc_ = false;
@@ -363,9 +504,11 @@ private:
     bool redundancyPolicyLatched_ = false;
     RedundancyStatusSnapshot redundancyStatus_{};
     RedundancyKpiSnapshot redundancyKpis_{};
+    StartupReport startupReport_{};
     std::chrono::steady_clock::time_point redundancyFaultStart_{};
     std::chrono::steady_clock::time_point redundancyRecoveryStart_{};
     bool redundancyFaultActive_ = false;
+    std::uint64_t lastRedundancyHealthyCycle_ = 0;
     std::vector<RedundancyTransitionEvent> redundancyTransitions_;
     std::size_t maxRedundancyTransitionHistory_ = 512U;
     bool degraded_ = false;
@@ -0,0 +1,105 @@
+/**
+ * @file firmware_update.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "openethercat/core/slave_state.hpp"
+#include "openethercat/master/foe_eoe.hpp"
+#include "openethercat/transport/i_transport.hpp"
+
+namespace oec {
+
+/**
+ * @brief One slave and the firmware image to write to it.
+ */
+struct FirmwareUpdateJob {
+    std::uint16_t slavePosition = 0;
+    std::string fileName;
+    std::uint32_t password = 0;
+    FoESource* image = nullptr;
+    /// Optional second pass over the same image; when set, the file is read back and compared.
+    FoESource* verifyImage = nullptr;
+};
+
+/**
+ * @brief Behavior of FirmwareUpdateOrchestrator::run().
+ */
+struct FirmwareUpdateOptions {
+    /// State reached after BOOTSTRAP -> INIT once the image is written, stepping INIT -> PREOP -> SAFEOP -> OP.
+    SlaveState finalState = SlaveState::PreOp;
+    std::chrono::milliseconds transitionTimeout{5000};
+    std::chrono::milliseconds pollInterval{10};
+    std::size_t maxChunkBytes = 1024;
+    std::function<void(const FoEProgress&)> onProgress;
+};
+
+/**
+ * @brief Per-slave outcome and phase timings of a firmware update.
+ */
+struct FirmwareUpdateSlaveReport {
+    std::uint16_t slavePosition = 0;
+    bool success = false;
+    bool verified = false;
+    std::string error;
+    std::size_t bytesWritten = 0;
+    std::chrono::microseconds bootstrapTime{0};
+    std::chrono::microseconds transferTime{0};
+    std::chrono::microseconds verifyTime{0};
+    std::chrono::microseconds restoreTime{0};
+    std::chrono::microseconds totalTime{0};
+};
+
+/**
+ * @brief Result of a whole-line firmware update.
+ */
+struct FirmwareUpdateReport {
+    bool success = false;
+    std::vector<FirmwareUpdateSlaveReport> slaves;
+    /// Wall-clock time of run().
+    std::chrono::microseconds wallTime{0};
+    /// Sum of per-slave totals, i.e. what a slave-by-slave update would roughly have cost.
+    std::chrono::microseconds serialTime{0};
+};
+
+/**
+ * @brief Updates firmware on many slaves at once.
+ *
+ * All slaves are moved to INIT, get their SII bootstrap mailbox layout in
+ * SM0/SM1 and enter BOOTSTRAP together. Their FoE transfers run interleaved in
+ * shared frames (ITransport::foeWriteStreams()). The images are optionally read
+ * back and compared. The slaves are then brought back to INIT, the standard
+ * mailbox layout is restored, and they climb the state ladder to `finalState`.
+ * A slave that fails a phase is dropped from the later phases; the others carry on.
+ */
+class FirmwareUpdateOrchestrator {
+public:
+    explicit FirmwareUpdateOrchestrator(ITransport& transport);
+
+    FirmwareUpdateReport run(std::vector<FirmwareUpdateJob>& jobs, const FirmwareUpdateOptions& options) const;
+
+private:
+    /**
+     * @brief Request @p target on every active slave, then poll them all until they arrive.
+     */
+    void transitionAll(std::vector<FirmwareUpdateSlaveReport>& reports, std::vector<bool>& active,
+                       SlaveState target, const FirmwareUpdateOptions& options,
+                       std::chrono::microseconds FirmwareUpdateSlaveReport::*phaseTime) const;
+    /**
+     * @brief Program the bootstrap or standard mailbox SMs of every active slave (INIT only).
+     */
+    void configureMailboxes(std::vector<FirmwareUpdateSlaveReport>& reports, std::vector<bool>& active,
+                            bool bootstrap) const;
+
+    ITransport& transport_;
+};
+
+} // namespace oec
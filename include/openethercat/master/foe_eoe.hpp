@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -13,13 +15,169 @@
 
 namespace oec {
 
+/**
+ * @brief Progress of one FoE transfer, reported after every acknowledged packet.
+ */
+struct FoEProgress {
+    std::uint16_t slavePosition = 0;
+    std::size_t bytesTransferred = 0;
+    /// Total size when the source knows it, otherwise 0.
+    std::size_t totalBytes = 0;
+    std::uint32_t packets = 0;
+};
+
 /**
  * @brief FoE file transfer request.
  */
 struct FoERequest {
     std::string fileName;
     std::uint32_t password = 0;
+    /// Upper bound for data per packet; the slave's mailbox window usually sets the actual size.
     std::size_t maxChunkBytes = 1024;
+    std::function<void(const FoEProgress&)> onProgress;
+};
+
+/**
+ * @brief Pull-style data source for streaming FoE writes.
+ *
+ * The transport asks for at most one packet of data at a time, so a transfer
+ * never holds more than one mailbox window of the file in memory.
+ */
+class FoESource {
+public:
+    virtual ~FoESource() = default;
+    /**
+     * @brief Copy up to @p capacity bytes into @p buffer; @p outBytes == 0 marks end of file.
+     */
+    virtual bool read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string& outError) = 0;
+    /**
+     * @brief Total size if known (used for progress only), otherwise 0.
+     */
+    virtual std::size_t sizeHint() const { return 0U; }
+};
+
+/**
+ * @brief Push-style data sink for streaming FoE reads.
+ */
+class FoESink {
+public:
+    virtual ~FoESink() = default;
+    virtual bool write(const std::uint8_t* data, std::size_t size, std::string& outError) = 0;
+};
+
+/**
+ * @brief Source over an in-memory buffer (must outlive the transfer).
+ */
+class FoEMemorySource : public FoESource {
+public:
+    explicit FoEMemorySource(const std::vector<std::uint8_t>& data);
+    bool read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string& outError) override;
+    std::size_t sizeHint() const override;
+
+private:
+    const std::vector<std::uint8_t>& data_;
+    std::size_t cursor_ = 0;
+};
+
+/**
+ * @brief Sink appending to a caller-owned vector.
+ */
+class FoEVectorSink : public FoESink {
+public:
+    explicit FoEVectorSink(std::vector<std::uint8_t>& out);
+    bool write(const std::uint8_t* data, std::size_t size, std::string& outError) override;
+
+private:
+    std::vector<std::uint8_t>& out_;
+};
+
+/**
+ * @brief Source reading from a file descriptor (not closed by the source).
+ */
+class FoEFdSource : public FoESource {
+public:
+    explicit FoEFdSource(int fd);
+    bool read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string& outError) override;
+    std::size_t sizeHint() const override;
+
+private:
+    int fd_;
+};
+
+/**
+ * @brief Sink writing to a file descriptor (not closed by the sink).
+ */
+class FoEFdSink : public FoESink {
+public:
+    explicit FoEFdSink(int fd);
+    bool write(const std::uint8_t* data, std::size_t size, std::string& outError) override;
+
+private:
+    int fd_;
+};
+
+/**
+ * @brief Source over a read-only memory-mapped file.
+ *
+ * Pages already sent are released with MADV_DONTNEED, so resident memory
+ * stays bounded for arbitrarily large images.
+ */
+class FoEMappedFileSource : public FoESource {
+public:
+    FoEMappedFileSource() = default;
+    ~FoEMappedFileSource() override;
+    FoEMappedFileSource(const FoEMappedFileSource&) = delete;
+    FoEMappedFileSource& operator=(const FoEMappedFileSource&) = delete;
+
+    bool open(const std::string& path, std::string& outError);
+    void close();
+    bool read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string& outError) override;
+    std::size_t sizeHint() const override;
+
+private:
+    std::uint8_t* base_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t cursor_ = 0;
+    std::size_t released_ = 0;
+};
+
+/**
+ * @brief Source backed by a user callback with FoESource::read() semantics.
+ */
+class FoECallbackSource : public FoESource {
+public:
+    using ReadFn = std::function<bool(std::uint8_t*, std::size_t, std::size_t&, std::string&)>;
+    explicit FoECallbackSource(ReadFn read, std::size_t sizeHint = 0U);
+    bool read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string& outError) override;
+    std::size_t sizeHint() const override;
+
+private:
+    ReadFn read_;
+    std::size_t sizeHint_;
+};
+
+/**
+ * @brief Sink backed by a user callback with FoESink::write() semantics.
+ */
+class FoECallbackSink : public FoESink {
+public:
+    using WriteFn = std::function<bool(const std::uint8_t*, std::size_t, std::string&)>;
+    explicit FoECallbackSink(WriteFn write);
+    bool write(const std::uint8_t* data, std::size_t size, std::string& outError) override;
+
+private:
+    WriteFn write_;
+};
+
+/**
+ * @brief One slave's part of a multi-slave FoE write.
+ */
+struct FoEWriteJob {
+    std::uint16_t slavePosition = 0;
+    FoERequest request;
+    FoESource* source = nullptr;
+    bool success = false;
+    std::string error;
 };
 
 /**
@@ -43,6 +201,14 @@ public:
                    const FoERequest& request,
                    const std::vector<std::uint8_t>& data,
                    std::string& outError) const;
+    bool readFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                        std::string& outError) const;
+    bool writeFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                         std::string& outError) const;
+    /**
+     * @brief Write to several slaves with packets interleaved; true when every job succeeded.
+     */
+    bool writeFiles(std::vector<FoEWriteJob>& jobs, std::string& outError) const;
 
     bool sendEthernetOverEthercat(std::uint16_t slavePosition,
                                   const std::vector<std::uint8_t>& frame,
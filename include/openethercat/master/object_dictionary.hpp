@@ -0,0 +1,97 @@
+/**
+ * @file object_dictionary.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "openethercat/master/coe_mailbox.hpp"
+
+namespace oec {
+
+/**
+ * @brief One sub-index as reported by SDO Information "Get Entry Description".
+ */
+struct CoeEntryDescription {
+    std::uint8_t subIndex = 0;
+    std::uint8_t valueInfo = 0;
+    /// CoE data type index (e.g. 0x0007 UNSIGNED32).
+    std::uint16_t dataType = 0;
+    std::uint16_t bitLength = 0;
+    /// Access/mappability flags (bit 6 RxPDO mappable, bit 7 TxPDO mappable).
+    std::uint16_t objectAccess = 0;
+    std::string name;
+};
+
+/**
+ * @brief One object as reported by SDO Information "Get Object Description".
+ */
+struct CoeObjectDescription {
+    std::uint16_t index = 0;
+    std::uint16_t dataType = 0;
+    std::uint8_t maxSubIndex = 0;
+    /// 0x07 VAR, 0x08 ARRAY, 0x09 RECORD.
+    std::uint8_t objectCode = 0;
+    std::string name;
+    std::vector<CoeEntryDescription> entries;
+};
+
+/**
+ * @brief Object dictionary of one device type, as enumerated via SDO Information.
+ */
+struct ObjectDictionary {
+    std::vector<CoeObjectDescription> objects;
+    /// False when an entry description was refused or malformed; such a scan is not cached.
+    bool complete = true;
+
+    const CoeObjectDescription* findObject(std::uint16_t index) const;
+    const CoeEntryDescription* findEntry(std::uint16_t index, std::uint8_t subIndex) const;
+    /**
+     * @brief Build a PDO mapping entry with the bit length taken from the dictionary.
+     * @return false when the entry is unknown or not PDO-mappable.
+     */
+    bool mappingEntry(std::uint16_t index, std::uint8_t subIndex, PdoMappingEntry& outEntry) const;
+};
+
+/**
+ * @brief Per-device-type object dictionary cache with a binary on-disk form.
+ *
+ * Keyed by (vendorId, productCode, revision). A dictionary scanned once for a
+ * device type is reused for every other slave of that type and, after
+ * `saveToFile()`/`loadFromFile()`, across runs.
+ */
+class ObjectDictionaryCache {
+public:
+    struct Key {
+        std::uint32_t vendorId = 0;
+        std::uint32_t productCode = 0;
+        std::uint32_t revision = 0;
+        bool operator<(const Key& other) const;
+    };
+
+    static constexpr std::uint32_t kFormatVersion = 1U;
+
+    const ObjectDictionary* find(const Key& key) const;
+    void store(const Key& key, ObjectDictionary dictionary);
+    std::size_t size() const;
+    void clear();
+
+    std::vector<std::uint8_t> encode() const;
+    bool decode(const std::vector<std::uint8_t>& bytes, std::string& outError);
+    /**
+     * @brief Write atomically (temporary file + rename).
+     */
+    bool saveToFile(const std::string& path, std::string& outError) const;
+    bool loadFromFile(const std::string& path, std::string& outError);
+
+private:
+    std::map<Key, ObjectDictionary> dictionaries_;
+};
+
+} // namespace oec
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "openethercat/master/coe_mailbox.hpp"
+#include "openethercat/master/object_dictionary.hpp"
 
 namespace oec {
 
@@ -28,6 +29,9 @@ struct EscMailboxFrame {
 
 /**
  * @brief Parsed SDO initiate-upload response metadata.
+ *
+ * For normal transfers `data` holds any bytes the slave placed after the
+ * complete-size field; segments follow only while `data` is short of `completeSize`.
  */
 struct CoeSdoInitiateUploadResponse {
     bool success = false;
@@ -61,12 +65,46 @@ struct CoeSdoAckResponse {
     std::string error;
 };
 
+/**
+ * @brief One parsed SDO Information response fragment.
+ *
+ * `data` is the fragment body after the 4-byte info header; a response is
+ * complete once a fragment arrives with `fragmentsLeft == 0`.
+ */
+struct CoeSdoInfoFragment {
+    bool success = false;
+    std::uint8_t opCode = 0;
+    bool incomplete = false;
+    std::uint16_t fragmentsLeft = 0;
+    std::vector<std::uint8_t> data;
+    std::uint32_t abortCode = 0;
+    std::string error;
+};
+
 /**
  * @brief CoE mailbox wire codec and segmented SDO helper.
  */
 class CoeMailboxProtocol {
 public:
     static constexpr std::uint8_t kMailboxTypeCoe = 0x03;
+    /// ESC mailbox header bytes preceding the CoE payload.
+    static constexpr std::size_t kMailboxHeaderBytes = 6U;
+    /// Classic (CAN-sized) segment payload; also the floor for tiny mailboxes.
+    static constexpr std::size_t kMinSegmentBytes = 7U;
+    /// Complete Access flag in the SDO command specifier.
+    static constexpr std::uint8_t kSdoCompleteAccessBit = 0x10U;
+
+    /**
+     * @brief Largest download-segment payload that fits a mailbox of @p mailboxBytes.
+     *
+     * Segments longer than 7 bytes carry `unused = 0` and their size is implied
+     * by the mailbox length (CoE "large segment" rule).
+     */
+    static std::size_t maxSegmentDataBytes(std::size_t mailboxBytes);
+    /**
+     * @brief Data bytes that fit inline after the size field of a normal initiate-download request.
+     */
+    static std::size_t maxInitiateDownloadDataBytes(std::size_t mailboxBytes);
 
     static std::vector<std::uint8_t> encodeEscMailbox(const EscMailboxFrame& frame);
     static std::optional<EscMailboxFrame> decodeEscMailbox(const std::vector<std::uint8_t>& bytes);
@@ -74,17 +112,41 @@ public:
                                std::uint16_t slavePosition,
                                EmergencyMessage& outEmergency);
 
-    static std::vector<std::uint8_t> buildSdoInitiateUploadRequest(SdoAddress address);
+    /**
+     * @brief Build an initiate-upload request.
+     *
+     * With @p completeAccess the CA bit is set and the whole object is read in
+     * one transfer, starting at `address.subIndex` (0 includes sub-index 0 as a
+     * 16-bit field, 1 starts at the first entry).
+     */
+    static std::vector<std::uint8_t> buildSdoInitiateUploadRequest(SdoAddress address, bool completeAccess = false);
     static CoeSdoInitiateUploadResponse parseSdoInitiateUploadResponse(const std::vector<std::uint8_t>& payload,
                                                                        SdoAddress expectedAddress);
 
     static std::vector<std::uint8_t> buildSdoUploadSegmentRequest(std::uint8_t toggle);
     static CoeSdoSegmentUploadResponse parseSdoUploadSegmentResponse(const std::vector<std::uint8_t>& payload);
 
+    /**
+     * @brief Build a normal (segmented) initiate-download request.
+     *
+     * @p initialData is appended after the 4-byte size field, so a transfer that
+     * fits the mailbox completes without any download segments. @p completeAccess
+     * sets the CA bit (see buildSdoInitiateUploadRequest()).
+     */
     static std::vector<std::uint8_t> buildSdoInitiateDownloadRequest(SdoAddress address,
-                                                                      std::uint32_t totalSize);
+                                                                      std::uint32_t totalSize,
+                                                                      const std::vector<std::uint8_t>& initialData = {},
+                                                                      bool completeAccess = false);
+    /**
+     * @brief Build an expedited initiate-download request carrying 1..4 data bytes inline.
+     */
+    static std::vector<std::uint8_t> buildSdoExpeditedDownloadRequest(SdoAddress address,
+                                                                       const std::vector<std::uint8_t>& data);
     static CoeSdoAckResponse parseSdoInitiateDownloadResponse(const std::vector<std::uint8_t>& payload,
                                                               SdoAddress expectedAddress);
+    /**
+     * @brief Build a download segment; @p maxSegmentBytes may exceed 7 for full-mailbox segments.
+     */
     static std::vector<std::uint8_t> buildSdoDownloadSegmentRequest(std::uint8_t toggle,
                                                                      bool lastSegment,
                                                                      const std::vector<std::uint8_t>& segmentData,
@@ -92,6 +154,33 @@ public:
     static CoeSdoAckResponse parseSdoDownloadSegmentResponse(const std::vector<std::uint8_t>& payload,
                                                              std::uint8_t expectedToggle);
 
+    /// SDO Information op-codes (request; the matching response is request + 1).
+    static constexpr std::uint8_t kSdoInfoGetOdListReq = 0x01U;
+    static constexpr std::uint8_t kSdoInfoGetObjectDescReq = 0x03U;
+    static constexpr std::uint8_t kSdoInfoGetEntryDescReq = 0x05U;
+    static constexpr std::uint8_t kSdoInfoError = 0x07U;
+    /// OD list type selecting every object of the dictionary.
+    static constexpr std::uint16_t kSdoInfoListAllObjects = 0x0001U;
+
+    static std::vector<std::uint8_t> buildSdoInfoGetOdListRequest(std::uint16_t listType);
+    static std::vector<std::uint8_t> buildSdoInfoGetObjectDescriptionRequest(std::uint16_t index);
+    static std::vector<std::uint8_t> buildSdoInfoGetEntryDescriptionRequest(std::uint16_t index,
+                                                                            std::uint8_t subIndex,
+                                                                            std::uint8_t valueInfo);
+    static CoeSdoInfoFragment parseSdoInfoFragment(const std::vector<std::uint8_t>& payload);
+    /**
+     * @brief Decode reassembled "Get OD List" data (list type followed by indices).
+     */
+    static bool parseSdoInfoOdList(const std::vector<std::uint8_t>& data, std::vector<std::uint16_t>& outIndices);
+    /**
+     * @brief Decode reassembled "Get Object Description" data; `entries` is left untouched.
+     */
+    static bool parseSdoInfoObjectDescription(const std::vector<std::uint8_t>& data, CoeObjectDescription& outObject);
+    /**
+     * @brief Decode reassembled "Get Entry Description" data requested with value info 0.
+     */
+    static bool parseSdoInfoEntryDescription(const std::vector<std::uint8_t>& data, CoeEntryDescription& outEntry);
+
 private:
     static std::uint16_t readLe16(const std::vector<std::uint8_t>& in, std::size_t offset);
     static std::uint32_t readLe32(const std::vector<std::uint8_t>& in, std::size_t offset);
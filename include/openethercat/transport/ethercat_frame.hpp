@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -40,6 +41,16 @@ struct EthercatDatagramResponse {
 
 class EthercatFrameCodec {
 public:
+    /**
+     * @brief Maximum datagram bytes (headers + payload + WKC) carried by one Ethernet frame.
+     */
+    static constexpr std::size_t kMaxDatagramBytesPerFrame = 1498U;
+
+    /**
+     * @brief Encoded size of one datagram (10-byte header + payload + 2-byte WKC).
+     */
+    static std::size_t datagramWireBytes(const EthercatDatagramRequest& request);
+
     static std::vector<std::uint8_t> buildDatagramFrame(
         const std::uint8_t destinationMac[6],
         const std::uint8_t sourceMac[6],
@@ -51,6 +62,24 @@ public:
         std::uint8_t expectedDatagramIndex,
         std::size_t expectedPayloadBytes);
 
+    /**
+     * @brief Build one EtherCAT frame carrying several chained datagrams.
+     *
+     * The "more datagrams follow" bit is set on every datagram except the last.
+     * Callers must keep the summed datagramWireBytes() within kMaxDatagramBytesPerFrame.
+     */
+    static std::vector<std::uint8_t> buildMultiDatagramFrame(
+        const std::uint8_t destinationMac[6],
+        const std::uint8_t sourceMac[6],
+        const std::vector<EthercatDatagramRequest>& requests);
+
+    /**
+     * @brief Parse every datagram of a (possibly chained) EtherCAT frame.
+     * @return false when the frame is not EtherCAT or a datagram is truncated.
+     */
+    static bool parseMultiDatagramFrame(const std::vector<std::uint8_t>& ethernetFrame,
+                                        std::vector<EthercatDatagramResponse>& outResponses);
+
     static std::vector<std::uint8_t> buildLrwFrame(
         const std::uint8_t destinationMac[6],
         const std::uint8_t sourceMac[6],
@@ -0,0 +1,96 @@
+/**
+ * @file frame_timestamping.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace oec {
+
+/**
+ * @brief Source of per-frame SO_TIMESTAMPING stamps.
+ */
+enum class FrameTimestampMode {
+    Off,
+    /// Kernel stamps taken in the driver (TX) and on packet reception (RX); CLOCK_REALTIME.
+    Software,
+    /// NIC stamps (SIOCSHWTSTAMP) in PHC time; mapped to host time through the measured PHC offset.
+    Hardware
+};
+
+/**
+ * @brief Parse `off|software|hardware` (also `0|sw|hw`); false on unknown text.
+ */
+bool parseFrameTimestampMode(const std::string& text, FrameTimestampMode& outMode);
+const char* toString(FrameTimestampMode mode);
+
+/**
+ * @brief TX/RX stamps of one frame in ns of the stamp clock.
+ */
+struct FrameWireSample {
+    bool txValid = false;
+    bool rxValid = false;
+    std::int64_t txNs = 0;
+    std::int64_t rxNs = 0;
+
+    bool complete() const { return txValid && rxValid; }
+    std::chrono::nanoseconds roundTrip() const { return std::chrono::nanoseconds(rxNs - txNs); }
+};
+
+/**
+ * @brief Enable RX stamps and TX stamp reporting on @p fd; hardware mode also configures the NIC.
+ *
+ * TX stamps are only generated for frames sent with sendTimestamped(), so
+ * other traffic on the socket never fills the error queue.
+ */
+bool enableFrameTimestamping(int fd, const std::string& ifname, FrameTimestampMode mode, std::string& outError);
+
+/**
+ * @brief sendto() requesting a TX stamp for this frame; collect it with readTxTimestamp().
+ */
+bool sendTimestamped(int fd, const void* data, std::size_t size, const sockaddr* target, socklen_t targetLength,
+                     FrameTimestampMode mode, std::string& outError);
+
+/**
+ * @brief recvmsg() returning the frame's RX stamp when one is attached. Same result as recv().
+ */
+ssize_t receiveTimestamped(int fd, void* buffer, std::size_t size, int flags, FrameTimestampMode mode,
+                           FrameWireSample& outSample);
+
+/**
+ * @brief Fetch one pending TX stamp from the error queue without blocking; false when none is queued.
+ */
+bool readTxTimestamp(int fd, FrameTimestampMode mode, FrameWireSample& outSample);
+
+/**
+ * @brief Drop stamps left in the error queue, e.g. by a frame whose exchange failed.
+ */
+void discardTxTimestamps(int fd);
+
+/**
+ * @brief Map a CLOCK_REALTIME stamp onto the steady clock used by the cycle and DC code.
+ */
+std::chrono::steady_clock::time_point realtimeStampToSteady(std::int64_t realtimeNs);
+
+/**
+ * @brief Open the PTP hardware clock behind @p ifname (ETHTOOL_GET_TS_INFO); -1 with @p outError when none.
+ */
+int openPhc(int fd, const std::string& ifname, std::string& outError);
+
+/**
+ * @brief CLOCK_REALTIME minus PHC time, from one PHC read bracketed by two realtime reads.
+ *
+ * A PHC usually runs on TAI and need not be disciplined at all, so hardware
+ * stamps go through this offset before realtimeStampToSteady().
+ */
+bool phcRealtimeOffset(int phcFd, std::int64_t& outOffsetNs);
+
+} // namespace oec
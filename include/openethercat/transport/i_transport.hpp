@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <cstddef>
 #include <array>
@@ -21,6 +22,10 @@ struct EmergencyMessage;
 struct TopologySnapshot;
 struct FoERequest;
 struct FoEResponse;
+struct FoEWriteJob;
+struct EoeBatchSlot;
+class FoESource;
+class FoESink;
 struct NetworkConfiguration;
 
 /**
@@ -79,6 +84,31 @@ public:
                              std::string&) {
         return false;
     }
+    /**
+     * @brief Read a whole object with SDO Complete Access.
+     * @param includeSubIndex0 Start at sub-index 0 (transferred as 16 bits) instead of 1.
+     */
+    virtual bool sdoUploadComplete(std::uint16_t, std::uint16_t, bool, std::vector<std::uint8_t>&, std::uint32_t&,
+                                   std::string&) {
+        return false;
+    }
+    /**
+     * @brief Write a whole object with SDO Complete Access (layout as for sdoUploadComplete()).
+     */
+    virtual bool sdoDownloadComplete(std::uint16_t, std::uint16_t, bool, const std::vector<std::uint8_t>&,
+                                     std::uint32_t&, std::string&) {
+        return false;
+    }
+    /**
+     * @brief Run one SDO Information request and return the reassembled response data.
+     *
+     * The request is a complete SDO Information payload (header included); the
+     * result is the concatenated data of all response fragments without headers.
+     */
+    virtual bool sdoInfoExchange(std::uint16_t, const std::vector<std::uint8_t>&, std::vector<std::uint8_t>&,
+                                 std::uint32_t&, std::string&) {
+        return false;
+    }
     virtual bool configurePdo(std::uint16_t, std::uint16_t, const std::vector<PdoMappingEntry>&,
                               std::string&) {
         return false;
@@ -86,13 +116,57 @@ public:
     virtual bool pollEmergency(EmergencyMessage&) { return false; }
     virtual bool discoverTopology(TopologySnapshot&, std::string&) { return false; }
     virtual bool isRedundancyLinkHealthy(std::string&) { return false; }
+    /**
+     * @brief Ring state seen by the last exchange(); false when the transport cannot tell per cycle.
+     */
+    virtual bool redundancyObservation(bool&) { return false; }
+    /**
+     * @brief Absolute deadline for the receive side of the next exchange(); ignored by default.
+     */
+    virtual void setNextReceiveDeadline(std::chrono::steady_clock::time_point) {}
+    /**
+     * @brief Launch time for the first frame of the next exchange(); ignored by default.
+     */
+    virtual void setNextLaunchTime(std::chrono::steady_clock::time_point) {}
+    /**
+     * @brief Kernel/NIC-stamped wire round trip of the last exchange(); false when not measured.
+     */
+    virtual bool lastWireRoundTrip(std::chrono::nanoseconds&) { return false; }
     virtual bool configureProcessImage(const NetworkConfiguration&, std::string&) { return true; }
     virtual bool foeRead(std::uint16_t, const FoERequest&, FoEResponse&, std::string&) { return false; }
     virtual bool foeWrite(std::uint16_t, const FoERequest&, const std::vector<std::uint8_t>&, std::string&) {
         return false;
     }
+    /**
+     * @brief FoE read delivering each packet to @p sink as it arrives.
+     */
+    virtual bool foeReadStream(std::uint16_t, const FoERequest&, FoESink&, std::string&) { return false; }
+    /**
+     * @brief FoE write pulling one packet at a time from @p source.
+     */
+    virtual bool foeWriteStream(std::uint16_t, const FoERequest&, FoESource&, std::string&) { return false; }
+    /**
+     * @brief FoE writes to several slaves; per-job results are stored in each job.
+     */
+    virtual bool foeWriteStreams(std::vector<FoEWriteJob>&, std::string&) { return false; }
+    /**
+     * @brief SM0 (master-to-slave mailbox) length of a slave in bytes; false when unknown.
+     */
+    virtual bool mailboxWriteSize(std::uint16_t, std::uint16_t&) { return false; }
+    /**
+     * @brief Program SM0/SM1 from the slave's SII bootstrap (or standard) mailbox words.
+     *
+     * Only valid in INIT. Transports without register access have nothing to program.
+     */
+    virtual bool configureMailboxSyncManagers(std::uint16_t, bool, std::string&) { return true; }
     virtual bool eoeSend(std::uint16_t, const std::vector<std::uint8_t>&, std::string&) { return false; }
     virtual bool eoeReceive(std::uint16_t, std::vector<std::uint8_t>&, std::string&) { return false; }
+    /**
+     * @brief Send at most one EoE fragment and fetch at most one per slot, sharing frames across slaves.
+     *
+     * Returns false with an empty error when the transport has no batched path.
+     */
+    virtual bool eoeExchangeBatch(std::vector<EoeBatchSlot>&, std::string&) { return false; }
 };
 
 } // namespace oec
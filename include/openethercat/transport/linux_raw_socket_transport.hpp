@@ -6,16 +6,26 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
-#include <queue>
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "openethercat/master/coe_mailbox.hpp"
+#include "openethercat/master/distributed_clock.hpp"
 #include "openethercat/transport/coe_mailbox_protocol.hpp"
 #include "openethercat/transport/ethercat_frame.hpp"
+#include "openethercat/transport/frame_timestamping.hpp"
 #include "openethercat/transport/i_transport.hpp"
+#include "openethercat/transport/process_image_plan.hpp"
+#include "openethercat/transport/receive_wait.hpp"
+#include "openethercat/transport/scheduled_transmit.hpp"
+#include "openethercat/transport/xdp_socket.hpp"
 
 namespace oec {
 
@@ -23,7 +33,7 @@ namespace oec {
  * @brief Mailbox-path diagnostics counters for LinuxRawSocketTransport.
  */
 struct MailboxDiagnostics {
-    std::uint32_t schemaVersion = 2;
+    std::uint32_t schemaVersion = 3;
     std::uint64_t transactionsStarted = 0;
     std::uint64_t transactionsFailed = 0;
     std::uint64_t foeReadStarted = 0;
@@ -43,6 +53,12 @@ struct MailboxDiagnostics {
     std::uint64_t emergencyQueued = 0;
     std::uint64_t emergencyDropped = 0;
     std::uint64_t matchedResponses = 0;
+    /// SM1 repeat requests issued after a lost mailbox read (schema v3).
+    std::uint64_t mailboxRepeatRequests = 0;
+    /// Repeat requests the slave acknowledged by toggling the repeat-ack bit.
+    std::uint64_t mailboxRepeatAcks = 0;
+    /// Lost reads recovered by the re-read that followed a repeat request.
+    std::uint64_t mailboxRepeatRecoveries = 0;
     std::uint64_t errorTimeout = 0;
     std::uint64_t errorBusy = 0;
     std::uint64_t errorParseReject = 0;
@@ -79,7 +95,7 @@ enum class MailboxErrorClass {
  * @brief DC register I/O diagnostics for LinuxRawSocketTransport.
  */
 struct DcDiagnostics {
-    std::uint32_t schemaVersion = 1;
+    std::uint32_t schemaVersion = 2;
     std::uint64_t readAttempts = 0;
     std::uint64_t readSuccess = 0;
     std::uint64_t readFailure = 0;
@@ -87,6 +103,43 @@ struct DcDiagnostics {
     std::uint64_t writeAttempts = 0;
     std::uint64_t writeSuccess = 0;
     std::uint64_t writeFailure = 0;
+    /// Cyclic ARMW reference reads carried in the process-data frame (schema v2).
+    std::uint64_t cyclicReferenceReads = 0;
+    std::uint64_t cyclicReferenceFailures = 0;
+    /// Reference offset writes piggybacked on the process-data frame (schema v2).
+    std::uint64_t cyclicOffsetWrites = 0;
+    std::uint64_t cyclicOffsetFailures = 0;
+};
+
+/**
+ * @brief Outcome counters of parallel redundant exchanges.
+ */
+struct RedundancyDiagnostics {
+    std::uint64_t parallelFrames = 0;
+    /// Primary copy came back on the secondary port and vice versa.
+    std::uint64_t ringIntactFrames = 0;
+    /// Each copy came back on its own port: the line is split between the two segments.
+    std::uint64_t ringBrokenFrames = 0;
+    /// Only one copy came back.
+    std::uint64_t singleCopyFrames = 0;
+    std::uint64_t lostFrames = 0;
+};
+
+/**
+ * @brief SO_TIMESTAMPING view of the last exchange() (`OEC_FRAME_TIMESTAMPING`).
+ */
+struct CycleWireTiming {
+    FrameTimestampMode mode = FrameTimestampMode::Off;
+    /// Frames sent at an SO_TXTIME launch time carry no stamps and are not counted.
+    std::uint32_t frames = 0;
+    /// Frames with both a TX and an RX stamp; only these count below.
+    std::uint32_t stampedFrames = 0;
+    /// Sum of RX minus TX stamp: time on the wire and in the slaves, without host scheduling.
+    std::chrono::nanoseconds wireRoundTrip{0};
+    std::chrono::nanoseconds maxFrameRoundTrip{0};
+    /// TX stamp of the frame carrying the DC ARMW, mapped onto the steady clock.
+    bool dcFrameTxValid = false;
+    std::chrono::steady_clock::time_point dcFrameTx{};
 };
 
 class LinuxRawSocketTransport final : public ITransport {
@@ -95,13 +148,96 @@ public:
     LinuxRawSocketTransport(std::string primaryIfname, std::string secondaryIfname);
     ~LinuxRawSocketTransport() override;
 
+    /**
+     * @brief Receive timeout of all operations in ms; also sets the cyclic receive timeout.
+     */
     void setCycleTimeoutMs(int timeoutMs);
+    /**
+     * @brief Receive budget of one exchange(), shared by all of its frames (`OEC_RX_TIMEOUT_US`).
+     */
+    void setReceiveTimeout(std::chrono::nanoseconds timeout);
+    std::chrono::nanoseconds receiveTimeout() const;
+    /**
+     * @brief Absolute deadline for the next exchange() only, e.g. cycle start + period - margin.
+     */
+    void setNextReceiveDeadline(std::chrono::steady_clock::time_point deadline) override;
+    /**
+     * @brief Block in ppoll() or spin until the deadline (`OEC_RX_BUSY_POLL=1`).
+     */
+    void setReceiveWaitMode(ReceiveWaitMode mode);
+    ReceiveWaitMode receiveWaitMode() const;
+    /**
+     * @brief SO_BUSY_POLL budget applied at open(); 0 leaves the socket default (`OEC_SO_BUSY_POLL_US`).
+     */
+    void setSocketBusyPoll(std::chrono::microseconds budget);
+    /**
+     * @brief Send each cycle's first frame at its launch time through SO_TXTIME; applied at open().
+     *
+     * Without a usable launch socket (no CAP_NET_ADMIN, old kernel) frames are sent immediately.
+     */
+    void setScheduledTransmit(const ScheduledTransmitOptions& options);
+    bool scheduledTransmitActive() const;
+    ScheduledTransmitDiagnostics scheduledTransmitDiagnostics() const;
+    /**
+     * @brief Launch time of the next exchange()'s first frame, e.g. cycle start + fixed offset.
+     */
+    void setNextLaunchTime(std::chrono::steady_clock::time_point launchTime) override;
+    /**
+     * @brief Stamp cyclic frames at open(); hardware falls back to software when the NIC refuses.
+     */
+    void setFrameTimestamping(FrameTimestampMode mode);
+    /**
+     * @brief Mode active on the sockets (after any fallback); Off while closed.
+     */
+    FrameTimestampMode frameTimestampMode() const;
+    CycleWireTiming lastCycleWireTiming() const;
+    /**
+     * @brief Sum of the last exchange's frame round trips; false unless every frame was stamped.
+     */
+    bool lastWireRoundTrip(std::chrono::nanoseconds& outRoundTrip) override;
+    /**
+     * @brief When the last cyclic ARMW frame left the NIC (TX stamp); false without a stamp.
+     */
+    bool lastDcReferenceTxTime(std::chrono::steady_clock::time_point& outTime) const;
+    /**
+     * @brief Carry cyclic frames over AF_XDP on the primary interface; applied at open().
+     *
+     * Acyclic traffic stays on AF_PACKET. Unlike the other tuning options,
+     * open() fails when the socket cannot be set up, and it excludes redundancy.
+     * Cyclic frames lose SO_TIMESTAMPING stamps on this path.
+     */
+    void setXdp(const XdpSocketOptions& options);
+    bool xdpActive() const;
+    bool xdpZeroCopy() const;
+    XdpSocketStats xdpStats() const;
     void setLogicalAddress(std::uint32_t logicalAddress);
     void setExpectedWorkingCounter(std::uint16_t expectedWorkingCounter);
     void setMaxFramesPerCycle(std::size_t maxFramesPerCycle);
     void enableRedundancy(bool enabled);
+    /**
+     * @brief Send each cyclic frame on both ports at once instead of failing over after a timeout.
+     *
+     * Default on; `OEC_REDUNDANCY_PARALLEL=0` at open() restores sequential
+     * failover. Takes effect only with an open secondary interface.
+     */
+    void setParallelRedundancy(bool enabled);
+    bool parallelRedundancyActive() const;
+    RedundancyDiagnostics redundancyDiagnostics() const;
     void setMailboxConfiguration(std::uint16_t writeOffset, std::uint16_t writeSize,
                                  std::uint16_t readOffset, std::uint16_t readSize);
+    /**
+     * @brief Persist/replay the process-image layout plan at @p path (empty disables).
+     *
+     * OEC_PROCESS_IMAGE_PLAN=<path> overrides this at open().
+     */
+    void setProcessImagePlanPath(std::string path);
+    /**
+     * @brief Let the next open() use @p socketFd instead of opening the primary interface.
+     *
+     * The socket must carry whole Ethernet frames, e.g. one end of an AF_UNIX
+     * SOCK_SEQPACKET pair whose peer simulates the segment. The transport owns it from this call on.
+     */
+    void adoptFrameSocket(int socketFd);
 
     bool open() override;
     void close() override;
@@ -120,23 +256,137 @@ public:
     bool sdoDownload(std::uint16_t slavePosition, const SdoAddress& address,
                      const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
                      std::string& outError) override;
+    bool sdoUploadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0,
+                           std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode,
+                           std::string& outError) override;
+    bool sdoDownloadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0,
+                             const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
+                             std::string& outError) override;
+    bool sdoInfoExchange(std::uint16_t slavePosition, const std::vector<std::uint8_t>& request,
+                         std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode,
+                         std::string& outError) override;
     bool configurePdo(std::uint16_t slavePosition, std::uint16_t assignIndex,
                       const std::vector<PdoMappingEntry>& entries,
                       std::string& outError) override;
     bool pollEmergency(EmergencyMessage& outEmergency) override;
     bool discoverTopology(TopologySnapshot& outSnapshot, std::string& outError) override;
     bool isRedundancyLinkHealthy(std::string& outError) override;
+    bool redundancyObservation(bool& outRingIntact) override;
     bool configureProcessImage(const NetworkConfiguration& config, std::string& outError) override;
     bool foeRead(std::uint16_t slavePosition, const FoERequest& request,
                  FoEResponse& outResponse, std::string& outError) override;
     bool foeWrite(std::uint16_t slavePosition, const FoERequest& request,
                   const std::vector<std::uint8_t>& data, std::string& outError) override;
+    bool foeReadStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                       std::string& outError) override;
+    bool foeWriteStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                        std::string& outError) override;
+    /**
+     * @brief Interleave FoE writes of many slaves in shared frames.
+     *
+     * Each round carries the due data packets of all slaves in one frame, their
+     * SM1 status reads in the next and the ready mailbox reads in a third, so
+     * N updates take roughly as long as the slowest one instead of their sum.
+     * A slave answering BUSY does not stall the others.
+     */
+    bool foeWriteStreams(std::vector<FoEWriteJob>& jobs, std::string& outError) override;
+    /**
+     * @brief One frame with every slot's EoE fragment write plus SM1 status read, one with the ready reads.
+     */
+    bool eoeExchangeBatch(std::vector<EoeBatchSlot>& slots, std::string& outError) override;
+    /**
+     * @brief SM0 length read from the ESC (cached with the EoE mailbox windows); false while closed.
+     */
+    bool mailboxWriteSize(std::uint16_t slavePosition, std::uint16_t& outBytes) override;
+    /**
+     * @brief APWR SM0/SM1 from SII words 0x14-0x17 (bootstrap) or 0x18-0x1B (standard).
+     */
+    bool configureMailboxSyncManagers(std::uint16_t slavePosition, bool bootstrap, std::string& outError) override;
     bool eoeSend(std::uint16_t slavePosition, const std::vector<std::uint8_t>& frame,
                  std::string& outError) override;
     bool eoeReceive(std::uint16_t slavePosition, std::vector<std::uint8_t>& frame,
                     std::string& outError) override;
     bool readDcSystemTime(std::uint16_t slavePosition, std::int64_t& outSlaveTimeNs, std::string& outError);
     bool writeDcSystemTimeOffset(std::uint16_t slavePosition, std::int64_t offsetNs, std::string& outError);
+    /**
+     * @brief Full DC bring-up: latch port receive times, derive delays from the topology, program all slaves.
+     *
+     * One broadcast write to 0x0900 latches every port; the port times, DL
+     * status and features of all slaves are read in batches, computeDcTiming()
+     * rebuilds the tree, and 0x0920/0x0928 of every DC slave are written in one
+     * batch. With DcInitOptions::measureSpread, 0x0910 is read back in one
+     * frame and the delay-compensated spread is reported.
+     */
+    bool initializeDistributedClocks(const DcInitOptions& options, DcInitReport& outReport, std::string& outError);
+    /**
+     * @brief Read the system time difference 0x092C of every slave in @p positions, packed into one frame.
+     *
+     * Non-answering slaves come back with valid=false; false only when the frame itself is lost.
+     */
+    bool readDcSystemTimeDifferences(const std::vector<std::uint16_t>& positions,
+                                     std::vector<DcSlaveSyncSample>& outSamples, std::string& outError);
+    /**
+     * @brief Carry an ARMW on 0x0910 of @p referencePosition in every cyclic input frame.
+     *
+     * The reference slave returns its system time and every slave behind it
+     * compares the value with its own clock, so drift compensation runs in
+     * hardware each cycle without extra round trips. The reference must be
+     * the first DC slave, since slaves ahead of it would latch the master's
+     * zero payload: once initializeDistributedClocks() has found the first DC
+     * slave, any other reference is refused (false, distribution off), and a
+     * DC init that finds a different first DC slave fails. The combined frame
+     * goes out on the primary port only, so it is skipped while parallel
+     * redundancy is active; a lost frame or a short working counter retries the
+     * LRD alone on the secondary port.
+     */
+    bool setDcReferenceDistribution(bool enabled, std::uint16_t referencePosition);
+    bool dcReferenceDistribution() const;
+    /**
+     * @brief Read 0x092C of @p positions in the next exchange()'s input frame.
+     *
+     * The APRDs ride with the LRD (and the DC ARMW), so a line-monitor round
+     * costs no extra frame or round trip. Positions beyond the frame's room are
+     * left out. Dropped while parallel redundancy is active.
+     */
+    void queueDcSystemTimeDifferenceRead(std::vector<std::uint16_t> positions);
+    /**
+     * @brief Samples carried by the last exchange(); false when it carried none or its frame was lost.
+     */
+    bool lastDcSystemTimeDifferences(std::vector<DcSlaveSyncSample>& outSamples) const;
+    /**
+     * @brief APRD the ESC features (0x0008) of @p positions in one frame and keep those with DC support.
+     */
+    bool readDcCapableSlaves(const std::vector<std::uint16_t>& positions, std::vector<std::uint16_t>& outDcSlaves,
+                             std::string& outError);
+    /**
+     * @brief Decoded DC-carrying input frame, see buildCyclicInputBatch().
+     */
+    struct CyclicInputResult {
+        bool referenceTimeValid = false;
+        std::int64_t referenceTimeNs = 0;
+        bool offsetWritten = false;
+        std::uint16_t inputWorkingCounter = 0;
+        std::vector<std::uint8_t> inputPayload;
+    };
+    /**
+     * @brief Datagrams of the DC-carrying input frame: ARMW on 0x0910, an optional APWR of 0x0920, then @p lrd.
+     */
+    static std::vector<EthercatDatagramRequest> buildCyclicInputBatch(std::uint16_t referencePosition,
+                                                                      std::optional<std::int64_t> offsetNs,
+                                                                      const EthercatDatagramRequest& lrd);
+    /**
+     * @brief Split the responses of buildCyclicInputBatch(); false when the datagram count does not match.
+     */
+    static bool decodeCyclicInputBatch(std::vector<EthercatDatagramResponse>& responses, bool offsetQueued,
+                                       CyclicInputResult& outResult);
+    /**
+     * @brief Reference system time read by the last exchange(); false when that frame carried none.
+     */
+    bool lastDcReferenceTime(std::int64_t& outTimeNs) const;
+    /**
+     * @brief Write 0x0920 of the distribution reference in the next exchange() frame.
+     */
+    void queueDcReferenceOffset(std::int64_t offsetNs);
 
     std::string lastError() const override;
     std::uint16_t lastWorkingCounter() const override;
@@ -148,6 +398,39 @@ public:
     MailboxStatusMode mailboxStatusMode() const;
     void setEmergencyQueueLimit(std::size_t limit);
     std::size_t emergencyQueueLimit() const;
+    /**
+     * @brief Cap SDO download segment payload; 0 (default) uses the full SM0 mailbox, 7 restores CAN-sized segments.
+     */
+    void setSdoSegmentBytesLimit(std::size_t limit);
+    std::size_t sdoSegmentBytesLimit() const;
+    /**
+     * @brief Enable SM1 repeat-request recovery of lost mailbox reads (default on, `OEC_MAILBOX_REPEAT=0` disables).
+     */
+    void setMailboxRepeatEnabled(bool enabled);
+    bool mailboxRepeatEnabled() const;
+    /**
+     * @brief Map every mailbox slave's SM1 "mailbox full" bit into the cyclic input read.
+     *
+     * Takes effect at the next configureProcessImage(): each slave with a mailbox
+     * gets one extra bit-wise FMMU into a status area placed right after the
+     * input image, so the cyclic LRD reports pending mailbox data without extra
+     * datagrams. Mailbox reads then skip the SM1 status APRD while the image is
+     * fresh. Also enabled by `OEC_MAILBOX_STATUS_FMMU=1`.
+     */
+    void setMailboxStatusMapping(bool enabled);
+    bool mailboxStatusMapping() const;
+    /**
+     * @brief Slaves whose status bit is mapped by the last configureProcessImage().
+     */
+    std::vector<std::uint16_t> mailboxStatusMappedSlaves() const;
+    /**
+     * @brief Slaves that reported a full SM1 mailbox in the last cyclic exchange.
+     */
+    std::vector<std::uint16_t> slavesWithMailboxData() const;
+    /**
+     * @brief Forget CoE identities cached by discoverTopology(); the next scan re-reads 0x1018.
+     */
+    void invalidateIdentityCache();
     MailboxErrorClass lastMailboxErrorClass() const;
     static MailboxErrorClass classifyMailboxError(const std::string& errorText);
     DcDiagnostics dcDiagnostics() const;
@@ -173,6 +456,110 @@ private:
                              std::vector<std::uint8_t>& outPayload,
                              std::string& outError);
 
+    /**
+     * @brief Pipelined multi-datagram exchange used by startup/batch paths.
+     *
+     * Requests are packed into as few frames as possible, all frames are sent
+     * back-to-back, and responses are matched by datagram index. Indices are
+     * assigned here. Responses are returned in request order; working counters
+     * are not checked so callers can apply per-command expectations.
+     */
+    bool sendDatagramBatch(std::vector<EthercatDatagramRequest>& requests,
+                           std::vector<EthercatDatagramResponse>& outResponses,
+                           std::string& outError);
+    /**
+     * @brief sendDatagramBatch() with one absolute deadline for all bursts; empty gives each burst timeoutMs_.
+     *
+     * With @p outWire, frames are stamped: TX of the first frame, RX of the last response.
+     */
+    bool sendDatagramBatchUntil(std::vector<EthercatDatagramRequest>& requests,
+                                std::vector<EthercatDatagramResponse>& outResponses,
+                                std::optional<std::chrono::steady_clock::time_point> deadline,
+                                std::string& outError,
+                                FrameWireSample* outWire = nullptr);
+
+    // One expedited SDO write inside a pipelined multi-slave mailbox job.
+    struct SdoBatchWrite {
+        SdoAddress address;
+        std::vector<std::uint8_t> data;
+    };
+
+    // Ordered SDO writes for one slave; lanes of different slaves run interleaved.
+    struct SdoBatchJob {
+        std::uint16_t slavePosition = 0U;
+        std::vector<SdoBatchWrite> writes;
+        std::size_t completedWrites = 0U;
+        bool success = false;
+        std::string error;
+    };
+
+    // One whole-object Complete Access write (sub-index 0 included).
+    struct SdoCompleteWrite {
+        std::uint16_t index = 0U;
+        std::vector<std::uint8_t> data;
+    };
+
+    bool sdoUploadTransfer(std::uint16_t slavePosition, const SdoAddress& address, bool completeAccess,
+                           std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode, std::string& outError);
+    bool sdoDownloadTransfer(std::uint16_t slavePosition, const SdoAddress& address, bool completeAccess,
+                             const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
+                             std::string& outError);
+    /**
+     * @brief Complete Access images for the PDO map object and its SM assignment.
+     */
+    static std::vector<SdoCompleteWrite> pdoConfigurationCompleteWrites(std::uint16_t assignIndex,
+                                                                        const std::vector<PdoMappingEntry>& entries);
+    /**
+     * @brief SDO writes that program one PDO map object and its SM assignment.
+     */
+    static std::vector<SdoBatchWrite> pdoConfigurationWrites(std::uint16_t assignIndex,
+                                                             const std::vector<PdoMappingEntry>& entries);
+    /**
+     * @brief Run expedited SDO downloads for several slaves concurrently.
+     *
+     * Each slave keeps its own ordered request queue, but mailbox writes, SM1
+     * status polls and mailbox reads of all slaves share batched frames.
+     * @return true when every job completed.
+     */
+    bool sdoDownloadExpeditedBatch(std::vector<SdoBatchJob>& jobs);
+    bool readTopologyFingerprint(std::uint64_t& outHash, std::string& outError);
+    bool replayProcessImagePlan(const ProcessImageLayoutPlan& plan, std::string& outError);
+    /**
+     * @brief Program the SM1 status FMMUs after the process-data FMMUs in @p registerWrites.
+     *
+     * Best effort: slaves without a mailbox, without a spare FMMU or that do not
+     * acknowledge the write keep using SM1 status polling.
+     */
+    void configureMailboxStatusMapping(const NetworkConfiguration& config,
+                                       const std::vector<ProcessImagePlanRegisterWrite>& registerWrites,
+                                       bool traceMap);
+    /**
+     * @brief Mailbox-full bit of @p slavePosition from a cyclic image not yet consumed by a mailbox read.
+     */
+    bool takeMailboxStatusFromImage(std::uint16_t slavePosition, bool& outFull);
+    /**
+     * @brief Push a received CoE emergency; at the queue limit the sender's oldest entry (else the oldest) is dropped.
+     */
+    void enqueueEmergency(const EmergencyMessage& emergency);
+
+    /**
+     * @brief Resolve an ambiguous BRD AL status by reading each of @p slaveCount slaves.
+     */
+    bool resolveMixedNetworkState(std::uint16_t slaveCount, SlaveState& outState);
+    /**
+     * @brief Read one SII dword through the EEPROM interface (0x0502/0x0504/0x0508).
+     */
+    bool readSiiDword(std::uint16_t adp, std::uint16_t wordAddress, std::uint32_t& outValue);
+
+    struct FoeWriteSession;
+    /**
+     * @brief Fill the next FoE data packet of @p session from its source.
+     */
+    bool foeWriteNextPacket(FoeWriteSession& session);
+    /**
+     * @brief Apply a slave's FoE reply to @p session; false fails the transfer.
+     */
+    bool foeWriteHandleReply(FoeWriteSession& session, const EscMailboxFrame& frame);
     /**
      * @brief Resolve mailbox read/write windows from ESC SM0/SM1 if available.
      */
@@ -258,6 +645,13 @@ private:
                                 std::uint8_t& outCounter,
                                 MailboxErrorClass& outErrorClass,
                                 std::string& outError);
+    /**
+     * @brief Toggle the SM1 repeat request and wait briefly for the slave's repeat ack.
+     * @return true when the slave acknowledged; the caller re-reads SM1 either way.
+     */
+    bool mailboxRepeatRequest(std::uint16_t adp);
+    /// Counter value that makes mailboxReadMatchingCoe() accept any mailbox counter.
+    static constexpr std::uint8_t kAnyMailboxCounter = 0xFFU;
     /**
      * @brief Read CoE mailbox frame matching expected counter and predicate.
      */
@@ -287,6 +681,8 @@ private:
     std::string ifname_;
     std::string secondaryIfname_;
     int socketFd_ = -1;
+    /// Socket handed over by adoptFrameSocket(), taken by the next open().
+    int adoptedSocketFd_ = -1;
     int secondarySocketFd_ = -1;
     int ifIndex_ = 0;
     int secondaryIfIndex_ = 0;
@@ -301,20 +697,84 @@ private:
     std::size_t maxFramesPerCycle_ = 128;
     bool redundancyEnabled_ = false;
     bool lastFrameUsedSecondary_ = false;
+    bool parallelRedundancy_ = true;
+    std::array<std::uint8_t, 6> secondarySourceMac_{};
+    RedundancyDiagnostics redundancyDiagnostics_{};
+    /// Ring state seen by the last exchange(); set only by parallel sends.
+    bool redundancyObserved_ = false;
+    bool lastRingIntact_ = false;
     std::uint16_t mailboxWriteOffset_ = 0x1000;
     std::uint16_t mailboxWriteSize_ = 0x0080;
     std::uint16_t mailboxReadOffset_ = 0x1080;
     std::uint16_t mailboxReadSize_ = 0x0080;
     std::uint8_t mailboxCounter_ = 0;
     int timeoutMs_ = 10;
+    std::chrono::nanoseconds receiveTimeout_{std::chrono::milliseconds(10)};
+    std::optional<std::chrono::steady_clock::time_point> nextReceiveDeadline_;
+    ReceiveWaitMode receiveWaitMode_ = ReceiveWaitMode::Block;
+    std::chrono::microseconds socketBusyPoll_{0};
+    ScheduledTransmitOptions scheduledTransmit_{};
+    ScheduledTransmitDiagnostics scheduledTransmitDiagnostics_{};
+    int launchSocketFd_ = -1;
+    std::optional<std::chrono::steady_clock::time_point> nextLaunchTime_;
+    FrameTimestampMode requestedTimestampMode_ = FrameTimestampMode::Off;
+    FrameTimestampMode activeTimestampMode_ = FrameTimestampMode::Off;
+    // PHC of the primary NIC; converts hardware TX stamps of the DC frame to host time.
+    int phcFd_ = -1;
+    CycleWireTiming lastWireTiming_{};
+    XdpSocketOptions xdpOptions_{};
+    XdpSocket xdp_;
     std::string error_;
     std::vector<ProcessDataWindow> outputWindows_;
-    std::queue<EmergencyMessage> emergencies_;
+    std::string processImagePlanPath_;
+    std::deque<EmergencyMessage> emergencies_;
     MailboxDiagnostics mailboxDiagnostics_{};
     MailboxStatusMode mailboxStatusMode_ = MailboxStatusMode::Hybrid;
     std::size_t emergencyQueueLimit_ = 256U;
+    std::size_t sdoSegmentBytesLimit_ = 0U;
+    bool mailboxRepeatEnabled_ = true;
+    // SM1 status bits mapped into the logical image (bit index per slave position).
+    bool mailboxStatusMappingEnabled_ = false;
+    std::map<std::uint16_t, std::size_t> mailboxStatusBitBySlave_;
+    std::map<std::uint16_t, std::uint64_t> mailboxStatusConsumedCycle_;
+    std::uint32_t mailboxStatusLogical_ = 0U;
+    std::size_t mailboxStatusBytes_ = 0U;
+    // Status-only slaves raise the LRD working counter; removed from lastInputWorkingCounter().
+    std::uint16_t mailboxStatusWkcExtra_ = 0U;
+    std::vector<std::uint8_t> mailboxStatusImage_;
+    std::uint64_t mailboxStatusCycle_ = 0U;
+    // Slaves that aborted a Complete Access write; configurePdo uses single-entry writes for them.
+    std::set<std::uint16_t> completeAccessUnsupported_;
+    // CoE identity per position from the last scan; reused while the slave count,
+    // AL status, ESC type/revision and SII vendor/product read back unchanged.
+    struct IdentityCacheEntry {
+        std::uint16_t alStatus = 0U;
+        std::uint16_t escType = 0U;
+        std::uint16_t escRevision = 0U;
+        std::uint32_t siiVendorId = 0U;
+        std::uint32_t siiProductCode = 0U;
+        std::uint32_t vendorId = 0U;
+        std::uint32_t productCode = 0U;
+    };
+    std::map<std::uint16_t, IdentityCacheEntry> identityCache_;
+    std::uint16_t identityCacheSlaveCount_ = 0U;
+    // SM0/SM1 windows {writeOffset, writeSize, readOffset, readSize} per EoE slave, resolved once per open().
+    std::map<std::uint16_t, std::array<std::uint16_t, 4>> eoeMailboxWindows_;
     MailboxErrorClass lastMailboxErrorClass_ = MailboxErrorClass::None;
     DcDiagnostics dcDiagnostics_{};
+    // Cyclic DC reference distribution (ARMW in the LRD frame).
+    bool dcDistributionEnabled_ = false;
+    std::uint16_t dcDistributionReference_ = 0;
+    // First DC-capable slave found by the last initializeDistributedClocks().
+    std::optional<std::uint16_t> dcFirstSlave_;
+    // Line-monitor reads carried in the next input frame, and the last carried result.
+    std::vector<std::uint16_t> dcLineReadQueue_;
+    std::vector<DcSlaveSyncSample> dcLineSamples_;
+    bool dcLineSamplesValid_ = false;
+    bool dcReferenceTimeValid_ = false;
+    std::int64_t dcReferenceTimeNs_ = 0;
+    bool dcOffsetPending_ = false;
+    std::int64_t dcPendingOffsetNs_ = 0;
 };
 
 } // namespace oec
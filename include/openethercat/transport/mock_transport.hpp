@@ -43,16 +43,42 @@ public:
     bool sdoDownload(std::uint16_t slavePosition, const SdoAddress& address,
                      const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
                      std::string& outError) override;
+    /**
+     * @brief Complete Access over the per-entry object store.
+     *
+     * Entries 1..N (N from sub-index 0) are concatenated; downloads split the
+     * payload into N equal-width entries, so only homogeneous arrays are modeled.
+     */
+    bool sdoUploadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0,
+                           std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode,
+                           std::string& outError) override;
+    bool sdoDownloadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0,
+                             const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
+                             std::string& outError) override;
     bool configurePdo(std::uint16_t slavePosition, std::uint16_t assignIndex,
                       const std::vector<PdoMappingEntry>& entries,
                       std::string& outError) override;
     bool pollEmergency(EmergencyMessage& outEmergency) override;
     bool discoverTopology(TopologySnapshot& outSnapshot, std::string& outError) override;
     bool isRedundancyLinkHealthy(std::string& outError) override;
+    bool redundancyObservation(bool& outRingIntact) override;
     bool foeRead(std::uint16_t slavePosition, const FoERequest& request,
                  FoEResponse& outResponse, std::string& outError) override;
     bool foeWrite(std::uint16_t slavePosition, const FoERequest& request,
                   const std::vector<std::uint8_t>& data, std::string& outError) override;
+    bool foeReadStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                       std::string& outError) override;
+    bool foeWriteStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                        std::string& outError) override;
+    bool foeWriteStreams(std::vector<FoEWriteJob>& jobs, std::string& outError) override;
+    bool mailboxWriteSize(std::uint16_t slavePosition, std::uint16_t& outBytes) override;
+    /**
+     * @brief Records which mailbox layout SM0/SM1 hold; refused outside INIT.
+     */
+    bool configureMailboxSyncManagers(std::uint16_t slavePosition, bool bootstrap, std::string& outError) override;
+    /**
+     * @brief eoeSend() rejects payloads longer than the mailbox SM0 length minus its 6-byte header.
+     */
     bool eoeSend(std::uint16_t slavePosition, const std::vector<std::uint8_t>& frame,
                  std::string& outError) override;
     bool eoeReceive(std::uint16_t slavePosition, std::vector<std::uint8_t>& frame,
@@ -67,7 +93,26 @@ public:
     void injectExchangeFailures(std::size_t count);
     void enqueueEmergency(const EmergencyMessage& emergency);
     void setRedundancyHealthy(bool healthy);
+    /**
+     * @brief Override only the topology-scan link check, leaving the cyclic ring observation as is.
+     */
+    void setRedundancyLinkHealthy(bool healthy);
+    /**
+     * @brief Report the redundancy health from every exchange(), as parallel redundancy does.
+     */
+    void setCyclicRedundancyObservation(bool enabled);
     void setDiscoveredSlaves(const std::vector<TopologySlaveInfo>& slaves);
+    /**
+     * @brief Model an SM0 mailbox of @p bytes for @p position; unset slaves report no size.
+     */
+    void setMailboxWriteSize(std::uint16_t position, std::uint16_t bytes);
+    /**
+     * @brief Refuse requestSlaveState() transitions an ESC would reject.
+     *
+     * Only one ladder step up at a time, BOOT only from INIT with the bootstrap
+     * mailbox configured, and PREOP never with it.
+     */
+    void setEnforceAlTransitions(bool enabled);
 
 private:
     static void setBit(std::vector<std::uint8_t>& bytes, std::size_t byteOffset,
@@ -84,10 +129,15 @@ private:
     std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> sdoObjects_;
     std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> foeFiles_;
     std::unordered_map<std::uint16_t, std::vector<PdoMappingEntry>> pdoAssignments_;
+    std::unordered_map<std::uint16_t, std::uint16_t> mailboxWriteSizes_;
+    std::unordered_map<std::uint16_t, bool> bootstrapMailbox_;
     std::queue<EmergencyMessage> emergencies_;
     std::queue<std::pair<std::uint16_t, std::vector<std::uint8_t>>> eoeFrames_;
     std::vector<TopologySlaveInfo> discoveredSlaves_;
     bool redundancyHealthy_ = true;
+    bool linkHealthy_ = true;
+    bool cyclicRedundancyObservation_ = false;
+    bool enforceAlTransitions_ = false;
     std::size_t remainingExchangeFailures_ = 0;
     bool opened_ = false;
     std::string error_;
@@ -0,0 +1,92 @@
+/**
+ * @file process_image_plan.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "openethercat/config/eni_esi_models.hpp"
+#include "openethercat/master/coe_mailbox.hpp"
+
+namespace oec {
+
+/**
+ * @brief Auto-increment addressed register write replayed via APWR.
+ */
+struct ProcessImagePlanRegisterWrite {
+    std::uint16_t slavePosition = 0;
+    std::uint16_t ado = 0;
+    std::vector<std::uint8_t> data;
+};
+
+/**
+ * @brief One expedited SDO download replayed before register writes.
+ */
+struct ProcessImagePlanSdoWrite {
+    std::uint16_t slavePosition = 0;
+    SdoAddress address{};
+    std::vector<std::uint8_t> data;
+};
+
+/**
+ * @brief Sync-manager window the slave must report after replay for the plan to be trusted.
+ */
+struct ProcessImagePlanSmExpectation {
+    std::uint16_t slavePosition = 0;
+    std::uint8_t syncManager = 0;
+    std::uint16_t start = 0;
+    std::uint16_t length = 0;
+};
+
+/**
+ * @brief Output window used by exchange() for optional SM2 readback verification.
+ */
+struct ProcessImagePlanOutputWindow {
+    std::uint16_t slavePosition = 0;
+    std::uint16_t physicalStart = 0;
+    std::uint16_t length = 0;
+    std::uint32_t logicalStart = 0;
+};
+
+/**
+ * @brief Final SM/FMMU mapping of one (topology, configuration) pair.
+ */
+struct ProcessImageLayoutPlan {
+    std::uint64_t topologyHash = 0;
+    std::uint64_t configHash = 0;
+    std::vector<ProcessImagePlanSdoWrite> sdoWrites;
+    std::vector<ProcessImagePlanRegisterWrite> registerWrites;
+    std::vector<ProcessImagePlanSmExpectation> smExpectations;
+    std::vector<ProcessImagePlanOutputWindow> outputWindows;
+};
+
+/**
+ * @brief Compact binary codec and file persistence for process-image layout plans.
+ */
+class ProcessImagePlanCodec {
+public:
+    static constexpr std::uint32_t kFormatVersion = 1U;
+    static constexpr std::uint64_t kHashSeed = 0xcbf29ce484222325ULL;
+
+    /**
+     * @brief FNV-1a 64-bit hash, chainable through @p seed.
+     */
+    static std::uint64_t hashBytes(const std::vector<std::uint8_t>& bytes, std::uint64_t seed = kHashSeed);
+    /**
+     * @brief Hash of every configuration field that influences the mapping plan.
+     */
+    static std::uint64_t hashConfiguration(const NetworkConfiguration& config, std::uint32_t logicalAddress);
+
+    static std::vector<std::uint8_t> encode(const ProcessImageLayoutPlan& plan);
+    static bool decode(const std::vector<std::uint8_t>& bytes, ProcessImageLayoutPlan& outPlan,
+                       std::string& outError);
+    static bool saveToFile(const std::string& path, const ProcessImageLayoutPlan& plan, std::string& outError);
+    static bool loadFromFile(const std::string& path, ProcessImageLayoutPlan& outPlan, std::string& outError);
+};
+
+} // namespace oec
@@ -0,0 +1,56 @@
+/**
+ * @file receive_wait.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace oec {
+
+/**
+ * @brief How a receive path waits for its socket.
+ */
+enum class ReceiveWaitMode {
+    /// Sleep in ppoll() until data or the deadline (nanosecond timeout).
+    Block,
+    /// Spin on zero-timeout polls until data or the deadline; burns a core, saves the wake-up latency.
+    BusyPoll
+};
+
+/**
+ * @brief Wait until one of @p fds is readable or the absolute steady-clock @p deadline passes.
+ *
+ * The remaining time is derived from the fixed deadline on every pass, so
+ * repeated waits inside one cycle never add up beyond it. Returns a mask with
+ * bit i set for readable fds[i], 0 on timeout and -1 on failure (@p outError set).
+ */
+int waitReadable(const int* fds, std::size_t count, std::chrono::steady_clock::time_point deadline,
+                 ReceiveWaitMode mode, std::string& outError);
+
+/**
+ * @brief Receive deadlines of a frame that may be retried on the secondary port.
+ */
+struct RedundantDeadlines {
+    std::chrono::steady_clock::time_point primary;
+    std::chrono::steady_clock::time_point secondary;
+};
+
+/**
+ * @brief Split the budget between @p start and @p deadline: the primary waits for the first half.
+ *
+ * A lost primary frame then still leaves the secondary retry half the budget
+ * instead of an already expired deadline. Past deadlines are returned unchanged.
+ */
+RedundantDeadlines splitRedundantDeadline(std::chrono::steady_clock::time_point start,
+                                          std::chrono::steady_clock::time_point deadline);
+
+/**
+ * @brief Set SO_BUSY_POLL so the kernel polls the NIC queue for up to @p budget in blocking receives.
+ */
+bool setSocketBusyPoll(int fd, std::chrono::microseconds budget, std::string& outError);
+
+} // namespace oec
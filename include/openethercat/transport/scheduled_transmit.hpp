@@ -0,0 +1,68 @@
+/**
+ * @file scheduled_transmit.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <sys/socket.h>
+
+namespace oec {
+
+/**
+ * @brief SO_TXTIME launch-time transmission of the first cyclic frame (`OEC_TXTIME=1`).
+ *
+ * The frame goes through a dedicated send-only socket whose priority the
+ * interface maps onto a queue with the ETF (or taprio) qdisc, clocked by
+ * CLOCK_TAI. Other traffic keeps the normal queue and is never held back.
+ */
+struct ScheduledTransmitOptions {
+    bool enabled = false;
+    /// SO_PRIORITY of the launch socket; choose the traffic class the ETF queue is mapped to.
+    int socketPriority = 7;
+    /// A launch time closer than this when the frame is handed over (ETF delta plus syscall) is sent at once.
+    std::chrono::nanoseconds minLead{std::chrono::microseconds(50)};
+};
+
+/**
+ * @brief Launch-time outcome counters.
+ */
+struct ScheduledTransmitDiagnostics {
+    std::uint64_t scheduledFrames = 0;
+    /// Launch time already too close at send time; the frame left immediately instead.
+    std::uint64_t lateAtSend = 0;
+    /// Dropped by the qdisc because the launch time passed before dequeue (SO_EE_CODE_TXTIME_MISSED).
+    std::uint64_t missedByQdisc = 0;
+    /// Rejected launch time, e.g. a clock mismatch with the qdisc (SO_EE_CODE_TXTIME_INVALID_PARAM).
+    std::uint64_t invalidLaunchTime = 0;
+    /// Cycles without a launch time (none set, or parallel redundancy active).
+    std::uint64_t unscheduledCycles = 0;
+};
+
+/**
+ * @brief Set SO_TXTIME (CLOCK_TAI, error reporting) and SO_PRIORITY on @p fd.
+ */
+bool enableScheduledTransmit(int fd, int socketPriority, std::string& outError);
+
+/**
+ * @brief sendmsg() with an SCM_TXTIME launch time in CLOCK_TAI ns.
+ */
+bool sendAtLaunchTime(int fd, const void* data, std::size_t size, const sockaddr* target, socklen_t targetLength,
+                      std::uint64_t launchTaiNs, std::string& outError);
+
+/**
+ * @brief Map a steady-clock time point onto CLOCK_TAI ns, the clock ETF schedules with.
+ */
+std::uint64_t steadyToTaiNs(std::chrono::steady_clock::time_point time);
+
+/**
+ * @brief Count and drain the launch-time errors the kernel queued on @p fd.
+ */
+void collectLaunchTimeErrors(int fd, ScheduledTransmitDiagnostics& diagnostics);
+
+} // namespace oec
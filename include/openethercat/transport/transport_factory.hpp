@@ -17,6 +17,8 @@ namespace oec {
 enum class TransportKind {
     Mock,
     LinuxRawSocket,
+    /// LinuxRawSocketTransport with its cyclic frames on AF_XDP.
+    LinuxXdp,
 };
 
 struct TransportFactoryConfig {
@@ -40,6 +42,7 @@ struct TransportFactoryConfig {
  * - mock
  * - linux:<ifname>
  * - linux:<ifname_primary>,<ifname_secondary>
+ * - xdp:<ifname>
  */
 class TransportFactory {
 public:
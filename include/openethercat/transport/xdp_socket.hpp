@@ -0,0 +1,162 @@
+/**
+ * @file xdp_socket.hpp
+ * @brief openEtherCAT source file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace oec {
+
+/**
+ * @brief AF_XDP data path for cyclic frames (`xdp:<ifname>` or `OEC_XDP=1`).
+ *
+ * A small XDP program redirects received EtherCAT frames whose first datagram
+ * is a logical command (LRD/LWR/LRW) or the DC ARMW to the socket; everything
+ * else passes to the kernel stack and the AF_PACKET socket as before.
+ */
+struct XdpSocketOptions {
+    bool enabled = false;
+    /// NIC RX queue the socket binds to; slave responses must arrive on it (ethtool -N/-X).
+    std::uint32_t queueId = 0;
+    /// UMEM frames, power of two; half back the RX ring, half the TX ring.
+    std::uint32_t frameCount = 256;
+    /// UMEM frame size: 2048 or 4096.
+    std::uint32_t frameSize = 2048;
+    /// Try XDP_ZEROCOPY before XDP_COPY (`OEC_XDP_COPY=1` forces copy mode).
+    bool zeroCopy = true;
+    /// Try the driver XDP hook before the generic one (`OEC_XDP_GENERIC=1` forces generic, e.g. veth tests).
+    bool nativeMode = true;
+};
+
+/**
+ * @brief AF_XDP counters; rxDropped comes from the kernel (XDP_STATISTICS).
+ */
+struct XdpSocketStats {
+    std::uint64_t framesSent = 0;
+    std::uint64_t framesReceived = 0;
+    /// Sends refused because every TX frame was still owned by the kernel.
+    std::uint64_t txRingFull = 0;
+    /// Frames the kernel dropped for this socket (no fill buffer, RX ring full).
+    std::uint64_t rxDropped = 0;
+};
+
+/**
+ * @brief UMEM and ring bookkeeping of an AF_XDP socket, apart from the kernel objects.
+ *
+ * Every ring is a power-of-two descriptor array with free-running producer and
+ * consumer indices shared with the kernel. The lower half of the UMEM frames
+ * circulates through the fill and RX rings, the upper half through TX and completion.
+ */
+class XdpRings {
+public:
+    struct Ring {
+        std::uint32_t* producer = nullptr;
+        std::uint32_t* consumer = nullptr;
+        /// std::uint64_t addresses (fill, completion) or xdp_desc (RX, TX).
+        void* descs = nullptr;
+        std::uint32_t mask = 0;
+    };
+
+    /**
+     * @brief Start over on @p umem: give the RX half to the fill ring and mark the TX half free.
+     */
+    void reset(std::uint8_t* umem, std::uint32_t frameCount, std::uint32_t frameSize, const Ring& fill,
+               const Ring& completion, const Ring& rx, const Ring& tx);
+    void clear();
+    /**
+     * @brief Copy @p frame into a free TX frame and publish its descriptor; the caller kicks the kernel.
+     */
+    bool queueTx(const std::vector<std::uint8_t>& frame, std::string& outError);
+    /**
+     * @brief Copy out the next RX frame and return its UMEM frame to the fill ring; -1/EAGAIN when empty.
+     */
+    ssize_t receive(void* buffer, std::size_t size);
+    /// TX frames neither queued nor awaiting completion (completions are reclaimed by queueTx()).
+    std::size_t freeTxFrames() const { return freeTxFrames_.size(); }
+    /// framesSent counts queued frames; rxDropped stays 0 (kernel counter).
+    XdpSocketStats stats() const { return stats_; }
+
+private:
+    void reclaimCompletions();
+
+    std::uint8_t* umem_ = nullptr;
+    std::uint32_t frameSize_ = 0;
+    Ring fill_{};
+    Ring completion_{};
+    Ring rx_{};
+    Ring tx_{};
+    std::vector<std::uint64_t> freeTxFrames_;
+    XdpSocketStats stats_{};
+};
+
+/**
+ * @brief One AF_XDP socket with its UMEM, rings and steering program.
+ *
+ * Raw bpf() syscalls keep libbpf out of the build. The program is attached
+ * through a BPF link, so it is detached when the socket closes or the process dies.
+ */
+class XdpSocket {
+public:
+    XdpSocket() = default;
+    ~XdpSocket();
+    XdpSocket(const XdpSocket&) = delete;
+    XdpSocket& operator=(const XdpSocket&) = delete;
+
+    bool open(const std::string& ifname, const XdpSocketOptions& options, std::string& outError);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+    /// Readable (POLLIN) while frames wait in the RX ring.
+    int fd() const { return fd_; }
+    bool zeroCopy() const { return zeroCopy_; }
+    /// False with the generic (SKB) XDP hook.
+    bool nativeMode() const { return nativeMode_; }
+
+    /**
+     * @brief Copy @p frame into a free TX frame, queue it and kick the kernel.
+     */
+    bool send(const std::vector<std::uint8_t>& frame, std::string& outError);
+    /**
+     * @brief Take one frame from the RX ring without blocking; same result as recv(MSG_DONTWAIT).
+     */
+    ssize_t receive(void* buffer, std::size_t size);
+    XdpSocketStats stats() const;
+
+    /**
+     * @brief The program's steering rule: EtherCAT frame whose first command is LRD/LWR/LRW/ARMW.
+     */
+    static bool isCyclicFrame(const std::uint8_t* data, std::size_t size);
+
+private:
+    struct MappedRing {
+        XdpRings::Ring ring{};
+        void* map = nullptr;
+        std::size_t mapSize = 0;
+    };
+
+    bool setupRings(std::string& outError);
+    bool attachProgram(int ifIndex, std::string& outError);
+
+    int fd_ = -1;
+    int mapFd_ = -1;
+    int progFd_ = -1;
+    int linkFd_ = -1;
+    std::uint8_t* umem_ = nullptr;
+    std::size_t umemSize_ = 0;
+    XdpSocketOptions options_{};
+    bool zeroCopy_ = false;
+    bool nativeMode_ = false;
+    MappedRing fill_{};
+    MappedRing completion_{};
+    MappedRing rx_{};
+    MappedRing tx_{};
+    XdpRings rings_{};
+};
+
+} // namespace oec
@@ -0,0 +1,252 @@
+/**
+ * @file binary_configuration.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/config/binary_configuration.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oec {
+namespace {
+
+constexpr std::uint8_t kMagic[4] = {'O', 'E', 'C', 'B'};
+constexpr std::uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t kFnvPrime = 0x100000001b3ULL;
+
+std::uint64_t fnv1a(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t hash = kFnvOffset;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+std::size_t align8(std::size_t value) {
+    return (value + 7U) & ~static_cast<std::size_t>(7U);
+}
+
+void storeLe(std::uint8_t* out, std::uint64_t value, std::size_t width) {
+    for (std::size_t i = 0; i < width; ++i) {
+        out[i] = static_cast<std::uint8_t>((value >> (8U * i)) & 0xFFU);
+    }
+}
+
+std::uint64_t loadLe(const std::uint8_t* in, std::size_t width) {
+    std::uint64_t value = 0U;
+    for (std::size_t i = 0; i < width; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8U * i);
+    }
+    return value;
+}
+
+// Interns strings so repeated slave names in signal records share storage.
+class StringTable {
+public:
+    std::pair<std::uint32_t, std::uint32_t> add(const std::string& text) {
+        const auto it = offsets_.find(text);
+        if (it != offsets_.end()) {
+            return {it->second, static_cast<std::uint32_t>(text.size())};
+        }
+        const auto offset = static_cast<std::uint32_t>(bytes_.size());
+        bytes_.insert(bytes_.end(), text.begin(), text.end());
+        offsets_.emplace(text, offset);
+        return {offset, static_cast<std::uint32_t>(text.size())};
+    }
+    const std::vector<std::uint8_t>& bytes() const { return bytes_; }
+
+private:
+    std::vector<std::uint8_t> bytes_;
+    std::unordered_map<std::string, std::uint32_t> offsets_;
+};
+
+// Header field offsets.
+constexpr std::size_t kOffVersion = 4U;
+constexpr std::size_t kOffSlaveCount = 8U;
+constexpr std::size_t kOffSignalCount = 12U;
+constexpr std::size_t kOffInputBytes = 16U;
+constexpr std::size_t kOffOutputBytes = 24U;
+constexpr std::size_t kOffStringBytes = 32U;
+constexpr std::size_t kOffChecksum = 40U;
+
+} // namespace
+
+std::vector<std::uint8_t> BinaryConfiguration::encode(const NetworkConfiguration& config) {
+    StringTable strings;
+    std::vector<std::uint8_t> slaveRecords(config.slaves.size() * kSlaveRecordBytes, 0U);
+    for (std::size_t i = 0; i < config.slaves.size(); ++i) {
+        const auto& s = config.slaves[i];
+        auto* rec = slaveRecords.data() + (i * kSlaveRecordBytes);
+        const auto name = strings.add(s.name);
+        storeLe(rec + 0U, name.first, 4U);
+        storeLe(rec + 4U, name.second, 4U);
+        storeLe(rec + 8U, s.alias, 2U);
+        storeLe(rec + 10U, s.position, 2U);
+        storeLe(rec + 12U, s.vendorId, 4U);
+        storeLe(rec + 16U, s.productCode, 4U);
+    }
+    std::vector<std::uint8_t> signalRecords(config.signals.size() * kSignalRecordBytes, 0U);
+    for (std::size_t i = 0; i < config.signals.size(); ++i) {
+        const auto& sig = config.signals[i];
+        auto* rec = signalRecords.data() + (i * kSignalRecordBytes);
+        const auto logical = strings.add(sig.logicalName);
+        const auto slave = strings.add(sig.slaveName);
+        storeLe(rec + 0U, logical.first, 4U);
+        storeLe(rec + 4U, logical.second, 4U);
+        storeLe(rec + 8U, slave.first, 4U);
+        storeLe(rec + 12U, slave.second, 4U);
+        storeLe(rec + 16U, sig.byteOffset, 8U);
+        rec[24] = (sig.direction == SignalDirection::Output) ? 1U : 0U;
+        rec[25] = sig.bitOffset;
+    }
+
+    const auto& table = strings.bytes();
+    std::vector<std::uint8_t> out(kHeaderBytes, 0U);
+    std::copy(std::begin(kMagic), std::end(kMagic), out.begin());
+    storeLe(out.data() + kOffVersion, kFormatVersion, 4U);
+    storeLe(out.data() + kOffSlaveCount, config.slaves.size(), 4U);
+    storeLe(out.data() + kOffSignalCount, config.signals.size(), 4U);
+    storeLe(out.data() + kOffInputBytes, config.processImageInputBytes, 8U);
+    storeLe(out.data() + kOffOutputBytes, config.processImageOutputBytes, 8U);
+    storeLe(out.data() + kOffStringBytes, table.size(), 4U);
+    out.insert(out.end(), slaveRecords.begin(), slaveRecords.end());
+    out.insert(out.end(), signalRecords.begin(), signalRecords.end());
+    out.insert(out.end(), table.begin(), table.end());
+    out.resize(align8(out.size()), 0U);
+    storeLe(out.data() + kOffChecksum, fnv1a(out.data() + kHeaderBytes, out.size() - kHeaderBytes), 8U);
+    return out;
+}
+
+bool BinaryConfiguration::looksLikeImage(const std::uint8_t* data, std::size_t size) {
+    return data != nullptr && size >= sizeof(kMagic) && std::equal(std::begin(kMagic), std::end(kMagic), data);
+}
+
+bool BinaryConfiguration::decode(const std::uint8_t* data, std::size_t size,
+                                 NetworkConfiguration& outConfig, std::string& outError) {
+    outConfig = NetworkConfiguration{};
+    outError.clear();
+    if (size < kHeaderBytes || !looksLikeImage(data, size)) {
+        outError = "Not a binary configuration image";
+        return false;
+    }
+    if (loadLe(data + kOffVersion, 4U) != kFormatVersion) {
+        outError = "Unsupported binary configuration version";
+        return false;
+    }
+    const auto slaveCount = static_cast<std::size_t>(loadLe(data + kOffSlaveCount, 4U));
+    const auto signalCount = static_cast<std::size_t>(loadLe(data + kOffSignalCount, 4U));
+    const auto stringBytes = static_cast<std::size_t>(loadLe(data + kOffStringBytes, 4U));
+    const auto slavesAt = kHeaderBytes;
+    const auto signalsAt = slavesAt + (slaveCount * kSlaveRecordBytes);
+    const auto stringsAt = signalsAt + (signalCount * kSignalRecordBytes);
+    if (stringsAt + stringBytes > size) {
+        outError = "Binary configuration image truncated";
+        return false;
+    }
+    if (fnv1a(data + kHeaderBytes, size - kHeaderBytes) != loadLe(data + kOffChecksum, 8U)) {
+        outError = "Binary configuration checksum mismatch";
+        return false;
+    }
+
+    const auto* strings = data + stringsAt;
+    bool stringsOk = true;
+    auto text = [&](const std::uint8_t* rec) -> std::string {
+        const auto offset = static_cast<std::size_t>(loadLe(rec, 4U));
+        const auto length = static_cast<std::size_t>(loadLe(rec + 4U, 4U));
+        if (offset + length > stringBytes) {
+            stringsOk = false;
+            return {};
+        }
+        return std::string(reinterpret_cast<const char*>(strings + offset), length);
+    };
+
+    outConfig.processImageInputBytes = static_cast<std::size_t>(loadLe(data + kOffInputBytes, 8U));
+    outConfig.processImageOutputBytes = static_cast<std::size_t>(loadLe(data + kOffOutputBytes, 8U));
+    outConfig.slaves.resize(slaveCount);
+    for (std::size_t i = 0; i < slaveCount; ++i) {
+        const auto* rec = data + slavesAt + (i * kSlaveRecordBytes);
+        auto& s = outConfig.slaves[i];
+        s.name = text(rec);
+        s.alias = static_cast<std::uint16_t>(loadLe(rec + 8U, 2U));
+        s.position = static_cast<std::uint16_t>(loadLe(rec + 10U, 2U));
+        s.vendorId = static_cast<std::uint32_t>(loadLe(rec + 12U, 4U));
+        s.productCode = static_cast<std::uint32_t>(loadLe(rec + 16U, 4U));
+    }
+    outConfig.signals.resize(signalCount);
+    for (std::size_t i = 0; i < signalCount; ++i) {
+        const auto* rec = data + signalsAt + (i * kSignalRecordBytes);
+        auto& sig = outConfig.signals[i];
+        sig.logicalName = text(rec);
+        sig.slaveName = text(rec + 8U);
+        sig.byteOffset = static_cast<std::size_t>(loadLe(rec + 16U, 8U));
+        sig.direction = (rec[24] != 0U) ? SignalDirection::Output : SignalDirection::Input;
+        sig.bitOffset = rec[25];
+    }
+    if (!stringsOk) {
+        outConfig = NetworkConfiguration{};
+        outError = "Binary configuration string reference out of range";
+        return false;
+    }
+    return true;
+}
+
+bool BinaryConfiguration::compileToFile(const NetworkConfiguration& config, const std::string& path,
+                                        std::string& outError) {
+    outError.clear();
+    const auto bytes = encode(config);
+    const auto tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            outError = "Cannot open file: " + tmpPath;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            outError = "Failed writing file: " + tmpPath;
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        outError = "Failed to replace file: " + path;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool BinaryConfiguration::loadFromFile(const std::string& path, NetworkConfiguration& outConfig,
+                                       std::string& outError) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        outError = "Cannot open file: " + path;
+        return false;
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        outError = "Cannot stat file: " + path;
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        outError = "Cannot map file: " + path;
+        return false;
+    }
+    const bool ok = decode(static_cast<const std::uint8_t*>(mapped), size, outConfig, outError);
+    ::munmap(mapped, size);
+    return ok;
+}
+
+} // namespace oec
@@ -5,110 +5,85 @@
 
 #include "openethercat/config/config_loader.hpp"
 
-#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
-#include <regex>
-#include <sstream>
+#include <optional>
 #include <stdexcept>
 #include <unordered_map>
 
+#include "openethercat/config/binary_configuration.hpp"
 #include "openethercat/config/config_validator.hpp"
+#include "openethercat/config/esi_catalog_index.hpp"
+#include "openethercat/config/xml_stream_parser.hpp"
 
 namespace oec {
 namespace {
 
-std::optional<std::string> attr(const std::string& xml, const std::string& key) {
-    const auto pattern = key + "\\s*=\\s*\"([^\"]+)\"";
-    std::regex re(pattern, std::regex_constants::icase);
-    std::smatch match;
-    if (!std::regex_search(xml, match, re) || match.size() < 2) {
-        return std::nullopt;
-    }
-    return match[1].str();
-}
+using Attributes = std::vector<XmlAttribute>;
 
+// Accepts decimal, 0x-prefixed and ESI-style #x-prefixed hexadecimal values.
 std::uint32_t parseUnsigned(const std::string& value) {
+    std::size_t begin = 0;
+    while (begin < value.size() && std::isspace(static_cast<unsigned char>(value[begin])) != 0) {
+        ++begin;
+    }
+    std::size_t end = value.size();
+    while (end > begin && std::isspace(static_cast<unsigned char>(value[end - 1U])) != 0) {
+        --end;
+    }
+    auto text = value.substr(begin, end - begin);
+    int base = 0;
+    if (text.size() > 2U && text[0] == '#' && (text[1] == 'x' || text[1] == 'X')) {
+        text = text.substr(2U);
+        base = 16;
+    }
     std::size_t consumed = 0;
-    const auto parsed = std::stoul(value, &consumed, 0);
-    if (consumed != value.size()) {
+    const auto parsed = std::stoul(text, &consumed, base);
+    if (consumed != text.size()) {
         throw std::invalid_argument("invalid numeric value");
     }
     return static_cast<std::uint32_t>(parsed);
 }
 
-bool readFile(const std::string& path, std::string& out, std::string& outError) {
-    std::ifstream file(path);
-    if (!file) {
-        outError = "Cannot open file: " + path;
-        return false;
-    }
-    std::ostringstream buffer;
-    buffer << file.rdbuf();
-    out = buffer.str();
-    return true;
-}
-
-std::vector<std::string> extractTags(const std::string& xml, const std::string& tagName) {
-    const auto pattern = "<\\s*" + tagName + "\\b[^>]*>";
-    std::regex re(pattern, std::regex_constants::icase);
-    std::vector<std::string> tags;
-
-    for (std::sregex_iterator it(xml.begin(), xml.end(), re), end; it != end; ++it) {
-        tags.push_back(it->str());
-    }
-    return tags;
-}
-
-bool parseProcessImage(const std::string& xml, NetworkConfiguration& config) {
-    const auto tags = extractTags(xml, "ProcessImage");
-    if (tags.empty()) {
-        return false;
-    }
-    const auto input = attr(tags.front(), "inputBytes");
-    const auto output = attr(tags.front(), "outputBytes");
-    if (!input || !output) {
-        return false;
-    }
-
-    config.processImageInputBytes = static_cast<std::size_t>(parseUnsigned(*input));
-    config.processImageOutputBytes = static_cast<std::size_t>(parseUnsigned(*output));
-    return true;
+const std::string* attr(const Attributes& attributes, const char* key) {
+    return XmlStreamParser::findAttribute(attributes, key);
 }
 
-std::optional<SlaveIdentity> parseSlaveTag(const std::string& tag) {
+std::optional<SlaveIdentity> parseSlaveAttributes(const Attributes& attributes) {
     SlaveIdentity slave;
-    const auto name = attr(tag, "name");
-    if (!name) {
+    const auto* name = attr(attributes, "name");
+    if (name == nullptr) {
         return std::nullopt;
     }
 
     slave.name = *name;
-    if (const auto alias = attr(tag, "alias")) {
+    if (const auto* alias = attr(attributes, "alias")) {
         slave.alias = static_cast<std::uint16_t>(parseUnsigned(*alias));
     }
-    if (const auto position = attr(tag, "position")) {
+    if (const auto* position = attr(attributes, "position")) {
         slave.position = static_cast<std::uint16_t>(parseUnsigned(*position));
     }
-    if (const auto vendor = attr(tag, "vendorId")) {
+    if (const auto* vendor = attr(attributes, "vendorId")) {
         slave.vendorId = parseUnsigned(*vendor);
     }
-    if (const auto product = attr(tag, "productCode")) {
+    if (const auto* product = attr(attributes, "productCode")) {
         slave.productCode = parseUnsigned(*product);
     }
-
     return slave;
 }
 
-std::optional<SignalBinding> parseSignalTag(const std::string& tag) {
+std::optional<SignalBinding> parseSignalAttributes(const Attributes& attributes) {
     SignalBinding signal;
-    const auto logical = attr(tag, "logicalName");
-    const auto direction = attr(tag, "direction");
-    const auto slave = attr(tag, "slaveName");
-    const auto byteOffset = attr(tag, "byteOffset");
-    const auto bitOffset = attr(tag, "bitOffset");
-
-    if (!logical || !direction || !slave || !byteOffset || !bitOffset) {
+    const auto* logical = attr(attributes, "logicalName");
+    const auto* direction = attr(attributes, "direction");
+    const auto* slave = attr(attributes, "slaveName");
+    const auto* byteOffset = attr(attributes, "byteOffset");
+    const auto* bitOffset = attr(attributes, "bitOffset");
+
+    if (logical == nullptr || direction == nullptr || slave == nullptr || byteOffset == nullptr ||
+        bitOffset == nullptr) {
         return std::nullopt;
     }
 
@@ -122,27 +97,216 @@ std::optional<SignalBinding> parseSignalTag(const std::string& tag) {
     return signal;
 }
 
-bool parseEniXml(const std::string& xml, NetworkConfiguration& config, std::string& outError) {
-    try {
-        if (!parseProcessImage(xml, config)) {
-            outError = "Missing or invalid <ProcessImage inputBytes=\"...\" outputBytes=\"...\"/>";
-            return false;
+/**
+ * @brief Collects ProcessImage/Slave/Signal elements of an ENI document.
+ */
+class EniHandler final : public XmlStreamParser::Handler {
+public:
+    explicit EniHandler(NetworkConfiguration& config) : config_(config) {}
+
+    void onStartElement(const std::string& name, const Attributes& attributes) override {
+        if (XmlStreamParser::equalsIgnoreCase(name, "ProcessImage")) {
+            if (processImageSeen_) {
+                return;
+            }
+            processImageSeen_ = true;
+            const auto* input = attr(attributes, "inputBytes");
+            const auto* output = attr(attributes, "outputBytes");
+            if (input == nullptr || output == nullptr) {
+                return;
+            }
+            config_.processImageInputBytes = static_cast<std::size_t>(parseUnsigned(*input));
+            config_.processImageOutputBytes = static_cast<std::size_t>(parseUnsigned(*output));
+            processImageValid_ = true;
+        } else if (XmlStreamParser::equalsIgnoreCase(name, "Slave")) {
+            if (auto slave = parseSlaveAttributes(attributes)) {
+                config_.slaves.push_back(std::move(*slave));
+            }
+        } else if (XmlStreamParser::equalsIgnoreCase(name, "Signal")) {
+            if (auto signal = parseSignalAttributes(attributes)) {
+                config_.signals.push_back(std::move(*signal));
+            }
         }
+    }
+    void onEndElement(const std::string& name) override { (void)name; }
+
+    bool processImageValid() const { return processImageValid_; }
+
+private:
+    NetworkConfiguration& config_;
+    bool processImageSeen_ = false;
+    bool processImageValid_ = false;
+};
+
+/**
+ * @brief Extracts devices from ESI documents.
+ *
+ * Understands both the compact attribute catalog used by this repository
+ * (`<Device name=".." vendorId=".." productCode=".."/>`, `<Slave .../>`) and
+ * ETG.2000 ESI structure (`Vendor/Id`, `Device/Type@ProductCode`,
+ * `Device/RxPdo|TxPdo/Entry`).
+ */
+class EsiHandler final : public XmlStreamParser::Handler {
+public:
+    explicit EsiHandler(std::vector<EsiDeviceDescription>& devices) : devices_(devices) {}
+
+    /**
+     * @brief Attach the driving parser so devices record their byte offset.
+     * @param stopAfterFirstDevice Stop parsing once one device was collected.
+     */
+    void attach(XmlStreamParser& parser, bool stopAfterFirstDevice) {
+        parser_ = &parser;
+        stopAfterFirstDevice_ = stopAfterFirstDevice;
+    }
 
-        for (const auto& tag : extractTags(xml, "Slave")) {
-            const auto slave = parseSlaveTag(tag);
-            if (slave) {
-                config.slaves.push_back(*slave);
+    void onStartElement(const std::string& name, const Attributes& attributes) override {
+        path_.push_back(name);
+        text_.clear();
+        const auto depth = path_.size();
+        if (deviceDepth_ == 0U) {
+            if (is(name, "Device") || (is(name, "Slave") && attr(attributes, "name") != nullptr)) {
+                device_ = EsiDeviceDescription{};
+                device_.sourceOffset = (parser_ != nullptr) ? parser_->markupOffset() : 0U;
+                deviceDepth_ = depth;
+                if (auto identity = parseSlaveAttributes(attributes)) {
+                    device_.identity = std::move(*identity);
+                }
             }
+            return;
         }
+        if (depth == deviceDepth_ + 1U && is(name, "Type")) {
+            if (const auto* product = attr(attributes, "ProductCode")) {
+                device_.identity.productCode = parseUnsigned(*product);
+            }
+            if (const auto* revision = attr(attributes, "RevisionNo")) {
+                device_.revision = parseUnsigned(*revision);
+            }
+        } else if (depth == deviceDepth_ + 1U && (is(name, "RxPdo") || is(name, "TxPdo"))) {
+            auto& list = is(name, "RxPdo") ? device_.rxPdos : device_.txPdos;
+            list.push_back(EsiPdo{});
+            pdo_ = &list.back();
+            pdoDepth_ = depth;
+        } else if (pdo_ != nullptr && depth == pdoDepth_ + 1U && is(name, "Entry")) {
+            pdo_->entries.push_back(EsiPdoEntry{});
+        }
+    }
 
-        for (const auto& tag : extractTags(xml, "Signal")) {
-            const auto signal = parseSignalTag(tag);
-            if (signal) {
-                config.signals.push_back(*signal);
+    void onEndElement(const std::string& name) override {
+        const auto value = trimmedText();
+        const auto depth = path_.size();
+        const bool parentIsEntry = depth >= 2U && is(path_[depth - 2U], "Entry");
+        path_.pop_back();
+        text_.clear();
+
+        if (deviceDepth_ == 0U) {
+            if (is(name, "Id") && parentIs("Vendor") && !value.empty()) {
+                vendorId_ = parseUnsigned(value);
+            }
+            return;
+        }
+        if (depth == deviceDepth_) {
+            if (!device_.identity.name.empty()) {
+                devices_.push_back(std::move(device_));
+                if (stopAfterFirstDevice_ && parser_ != nullptr) {
+                    parser_->stop();
+                }
+            }
+            device_ = EsiDeviceDescription{};
+            deviceDepth_ = 0U;
+            pdo_ = nullptr;
+            pdoDepth_ = 0U;
+        } else if (depth == deviceDepth_ + 1U && is(name, "Type")) {
+            if (device_.identity.name.empty()) {
+                device_.identity.name = value;
             }
+        } else if (pdo_ != nullptr && depth == pdoDepth_) {
+            pdo_ = nullptr;
+            pdoDepth_ = 0U;
+        } else if (pdo_ != nullptr && depth == pdoDepth_ + 1U) {
+            if (is(name, "Index") && !value.empty()) {
+                pdo_->index = static_cast<std::uint16_t>(parseUnsigned(value));
+            } else if (is(name, "Name") && pdo_->name.empty()) {
+                pdo_->name = value;
+            }
+        } else if (pdo_ != nullptr && depth == pdoDepth_ + 2U && parentIsEntry && !pdo_->entries.empty()) {
+            auto& entry = pdo_->entries.back();
+            if (is(name, "Index") && !value.empty()) {
+                entry.index = static_cast<std::uint16_t>(parseUnsigned(value));
+            } else if (is(name, "SubIndex") && !value.empty()) {
+                entry.subIndex = static_cast<std::uint8_t>(parseUnsigned(value));
+            } else if (is(name, "BitLen") && !value.empty()) {
+                entry.bitLength = static_cast<std::uint8_t>(parseUnsigned(value));
+            } else if (is(name, "Name")) {
+                entry.name = value;
+            }
+        }
+    }
+
+    void onText(std::string_view text) override {
+        // Only leaf values are ever needed; cap to keep memory bounded on large docs.
+        if (text_.size() < kMaxTextBytes) {
+            text_.append(text.substr(0, kMaxTextBytes - text_.size()));
+        }
+    }
+
+    // Vendor/Id may follow the devices it applies to, so fill it in at the end.
+    void finishDocument() {
+        for (auto it = devices_.begin() + static_cast<std::ptrdiff_t>(documentBegin_); it != devices_.end(); ++it) {
+            if (it->identity.vendorId == 0U) {
+                it->identity.vendorId = vendorId_;
+            }
+        }
+        documentBegin_ = devices_.size();
+        vendorId_ = 0U;
+    }
+
+private:
+    static constexpr std::size_t kMaxTextBytes = 256U;
+
+    static bool is(const std::string& name, const char* expected) {
+        return XmlStreamParser::equalsIgnoreCase(name, expected);
+    }
+    // Parent of the element currently on top of the path.
+    bool parentIs(const char* expected) const {
+        return !path_.empty() && is(path_.back(), expected);
+    }
+    std::string trimmedText() const {
+        std::size_t begin = 0;
+        std::size_t end = text_.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(text_[begin])) != 0) {
+            ++begin;
+        }
+        while (end > begin && std::isspace(static_cast<unsigned char>(text_[end - 1U])) != 0) {
+            --end;
         }
+        return text_.substr(begin, end - begin);
+    }
 
+    std::vector<EsiDeviceDescription>& devices_;
+    XmlStreamParser* parser_ = nullptr;
+    bool stopAfterFirstDevice_ = false;
+    std::vector<std::string> path_;
+    std::string text_;
+    EsiDeviceDescription device_;
+    std::size_t deviceDepth_ = 0U;
+    EsiPdo* pdo_ = nullptr;
+    std::size_t pdoDepth_ = 0U;
+    std::uint32_t vendorId_ = 0U;
+    std::size_t documentBegin_ = 0U;
+};
+
+bool parseEniFile(const std::string& eniPath, NetworkConfiguration& config, std::string& outError) {
+    try {
+        EniHandler handler(config);
+        std::string parseError;
+        if (!XmlStreamParser::parseFile(eniPath, handler, parseError)) {
+            outError = (parseError.rfind("Cannot open file", 0) == 0) ? parseError : "ENI parse error: " + parseError;
+            return false;
+        }
+        if (!handler.processImageValid()) {
+            outError = "Missing or invalid <ProcessImage inputBytes=\"...\" outputBytes=\"...\"/>";
+            return false;
+        }
         if (config.signals.empty()) {
             outError = "No <Signal ...> entries found in ENI file";
             return false;
@@ -154,65 +318,77 @@ bool parseEniXml(const std::string& xml, NetworkConfiguration& config, std::stri
     }
 }
 
+bool parseEsiStream(const std::string& esiPath, std::uint64_t offset, bool firstDeviceOnly,
+                    std::vector<EsiDeviceDescription>& outDevices, std::string& outError) {
+    std::ifstream file(esiPath, std::ios::binary);
+    if (!file) {
+        outError = "Cannot open file: " + esiPath;
+        return false;
+    }
+    if (offset != 0U && !file.seekg(static_cast<std::streamoff>(offset))) {
+        outError = esiPath + ": cannot seek to offset " + std::to_string(offset);
+        return false;
+    }
+    try {
+        EsiHandler handler(outDevices);
+        XmlStreamParser parser(handler);
+        handler.attach(parser, firstDeviceOnly);
+        if (!parser.feedStream(file) || !parser.finish()) {
+            outError = esiPath + ": " + parser.error();
+            return false;
+        }
+        handler.finishDocument();
+        return true;
+    } catch (const std::exception& ex) {
+        outError = esiPath + ": ESI parse error: " + ex.what();
+        return false;
+    }
+}
+
 std::unordered_map<std::string, SlaveIdentity> loadEsiCatalog(const std::string& esiDirectory,
+                                                              std::vector<std::string>& outSkipped,
                                                               std::string& outError) {
     std::unordered_map<std::string, SlaveIdentity> catalog;
-    namespace fs = std::filesystem;
 
-    std::error_code ec;
-    if (!fs::exists(esiDirectory, ec)) {
-        outError = "ESI directory does not exist: " + esiDirectory;
+    // OEC_ESI_INDEX_CACHE names an index file; unchanged ESI files are not reparsed.
+    const char* cachePath = std::getenv("OEC_ESI_INDEX_CACHE");
+    EsiCatalogIndex index;
+    if (cachePath != nullptr && *cachePath != '\0') {
+        std::string cacheError;
+        (void)index.loadCache(cachePath, cacheError); // stale/missing cache just means a full scan
+    }
+    if (!index.build(esiDirectory, outError)) {
         return catalog;
     }
+    for (const auto& failure : index.fileErrors()) {
+        // Parser errors already start with the file path.
+        outSkipped.push_back(failure.error.rfind(failure.filePath, 0) == 0 ? failure.error
+                                                                          : failure.filePath + ": " + failure.error);
+    }
+    if (cachePath != nullptr && *cachePath != '\0' && index.stats().filesParsed > 0U) {
+        std::string cacheError;
+        (void)index.saveCache(cachePath, cacheError);
+    }
 
-    for (const auto& entry : fs::directory_iterator(esiDirectory, ec)) {
-        if (ec) {
-            outError = "Failed to enumerate ESI directory: " + ec.message();
-            return {};
-        }
-        if (!entry.is_regular_file()) {
+    // Entries are ordered by (file, offset), matching the former serial scan.
+    for (const auto& device : index.entries()) {
+        const auto& slave = device.identity;
+        auto& existing = catalog[slave.name];
+        if (existing.name.empty()) {
+            existing = slave;
             continue;
         }
-        if (entry.path().extension() != ".xml") {
-            continue;
+        if (existing.vendorId == 0U && slave.vendorId != 0U) {
+            existing.vendorId = slave.vendorId;
         }
-
-        std::string xml;
-        if (!readFile(entry.path().string(), xml, outError)) {
-            return {};
+        if (existing.productCode == 0U && slave.productCode != 0U) {
+            existing.productCode = slave.productCode;
         }
-
-        const auto mergeIntoCatalog = [&](const SlaveIdentity& slave) {
-            auto& existing = catalog[slave.name];
-            if (existing.name.empty()) {
-                existing = slave;
-                return;
-            }
-            if (existing.vendorId == 0U && slave.vendorId != 0U) {
-                existing.vendorId = slave.vendorId;
-            }
-            if (existing.productCode == 0U && slave.productCode != 0U) {
-                existing.productCode = slave.productCode;
-            }
-            if (existing.alias == 0U && slave.alias != 0U) {
-                existing.alias = slave.alias;
-            }
-            if (existing.position == 0U && slave.position != 0U) {
-                existing.position = slave.position;
-            }
-        };
-
-        for (const auto& tag : extractTags(xml, "Device")) {
-            const auto slave = parseSlaveTag(tag);
-            if (slave) {
-                mergeIntoCatalog(*slave);
-            }
+        if (existing.alias == 0U && slave.alias != 0U) {
+            existing.alias = slave.alias;
         }
-        for (const auto& tag : extractTags(xml, "Slave")) {
-            const auto slave = parseSlaveTag(tag);
-            if (slave) {
-                mergeIntoCatalog(*slave);
-            }
+        if (existing.position == 0U && slave.position != 0U) {
+            existing.position = slave.position;
         }
     }
 
@@ -235,6 +411,20 @@ void mergeEsiInfo(NetworkConfiguration& config,
     }
 }
 
+bool rejectInvalid(const NetworkConfiguration& config, std::string& outError) {
+    const auto issues = ConfigurationValidator::validate(config);
+    if (!ConfigurationValidator::hasErrors(issues)) {
+        return false;
+    }
+    outError = "Configuration validation failed:";
+    for (const auto& issue : issues) {
+        if (issue.severity == ValidationSeverity::Error) {
+            outError += " " + issue.message + ";";
+        }
+    }
+    return true;
+}
+
 } // namespace
 
 bool ConfigurationLoader::loadFromEniFile(const std::string& eniPath,
@@ -243,23 +433,11 @@ bool ConfigurationLoader::loadFromEniFile(const std::string& eniPath,
     outConfig = NetworkConfiguration{};
     outError.clear();
 
-    std::string xml;
-    if (!readFile(eniPath, xml, outError)) {
-        return false;
-    }
-
-    if (!parseEniXml(xml, outConfig, outError)) {
+    if (!parseEniFile(eniPath, outConfig, outError)) {
         return false;
     }
 
-    const auto issues = ConfigurationValidator::validate(outConfig);
-    if (ConfigurationValidator::hasErrors(issues)) {
-        outError = "Configuration validation failed:";
-        for (const auto& issue : issues) {
-            if (issue.severity == ValidationSeverity::Error) {
-                outError += " " + issue.message + ";";
-            }
-        }
+    if (rejectInvalid(outConfig, outError)) {
         return false;
     }
     return true;
@@ -268,25 +446,29 @@ bool ConfigurationLoader::loadFromEniFile(const std::string& eniPath,
 bool ConfigurationLoader::loadFromEniAndEsiDirectory(const std::string& eniPath,
                                                      const std::string& esiDirectory,
                                                      NetworkConfiguration& outConfig,
-                                                     std::string& outError) {
+                                                     std::string& outError,
+                                                     std::vector<std::string>* outWarnings) {
     if (!loadFromEniFile(eniPath, outConfig, outError)) {
         return false;
     }
 
-    auto catalog = loadEsiCatalog(esiDirectory, outError);
+    std::vector<std::string> skipped;
+    auto catalog = loadEsiCatalog(esiDirectory, skipped, outError);
     if (!outError.empty()) {
         return false;
     }
+    if (outWarnings != nullptr) {
+        for (const auto& file : skipped) {
+            outWarnings->push_back("Skipped malformed ESI file " + file);
+        }
+    }
 
     mergeEsiInfo(outConfig, catalog);
 
-    const auto issues = ConfigurationValidator::validate(outConfig);
-    if (ConfigurationValidator::hasErrors(issues)) {
-        outError = "Configuration validation failed:";
-        for (const auto& issue : issues) {
-            if (issue.severity == ValidationSeverity::Error) {
-                outError += " " + issue.message + ";";
-            }
+    if (rejectInvalid(outConfig, outError)) {
+        // The missing data may have been in a file that did not parse.
+        for (const auto& file : skipped) {
+            outError += " skipped ESI file " + file + ";";
         }
         return false;
     }
@@ -294,4 +476,37 @@ bool ConfigurationLoader::loadFromEniAndEsiDirectory(const std::string& eniPath,
     return true;
 }
 
+bool ConfigurationLoader::loadEsiFile(const std::string& esiPath,
+                                      std::vector<EsiDeviceDescription>& outDevices,
+                                      std::string& outError) {
+    return parseEsiStream(esiPath, 0U, false, outDevices, outError);
+}
+
+bool ConfigurationLoader::loadEsiDeviceAt(const std::string& esiPath,
+                                          std::uint64_t byteOffset,
+                                          EsiDeviceDescription& outDevice,
+                                          std::string& outError) {
+    std::vector<EsiDeviceDescription> devices;
+    if (!parseEsiStream(esiPath, byteOffset, true, devices, outError)) {
+        return false;
+    }
+    if (devices.empty()) {
+        outError = esiPath + ": no ESI device at offset " + std::to_string(byteOffset);
+        return false;
+    }
+    outDevice = std::move(devices.front());
+    outDevice.sourceOffset += byteOffset;
+    return true;
+}
+
+bool ConfigurationLoader::loadFromBinaryFile(const std::string& imagePath,
+                                             NetworkConfiguration& outConfig,
+                                             std::string& outError) {
+    outError.clear();
+    if (!BinaryConfiguration::loadFromFile(imagePath, outConfig, outError)) {
+        return false;
+    }
+    return !rejectInvalid(outConfig, outError);
+}
+
 } // namespace oec
@@ -5,19 +5,40 @@
 
 #include "openethercat/config/eni_esi_models.hpp"
 
-#include <regex>
+#include <stdexcept>
+
+#include "openethercat/config/xml_stream_parser.hpp"
 
 namespace oec {
 namespace {
 
-std::optional<std::string> attr(const std::string& xml, const std::string& key) {
-    const auto pattern = key + "\\s*=\\s*\"([^\"]+)\"";
-    std::regex re(pattern);
-    std::smatch match;
-    if (!std::regex_search(xml, match, re) || match.size() < 2) {
-        return std::nullopt;
+// Attributes of the first element in an ENI/ESI fragment (fragments need not be closed).
+std::vector<XmlAttribute> firstElementAttributes(const std::string& xml) {
+    class FirstElement final : public XmlStreamParser::Handler {
+    public:
+        void onStartElement(const std::string& name, const std::vector<XmlAttribute>& attributes) override {
+            (void)name;
+            if (!seen) {
+                seen = true;
+                captured = attributes;
+            }
+        }
+        void onEndElement(const std::string& name) override { (void)name; }
+
+        bool seen = false;
+        std::vector<XmlAttribute> captured;
+    };
+    FirstElement handler;
+    XmlStreamParser parser(handler);
+    (void)parser.feed(xml.data(), xml.size());
+    return handler.captured;
+}
+
+std::optional<std::string> attr(const std::vector<XmlAttribute>& attributes, const char* key) {
+    if (const auto* value = XmlStreamParser::findAttribute(attributes, key)) {
+        return *value;
     }
-    return match[1].str();
+    return std::nullopt;
 }
 
 std::uint32_t parseUnsigned(const std::string& value) {
@@ -34,11 +55,12 @@ std::uint32_t parseUnsigned(const std::string& value) {
 std::optional<SlaveIdentity> EniEsiParser::parseSlaveIdentityFromXml(const std::string& xml) {
     try {
         SlaveIdentity slave;
-        const auto name = attr(xml, "name");
-        const auto alias = attr(xml, "alias");
-        const auto position = attr(xml, "position");
-        const auto vendor = attr(xml, "vendorId");
-        const auto product = attr(xml, "productCode");
+        const auto attributes = firstElementAttributes(xml);
+        const auto name = attr(attributes, "name");
+        const auto alias = attr(attributes, "alias");
+        const auto position = attr(attributes, "position");
+        const auto vendor = attr(attributes, "vendorId");
+        const auto product = attr(attributes, "productCode");
 
         if (!name || !alias || !position || !vendor || !product) {
             return std::nullopt;
@@ -59,11 +81,12 @@ std::optional<SlaveIdentity> EniEsiParser::parseSlaveIdentityFromXml(const std::
 std::optional<SignalBinding> EniEsiParser::parseSignalBindingFromXml(const std::string& xml) {
     try {
         SignalBinding binding;
-        const auto logical = attr(xml, "logicalName");
-        const auto direction = attr(xml, "direction");
-        const auto slave = attr(xml, "slaveName");
-        const auto byteOffset = attr(xml, "byteOffset");
-        const auto bitOffset = attr(xml, "bitOffset");
+        const auto attributes = firstElementAttributes(xml);
+        const auto logical = attr(attributes, "logicalName");
+        const auto direction = attr(attributes, "direction");
+        const auto slave = attr(attributes, "slaveName");
+        const auto byteOffset = attr(attributes, "byteOffset");
+        const auto bitOffset = attr(attributes, "bitOffset");
 
         if (!logical || !direction || !slave || !byteOffset || !bitOffset) {
             return std::nullopt;
@@ -0,0 +1,437 @@
+/**
+ * @file esi_catalog_index.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/config/esi_catalog_index.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <thread>
+
+#include "openethercat/config/config_loader.hpp"
+
+namespace oec {
+namespace {
+
+constexpr std::uint8_t kMagic[4] = {'O', 'E', 'C', 'I'};
+constexpr std::uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t kFnvPrime = 0x100000001b3ULL;
+
+std::uint64_t fnv1a(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t hash = kFnvOffset;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+class Writer {
+public:
+    void put(std::uint64_t value, std::size_t width) {
+        for (std::size_t i = 0; i < width; ++i) {
+            bytes.push_back(static_cast<std::uint8_t>((value >> (8U * i)) & 0xFFU));
+        }
+    }
+    void putString(const std::string& text) {
+        put(text.size(), 4U);
+        bytes.insert(bytes.end(), text.begin(), text.end());
+    }
+    std::vector<std::uint8_t> bytes;
+};
+
+class Reader {
+public:
+    Reader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+    bool get(std::uint64_t& value, std::size_t width) {
+        if (size_ - pos_ < width) {
+            return false;
+        }
+        value = 0U;
+        for (std::size_t i = 0; i < width; ++i) {
+            value |= static_cast<std::uint64_t>(data_[pos_ + i]) << (8U * i);
+        }
+        pos_ += width;
+        return true;
+    }
+    bool getString(std::string& text) {
+        std::uint64_t length = 0U;
+        if (!get(length, 4U) || size_ - pos_ < length) {
+            return false;
+        }
+        text.assign(reinterpret_cast<const char*>(data_ + pos_), static_cast<std::size_t>(length));
+        pos_ += static_cast<std::size_t>(length);
+        return true;
+    }
+    bool atEnd() const { return pos_ == size_; }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0U;
+};
+
+struct FileStamp {
+    std::uint64_t size = 0;
+    std::int64_t mtimeNs = 0;
+};
+
+bool stampFile(const std::filesystem::path& path, FileStamp& out) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    out.size = static_cast<std::uint64_t>(size);
+    out.mtimeNs = static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count());
+    return true;
+}
+
+} // namespace
+
+bool EsiCatalogIndex::IdentityKey::operator==(const IdentityKey& other) const {
+    return vendorId == other.vendorId && productCode == other.productCode && revision == other.revision;
+}
+
+std::size_t EsiCatalogIndex::IdentityKeyHash::operator()(const IdentityKey& key) const {
+    const auto high = (static_cast<std::uint64_t>(key.vendorId) << 32U) | key.productCode;
+    return std::hash<std::uint64_t>{}(high * kFnvPrime ^ key.revision);
+}
+
+bool EsiCatalogIndex::build(const std::string& directory, std::string& outError, std::size_t threads) {
+    namespace fs = std::filesystem;
+    outError.clear();
+    stats_ = Stats{};
+    fileErrors_.clear();
+
+    std::error_code ec;
+    if (!fs::exists(directory, ec)) {
+        outError = "ESI directory does not exist: " + directory;
+        return false;
+    }
+    std::vector<fs::path> files;
+    for (const auto& item : fs::directory_iterator(directory, ec)) {
+        if (ec) {
+            break;
+        }
+        if (item.is_regular_file() && item.path().extension() == ".xml") {
+            files.push_back(item.path());
+        }
+    }
+    if (ec) {
+        outError = "Failed to enumerate ESI directory: " + ec.message();
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+    stats_.filesScanned = files.size();
+
+    // Cached entries grouped by file; reused when size and mtime still match.
+    std::map<std::string, std::vector<Entry>> cached;
+    for (auto& entry : entries_) {
+        cached[entry.filePath].push_back(std::move(entry));
+    }
+    std::map<std::string, FileStamp> cachedEmpty;
+    for (const auto& file : emptyFiles_) {
+        cachedEmpty[file.filePath] = FileStamp{file.fileSize, file.fileMtimeNs};
+    }
+
+    struct FileWork {
+        std::string path;
+        FileStamp stamp;
+        std::vector<Entry> entries;
+        std::string error;
+    };
+    std::vector<FileWork> work(files.size());
+    std::vector<std::size_t> toParse;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        auto& item = work[i];
+        item.path = files[i].string();
+        if (!stampFile(files[i], item.stamp)) {
+            outError = "Cannot stat ESI file: " + item.path;
+            entries_.clear();
+            emptyFiles_.clear();
+            rebuildLookups();
+            return false;
+        }
+        const auto it = cached.find(item.path);
+        const auto empty = cachedEmpty.find(item.path);
+        if (it != cached.end() && !it->second.empty() && it->second.front().fileSize == item.stamp.size &&
+            it->second.front().fileMtimeNs == item.stamp.mtimeNs) {
+            item.entries = std::move(it->second);
+            ++stats_.filesReused;
+        } else if (empty != cachedEmpty.end() && empty->second.size == item.stamp.size &&
+                   empty->second.mtimeNs == item.stamp.mtimeNs) {
+            ++stats_.filesReused;
+        } else {
+            toParse.push_back(i);
+        }
+    }
+
+    auto parseOne = [&work](std::size_t index) {
+        auto& item = work[index];
+        std::vector<EsiDeviceDescription> devices;
+        if (!ConfigurationLoader::loadEsiFile(item.path, devices, item.error)) {
+            return;
+        }
+        item.entries.reserve(devices.size());
+        for (auto& device : devices) {
+            Entry entry;
+            entry.filePath = item.path;
+            entry.byteOffset = device.sourceOffset;
+            entry.fileSize = item.stamp.size;
+            entry.fileMtimeNs = item.stamp.mtimeNs;
+            entry.identity = std::move(device.identity);
+            entry.revision = device.revision;
+            item.entries.push_back(std::move(entry));
+        }
+    };
+
+    std::size_t workers = (threads != 0U) ? threads : std::max(1U, std::thread::hardware_concurrency());
+    workers = std::min(workers, toParse.size());
+    stats_.threads = workers;
+    if (workers <= 1U) {
+        for (const auto index : toParse) {
+            parseOne(index);
+        }
+    } else {
+        std::atomic<std::size_t> next{0U};
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (std::size_t t = 0; t < workers; ++t) {
+            pool.emplace_back([&]() {
+                for (auto i = next.fetch_add(1U); i < toParse.size(); i = next.fetch_add(1U)) {
+                    parseOne(toParse[i]);
+                }
+            });
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+    stats_.filesParsed = toParse.size();
+
+    // A malformed file costs only its own devices; the rest of the catalog stays usable.
+    entries_.clear();
+    emptyFiles_.clear();
+    for (auto& item : work) {
+        if (!item.error.empty()) {
+            fileErrors_.push_back(FileError{item.path, std::move(item.error)});
+            continue;
+        }
+        if (item.entries.empty()) {
+            emptyFiles_.push_back(EmptyFile{item.path, item.stamp.size, item.stamp.mtimeNs});
+            continue;
+        }
+        for (auto& entry : item.entries) {
+            entries_.push_back(std::move(entry));
+        }
+    }
+    stats_.filesFailed = fileErrors_.size();
+    stats_.devices = entries_.size();
+    rebuildLookups();
+    return true;
+}
+
+void EsiCatalogIndex::rebuildLookups() {
+    byIdentity_.clear();
+    latestByProduct_.clear();
+    byName_.clear();
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        const auto& entry = entries_[i];
+        const IdentityKey key{entry.identity.vendorId, entry.identity.productCode, entry.revision};
+        byIdentity_.emplace(key, i);
+        const auto product = (static_cast<std::uint64_t>(entry.identity.vendorId) << 32U) | entry.identity.productCode;
+        const auto latest = latestByProduct_.find(product);
+        if (latest == latestByProduct_.end()) {
+            latestByProduct_.emplace(product, i);
+        } else if (entries_[latest->second].revision < entry.revision) {
+            latest->second = i;
+        }
+        byName_.emplace(entry.identity.name, i);
+    }
+}
+
+bool EsiCatalogIndex::loadCache(const std::string& path, std::string& outError) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        outError = "Cannot open file: " + path;
+        return false;
+    }
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 16U || !std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin())) {
+        outError = "ESI index cache has bad magic";
+        return false;
+    }
+    const auto payloadBytes = bytes.size() - 8U;
+    Reader trailer(bytes.data() + payloadBytes, 8U);
+    std::uint64_t checksum = 0U;
+    trailer.get(checksum, 8U);
+    if (checksum != fnv1a(bytes.data(), payloadBytes)) {
+        outError = "ESI index cache checksum mismatch";
+        return false;
+    }
+
+    Reader in(bytes.data() + 4U, payloadBytes - 4U);
+    std::uint64_t version = 0U;
+    std::uint64_t count = 0U;
+    if (!in.get(version, 4U) || version != kCacheVersion || !in.get(count, 4U)) {
+        outError = "ESI index cache version mismatch";
+        return false;
+    }
+    std::vector<Entry> loaded;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        Entry entry;
+        std::uint64_t offset = 0U;
+        std::uint64_t size = 0U;
+        std::uint64_t mtime = 0U;
+        std::uint64_t alias = 0U;
+        std::uint64_t position = 0U;
+        std::uint64_t vendor = 0U;
+        std::uint64_t product = 0U;
+        std::uint64_t revision = 0U;
+        if (!in.getString(entry.filePath) || !in.get(offset, 8U) || !in.get(size, 8U) || !in.get(mtime, 8U) ||
+            !in.getString(entry.identity.name) || !in.get(alias, 2U) || !in.get(position, 2U) ||
+            !in.get(vendor, 4U) || !in.get(product, 4U) || !in.get(revision, 4U)) {
+            outError = "ESI index cache truncated";
+            return false;
+        }
+        entry.byteOffset = offset;
+        entry.fileSize = size;
+        entry.fileMtimeNs = static_cast<std::int64_t>(mtime);
+        entry.identity.alias = static_cast<std::uint16_t>(alias);
+        entry.identity.position = static_cast<std::uint16_t>(position);
+        entry.identity.vendorId = static_cast<std::uint32_t>(vendor);
+        entry.identity.productCode = static_cast<std::uint32_t>(product);
+        entry.revision = static_cast<std::uint32_t>(revision);
+        loaded.push_back(std::move(entry));
+    }
+    std::vector<EmptyFile> loadedEmpty;
+    if (!in.get(count, 4U)) {
+        outError = "ESI index cache truncated";
+        return false;
+    }
+    for (std::uint64_t i = 0; i < count; ++i) {
+        EmptyFile file;
+        std::uint64_t mtime = 0U;
+        if (!in.getString(file.filePath) || !in.get(file.fileSize, 8U) || !in.get(mtime, 8U)) {
+            outError = "ESI index cache truncated";
+            return false;
+        }
+        file.fileMtimeNs = static_cast<std::int64_t>(mtime);
+        loadedEmpty.push_back(std::move(file));
+    }
+    if (!in.atEnd()) {
+        outError = "ESI index cache truncated";
+        return false;
+    }
+    entries_ = std::move(loaded);
+    emptyFiles_ = std::move(loadedEmpty);
+    rebuildLookups();
+    return true;
+}
+
+bool EsiCatalogIndex::saveCache(const std::string& path, std::string& outError) const {
+    outError.clear();
+    Writer out;
+    out.bytes.assign(std::begin(kMagic), std::end(kMagic));
+    out.put(kCacheVersion, 4U);
+    out.put(entries_.size(), 4U);
+    for (const auto& entry : entries_) {
+        out.putString(entry.filePath);
+        out.put(entry.byteOffset, 8U);
+        out.put(entry.fileSize, 8U);
+        out.put(static_cast<std::uint64_t>(entry.fileMtimeNs), 8U);
+        out.putString(entry.identity.name);
+        out.put(entry.identity.alias, 2U);
+        out.put(entry.identity.position, 2U);
+        out.put(entry.identity.vendorId, 4U);
+        out.put(entry.identity.productCode, 4U);
+        out.put(entry.revision, 4U);
+    }
+    out.put(emptyFiles_.size(), 4U);
+    for (const auto& file : emptyFiles_) {
+        out.putString(file.filePath);
+        out.put(file.fileSize, 8U);
+        out.put(static_cast<std::uint64_t>(file.fileMtimeNs), 8U);
+    }
+    out.put(fnv1a(out.bytes.data(), out.bytes.size()), 8U);
+
+    const auto tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            outError = "Cannot open file: " + tmpPath;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(out.bytes.data()), static_cast<std::streamsize>(out.bytes.size()));
+        if (!file) {
+            outError = "Failed writing file: " + tmpPath;
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        outError = "Failed to replace file: " + path;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+const EsiCatalogIndex::Entry* EsiCatalogIndex::find(std::uint32_t vendorId, std::uint32_t productCode,
+                                                    std::uint32_t revision) const {
+    const auto it = byIdentity_.find(IdentityKey{vendorId, productCode, revision});
+    return (it != byIdentity_.end()) ? &entries_[it->second] : nullptr;
+}
+
+const EsiCatalogIndex::Entry* EsiCatalogIndex::findLatest(std::uint32_t vendorId, std::uint32_t productCode) const {
+    const auto it = latestByProduct_.find((static_cast<std::uint64_t>(vendorId) << 32U) | productCode);
+    return (it != latestByProduct_.end()) ? &entries_[it->second] : nullptr;
+}
+
+const EsiCatalogIndex::Entry* EsiCatalogIndex::findByName(const std::string& name) const {
+    const auto it = byName_.find(name);
+    return (it != byName_.end()) ? &entries_[it->second] : nullptr;
+}
+
+bool EsiCatalogIndex::loadDevice(const Entry& entry, EsiDeviceDescription& outDevice, std::string& outError) {
+    FileStamp stamp;
+    if (!stampFile(entry.filePath, stamp) || stamp.size != entry.fileSize || stamp.mtimeNs != entry.fileMtimeNs) {
+        outError = "ESI file changed since indexing: " + entry.filePath;
+        return false;
+    }
+    if (!ConfigurationLoader::loadEsiDeviceAt(entry.filePath, entry.byteOffset, outDevice, outError)) {
+        return false;
+    }
+    // File-level Vendor/Id lives outside the device element.
+    if (outDevice.identity.vendorId == 0U) {
+        outDevice.identity.vendorId = entry.identity.vendorId;
+    }
+    return true;
+}
+
+const std::vector<EsiCatalogIndex::Entry>& EsiCatalogIndex::entries() const {
+    return entries_;
+}
+
+const EsiCatalogIndex::Stats& EsiCatalogIndex::stats() const {
+    return stats_;
+}
+
+const std::vector<EsiCatalogIndex::FileError>& EsiCatalogIndex::fileErrors() const {
+    return fileErrors_;
+}
+
+} // namespace oec
@@ -0,0 +1,433 @@
+/**
+ * @file xml_stream_parser.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/config/xml_stream_parser.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+
+namespace oec {
+namespace {
+
+constexpr std::size_t kMaxEntityBytes = 12U;
+constexpr std::size_t kMaxDepth = 256U;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool isNameChar(char c) {
+    return !isSpace(c) && c != '=' && c != '>' && c != '/' && c != '"' && c != '\'';
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+void appendUtf8(std::string& out, std::uint32_t cp) {
+    if (cp < 0x80U) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800U) {
+        out.push_back(static_cast<char>(0xC0U | (cp >> 6U)));
+        out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+    } else if (cp < 0x10000U) {
+        out.push_back(static_cast<char>(0xE0U | (cp >> 12U)));
+        out.push_back(static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU)));
+        out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+    } else {
+        out.push_back(static_cast<char>(0xF0U | (cp >> 18U)));
+        out.push_back(static_cast<char>(0x80U | ((cp >> 12U) & 0x3FU)));
+        out.push_back(static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU)));
+        out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+    }
+}
+
+// Decodes predefined and numeric entities; unknown entities are kept verbatim.
+std::string decodeEntities(std::string_view raw) {
+    std::string out;
+    out.reserve(raw.size());
+    std::size_t i = 0;
+    while (i < raw.size()) {
+        if (raw[i] != '&') {
+            out.push_back(raw[i++]);
+            continue;
+        }
+        const auto semi = raw.find(';', i);
+        if (semi == std::string_view::npos || semi - i > kMaxEntityBytes) {
+            out.push_back(raw[i++]);
+            continue;
+        }
+        const auto entity = raw.substr(i + 1U, semi - i - 1U);
+        if (entity == "lt") {
+            out.push_back('<');
+        } else if (entity == "gt") {
+            out.push_back('>');
+        } else if (entity == "amp") {
+            out.push_back('&');
+        } else if (entity == "quot") {
+            out.push_back('"');
+        } else if (entity == "apos") {
+            out.push_back('\'');
+        } else if (!entity.empty() && entity[0] == '#') {
+            const bool hex = entity.size() > 1U && (entity[1] == 'x' || entity[1] == 'X');
+            std::uint32_t cp = 0;
+            bool valid = entity.size() > (hex ? 2U : 1U);
+            for (std::size_t k = hex ? 2U : 1U; valid && k < entity.size(); ++k) {
+                const char c = entity[k];
+                std::uint32_t digit = 0;
+                if (c >= '0' && c <= '9') {
+                    digit = static_cast<std::uint32_t>(c - '0');
+                } else if (hex && c >= 'a' && c <= 'f') {
+                    digit = static_cast<std::uint32_t>(c - 'a' + 10);
+                } else if (hex && c >= 'A' && c <= 'F') {
+                    digit = static_cast<std::uint32_t>(c - 'A' + 10);
+                } else {
+                    valid = false;
+                }
+                cp = (cp * (hex ? 16U : 10U)) + digit;
+                valid = valid && cp <= 0x10FFFFU;
+            }
+            if (!valid) {
+                out.append(raw.substr(i, semi - i + 1U));
+            } else {
+                appendUtf8(out, cp);
+            }
+        } else {
+            out.append(raw.substr(i, semi - i + 1U));
+        }
+        i = semi + 1U;
+    }
+    return out;
+}
+
+} // namespace
+
+XmlStreamParser::XmlStreamParser(Handler& handler, std::size_t maxTokenBytes)
+    : handler_(handler), maxTokenBytes_(maxTokenBytes) {}
+
+const std::string& XmlStreamParser::error() const {
+    return error_;
+}
+
+std::size_t XmlStreamParser::peakBufferBytes() const {
+    return peakBufferBytes_;
+}
+
+bool XmlStreamParser::fail(std::string message) {
+    failed_ = true;
+    error_ = std::move(message);
+    return false;
+}
+
+bool XmlStreamParser::equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const auto lower = [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; };
+        if (lower(a[i]) != lower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const std::string* XmlStreamParser::findAttribute(const std::vector<XmlAttribute>& attributes,
+                                                  std::string_view name) {
+    for (const auto& a : attributes) {
+        if (equalsIgnoreCase(a.name, name)) {
+            return &a.value;
+        }
+    }
+    return nullptr;
+}
+
+bool XmlStreamParser::findMarkupEnd(std::size_t begin, std::size_t& outEnd, bool& outIncomplete) const {
+    outIncomplete = false;
+    const std::string_view rest(buffer_.data() + begin, buffer_.size() - begin);
+    auto closeAfter = [&](std::string_view terminator, std::size_t from) {
+        const auto at = rest.find(terminator, from);
+        if (at == std::string_view::npos) {
+            outIncomplete = true;
+            return false;
+        }
+        outEnd = begin + at + terminator.size() - 1U;
+        return true;
+    };
+
+    if (rest.size() > 1U && rest[1] == '!') {
+        // Need enough bytes to tell comment, CDATA and declarations apart.
+        if (rest.size() < 9U && !finished_) {
+            outIncomplete = true;
+            return false;
+        }
+        if (startsWith(rest, "<!--")) {
+            return closeAfter("-->", 4U);
+        }
+        if (startsWith(rest, "<![CDATA[")) {
+            return closeAfter("]]>", 9U);
+        }
+        // DOCTYPE and friends: skip to '>' outside quotes and internal subset.
+        int bracketDepth = 0;
+        char quote = 0;
+        for (std::size_t i = 2; i < rest.size(); ++i) {
+            const char c = rest[i];
+            if (quote != 0) {
+                quote = (c == quote) ? 0 : quote;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '[') {
+                ++bracketDepth;
+            } else if (c == ']') {
+                --bracketDepth;
+            } else if (c == '>' && bracketDepth <= 0) {
+                outEnd = begin + i;
+                return true;
+            }
+        }
+        outIncomplete = true;
+        return false;
+    }
+    if (rest.size() > 1U && rest[1] == '?') {
+        return closeAfter("?>", 2U);
+    }
+    char quote = 0;
+    for (std::size_t i = 1; i < rest.size(); ++i) {
+        const char c = rest[i];
+        if (quote != 0) {
+            quote = (c == quote) ? 0 : quote;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            outEnd = begin + i;
+            return true;
+        }
+    }
+    outIncomplete = true;
+    return false;
+}
+
+bool XmlStreamParser::handleStartTag(std::string_view markup) {
+    // markup excludes '<' and '>'.
+    bool selfClosing = false;
+    if (!markup.empty() && markup.back() == '/') {
+        selfClosing = true;
+        markup.remove_suffix(1U);
+    }
+    std::size_t i = 0;
+    while (i < markup.size() && isNameChar(markup[i])) {
+        ++i;
+    }
+    if (i == 0U) {
+        return fail("XML element without name");
+    }
+    std::string name(markup.substr(0, i));
+
+    attributes_.clear();
+    while (i < markup.size()) {
+        while (i < markup.size() && isSpace(markup[i])) {
+            ++i;
+        }
+        if (i >= markup.size()) {
+            break;
+        }
+        const auto nameBegin = i;
+        while (i < markup.size() && isNameChar(markup[i])) {
+            ++i;
+        }
+        if (i == nameBegin) {
+            return fail("malformed attribute in <" + name + ">");
+        }
+        XmlAttribute attribute;
+        attribute.name.assign(markup.substr(nameBegin, i - nameBegin));
+        while (i < markup.size() && isSpace(markup[i])) {
+            ++i;
+        }
+        if (i >= markup.size() || markup[i] != '=') {
+            return fail("attribute '" + attribute.name + "' without value in <" + name + ">");
+        }
+        ++i;
+        while (i < markup.size() && isSpace(markup[i])) {
+            ++i;
+        }
+        if (i >= markup.size() || (markup[i] != '"' && markup[i] != '\'')) {
+            return fail("unquoted attribute '" + attribute.name + "' in <" + name + ">");
+        }
+        const char quote = markup[i++];
+        const auto valueEnd = markup.find(quote, i);
+        if (valueEnd == std::string_view::npos) {
+            return fail("unterminated attribute '" + attribute.name + "' in <" + name + ">");
+        }
+        attribute.value = decodeEntities(markup.substr(i, valueEnd - i));
+        attributes_.push_back(std::move(attribute));
+        i = valueEnd + 1U;
+    }
+
+    handler_.onStartElement(name, attributes_);
+    if (selfClosing) {
+        handler_.onEndElement(name);
+        return true;
+    }
+    if (openElements_.size() >= kMaxDepth) {
+        return fail("XML nesting deeper than supported");
+    }
+    openElements_.push_back(std::move(name));
+    return true;
+}
+
+bool XmlStreamParser::handleMarkup(std::string_view markup) {
+    // markup spans '<' .. '>' inclusive.
+    if (startsWith(markup, "<!--") || startsWith(markup, "<?")) {
+        return true;
+    }
+    if (startsWith(markup, "<![CDATA[")) {
+        handler_.onText(markup.substr(9U, markup.size() - 12U));
+        return true;
+    }
+    if (startsWith(markup, "<!")) {
+        return true;
+    }
+    if (startsWith(markup, "</")) {
+        auto name = markup.substr(2U, markup.size() - 3U);
+        while (!name.empty() && isSpace(name.back())) {
+            name.remove_suffix(1U);
+        }
+        if (openElements_.empty() || openElements_.back() != name) {
+            return fail("mismatched closing tag </" + std::string(name) + ">");
+        }
+        handler_.onEndElement(openElements_.back());
+        openElements_.pop_back();
+        return true;
+    }
+    return handleStartTag(markup.substr(1U, markup.size() - 2U));
+}
+
+bool XmlStreamParser::feed(const char* data, std::size_t size) {
+    if (failed_) {
+        return false;
+    }
+    if (stopped_) {
+        return true;
+    }
+    buffer_.append(data, size);
+    peakBufferBytes_ = std::max(peakBufferBytes_, buffer_.size());
+
+    std::size_t pos = 0;
+    while (pos < buffer_.size() && !stopped_) {
+        if (buffer_[pos] != '<') {
+            auto end = buffer_.find('<', pos);
+            if (end == std::string::npos) {
+                end = buffer_.size();
+                // Hold back a possibly split trailing entity until more input arrives.
+                const auto amp = buffer_.rfind('&', end - 1U);
+                if (!finished_ && amp != std::string::npos && amp >= pos &&
+                    buffer_.find(';', amp) == std::string::npos && end - amp <= kMaxEntityBytes) {
+                    end = amp;
+                }
+                if (end == pos) {
+                    break;
+                }
+            }
+            const auto text = decodeEntities(std::string_view(buffer_.data() + pos, end - pos));
+            handler_.onText(text);
+            pos = end;
+            continue;
+        }
+        std::size_t end = 0;
+        bool incomplete = false;
+        if (!findMarkupEnd(pos, end, incomplete)) {
+            break;
+        }
+        markupOffset_ = consumedBytes_ + pos;
+        if (!handleMarkup(std::string_view(buffer_.data() + pos, end - pos + 1U))) {
+            return false;
+        }
+        pos = end + 1U;
+    }
+    buffer_.erase(0, pos);
+    consumedBytes_ += pos;
+    if (stopped_) {
+        buffer_.clear();
+        return true;
+    }
+    if (buffer_.size() > maxTokenBytes_) {
+        return fail("XML token exceeds " + std::to_string(maxTokenBytes_) + " bytes");
+    }
+    return true;
+}
+
+bool XmlStreamParser::finish() {
+    if (failed_) {
+        return false;
+    }
+    finished_ = true;
+    if (!feed("", 0U)) {
+        return false;
+    }
+    if (stopped_) {
+        return true;
+    }
+    if (!buffer_.empty()) {
+        return fail("unexpected end of XML inside markup");
+    }
+    if (!openElements_.empty()) {
+        return fail("unclosed element <" + openElements_.back() + ">");
+    }
+    return true;
+}
+
+void XmlStreamParser::stop() {
+    stopped_ = true;
+}
+
+bool XmlStreamParser::stopped() const {
+    return stopped_;
+}
+
+std::uint64_t XmlStreamParser::markupOffset() const {
+    return markupOffset_;
+}
+
+bool XmlStreamParser::feedStream(std::istream& in, std::size_t chunkBytes) {
+    std::vector<char> chunk(std::max<std::size_t>(chunkBytes, 1U));
+    while (in && !stopped_) {
+        in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        const auto got = static_cast<std::size_t>(in.gcount());
+        if (got == 0U) {
+            break;
+        }
+        if (!feed(chunk.data(), got)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool XmlStreamParser::parseFile(const std::string& path, Handler& handler, std::string& outError,
+                                std::size_t chunkBytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        outError = "Cannot open file: " + path;
+        return false;
+    }
+    XmlStreamParser parser(handler);
+    if (!parser.feedStream(file, chunkBytes) || !parser.finish()) {
+        outError = path + ": " + parser.error();
+        return false;
+    }
+    return true;
+}
+
+bool XmlStreamParser::parseString(std::string_view xml, Handler& handler, std::string& outError) {
+    XmlStreamParser parser(handler, std::max(kDefaultMaxTokenBytes, xml.size()));
+    if (!parser.feed(xml.data(), xml.size()) || !parser.finish()) {
+        outError = parser.error();
+        return false;
+    }
+    return true;
+}
+
+} // namespace oec
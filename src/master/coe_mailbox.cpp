@@ -7,9 +7,27 @@
 
 #include <sstream>
 
+#include "openethercat/master/object_dictionary.hpp"
+#include "openethercat/transport/coe_mailbox_protocol.hpp"
+
 namespace oec {
 
-CoeMailboxService::CoeMailboxService(ITransport& transport) : transport_(transport) {}
+namespace {
+
+constexpr std::uint32_t kAbortSubIndexDoesNotExist = 0x06090011U;
+
+std::uint32_t cacheKey(SdoAddress address) {
+    return (static_cast<std::uint32_t>(address.index) << 8U) | address.subIndex;
+}
+
+} // namespace
+
+CoeMailboxService::CoeMailboxService(ITransport& transport) : transport_(transport) {
+    // Objects whose value cannot change without a device swap or firmware update.
+    for (const std::uint16_t index : {0x1000U, 0x1008U, 0x1009U, 0x100AU, 0x1018U}) {
+        cachePolicies_[index] = SdoCachePolicy::Static;
+    }
+}
 
 SdoResponse CoeMailboxService::upload(std::uint16_t slavePosition, SdoAddress address) const {
     SdoResponse response;
@@ -49,6 +67,189 @@ SdoResponse CoeMailboxService::download(std::uint16_t slavePosition,
     return response;
 }
 
+SdoResponse CoeMailboxService::uploadCached(std::uint16_t slavePosition, SdoAddress address) {
+    if (cachePolicy(address.index) != SdoCachePolicy::Static) {
+        return upload(slavePosition, address);
+    }
+    auto& slave = cache_[slavePosition];
+    const auto it = slave.objects.find(cacheKey(address));
+    if (it != slave.objects.end()) {
+        ++cacheStats_.hits;
+        SdoResponse response;
+        response.success = true;
+        response.data = it->second;
+        return response;
+    }
+    ++cacheStats_.misses;
+    auto response = upload(slavePosition, address);
+    if (response.success) {
+        slave.objects[cacheKey(address)] = response.data;
+    }
+    return response;
+}
+
+void CoeMailboxService::setCachePolicy(std::uint16_t index, SdoCachePolicy policy) {
+    cachePolicies_[index] = policy;
+    if (policy == SdoCachePolicy::Volatile) {
+        for (auto& [position, slave] : cache_) {
+            auto it = slave.objects.lower_bound(static_cast<std::uint32_t>(index) << 8U);
+            while (it != slave.objects.end() && (it->first >> 8U) == index) {
+                it = slave.objects.erase(it);
+            }
+        }
+    }
+}
+
+SdoCachePolicy CoeMailboxService::cachePolicy(std::uint16_t index) const {
+    const auto it = cachePolicies_.find(index);
+    return (it != cachePolicies_.end()) ? it->second : SdoCachePolicy::Volatile;
+}
+
+void CoeMailboxService::noteSlaveState(std::uint16_t slavePosition, SlaveState state) {
+    auto& slave = cache_[slavePosition];
+    if (slave.stateKnown && slave.state != state && !slave.objects.empty()) {
+        slave.objects.clear();
+        ++cacheStats_.invalidations;
+    }
+    slave.stateKnown = true;
+    slave.state = state;
+}
+
+void CoeMailboxService::invalidateCache() {
+    if (!cache_.empty()) {
+        ++cacheStats_.invalidations;
+    }
+    cache_.clear();
+}
+
+void CoeMailboxService::invalidateCache(std::uint16_t slavePosition) {
+    if (cache_.erase(slavePosition) != 0U) {
+        ++cacheStats_.invalidations;
+    }
+}
+
+void CoeMailboxService::invalidateCache(std::uint16_t slavePosition, std::uint16_t index) {
+    const auto slave = cache_.find(slavePosition);
+    if (slave == cache_.end()) {
+        return;
+    }
+    auto& objects = slave->second.objects;
+    auto it = objects.lower_bound(static_cast<std::uint32_t>(index) << 8U);
+    bool erased = false;
+    while (it != objects.end() && (it->first >> 8U) == index) {
+        it = objects.erase(it);
+        erased = true;
+    }
+    if (erased) {
+        ++cacheStats_.invalidations;
+    }
+}
+
+SdoCacheStats CoeMailboxService::cacheStats() const {
+    return cacheStats_;
+}
+
+SdoResponse CoeMailboxService::uploadComplete(std::uint16_t slavePosition, std::uint16_t index,
+                                              bool includeSubIndex0) const {
+    SdoResponse response;
+    std::uint32_t abortCode = 0;
+    std::string error;
+    response.success = transport_.sdoUploadComplete(slavePosition, index, includeSubIndex0, response.data,
+                                                    abortCode, error);
+    if (!response.success) {
+        setFailure(response, abortCode, error, "SDO complete upload failed");
+    }
+    return response;
+}
+
+SdoResponse CoeMailboxService::downloadComplete(std::uint16_t slavePosition,
+                                                std::uint16_t index,
+                                                const std::vector<std::uint8_t>& data,
+                                                bool includeSubIndex0) const {
+    SdoResponse response;
+    std::uint32_t abortCode = 0;
+    std::string error;
+    response.success = transport_.sdoDownloadComplete(slavePosition, index, includeSubIndex0, data, abortCode, error);
+    if (!response.success) {
+        setFailure(response, abortCode, error, "SDO complete download failed");
+    }
+    return response;
+}
+
+void CoeMailboxService::setFailure(SdoResponse& response, std::uint32_t abortCode, const std::string& error,
+                                   const char* fallback) {
+    if (abortCode != 0U) {
+        response.abort = SdoAbort{abortCode, describeAbort(abortCode)};
+    } else {
+        response.abort = SdoAbort{0U, error.empty() ? fallback : error};
+    }
+}
+
+bool CoeMailboxService::readObjectDictionary(std::uint16_t slavePosition, ObjectDictionary& outDictionary,
+                                             std::string& outError) const {
+    outDictionary.objects.clear();
+    outDictionary.complete = true;
+    std::vector<std::uint8_t> data;
+    std::uint32_t abortCode = 0;
+    std::string error;
+    auto failWith = [&](const std::string& what) {
+        outError = what + ": " + (abortCode != 0U ? describeAbort(abortCode) : error);
+        return false;
+    };
+
+    std::vector<std::uint16_t> indices;
+    if (!transport_.sdoInfoExchange(slavePosition,
+                                    CoeMailboxProtocol::buildSdoInfoGetOdListRequest(
+                                        CoeMailboxProtocol::kSdoInfoListAllObjects),
+                                    data, abortCode, error)) {
+        return failWith("SDO information OD list failed");
+    }
+    if (!CoeMailboxProtocol::parseSdoInfoOdList(data, indices)) {
+        outError = "Malformed SDO information OD list";
+        return false;
+    }
+
+    outDictionary.objects.reserve(indices.size());
+    for (const auto index : indices) {
+        CoeObjectDescription object;
+        if (!transport_.sdoInfoExchange(slavePosition,
+                                        CoeMailboxProtocol::buildSdoInfoGetObjectDescriptionRequest(index),
+                                        data, abortCode, error)) {
+            return failWith("SDO information object description failed");
+        }
+        if (!CoeMailboxProtocol::parseSdoInfoObjectDescription(data, object) || object.index != index) {
+            outError = "Malformed SDO information object description";
+            return false;
+        }
+        for (unsigned sub = 0; sub <= object.maxSubIndex; ++sub) {
+            CoeEntryDescription entry;
+            abortCode = 0U;
+            error.clear();
+            if (!transport_.sdoInfoExchange(slavePosition,
+                                            CoeMailboxProtocol::buildSdoInfoGetEntryDescriptionRequest(
+                                                index, static_cast<std::uint8_t>(sub), 0U),
+                                            data, abortCode, error)) {
+                if (abortCode == 0U) {
+                    return failWith("SDO information entry description failed");
+                }
+                // Records may have gaps; a sub-index that does not exist is simply absent.
+                if (abortCode != kAbortSubIndexDoesNotExist) {
+                    outDictionary.complete = false;
+                }
+                continue;
+            }
+            if (!CoeMailboxProtocol::parseSdoInfoEntryDescription(data, entry)) {
+                outDictionary.complete = false;
+                continue;
+            }
+            object.entries.push_back(std::move(entry));
+        }
+        outDictionary.objects.push_back(std::move(object));
+    }
+    outError.clear();
+    return true;
+}
+
 bool CoeMailboxService::configureRxPdo(std::uint16_t slavePosition,
                                        const std::vector<PdoMappingEntry>& entries,
                                        std::string& outError) const {
@@ -65,16 +266,21 @@ bool CoeMailboxService::configureTxPdo(std::uint16_t slavePosition,
 
 std::vector<EmergencyMessage> CoeMailboxService::drainEmergencyQueue(std::size_t maxMessages) const {
     std::vector<EmergencyMessage> messages;
-    messages.reserve(maxMessages);
+    drainEmergencyQueue(maxMessages, messages);
+    return messages;
+}
+
+void CoeMailboxService::drainEmergencyQueue(std::size_t maxMessages,
+                                            std::vector<EmergencyMessage>& outMessages) const {
+    outMessages.clear();
     for (std::size_t i = 0; i < maxMessages; ++i) {
         EmergencyMessage emergency;
         // Poll until queue is empty or caller-imposed limit is reached.
         if (!transport_.pollEmergency(emergency)) {
             break;
         }
-        messages.push_back(emergency);
+        outMessages.push_back(emergency);
     }
-    return messages;
 }
 
 std::string CoeMailboxService::describeAbort(std::uint32_t code) {
@@ -5,17 +5,60 @@
 
 #include "openethercat/master/cycle_controller.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <chrono>
 
 #include "openethercat/master/ethercat_master.hpp"
 
 namespace oec {
 
+DcFollowLoop::DcFollowLoop(std::chrono::nanoseconds period, std::chrono::nanoseconds sync0Shift,
+                           std::chrono::nanoseconds sendLead, double kp, double ki,
+                           std::chrono::nanoseconds maxAdjust)
+    : periodNs_(std::max<std::int64_t>(1, period.count())), kp_(kp), ki_(ki),
+      maxAdjustNs_(static_cast<double>(std::max<std::int64_t>(0, maxAdjust.count()))) {
+    targetPhaseNs_ = (sync0Shift.count() - sendLead.count()) % periodNs_;
+    if (targetPhaseNs_ < 0) {
+        targetPhaseNs_ += periodNs_;
+    }
+}
+
+std::int64_t DcFollowLoop::update(std::int64_t referenceTimeNs) {
+    // Distance from the target phase, wrapped to [-period/2, period/2).
+    auto error = (referenceTimeNs - targetPhaseNs_) % periodNs_;
+    if (error < 0) {
+        error += periodNs_;
+    }
+    if (error >= periodNs_ / 2) {
+        error -= periodNs_;
+    }
+    phaseErrorNs_ = error;
+
+    // Conditional integration: hold the integrator while the output saturates.
+    const auto proportional = kp_ * static_cast<double>(error);
+    const auto candidate = std::clamp(integral_ + ki_ * static_cast<double>(error), -maxAdjustNs_, maxAdjustNs_);
+    if (std::abs(proportional + candidate) <= maxAdjustNs_ || std::abs(candidate) < std::abs(integral_)) {
+        integral_ = candidate;
+    }
+    const auto adjust = std::clamp(proportional + integral_, -maxAdjustNs_, maxAdjustNs_);
+    return static_cast<std::int64_t>(adjust);
+}
+
+void DcFollowLoop::reset() {
+    integral_ = 0.0;
+    phaseErrorNs_ = 0;
+}
+
 CycleController::~CycleController() { stop(); }
 
 bool CycleController::start(EthercatMaster& master,
                             CycleControllerOptions options,
                             CycleReportCallback callback) {
+    if (options.launchOffset.count() > 0 && options.receiveBudget.count() > 0 &&
+        options.launchOffset >= options.receiveBudget) {
+        return false;
+    }
     if (running_.exchange(true)) {
         return false;
     }
@@ -24,12 +67,35 @@ bool CycleController::start(EthercatMaster& master,
         std::uint64_t cycleIndex = 0;
         std::size_t consecutiveFailures = 0;
         auto nextWake = std::chrono::steady_clock::now();
+        DcFollowLoop follow(options.period, options.sync0Shift, options.sendLeadBeforeSync0, options.dcFollowKp,
+                            options.dcFollowKi, options.dcFollowMaxAdjust);
 
         while (running_.load()) {
             const auto start = std::chrono::steady_clock::now();
+            if (options.receiveBudget.count() > 0) {
+                // A late wake-up still gets the full budget rather than an already expired deadline.
+                master.setNextReceiveDeadline(std::max(nextWake, start) + options.receiveBudget);
+            }
+            if (options.launchOffset.count() > 0) {
+                // Fixed grid: a late wake-up must not shift the launch, the transport counts it late instead.
+                master.setNextLaunchTime(nextWake + options.launchOffset);
+            }
             const bool ok = master.runCycle();
             const auto end = std::chrono::steady_clock::now();
 
+            // DC time at this cycle's start, if the frame carried one.
+            std::optional<std::int64_t> referenceAtStart;
+            if (options.followDistributedClock) {
+                if (options.dcReferenceTimeNsProvider) {
+                    referenceAtStart = options.dcReferenceTimeNsProvider();
+                } else if (const auto sample = master.lastDcReferenceSample();
+                           sample.has_value() && sample->hostTime >= start) {
+                    referenceAtStart = sample->referenceTimeNs -
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(sample->hostTime - start)
+                                           .count();
+                }
+            }
+
             if (!ok) {
                 ++consecutiveFailures;
             } else {
@@ -41,6 +107,12 @@ bool CycleController::start(EthercatMaster& master,
             report.success = ok;
             report.workingCounter = master.lastWorkingCounter();
             report.runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+            std::int64_t followAdjustNs = 0;
+            if (referenceAtStart.has_value()) {
+                followAdjustNs = follow.update(*referenceAtStart);
+                report.dcFollowing = true;
+                report.dcPhaseErrorNs = follow.phaseErrorNs();
+            }
             if (callback) {
                 callback(report);
             }
@@ -51,6 +123,7 @@ bool CycleController::start(EthercatMaster& master,
             }
 
             nextWake += options.period;
+            nextWake -= std::chrono::nanoseconds(followAdjustNs);
             if (options.enablePhaseCorrection && options.phaseCorrectionNsProvider) {
                 const auto correction = options.phaseCorrectionNsProvider();
                 if (correction.has_value()) {
@@ -7,16 +7,44 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 
 namespace oec {
 
-DistributedClockController::DistributedClockController() = default;
+namespace {
 
-DistributedClockController::DistributedClockController(Options options) : options_(options) {}
+constexpr int kQ16 = 16;
+// Keeps Q16 values within +-2^46 (about +-1 s) so products stay inside int64.
+constexpr std::int64_t kQ16Limit = std::int64_t{1} << 46;
+
+std::int64_t toQ16Gain(double gain) {
+    return static_cast<std::int64_t>(std::lround(std::clamp(gain, 0.0, 1.0) * 65536.0));
+}
+
+std::int64_t saturateQ16(std::int64_t value) { return std::clamp(value, -kQ16Limit, kQ16Limit); }
+
+std::int64_t mulQ16(std::int64_t valueQ16, std::int64_t gainQ16) {
+    return ((saturateQ16(valueQ16) / 256) * gainQ16) / 256;
+}
+
+std::int64_t roundQ16(std::int64_t valueQ16) {
+    return (valueQ16 >= 0) ? ((valueQ16 + (1 << (kQ16 - 1))) >> kQ16) : -((-valueQ16 + (1 << (kQ16 - 1))) >> kQ16);
+}
+
+} // namespace
+
+DistributedClockController::DistributedClockController() : DistributedClockController(Options{}) {}
+
+DistributedClockController::DistributedClockController(Options options)
+    : options_(options), alphaQ16_(toQ16Gain(options.trackingAlpha)), betaQ16_(toQ16Gain(options.trackingBeta)) {}
 
 std::optional<std::int64_t> DistributedClockController::update(const DcSyncSample& sample) {
     const auto offset = sample.referenceTimeNs - sample.localTimeNs;
-    stats_.lastOffsetNs = offset;
+    if (options_.algorithm == Algorithm::DriftTracking) {
+        stats_.correctionNs = updateDriftTracking(offset);
+        recordStats(offset);
+        return stats_.correctionNs;
+    }
 
     const double filtered =
         (stats_.samples == 0U)
@@ -32,14 +60,44 @@ std::optional<std::int64_t> DistributedClockController::update(const DcSyncSampl
                             static_cast<double>(options_.correctionClampNs));
 
     stats_.correctionNs = static_cast<std::int64_t>(correction);
-    const auto absOffset = static_cast<std::int64_t>(std::llabs(offset));
+    recordStats(offset);
+    return stats_.correctionNs;
+}
+
+std::int64_t DistributedClockController::updateDriftTracking(std::int64_t offsetNs) {
+    // What the offset would be without the correction currently in force.
+    const auto uncorrectedQ16 = saturateQ16((offsetNs + appliedNs_) * (std::int64_t{1} << kQ16));
+    if (stats_.samples == 0U) {
+        offsetEstimateQ16_ = uncorrectedQ16;
+        driftEstimateQ16_ = 0;
+    } else {
+        const auto predictedQ16 = offsetEstimateQ16_ + driftEstimateQ16_;
+        const auto residualQ16 = saturateQ16(uncorrectedQ16 - predictedQ16);
+        offsetEstimateQ16_ = saturateQ16(predictedQ16 + mulQ16(residualQ16, alphaQ16_));
+        const auto driftLimitQ16 = saturateQ16(options_.correctionClampNs * (std::int64_t{1} << kQ16));
+        driftEstimateQ16_ =
+            std::clamp(driftEstimateQ16_ + mulQ16(residualQ16, betaQ16_), -driftLimitQ16, driftLimitQ16);
+    }
+    stats_.filteredOffsetNs = roundQ16(offsetEstimateQ16_) - appliedNs_;
+    stats_.estimatedDriftNs = static_cast<double>(driftEstimateQ16_) / 65536.0;
+
+    // Aim at where the offset will be at the next sample.
+    const auto correction = std::clamp(roundQ16(offsetEstimateQ16_ + driftEstimateQ16_),
+                                       -options_.correctionClampNs, options_.correctionClampNs);
+    appliedNs_ = correction;
+    return correction;
+}
+
+void DistributedClockController::notifyApplied(std::int64_t appliedNs) { appliedNs_ = appliedNs; }
+
+void DistributedClockController::recordStats(std::int64_t offsetNs) {
+    stats_.lastOffsetNs = offsetNs;
+    const auto absOffset = static_cast<std::int64_t>(std::llabs(offsetNs));
     stats_.maxAbsOffsetNs = std::max(stats_.maxAbsOffsetNs, absOffset);
 
-    sumSquares_ += static_cast<double>(offset) * static_cast<double>(offset);
+    sumSquares_ += static_cast<double>(offsetNs) * static_cast<double>(offsetNs);
     ++stats_.samples;
     stats_.jitterRmsNs = std::sqrt(sumSquares_ / static_cast<double>(stats_.samples));
-
-    return stats_.correctionNs;
 }
 
 DcSyncStats DistributedClockController::stats() const noexcept { return stats_; }
@@ -48,6 +106,224 @@ void DistributedClockController::reset() {
     stats_ = DcSyncStats{};
     integral_ = 0.0;
     sumSquares_ = 0.0;
+    offsetEstimateQ16_ = 0;
+    driftEstimateQ16_ = 0;
+    appliedNs_ = 0;
+}
+
+namespace {
+
+// Order in which an ESC forwards a frame through its ports.
+constexpr std::array<std::uint8_t, 4> kPortProcessingOrder = {0U, 3U, 1U, 2U};
+
+std::vector<std::uint8_t> activePortsInOrder(std::uint8_t activePorts) {
+    std::vector<std::uint8_t> ports;
+    for (const auto port : kPortProcessingOrder) {
+        if ((activePorts & (1U << port)) != 0U) {
+            ports.push_back(port);
+        }
+    }
+    return ports;
+}
+
+// Port times are 32-bit and wrap every ~4.3 s.
+std::int64_t portDelta(std::uint32_t later, std::uint32_t earlier) {
+    return static_cast<std::int32_t>(later - earlier);
+}
+
+} // namespace
+
+bool computeDcTiming(const std::vector<DcPortLatch>& latches, std::int64_t referenceSystemTimeNs,
+                     DcInitReport& outReport) {
+    outReport.slaves.assign(latches.size(), DcSlaveTiming{});
+    outReport.maxPropagationDelayNs = 0;
+    const auto reference = std::find_if(latches.begin(), latches.end(),
+                                        [](const DcPortLatch& latch) { return latch.dcSupported; });
+    if (reference == latches.end()) {
+        outReport.error = "no DC-capable slave";
+        return false;
+    }
+    outReport.referenceSlavePosition = reference->slavePosition;
+    const auto referenceIndex = static_cast<std::size_t>(reference - latches.begin());
+
+    // Rebuild the tree: each slave takes the next free downstream port of the
+    // nearest upstream slave that still has one.
+    struct OpenBranch {
+        std::size_t index;
+        std::vector<std::uint8_t> ports;
+        std::size_t nextPort;
+    };
+    std::vector<OpenBranch> stack;
+    std::vector<std::int32_t> parents(latches.size(), -1);
+    std::vector<std::uint8_t> parentPorts(latches.size(), 0U);
+    for (std::size_t i = 0; i < latches.size(); ++i) {
+        while (!stack.empty() && stack.back().nextPort >= stack.back().ports.size()) {
+            stack.pop_back();
+        }
+        if (!stack.empty()) {
+            auto& branch = stack.back();
+            parents[i] = static_cast<std::int32_t>(branch.index);
+            parentPorts[i] = branch.ports[branch.nextPort++];
+        } else if (i != 0U) {
+            outReport.error = "slave " + std::to_string(latches[i].slavePosition) +
+                              " has no upstream port (DL status inconsistent)";
+            return false;
+        }
+        auto ports = activePortsInOrder(latches[i].activePorts);
+        if (!ports.empty() && ports.front() == 0U) {
+            ports.erase(ports.begin());
+        }
+        stack.push_back(OpenBranch{i, std::move(ports), 0U});
+    }
+
+    // delays: link distance from the reference (0x0928). arrivals: when the
+    // latching frame reached port 0, which also counts time spent in earlier branches.
+    std::vector<std::int64_t> delays(latches.size(), 0);
+    std::vector<std::int64_t> arrivals(latches.size(), 0);
+    for (std::size_t i = 0; i < latches.size(); ++i) {
+        auto& timing = outReport.slaves[i];
+        timing.slavePosition = latches[i].slavePosition;
+        timing.dcSupported = latches[i].dcSupported;
+        timing.parentPosition = (parents[i] < 0) ? -1 : static_cast<std::int32_t>(latches[parents[i]].slavePosition);
+        timing.parentPort = parentPorts[i];
+        if (i <= referenceIndex || parents[i] < 0) {
+            continue;
+        }
+        const auto parent = static_cast<std::size_t>(parents[i]);
+        delays[i] = delays[parent];
+        arrivals[i] = arrivals[parent];
+        if (!latches[i].dcSupported || !latches[parent].dcSupported) {
+            continue;
+        }
+        // Round trip seen by the parent: return on the child's port minus the
+        // return on the port processed just before it.
+        const auto parentOrder = activePortsInOrder(latches[parent].activePorts);
+        const auto at = std::find(parentOrder.begin(), parentOrder.end(), parentPorts[i]);
+        if (at == parentOrder.end() || at == parentOrder.begin()) {
+            continue;
+        }
+        const auto& parentTimes = latches[parent].portReceiveTimeNs;
+        const auto branchRoundTrip = portDelta(parentTimes[*at], parentTimes[*(at - 1)]);
+        const auto departure = portDelta(parentTimes[*(at - 1)], parentTimes[0]);
+        // Time the frame spends below the child, which is not link delay.
+        const auto childOrder = activePortsInOrder(latches[i].activePorts);
+        std::int64_t subtreeRoundTrip = 0;
+        if (childOrder.size() > 1U) {
+            const auto& childTimes = latches[i].portReceiveTimeNs;
+            subtreeRoundTrip = portDelta(childTimes[childOrder.back()], childTimes[childOrder.front()]);
+        }
+        const auto linkDelay = std::max<std::int64_t>(0, (branchRoundTrip - subtreeRoundTrip) / 2);
+        delays[i] += linkDelay;
+        arrivals[i] += departure + linkDelay;
+    }
+
+    for (std::size_t i = 0; i < latches.size(); ++i) {
+        auto& timing = outReport.slaves[i];
+        if (!timing.dcSupported) {
+            continue;
+        }
+        timing.propagationDelayNs = delays[i];
+        timing.systemTimeOffsetNs = referenceSystemTimeNs + arrivals[i] - latches[i].processingUnitReceiveTimeNs;
+        outReport.maxPropagationDelayNs = std::max(outReport.maxPropagationDelayNs, delays[i]);
+    }
+    return true;
+}
+
+std::int64_t decodeDcSystemTimeDifference(std::uint32_t raw) {
+    const auto magnitude = static_cast<std::int64_t>(raw & 0x7FFFFFFFU);
+    return ((raw & 0x80000000U) != 0U) ? -magnitude : magnitude;
+}
+
+DcLineMonitor::DcLineMonitor() : DcLineMonitor(DcLineMonitorOptions{}) {}
+
+DcLineMonitor::DcLineMonitor(DcLineMonitorOptions options) : options_(options) {
+    options_.decimation = std::max<std::size_t>(1U, options_.decimation);
+    options_.bucketWidthNs = std::max<std::int64_t>(1, options_.bucketWidthNs);
+    options_.bucketCount = std::max<std::size_t>(1U, options_.bucketCount);
+}
+
+bool DcLineMonitor::due() {
+    if (++cyclesSinceRound_ < options_.decimation) {
+        return false;
+    }
+    cyclesSinceRound_ = 0U;
+    return true;
+}
+
+void DcLineMonitor::record(const std::vector<DcSlaveSyncSample>& samples) {
+    ++rounds_;
+    for (const auto& sample : samples) {
+        auto it = std::lower_bound(slaves_.begin(), slaves_.end(), sample.slavePosition,
+                                   [](const DcSlaveJitterHistogram& h, std::uint16_t position) {
+                                       return h.slavePosition < position;
+                                   });
+        if (it == slaves_.end() || it->slavePosition != sample.slavePosition) {
+            DcSlaveJitterHistogram fresh;
+            fresh.slavePosition = sample.slavePosition;
+            fresh.buckets.assign(options_.bucketCount, 0U);
+            it = slaves_.insert(it, std::move(fresh));
+        }
+        auto& slave = *it;
+        if (!sample.valid) {
+            ++slave.missed;
+            continue;
+        }
+        slave.minDeviationNs = (slave.samples == 0U) ? sample.deviationNs
+                                                     : std::min(slave.minDeviationNs, sample.deviationNs);
+        slave.maxDeviationNs = (slave.samples == 0U) ? sample.deviationNs
+                                                     : std::max(slave.maxDeviationNs, sample.deviationNs);
+        slave.lastDeviationNs = sample.deviationNs;
+        ++slave.samples;
+        const auto bucket = static_cast<std::size_t>(std::llabs(sample.deviationNs) / options_.bucketWidthNs);
+        ++slave.buckets[std::min(bucket, options_.bucketCount - 1U)];
+    }
+}
+
+void DcLineMonitor::recordFailure() {
+    ++rounds_;
+    ++failedRounds_;
+}
+
+DcLineMonitorSnapshot DcLineMonitor::snapshot() const {
+    DcLineMonitorSnapshot snapshot;
+    snapshot.enabled = options_.enabled;
+    snapshot.rounds = rounds_;
+    snapshot.failedRounds = failedRounds_;
+    snapshot.bucketWidthNs = options_.bucketWidthNs;
+    snapshot.slaves = slaves_;
+    for (auto& slave : snapshot.slaves) {
+        if (slave.samples == 0U) {
+            continue;
+        }
+        // Smallest bucket edge covering 99 % of the samples (rounded up).
+        const auto target = (slave.samples * 99U + 99U) / 100U;
+        std::uint64_t seen = 0U;
+        for (std::size_t b = 0; b < slave.buckets.size(); ++b) {
+            seen += slave.buckets[b];
+            if (seen >= target) {
+                slave.p99AbsNs = static_cast<std::int64_t>(b + 1U) * options_.bucketWidthNs;
+                // The overflow bucket has no upper edge; fall back to the largest sample.
+                slave.p99Saturated = (b + 1U == slave.buckets.size());
+                if (slave.p99Saturated) {
+                    slave.p99AbsNs = std::max(std::llabs(slave.minDeviationNs), std::llabs(slave.maxDeviationNs));
+                }
+                break;
+            }
+        }
+        if (snapshot.worstSlavePosition < 0 || slave.p99AbsNs > snapshot.worstP99AbsNs) {
+            snapshot.worstSlavePosition = slave.slavePosition;
+            snapshot.worstP99AbsNs = slave.p99AbsNs;
+            snapshot.worstP99Saturated = slave.p99Saturated;
+        }
+    }
+    return snapshot;
+}
+
+void DcLineMonitor::reset() {
+    slaves_.clear();
+    rounds_ = 0U;
+    failedRounds_ = 0U;
+    cyclesSinceRound_ = 0U;
 }
 
 } // namespace oec
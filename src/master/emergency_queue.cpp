@@ -0,0 +1,217 @@
+/**
+ * @file emergency_queue.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/master/emergency_queue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace oec {
+namespace {
+
+std::size_t roundUpPowerOfTwo(std::size_t value) {
+    std::size_t result = 2U;
+    while (result < value) {
+        result <<= 1U;
+    }
+    return result;
+}
+
+std::uint64_t dedupKey(const EmergencyMessage& message) {
+    return (static_cast<std::uint64_t>(message.slavePosition) << 24U) |
+           (static_cast<std::uint64_t>(message.errorCode) << 8U) | message.errorRegister;
+}
+
+} // namespace
+
+EmergencyRing::EmergencyRing(std::size_t capacity) {
+    const auto size = roundUpPowerOfTwo(capacity);
+    cells_.reset(new Cell[size]);
+    mask_ = size - 1U;
+    for (std::size_t i = 0; i < size; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool EmergencyRing::tryPush(const EmergencyMessage& message) {
+    auto pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            // Slot is free for this lap; claim it.
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Consumer has not released this slot yet: ring is full.
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->message = message;
+    cell->sequence.store(pos + 1U, std::memory_order_release);
+    return true;
+}
+
+bool EmergencyRing::tryPop(EmergencyMessage& outMessage) {
+    const auto pos = dequeuePos_.load(std::memory_order_relaxed);
+    Cell& cell = cells_[pos & mask_];
+    const auto sequence = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1U) < 0) {
+        return false;
+    }
+    outMessage = cell.message;
+    // Hand the slot to producers of the next lap.
+    cell.sequence.store(pos + mask_ + 1U, std::memory_order_release);
+    dequeuePos_.store(pos + 1U, std::memory_order_relaxed);
+    return true;
+}
+
+std::size_t EmergencyRing::sizeApprox() const {
+    const auto head = dequeuePos_.load(std::memory_order_relaxed);
+    const auto tail = enqueuePos_.load(std::memory_order_relaxed);
+    return (tail > head) ? (tail - head) : 0U;
+}
+
+EmergencyQueue::EmergencyQueue(std::size_t capacity, EmergencyRateLimitOptions options)
+    : ring_(capacity), options_(options) {}
+
+std::uint64_t EmergencyQueue::nowNs() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+bool EmergencyQueue::takeToken(std::uint16_t slavePosition, std::uint64_t nowNs) {
+    if (options_.tokensPerSecond <= 0.0) {
+        return true;
+    }
+    const auto burst = static_cast<double>(std::max<std::size_t>(1U, options_.burst));
+    auto& bucket = buckets_[slavePosition];
+    if (!bucket.primed) {
+        bucket.tokens = burst;
+        bucket.lastRefillNs = nowNs;
+        bucket.primed = true;
+    } else if (nowNs > bucket.lastRefillNs) {
+        const auto elapsedS = static_cast<double>(nowNs - bucket.lastRefillNs) * 1e-9;
+        bucket.tokens = std::min(burst, bucket.tokens + elapsedS * options_.tokensPerSecond);
+        bucket.lastRefillNs = nowNs;
+    }
+    if (bucket.tokens < 1.0) {
+        return false;
+    }
+    bucket.tokens -= 1.0;
+    return true;
+}
+
+bool EmergencyQueue::offer(EmergencyMessage message) {
+    if (message.timestampNs == 0U) {
+        message.timestampNs = nowNs();
+    }
+    const auto now = message.timestampNs;
+
+    DedupEntry* dedup = nullptr;
+    if (options_.dedupWindow.count() > 0) {
+        dedup = &dedup_[dedupKey(message)];
+        const auto windowNs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(options_.dedupWindow).count());
+        if (dedup->lastAcceptedNs != 0U && now >= dedup->lastAcceptedNs && now - dedup->lastAcceptedNs < windowNs) {
+            if (dedup->suppressed++ == 0U) {
+                ++pendingSuppressed_;
+            }
+            dedup->lastSuppressed = message;
+            deduplicated_.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    if (!takeToken(message.slavePosition, now)) {
+        rateLimited_.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    if (dedup != nullptr) {
+        message.repeatCount = dedup->suppressed;
+    }
+    if (!ring_.tryPush(message)) {
+        overflowDropped_.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    if (dedup != nullptr) {
+        dedup->lastAcceptedNs = now;
+        if (dedup->suppressed != 0U) {
+            dedup->suppressed = 0U;
+            --pendingSuppressed_;
+        }
+    }
+    accepted_.fetch_add(1U, std::memory_order_relaxed);
+    return true;
+}
+
+std::size_t EmergencyQueue::flushSuppressed(std::uint64_t nowNs) {
+    if (pendingSuppressed_ == 0U) {
+        return 0U;
+    }
+    const auto windowNs = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(options_.dedupWindow).count());
+    std::size_t flushed = 0U;
+    for (auto& [key, entry] : dedup_) {
+        (void)key;
+        if (entry.suppressed == 0U || nowNs < entry.lastAcceptedNs || nowNs - entry.lastAcceptedNs < windowNs) {
+            continue;
+        }
+        // Already admitted once by the bucket; the summary itself is not rate limited.
+        auto message = entry.lastSuppressed;
+        message.repeatCount = entry.suppressed - 1U;
+        if (!ring_.tryPush(message)) {
+            overflowDropped_.fetch_add(1U, std::memory_order_relaxed);
+            continue;
+        }
+        accepted_.fetch_add(1U, std::memory_order_relaxed);
+        entry.lastAcceptedNs = message.timestampNs;
+        entry.suppressed = 0U;
+        --pendingSuppressed_;
+        ++flushed;
+    }
+    return flushed;
+}
+
+bool EmergencyQueue::pop(EmergencyMessage& outMessage) {
+    if (!ring_.tryPop(outMessage)) {
+        return false;
+    }
+    delivered_.fetch_add(1U, std::memory_order_relaxed);
+    return true;
+}
+
+std::vector<EmergencyMessage> EmergencyQueue::drain(std::size_t maxMessages) {
+    std::vector<EmergencyMessage> messages;
+    EmergencyMessage message;
+    while (messages.size() < maxMessages && pop(message)) {
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+void EmergencyQueue::setRateLimit(EmergencyRateLimitOptions options) {
+    options_ = options;
+    buckets_.clear();
+    dedup_.clear();
+    pendingSuppressed_ = 0U;
+}
+
+EmergencyQueueStats EmergencyQueue::stats() const {
+    EmergencyQueueStats stats;
+    stats.accepted = accepted_.load(std::memory_order_relaxed);
+    stats.deduplicated = deduplicated_.load(std::memory_order_relaxed);
+    stats.rateLimited = rateLimited_.load(std::memory_order_relaxed);
+    stats.overflowDropped = overflowDropped_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace oec
@@ -0,0 +1,374 @@
+/**
+ * @file eoe_gateway.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/master/eoe_gateway.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/if_tun.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace oec {
+namespace {
+
+constexpr std::size_t kEoeBlockBytes = 32U;
+constexpr std::size_t kTimestampBytes = 4U;
+constexpr std::size_t kMaxTapFrameBytes = 2048U;
+// Mailbox header in front of the EoE payload in SM0.
+constexpr std::size_t kMailboxHeaderBytes = 6U;
+
+} // namespace
+
+std::vector<std::vector<std::uint8_t>> EoeCodec::fragment(const std::vector<std::uint8_t>& frame,
+                                                          std::size_t maxPayloadBytes,
+                                                          std::uint8_t frameNumber) {
+    std::vector<std::vector<std::uint8_t>> out;
+    const std::size_t maxData = (maxPayloadBytes > kHeaderBytes) ? (maxPayloadBytes - kHeaderBytes) : 0U;
+    const std::size_t blockData = (maxData / kEoeBlockBytes) * kEoeBlockBytes;
+    if (blockData == 0U && frame.size() > maxData) {
+        return out;
+    }
+
+    std::size_t offset = 0U;
+    std::uint8_t fragmentNumber = 0U;
+    do {
+        const std::size_t remaining = frame.size() - offset;
+        const bool last = remaining <= maxData;
+        const std::size_t dataBytes = last ? remaining : blockData;
+        const auto offsetBlocks = (fragmentNumber == 0U) ? ((frame.size() + kEoeBlockBytes - 1U) / kEoeBlockBytes)
+                                                         : (offset / kEoeBlockBytes);
+        const auto word0 = static_cast<std::uint16_t>(kFrameTypeFragment | (last ? 0x0100U : 0U));
+        const auto word1 = static_cast<std::uint16_t>((fragmentNumber & 0x3FU) | ((offsetBlocks & 0x3FU) << 6U) |
+                                                      ((frameNumber & 0x0FU) << 12U));
+        std::vector<std::uint8_t> payload;
+        payload.reserve(kHeaderBytes + dataBytes);
+        payload.push_back(static_cast<std::uint8_t>(word0 & 0xFFU));
+        payload.push_back(static_cast<std::uint8_t>((word0 >> 8U) & 0xFFU));
+        payload.push_back(static_cast<std::uint8_t>(word1 & 0xFFU));
+        payload.push_back(static_cast<std::uint8_t>((word1 >> 8U) & 0xFFU));
+        payload.insert(payload.end(), frame.begin() + static_cast<std::ptrdiff_t>(offset),
+                       frame.begin() + static_cast<std::ptrdiff_t>(offset + dataBytes));
+        out.push_back(std::move(payload));
+        offset += dataBytes;
+        ++fragmentNumber;
+    } while (offset < frame.size());
+    return out;
+}
+
+bool EoeCodec::parseHeader(const std::vector<std::uint8_t>& payload, EoeFragmentHeader& outHeader) {
+    if (payload.size() < kHeaderBytes) {
+        return false;
+    }
+    const auto word0 = static_cast<std::uint16_t>(payload[0] | (payload[1] << 8U));
+    const auto word1 = static_cast<std::uint16_t>(payload[2] | (payload[3] << 8U));
+    outHeader.frameType = static_cast<std::uint8_t>(word0 & 0x0FU);
+    outHeader.port = static_cast<std::uint8_t>((word0 >> 4U) & 0x0FU);
+    outHeader.lastFragment = (word0 & 0x0100U) != 0U;
+    outHeader.timeAppended = (word0 & 0x0200U) != 0U;
+    outHeader.fragmentNumber = static_cast<std::uint8_t>(word1 & 0x3FU);
+    outHeader.offsetBlocks = static_cast<std::uint8_t>((word1 >> 6U) & 0x3FU);
+    outHeader.frameNumber = static_cast<std::uint8_t>((word1 >> 12U) & 0x0FU);
+    return true;
+}
+
+EoeReassembler::Result EoeReassembler::push(const std::vector<std::uint8_t>& payload,
+                                            std::vector<std::uint8_t>& outFrame) {
+    EoeFragmentHeader header;
+    if (!EoeCodec::parseHeader(payload, header)) {
+        reset();
+        return Result::Dropped;
+    }
+    if (header.frameType != EoeCodec::kFrameTypeFragment) {
+        // IP/filter/init services are not frame data.
+        return Result::Ignored;
+    }
+
+    if (header.fragmentNumber == 0U) {
+        if (active_) {
+            // The previous frame lost its tail; keep the new one.
+            ++abandonedFrames_;
+        }
+        reset();
+        active_ = true;
+        frameNumber_ = header.frameNumber;
+        expectedBytes_ = static_cast<std::size_t>(header.offsetBlocks) * kEoeBlockBytes;
+        buffer_.reserve(expectedBytes_);
+    } else if (!active_ || header.frameNumber != frameNumber_ || header.fragmentNumber != nextFragment_ ||
+               static_cast<std::size_t>(header.offsetBlocks) * kEoeBlockBytes != buffer_.size()) {
+        reset();
+        return Result::Dropped;
+    }
+
+    buffer_.insert(buffer_.end(), payload.begin() + EoeCodec::kHeaderBytes, payload.end());
+    ++nextFragment_;
+    if (header.lastFragment && header.timeAppended && buffer_.size() >= kTimestampBytes) {
+        buffer_.resize(buffer_.size() - kTimestampBytes);
+    }
+    if (buffer_.size() > expectedBytes_) {
+        reset();
+        return Result::Dropped;
+    }
+    if (!header.lastFragment) {
+        return Result::Incomplete;
+    }
+    outFrame = std::move(buffer_);
+    reset();
+    return Result::Complete;
+}
+
+void EoeReassembler::reset() {
+    buffer_.clear();
+    expectedBytes_ = 0U;
+    frameNumber_ = 0U;
+    nextFragment_ = 0U;
+    active_ = false;
+}
+
+TapEndpoint::~TapEndpoint() { close(); }
+
+bool TapEndpoint::open(const std::string& ifName, std::string& outError) {
+    close();
+    if (ifName.size() >= IFNAMSIZ) {
+        outError = "TAP interface name too long: " + ifName;
+        return false;
+    }
+    fd_ = ::open("/dev/net/tun", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+        outError = std::string("Cannot open /dev/net/tun: ") + std::strerror(errno);
+        return false;
+    }
+    ifreq ifr {};
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    std::strncpy(ifr.ifr_name, ifName.c_str(), IFNAMSIZ - 1);
+    if (::ioctl(fd_, TUNSETIFF, &ifr) != 0) {
+        outError = "TUNSETIFF failed for " + ifName + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+    name_ = ifr.ifr_name;
+    return true;
+}
+
+void TapEndpoint::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    name_.clear();
+}
+
+bool TapEndpoint::readFrame(std::vector<std::uint8_t>& outFrame) {
+    if (fd_ < 0) {
+        return false;
+    }
+    outFrame.resize(kMaxTapFrameBytes);
+    const auto rc = ::read(fd_, outFrame.data(), outFrame.size());
+    if (rc <= 0) {
+        outFrame.clear();
+        return false;
+    }
+    outFrame.resize(static_cast<std::size_t>(rc));
+    return true;
+}
+
+bool TapEndpoint::writeFrame(const std::vector<std::uint8_t>& frame) {
+    if (fd_ < 0) {
+        return false;
+    }
+    const auto rc = ::write(fd_, frame.data(), frame.size());
+    return rc == static_cast<ssize_t>(frame.size());
+}
+
+EoeGateway::EoeGateway(ITransport& transport, EoeGatewayOptions options)
+    : transport_(transport), options_(options) {}
+
+EoeGateway::~EoeGateway() = default;
+
+bool EoeGateway::addSlave(std::uint16_t slavePosition, EoeEndpoint& endpoint, std::string& outError) {
+    if (lanes_.count(slavePosition) != 0U) {
+        outError = "EoE slave already attached: " + std::to_string(slavePosition);
+        return false;
+    }
+    lanes_[slavePosition].endpoint = &endpoint;
+    return true;
+}
+
+bool EoeGateway::addTapSlave(std::uint16_t slavePosition, const std::string& ifName, std::string& outError) {
+    auto tap = std::make_unique<TapEndpoint>();
+    if (!tap->open(ifName, outError) || !addSlave(slavePosition, *tap, outError)) {
+        return false;
+    }
+    ownedTaps_.push_back(std::move(tap));
+    return true;
+}
+
+bool EoeGateway::enqueueFrame(std::uint16_t slavePosition, std::vector<std::uint8_t> frame) {
+    const auto it = lanes_.find(slavePosition);
+    if (it == lanes_.end() || it->second.queue.size() >= options_.maxQueuedFrames) {
+        return false;
+    }
+    it->second.queue.push_back(std::move(frame));
+    return true;
+}
+
+std::size_t EoeGateway::queuedFrames(std::uint16_t slavePosition) const {
+    const auto it = lanes_.find(slavePosition);
+    if (it == lanes_.end()) {
+        return 0U;
+    }
+    return it->second.queue.size() + (it->second.fragments.empty() ? 0U : 1U);
+}
+
+void EoeGateway::pullEndpointFrames(Lane& lane) {
+    // A full queue leaves further frames in the endpoint (kernel TAP queue) instead of dropping them.
+    std::vector<std::uint8_t> frame;
+    while (lane.endpoint != nullptr && lane.queue.size() < options_.maxQueuedFrames &&
+           lane.endpoint->readFrame(frame)) {
+        lane.queue.push_back(std::move(frame));
+        frame = {};
+    }
+}
+
+std::size_t EoeGateway::fragmentBytes(std::uint16_t slavePosition, Lane& lane) {
+    if (lane.fragmentBytes == 0U) {
+        std::uint16_t writeSize = 0U;
+        if (!transport_.mailboxWriteSize(slavePosition, writeSize) || writeSize <= kMailboxHeaderBytes) {
+            return options_.maxFragmentBytes;
+        }
+        lane.fragmentBytes = writeSize - kMailboxHeaderBytes;
+    }
+    return lane.fragmentBytes;
+}
+
+bool EoeGateway::prepareFragment(std::uint16_t slavePosition, Lane& lane) {
+    while (lane.nextFragment >= lane.fragments.size()) {
+        if (lane.queue.empty()) {
+            return false;
+        }
+        lane.fragments =
+            EoeCodec::fragment(lane.queue.front(), fragmentBytes(slavePosition, lane), lane.frameNumber);
+        lane.queue.pop_front();
+        lane.nextFragment = 0U;
+        lane.fragmentRetries = 0U;
+        lane.frameNumber = static_cast<std::uint8_t>((lane.frameNumber + 1U) & 0x0FU);
+        if (lane.fragments.empty()) {
+            // SM0 too small for even one 32-byte block of a frame that needs several fragments.
+            ++stats_.txFramesDropped;
+        }
+    }
+    return true;
+}
+
+void EoeGateway::dropFrame(Lane& lane) {
+    // The slave discards the partial frame when the next frame's fragment 0 arrives.
+    ++stats_.txFramesDropped;
+    lane.fragments.clear();
+    lane.nextFragment = 0U;
+    lane.fragmentRetries = 0U;
+}
+
+void EoeGateway::acceptFragment(Lane& lane) {
+    ++stats_.txFragments;
+    lane.fragmentRetries = 0U;
+    if (++lane.nextFragment >= lane.fragments.size()) {
+        ++stats_.txFrames;
+        lane.fragments.clear();
+        lane.nextFragment = 0U;
+    }
+}
+
+void EoeGateway::deliverFragment(Lane& lane, const std::vector<std::uint8_t>& payload) {
+    ++stats_.rxFragments;
+    std::vector<std::uint8_t> frame;
+    const auto abandonedBefore = lane.reassembler.abandonedFrames();
+    const auto result = lane.reassembler.push(payload, frame);
+    stats_.reassemblyDrops += lane.reassembler.abandonedFrames() - abandonedBefore;
+    if (result == EoeReassembler::Result::Dropped) {
+        ++stats_.reassemblyDrops;
+    }
+    if (result == EoeReassembler::Result::Complete) {
+        ++stats_.rxFrames;
+        if (lane.endpoint == nullptr || !lane.endpoint->writeFrame(frame)) {
+            ++stats_.endpointWriteFailures;
+        }
+    }
+}
+
+std::size_t EoeGateway::service(std::string& outError) {
+    outError.clear();
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t moved = 0U;
+    std::vector<EoeBatchSlot> slots;
+    slots.reserve(lanes_.size());
+
+    while (true) {
+        slots.clear();
+        for (auto& [position, lane] : lanes_) {
+            pullEndpointFrames(lane);
+            EoeBatchSlot slot;
+            slot.slavePosition = position;
+            if (prepareFragment(position, lane)) {
+                slot.tx = lane.fragments[lane.nextFragment];
+            }
+            slots.push_back(std::move(slot));
+        }
+        if (slots.empty()) {
+            return moved;
+        }
+
+        bool exchanged = false;
+        if (batchSupported_) {
+            if (transport_.eoeExchangeBatch(slots, outError)) {
+                exchanged = true;
+                ++stats_.batchedRounds;
+            } else if (!outError.empty()) {
+                return moved;
+            } else {
+                batchSupported_ = false;
+            }
+        }
+        if (!exchanged) {
+            // Per-slave mailbox transactions for transports without a batched path.
+            std::string error;
+            for (auto& slot : slots) {
+                slot.txAccepted = !slot.tx.empty() && transport_.eoeSend(slot.slavePosition, slot.tx, error);
+                slot.rxValid = transport_.eoeReceive(slot.slavePosition, slot.rx, error);
+            }
+            ++stats_.fallbackRounds;
+        }
+
+        std::size_t roundMoved = 0U;
+        for (const auto& slot : slots) {
+            auto& lane = lanes_[slot.slavePosition];
+            if (!slot.tx.empty()) {
+                if (slot.txAccepted) {
+                    acceptFragment(lane);
+                    ++roundMoved;
+                } else {
+                    ++stats_.txFragmentRetries;
+                    if (options_.maxFragmentRetries != 0U && ++lane.fragmentRetries >= options_.maxFragmentRetries) {
+                        dropFrame(lane);
+                    }
+                }
+            }
+            if (slot.rxValid) {
+                deliverFragment(lane, slot.rx);
+                ++roundMoved;
+            }
+        }
+        moved += roundMoved;
+        if (roundMoved == 0U || std::chrono::steady_clock::now() - start >= options_.budget) {
+            return moved;
+        }
+    }
+}
+
+} // namespace oec
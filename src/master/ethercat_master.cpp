@@ -157,6 +157,9 @@ bool EthercatMaster::configure(const NetworkConfiguration& config) {
     dcSyncQuality_ = DcSyncQualitySnapshot{};
     dcPhaseErrorAbsHistoryNs_.clear();
     dcPolicyLatched_ = false;
+    dcLineMonitor_.reset();
+    dcLineMonitorPositions_.clear();
+    dcLineMonitorRoundQueued_ = false;
     missingConditionCycles_ = 0;
     hotConnectConditionCycles_ = 0;
     redundancyConditionCycles_ = 0;
@@ -166,8 +169,10 @@ bool EthercatMaster::configure(const NetworkConfiguration& config) {
     redundancyStatus_ = RedundancyStatusSnapshot{};
     redundancyKpis_ = RedundancyKpiSnapshot{};
     redundancyFaultActive_ = false;
+    lastRedundancyHealthyCycle_ = 0;
     redundancyTransitions_.clear();
     dcTraceCounter_ = 0;
+    mailbox_.invalidateCache();
 
     // Validate before binding signals to avoid partially configured runtime state.
     const auto issues = ConfigurationValidator::validate(config);
@@ -213,30 +218,76 @@ bool EthercatMaster::start() {
     redundancyStatus_.state = RedundancyState::PrimaryOnly;
     redundancyKpis_ = RedundancyKpiSnapshot{};
     redundancyFaultActive_ = false;
+    lastRedundancyHealthyCycle_ = 0;
     redundancyTransitions_.clear();
 
     // Optionally drive a full AL startup ladder so cyclic exchange starts from OP.
+    startupReport_ = StartupReport{};
+    const auto startupBegin = std::chrono::steady_clock::now();
+    const bool traceStartup = parseBoolEnv("OEC_TRACE_STARTUP", false);
+    auto runPhase = [&](const char* name, std::chrono::microseconds& slot, auto&& body) {
+        const auto begin = std::chrono::steady_clock::now();
+        const bool ok = body();
+        slot = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+        if (traceStartup) {
+            std::cout << "[oec-startup] phase=" << name << " us=" << slot.count()
+                      << (ok ? "" : " failed") << '\n';
+        }
+        if (!ok) {
+            startupReport_.failedPhase = name;
+        }
+        return ok;
+    };
+    auto finishReport = [&](bool completed) {
+        startupReport_.completed = completed;
+        startupReport_.total = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startupBegin);
+        if (traceStartup) {
+            std::cout << "[oec-startup] total_us=" << startupReport_.total.count()
+                      << " state_polls=" << startupReport_.statePolls
+                      << " completed=" << (completed ? 1 : 0) << '\n';
+        }
+    };
     if (stateMachineOptions_.enable) {
-        if (!transitionNetworkTo(SlaveState::Init) ||
-            !transitionNetworkTo(SlaveState::PreOp)) {
+        auto transition = [this](SlaveState target) {
+            return [this, target]() { return transitionNetworkTo(target); };
+        };
+        if (!runPhase("init", startupReport_.initTransition, transition(SlaveState::Init)) ||
+            !runPhase("preop", startupReport_.preOpTransition, transition(SlaveState::PreOp))) {
+            finishReport(false);
             transport_.close();
             return false;
         }
 
         std::string processMapError;
-        if (!transport_.configureProcessImage(config_, processMapError)) {
+        if (!runPhase("process-image", startupReport_.processImageConfiguration,
+                      [&]() { return transport_.configureProcessImage(config_, processMapError); })) {
             setError("Failed to configure process image mapping: " + processMapError);
+            finishReport(false);
+            transport_.close();
+            return false;
+        }
+
+        if (parseBoolEnv("OEC_DC_INIT", false) &&
+            !runPhase("dc-init", startupReport_.dcInitialization, [&]() {
+                DcInitReport report;
+                return initializeDistributedClocks(DcInitOptions{}, report);
+            })) {
+            finishReport(false);
             transport_.close();
             return false;
         }
 
-        if (!transitionNetworkTo(SlaveState::SafeOp) ||
-            !transitionNetworkTo(SlaveState::Op)) {
+        if (!runPhase("safeop", startupReport_.safeOpTransition, transition(SlaveState::SafeOp)) ||
+            !runPhase("op", startupReport_.opTransition, transition(SlaveState::Op))) {
+            finishReport(false);
             transport_.close();
             return false;
         }
     }
+    finishReport(true);
 
+    resolveDcLineMonitorPositionsLocked();
     degraded_ = false;
     started_ = true;
     return true;
@@ -279,6 +330,22 @@ bool EthercatMaster::runCycle() {
         }
         processImage_.inputBytes() = rx;
         statistics_.lastWorkingCounter = transport_.lastWorkingCounter();
+        statistics_.lastWireRoundTrip = std::chrono::nanoseconds(0);
+        if (transport_.lastWireRoundTrip(statistics_.lastWireRoundTrip)) {
+            ++statistics_.wireTimedCycles;
+        }
+        // Parallel redundancy sees the ring state in every frame; no need to wait for a topology scan.
+        bool ringIntact = true;
+        if (transport_.redundancyObservation(ringIntact)) {
+            observeRedundancyLocked(ringIntact);
+        }
+        std::int64_t referenceTimeNs = 0;
+        if (dcLinuxTransport_ != nullptr && dcLinuxTransport_->lastDcReferenceTime(referenceTimeNs)) {
+            // The frame's TX stamp is closer to the ARMW than the host time before exchange().
+            auto hostTime = begin;
+            (void)dcLinuxTransport_->lastDcReferenceTxTime(hostTime);
+            lastDcReferenceSample_ = DcReferenceSample{statistics_.cyclesTotal, referenceTimeNs, hostTime};
+        }
         if (redundancyStatus_.state == RedundancyState::RedundancyDegraded ||
             redundancyStatus_.state == RedundancyState::Recovering) {
             ++redundancyKpis_.impactedCycles;
@@ -288,8 +355,11 @@ bool EthercatMaster::runCycle() {
             ++statistics_.cyclesTotal;
             return false;
         }
+        runDcLineMonitorLocked();
         // Dispatch callbacks only after a consistent full-image update.
         mapper_.dispatchInputChanges(processImage_);
+        // Bounded so an EMCY flood cannot stretch the cycle; the rest waits in the transport.
+        collectEmergenciesLocked(32U);
         const auto end = std::chrono::steady_clock::now();
         statistics_.lastCycleRuntime =
             std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
@@ -420,6 +490,9 @@ std::vector<SlaveDiagnostic> EthercatMaster::collectSlaveDiagnostics() {
         const bool hasState = transport_.readSlaveState(slave.position, state);
         const bool hasAlStatus = transport_.readSlaveAlStatusCode(slave.position, alStatusCode);
         diagnostic.available = hasState && hasAlStatus;
+        if (hasState) {
+            mailbox_.noteSlaveState(slave.position, state);
+        }
         if (diagnostic.available) {
             diagnostic.state = state;
             diagnostic.alStatusCode = alStatusCode;
@@ -491,15 +564,97 @@ bool EthercatMaster::isDegraded() const {
 
 SdoResponse EthercatMaster::sdoUpload(std::uint16_t slavePosition, SdoAddress address) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    return mailbox_.upload(slavePosition, address);
+    return mailbox_.uploadCached(slavePosition, address);
 }
 
 SdoResponse EthercatMaster::sdoDownload(std::uint16_t slavePosition, SdoAddress address,
                                         const std::vector<std::uint8_t>& data) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (mailbox_.cachePolicy(address.index) == SdoCachePolicy::Static) {
+        mailbox_.invalidateCache(slavePosition);
+    }
     return mailbox_.download(slavePosition, address, data);
 }
 
+void EthercatMaster::setSdoCachePolicy(std::uint16_t index, SdoCachePolicy policy) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    mailbox_.setCachePolicy(index, policy);
+}
+
+void EthercatMaster::invalidateSdoCache() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    mailbox_.invalidateCache();
+}
+
+SdoCacheStats EthercatMaster::sdoCacheStats() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return mailbox_.cacheStats();
+}
+
+SdoResponse EthercatMaster::sdoUploadComplete(std::uint16_t slavePosition, std::uint16_t index,
+                                              bool includeSubIndex0) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return mailbox_.uploadComplete(slavePosition, index, includeSubIndex0);
+}
+
+SdoResponse EthercatMaster::sdoDownloadComplete(std::uint16_t slavePosition, std::uint16_t index,
+                                                const std::vector<std::uint8_t>& data, bool includeSubIndex0) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // Every sub-index may change; also on failure, since a partial write is possible.
+    mailbox_.invalidateCache(slavePosition, index);
+    return mailbox_.downloadComplete(slavePosition, index, data, includeSubIndex0);
+}
+
+bool EthercatMaster::objectDictionary(std::uint16_t slavePosition, ObjectDictionary& outDictionary,
+                                      std::string& outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto readU32 = [&](std::uint8_t subIndex, std::uint32_t& value) {
+        const auto response = mailbox_.uploadCached(slavePosition, SdoAddress{0x1018U, subIndex});
+        if (!response.success || response.data.size() < 4U) {
+            return false;
+        }
+        value = static_cast<std::uint32_t>(response.data[0]) | (static_cast<std::uint32_t>(response.data[1]) << 8U) |
+                (static_cast<std::uint32_t>(response.data[2]) << 16U) |
+                (static_cast<std::uint32_t>(response.data[3]) << 24U);
+        return true;
+    };
+
+    ObjectDictionaryCache::Key key;
+    bool haveIdentity = false;
+    for (const auto& slave : config_.slaves) {
+        if (slave.position == slavePosition && (slave.vendorId != 0U || slave.productCode != 0U)) {
+            key.vendorId = slave.vendorId;
+            key.productCode = slave.productCode;
+            haveIdentity = true;
+            break;
+        }
+    }
+    if (!haveIdentity) {
+        haveIdentity = readU32(1U, key.vendorId) && readU32(2U, key.productCode);
+    }
+    if (haveIdentity) {
+        readU32(3U, key.revision);
+        if (const auto* cached = objectDictionaryCache_.find(key)) {
+            outDictionary = *cached;
+            outError.clear();
+            return true;
+        }
+    }
+
+    if (!mailbox_.readObjectDictionary(slavePosition, outDictionary, outError)) {
+        return false;
+    }
+    // A partial scan is returned but not reused for other slaves or saved to disk.
+    if (haveIdentity && outDictionary.complete) {
+        objectDictionaryCache_.store(key, outDictionary);
+    }
+    return true;
+}
+
+ObjectDictionaryCache& EthercatMaster::objectDictionaryCache() {
+    return objectDictionaryCache_;
+}
+
 bool EthercatMaster::configureRxPdo(std::uint16_t slavePosition,
                                     const std::vector<PdoMappingEntry>& entries,
                                     std::string& outError) {
@@ -515,8 +670,28 @@ bool EthercatMaster::configureTxPdo(std::uint16_t slavePosition,
 }
 
 std::vector<EmergencyMessage> EthercatMaster::drainEmergencies(std::size_t maxMessages) {
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        collectEmergenciesLocked(maxMessages);
+    }
+    return emergencyQueue_.drain(maxMessages);
+}
+
+EmergencyQueue& EthercatMaster::emergencyQueue() { return emergencyQueue_; }
+
+void EthercatMaster::setEmergencyRateLimit(EmergencyRateLimitOptions options) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    return mailbox_.drainEmergencyQueue(maxMessages);
+    emergencyQueue_.setRateLimit(options);
+}
+
+void EthercatMaster::collectEmergenciesLocked(std::size_t maxMessages) {
+    // The scratch buffer keeps its capacity, so the cyclic drain does not allocate.
+    mailbox_.drainEmergencyQueue(maxMessages, emergencyScratch_);
+    for (auto& emergency : emergencyScratch_) {
+        emergency.cycleIndex = statistics_.cyclesTotal;
+        (void)emergencyQueue_.offer(emergency);
+    }
+    (void)emergencyQueue_.flushSuppressed(EmergencyQueue::nowNs());
 }
 
 FoEResponse EthercatMaster::foeReadFile(std::uint16_t slavePosition, const FoERequest& request) {
@@ -530,6 +705,29 @@ bool EthercatMaster::foeWriteFile(std::uint16_t slavePosition, const FoERequest&
     return foeEoe_.writeFile(slavePosition, request, data, outError);
 }
 
+bool EthercatMaster::foeReadFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                                       std::string& outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return foeEoe_.readFileStream(slavePosition, request, sink, outError);
+}
+
+bool EthercatMaster::foeWriteFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                                        std::string& outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return foeEoe_.writeFileStream(slavePosition, request, source, outError);
+}
+
+bool EthercatMaster::foeWriteFiles(std::vector<FoEWriteJob>& jobs, std::string& outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return foeEoe_.writeFiles(jobs, outError);
+}
+
+FirmwareUpdateReport EthercatMaster::updateFirmware(std::vector<FirmwareUpdateJob>& jobs,
+                                                    const FirmwareUpdateOptions& options) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return FirmwareUpdateOrchestrator(transport_).run(jobs, options);
+}
+
 bool EthercatMaster::eoeSendFrame(std::uint16_t slavePosition, const std::vector<std::uint8_t>& frame,
                                   std::string& outError) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
@@ -542,6 +740,11 @@ bool EthercatMaster::eoeReceiveFrame(std::uint16_t slavePosition, std::vector<st
     return foeEoe_.receiveEthernetOverEthercat(slavePosition, frame, outError);
 }
 
+std::size_t EthercatMaster::serviceEoeGateway(EoeGateway& gateway, std::string& outError) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return gateway.service(outError);
+}
+
 std::optional<std::int64_t> EthercatMaster::updateDistributedClock(std::int64_t referenceTimeNs,
                                                                    std::int64_t localTimeNs) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
@@ -565,14 +768,52 @@ std::optional<std::int64_t> EthercatMaster::lastAppliedDcCorrectionNs() const {
     return lastAppliedDcCorrectionNs_;
 }
 
+std::optional<DcReferenceSample> EthercatMaster::lastDcReferenceSample() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return lastDcReferenceSample_;
+}
+
+void EthercatMaster::setNextReceiveDeadline(std::chrono::steady_clock::time_point deadline) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    transport_.setNextReceiveDeadline(deadline);
+}
+
+void EthercatMaster::setNextLaunchTime(std::chrono::steady_clock::time_point launchTime) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    transport_.setNextLaunchTime(launchTime);
+}
+
 bool EthercatMaster::refreshTopology(std::string& outError) {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!topologyManager_.refresh(outError)) {
         return false;
     }
     const auto changes = topologyManager_.changeSet();
-    redundancyStatus_.redundancyHealthy = changes.redundancyHealthy;
-    if (!topologyRecoveryOptions_.enable) {
+    // Cached static objects follow the slave occupying a position, not the position.
+    for (const auto& slave : changes.added) {
+        mailbox_.invalidateCache(slave.position);
+    }
+    for (const auto& slave : changes.removed) {
+        mailbox_.invalidateCache(slave.position);
+    }
+    for (const auto& delta : changes.updated) {
+        if (!delta.isOnline || delta.vendorId != delta.previousVendorId ||
+            delta.productCode != delta.previousProductCode) {
+            mailbox_.invalidateCache(delta.position);
+        }
+    }
+    for (const auto& slave : topologyManager_.snapshot().slaves) {
+        if (slave.alStateValid) {
+            mailbox_.noteSlaveState(slave.position, slave.alState);
+        }
+    }
+    // Parallel redundancy reports the ring in every cycle; the scan's link check must not override it.
+    bool ringIntact = true;
+    const bool cyclicRedundancy = transport_.redundancyObservation(ringIntact);
+    if (!cyclicRedundancy) {
+        redundancyStatus_.redundancyHealthy = changes.redundancyHealthy;
+    }
+    if (!topologyRecoveryOptions_.enable && !cyclicRedundancy) {
         transitionRedundancyState(changes.redundancyHealthy ? RedundancyState::RedundantHealthy
                                                             : RedundancyState::RedundancyDegraded,
                                   changes.redundancyHealthy ? "redundancy healthy (policy disabled)"
@@ -649,6 +890,11 @@ EthercatMaster::RedundancyKpiSnapshot EthercatMaster::redundancyKpis() const {
     return redundancyKpis_;
 }
 
+EthercatMaster::StartupReport EthercatMaster::startupReport() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return startupReport_;
+}
+
 std::vector<EthercatMaster::RedundancyTransitionEvent> EthercatMaster::redundancyTransitions() const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     return redundancyTransitions_;
@@ -694,17 +940,44 @@ void EthercatMaster::configureDcClosedLoopFromEnvironment() {
     dcPhaseErrorAbsHistoryNs_.clear();
     dcPolicyLatched_ = false;
 
+    auto lineOptions = dcLineMonitor_.options();
+    lineOptions.enabled = parseBoolEnv("OEC_DC_LINE_MONITOR", lineOptions.enabled);
+    lineOptions.decimation = parseIntegralEnv<std::size_t>("OEC_DC_LINE_MONITOR_DECIMATION", lineOptions.decimation);
+    lineOptions.bucketWidthNs =
+        parseIntegralEnv<std::int64_t>("OEC_DC_LINE_MONITOR_BUCKET_NS", lineOptions.bucketWidthNs);
+    dcLineMonitor_ = DcLineMonitor(lineOptions);
+
     DistributedClockController::Options dcOptions{};
     dcOptions.filterAlpha = parseDoubleEnv("OEC_DC_FILTER_ALPHA", dcOptions.filterAlpha);
     dcOptions.kp = parseDoubleEnv("OEC_DC_KP", dcOptions.kp);
     dcOptions.ki = parseDoubleEnv("OEC_DC_KI", dcOptions.ki);
     dcOptions.correctionClampNs =
         parseIntegralEnv<std::int64_t>("OEC_DC_CORRECTION_CLAMP_NS", dcOptions.correctionClampNs);
+    if (const char* algorithm = std::getenv("OEC_DC_CONTROLLER")) {
+        const std::string value(algorithm);
+        if (value == "tracking") {
+            dcOptions.algorithm = DistributedClockController::Algorithm::DriftTracking;
+        } else if (value == "pi") {
+            dcOptions.algorithm = DistributedClockController::Algorithm::Pi;
+        }
+    }
+    dcOptions.trackingAlpha = parseDoubleEnv("OEC_DC_TRACK_ALPHA", dcOptions.trackingAlpha);
+    dcOptions.trackingBeta = parseDoubleEnv("OEC_DC_TRACK_BETA", dcOptions.trackingBeta);
     dcController_ = DistributedClockController(dcOptions);
     dcController_.reset();
 
     lastAppliedDcCorrectionNs_.reset();
+    lastDcReferenceSample_.reset();
     dcLinuxTransport_ = dynamic_cast<LinuxRawSocketTransport*>(&transport_);
+    dcClosedLoopOptions_.cyclicDistribution =
+        parseBoolEnv("OEC_DC_CYCLIC_ARMW", dcClosedLoopOptions_.cyclicDistribution);
+    if (dcLinuxTransport_ != nullptr &&
+        !dcLinuxTransport_->setDcReferenceDistribution(dcClosedLoopOptions_.cyclicDistribution,
+                                                       dcClosedLoopOptions_.referenceSlavePosition)) {
+        // The reference is not the first DC slave; the closed loop keeps the APRD/APWR path.
+        dcClosedLoopOptions_.cyclicDistribution = false;
+        setError(dcLinuxTransport_->lastError());
+    }
 }
 
 void EthercatMaster::configureTopologyRecoveryFromEnvironment() {
@@ -746,6 +1019,7 @@ void EthercatMaster::configureTopologyRecoveryFromEnvironment() {
     redundancyStatus_.state = RedundancyState::PrimaryOnly;
     redundancyKpis_ = RedundancyKpiSnapshot{};
     redundancyFaultActive_ = false;
+    lastRedundancyHealthyCycle_ = 0;
     redundancyTransitions_.clear();
     maxRedundancyTransitionHistory_ = parseIntegralEnv<std::size_t>(
         "OEC_TOPOLOGY_REDUNDANCY_HISTORY", maxRedundancyTransitionHistory_);
@@ -773,14 +1047,11 @@ void EthercatMaster::applyTopologyPolicyIfNeeded(const std::vector<SlaveIdentity
                                                  const std::vector<SlaveIdentity>& hotConnected,
                                                  bool redundancyHealthy,
                                                  std::uint64_t topologyGeneration) {
-    redundancyStatus_.redundancyHealthy = redundancyHealthy;
     const bool hasMissing = !missing.empty();
     const bool hasHotConnected = !hotConnected.empty();
-    const bool redundancyDown = !redundancyHealthy;
 
     missingConditionCycles_ = hasMissing ? (missingConditionCycles_ + 1U) : 0U;
     hotConnectConditionCycles_ = hasHotConnected ? (hotConnectConditionCycles_ + 1U) : 0U;
-    redundancyConditionCycles_ = redundancyDown ? (redundancyConditionCycles_ + 1U) : 0U;
 
     if (!hasMissing) {
         missingPolicyLatched_ = false;
@@ -788,40 +1059,10 @@ void EthercatMaster::applyTopologyPolicyIfNeeded(const std::vector<SlaveIdentity
     if (!hasHotConnected) {
         hotConnectPolicyLatched_ = false;
     }
-    if (!redundancyDown) {
-        redundancyPolicyLatched_ = false;
-    }
-
-    if (redundancyDown && !redundancyFaultActive_) {
-        redundancyFaultActive_ = true;
-        redundancyFaultStart_ = std::chrono::steady_clock::now();
-        ++redundancyKpis_.degradeEvents;
-        transitionRedundancyState(RedundancyState::RedundancyDegraded,
-                                  "redundancy down detected",
-                                  topologyGeneration);
-        redundancyKpis_.lastDetectionLatencyMs = 0;
-    } else if (!redundancyDown && redundancyFaultActive_) {
-        redundancyFaultActive_ = false;
-        redundancyRecoveryStart_ = std::chrono::steady_clock::now();
-        ++redundancyKpis_.recoverEvents;
-        transitionRedundancyState(RedundancyState::Recovering,
-                                  "redundancy link restored",
-                                  topologyGeneration);
-    }
 
-    auto emitEvent = [&](std::uint16_t slavePosition,
-                         TopologyPolicyAction policyAction,
-                         bool success,
+    auto emitEvent = [&](std::uint16_t slavePosition, TopologyPolicyAction policyAction, bool success,
                          const std::string& reason) {
-        RecoveryEvent event;
-        event.timestamp = std::chrono::system_clock::now();
-        event.cycleIndex = statistics_.cyclesTotal;
-        event.slavePosition = slavePosition;
-        event.alStatusCode = 0U;
-        event.action = mapTopologyActionToRecoveryAction(policyAction);
-        event.success = success;
-        event.message = "topology_generation=" + std::to_string(topologyGeneration) + " " + reason;
-        appendRecoveryEvent(event);
+        emitTopologyPolicyEvent(slavePosition, policyAction, success, reason, topologyGeneration);
     };
 
     if (hasMissing &&
@@ -898,6 +1139,59 @@ void EthercatMaster::applyTopologyPolicyIfNeeded(const std::vector<SlaveIdentity
         hotConnectPolicyLatched_ = true;
     }
 
+    // With parallel redundancy observeRedundancyLocked() owns the grace count and latch.
+    bool ringIntact = true;
+    if (!transport_.redundancyObservation(ringIntact)) {
+        applyRedundancyPolicyLocked(redundancyHealthy, topologyGeneration);
+    }
+}
+
+void EthercatMaster::emitTopologyPolicyEvent(std::uint16_t slavePosition, TopologyPolicyAction policyAction,
+                                             bool success, const std::string& reason,
+                                             std::uint64_t topologyGeneration) {
+    RecoveryEvent event;
+    event.timestamp = std::chrono::system_clock::now();
+    event.cycleIndex = statistics_.cyclesTotal;
+    event.slavePosition = slavePosition;
+    event.alStatusCode = 0U;
+    event.action = mapTopologyActionToRecoveryAction(policyAction);
+    event.success = success;
+    event.message = "topology_generation=" + std::to_string(topologyGeneration) + " " + reason;
+    appendRecoveryEvent(event);
+}
+
+void EthercatMaster::applyRedundancyPolicyLocked(bool redundancyHealthy, std::uint64_t topologyGeneration) {
+    redundancyStatus_.redundancyHealthy = redundancyHealthy;
+    const bool redundancyDown = !redundancyHealthy;
+    redundancyConditionCycles_ = redundancyDown ? (redundancyConditionCycles_ + 1U) : 0U;
+    if (!redundancyDown) {
+        redundancyPolicyLatched_ = false;
+        lastRedundancyHealthyCycle_ = statistics_.cyclesTotal;
+    }
+    auto emitEvent = [&](std::uint16_t slavePosition, TopologyPolicyAction policyAction, bool success,
+                         const std::string& reason) {
+        emitTopologyPolicyEvent(slavePosition, policyAction, success, reason, topologyGeneration);
+    };
+
+    if (redundancyDown && !redundancyFaultActive_) {
+        redundancyFaultActive_ = true;
+        redundancyFaultStart_ = std::chrono::steady_clock::now();
+        ++redundancyKpis_.degradeEvents;
+        transitionRedundancyState(RedundancyState::RedundancyDegraded,
+                                  "redundancy down detected",
+                                  topologyGeneration);
+        redundancyKpis_.lastDetectionLatencyMs = 0;
+        redundancyKpis_.lastDetectionLatencyCycles =
+            static_cast<std::int64_t>(statistics_.cyclesTotal - lastRedundancyHealthyCycle_);
+    } else if (!redundancyDown && redundancyFaultActive_) {
+        redundancyFaultActive_ = false;
+        redundancyRecoveryStart_ = std::chrono::steady_clock::now();
+        ++redundancyKpis_.recoverEvents;
+        transitionRedundancyState(RedundancyState::Recovering,
+                                  "redundancy link restored",
+                                  topologyGeneration);
+    }
+
     if (redundancyDown &&
         !redundancyPolicyLatched_ &&
         redundancyConditionCycles_ >= topologyRecoveryOptions_.redundancyGraceCycles) {
@@ -948,6 +1242,26 @@ void EthercatMaster::applyTopologyPolicyIfNeeded(const std::vector<SlaveIdentity
     }
 }
 
+void EthercatMaster::observeRedundancyLocked(bool ringIntact) {
+    if (ringIntact && redundancyStatus_.redundancyHealthy && !redundancyFaultActive_ &&
+        redundancyStatus_.state != RedundancyState::Recovering) {
+        lastRedundancyHealthyCycle_ = statistics_.cyclesTotal;
+        return;
+    }
+    const auto generation = topologyManager_.generation();
+    if (topologyRecoveryOptions_.enable) {
+        applyRedundancyPolicyLocked(ringIntact, generation);
+        return;
+    }
+    if (ringIntact) {
+        lastRedundancyHealthyCycle_ = statistics_.cyclesTotal;
+    }
+    redundancyStatus_.redundancyHealthy = ringIntact;
+    transitionRedundancyState(ringIntact ? RedundancyState::RedundantHealthy : RedundancyState::RedundancyDegraded,
+                              ringIntact ? "ring intact (policy disabled)" : "ring broken (policy disabled)",
+                              generation);
+}
+
 void EthercatMaster::transitionRedundancyState(RedundancyState newState,
                                                const std::string& reason,
                                                std::uint64_t topologyGeneration) {
@@ -973,6 +1287,100 @@ void EthercatMaster::transitionRedundancyState(RedundancyState newState,
     ++redundancyStatus_.transitionCount;
 }
 
+bool EthercatMaster::initializeDistributedClocks(const DcInitOptions& options, DcInitReport& outReport) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // Set by start() for a LinuxRawSocketTransport; DC init needs the open transport anyway.
+    if (dcLinuxTransport_ == nullptr) {
+        outReport = DcInitReport{};
+        outReport.error = "DC initialization requires a started LinuxRawSocketTransport";
+        dcInitReport_ = outReport;
+        setError(outReport.error);
+        return false;
+    }
+    std::string error;
+    const bool ok = dcLinuxTransport_->initializeDistributedClocks(options, outReport, error);
+    dcInitReport_ = outReport;
+    if (!ok) {
+        setError("DC initialization failed: " + error);
+        return false;
+    }
+    resolveDcLineMonitorPositionsLocked();
+    if (traceDc_) {
+        std::cout << "[oec-dc] init ref_slave=" << outReport.referenceSlavePosition
+                  << " max_delay_ns=" << outReport.maxPropagationDelayNs
+                  << " spread_ns=" << (outReport.spreadMeasured ? std::to_string(outReport.spreadNs) : "n/a") << '\n';
+    }
+    return true;
+}
+
+void EthercatMaster::setDcLineMonitorOptions(const DcLineMonitorOptions& options) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    dcLineMonitor_ = DcLineMonitor(options);
+    dcLineMonitorRoundQueued_ = false;
+    if (started_) {
+        resolveDcLineMonitorPositionsLocked();
+    }
+}
+
+DcLineMonitorSnapshot EthercatMaster::distributedClockLineQuality() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return dcLineMonitor_.snapshot();
+}
+
+void EthercatMaster::runDcLineMonitorLocked() {
+    if (!dcLineMonitor_.options().enabled || dcLinuxTransport_ == nullptr) {
+        return;
+    }
+    if (dcLineMonitorRoundQueued_) {
+        // Queued last cycle, carried by this cycle's input frame.
+        dcLineMonitorRoundQueued_ = false;
+        std::vector<DcSlaveSyncSample> samples;
+        if (dcLinuxTransport_->lastDcSystemTimeDifferences(samples)) {
+            dcLineMonitor_.record(samples);
+        } else {
+            dcLineMonitor_.recordFailure();
+            if (traceDc_) {
+                std::cout << "[oec-dc] line monitor round lost with its frame\n";
+            }
+        }
+    }
+    if (!dcLineMonitor_.due() || dcLineMonitorPositions_.empty() || dcLinuxTransport_->parallelRedundancyActive()) {
+        return;
+    }
+    dcLinuxTransport_->queueDcSystemTimeDifferenceRead(dcLineMonitorPositions_);
+    dcLineMonitorRoundQueued_ = true;
+}
+
+void EthercatMaster::resolveDcLineMonitorPositionsLocked() {
+    dcLineMonitorPositions_.clear();
+    if (!dcLineMonitor_.options().enabled || dcLinuxTransport_ == nullptr) {
+        return;
+    }
+    if (dcInitReport_.success) {
+        for (const auto& timing : dcInitReport_.slaves) {
+            if (timing.dcSupported) {
+                dcLineMonitorPositions_.push_back(timing.slavePosition);
+            }
+        }
+        return;
+    }
+    // Without a bring-up report, ask the ESCs; slaves without DC have no 0x092C to sample.
+    std::vector<std::uint16_t> configured;
+    for (const auto& slave : config_.slaves) {
+        configured.push_back(slave.position);
+    }
+    std::string error;
+    if (!configured.empty() && !dcLinuxTransport_->readDcCapableSlaves(configured, dcLineMonitorPositions_, error) &&
+        traceDc_) {
+        std::cout << "[oec-dc] line monitor DC capability scan failed: " << error << '\n';
+    }
+}
+
+DcInitReport EthercatMaster::dcInitReport() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return dcInitReport_;
+}
+
 bool EthercatMaster::runDcClosedLoopUpdate() {
     if (!dcClosedLoopOptions_.enabled) {
         return true;
@@ -984,14 +1392,28 @@ bool EthercatMaster::runDcClosedLoopUpdate() {
 
     std::int64_t slaveTimeNs = 0;
     std::string dcError;
-    if (!dcLinuxTransport_->readDcSystemTime(dcClosedLoopOptions_.referenceSlavePosition, slaveTimeNs, dcError)) {
+    // The ARMW frame is primary-port only; parallel redundancy falls back to the APRD path.
+    const bool cyclic = dcClosedLoopOptions_.cyclicDistribution && !dcLinuxTransport_->parallelRedundancyActive();
+    if (cyclic) {
+        // Read by the ARMW in this cycle's process-data frame.
+        if (!dcLinuxTransport_->lastDcReferenceTime(slaveTimeNs)) {
+            setError("DC reference time missing from cyclic frame");
+            return false;
+        }
+    } else if (!dcLinuxTransport_->readDcSystemTime(dcClosedLoopOptions_.referenceSlavePosition, slaveTimeNs,
+                                                    dcError)) {
         setError("DC read failed: " + dcError);
         return false;
     }
 
-    const auto hostNow = std::chrono::steady_clock::now().time_since_epoch();
-    const auto hostTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(hostNow).count() +
-                            dcClosedLoopOptions_.targetPhaseNs;
+    // With frame timestamping the host side is the ARMW frame's TX stamp, free of scheduling delay.
+    auto hostTime = std::chrono::steady_clock::now();
+    if (cyclic) {
+        (void)dcLinuxTransport_->lastDcReferenceTxTime(hostTime);
+    }
+    const auto hostTimeNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(hostTime.time_since_epoch()).count() +
+        dcClosedLoopOptions_.targetPhaseNs;
 
     DcSyncSample sample;
     sample.referenceTimeNs = slaveTimeNs;
@@ -1008,12 +1430,15 @@ bool EthercatMaster::runDcClosedLoopUpdate() {
                                             previous,
                                             dcClosedLoopOptions_.maxCorrectionStepNs,
                                             dcClosedLoopOptions_.maxSlewPerCycleNs);
-    if (!dcLinuxTransport_->writeDcSystemTimeOffset(dcClosedLoopOptions_.referenceSlavePosition,
-                                                    safeCorrection, dcError)) {
+    if (cyclic) {
+        dcLinuxTransport_->queueDcReferenceOffset(safeCorrection);
+    } else if (!dcLinuxTransport_->writeDcSystemTimeOffset(dcClosedLoopOptions_.referenceSlavePosition,
+                                                           safeCorrection, dcError)) {
         setError("DC write failed: " + dcError);
         return false;
     }
 
+    dcController_.notifyApplied(safeCorrection);
     lastAppliedDcCorrectionNs_ = safeCorrection;
     if (traceDc_) {
         const bool isLocked = dcSyncQuality_.locked;
@@ -1116,6 +1541,7 @@ bool EthercatMaster::transitionNetworkTo(SlaveState target) {
     const auto deadline = std::chrono::steady_clock::now() + stateMachineOptions_.transitionTimeout;
     while (std::chrono::steady_clock::now() < deadline) {
         SlaveState state = SlaveState::Init;
+        ++startupReport_.statePolls;
         if (!transport_.readNetworkState(state)) {
             setError("Failed to read network state: " + transport_.lastError());
             return false;
@@ -0,0 +1,256 @@
+/**
+ * @file firmware_update.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/master/firmware_update.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace oec {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+/**
+ * @brief Sink comparing read-back data against a second pass over the image.
+ */
+class CompareSink : public FoESink {
+public:
+    explicit CompareSink(FoESource& expected) : expected_(expected) {}
+
+    bool write(const std::uint8_t* data, std::size_t size, std::string& outError) override {
+        buffer_.resize(size);
+        std::size_t filled = 0U;
+        while (filled < size) {
+            std::size_t got = 0U;
+            if (!expected_.read(buffer_.data() + filled, size - filled, got, outError)) {
+                return false;
+            }
+            if (got == 0U) {
+                break;
+            }
+            filled += got;
+        }
+        if (filled != size || !std::equal(data, data + size, buffer_.begin())) {
+            outError = "firmware read-back mismatch at byte " + std::to_string(compared_);
+            return false;
+        }
+        compared_ += size;
+        return true;
+    }
+
+    bool finish(std::string& outError) {
+        std::uint8_t extra = 0U;
+        std::size_t got = 0U;
+        if (!expected_.read(&extra, 1U, got, outError)) {
+            return false;
+        }
+        if (got != 0U) {
+            outError = "firmware read-back shorter than image (" + std::to_string(compared_) + " bytes)";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    FoESource& expected_;
+    std::vector<std::uint8_t> buffer_;
+    std::size_t compared_ = 0;
+};
+
+} // namespace
+
+FirmwareUpdateOrchestrator::FirmwareUpdateOrchestrator(ITransport& transport) : transport_(transport) {}
+
+void FirmwareUpdateOrchestrator::transitionAll(std::vector<FirmwareUpdateSlaveReport>& reports,
+                                               std::vector<bool>& active, SlaveState target,
+                                               const FirmwareUpdateOptions& options,
+                                               std::chrono::microseconds FirmwareUpdateSlaveReport::*phaseTime) const {
+    const auto start = Clock::now();
+    std::vector<bool> waiting(reports.size(), false);
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        if (!active[i]) {
+            continue;
+        }
+        if (!transport_.requestSlaveState(reports[i].slavePosition, target)) {
+            if (reports[i].error.empty()) {
+                reports[i].error =
+                    "failed to request " + std::string(toString(target)) + ": " + transport_.lastError();
+            }
+            active[i] = false;
+            continue;
+        }
+        waiting[i] = true;
+    }
+
+    const auto deadline = start + options.transitionTimeout;
+    while (std::any_of(waiting.begin(), waiting.end(), [](bool w) { return w; })) {
+        for (std::size_t i = 0; i < reports.size(); ++i) {
+            if (!waiting[i]) {
+                continue;
+            }
+            SlaveState state = SlaveState::Init;
+            if (transport_.readSlaveState(reports[i].slavePosition, state) && state == target) {
+                waiting[i] = false;
+                reports[i].*phaseTime += since(start);
+            }
+        }
+        if (Clock::now() >= deadline) {
+            for (std::size_t i = 0; i < reports.size(); ++i) {
+                if (waiting[i]) {
+                    waiting[i] = false;
+                    active[i] = false;
+                    if (reports[i].error.empty()) {
+                        reports[i].error = "timeout waiting for " + std::string(toString(target));
+                    }
+                }
+            }
+            break;
+        }
+        if (std::any_of(waiting.begin(), waiting.end(), [](bool w) { return w; })) {
+            std::this_thread::sleep_for(options.pollInterval);
+        }
+    }
+}
+
+void FirmwareUpdateOrchestrator::configureMailboxes(std::vector<FirmwareUpdateSlaveReport>& reports,
+                                                    std::vector<bool>& active, bool bootstrap) const {
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        if (!active[i]) {
+            continue;
+        }
+        std::string error;
+        if (!transport_.configureMailboxSyncManagers(reports[i].slavePosition, bootstrap, error)) {
+            if (reports[i].error.empty()) {
+                reports[i].error = std::string("failed to configure ") + (bootstrap ? "bootstrap" : "standard") +
+                                   " mailbox: " + error;
+            }
+            active[i] = false;
+        }
+    }
+}
+
+FirmwareUpdateReport FirmwareUpdateOrchestrator::run(std::vector<FirmwareUpdateJob>& jobs,
+                                                     const FirmwareUpdateOptions& options) const {
+    const auto start = Clock::now();
+    FirmwareUpdateReport report;
+    report.slaves.resize(jobs.size());
+    std::vector<bool> active(jobs.size(), true);
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        report.slaves[i].slavePosition = jobs[i].slavePosition;
+        if (jobs[i].image == nullptr) {
+            report.slaves[i].error = "no firmware image";
+            active[i] = false;
+        }
+    }
+
+    // BOOTSTRAP is only entered from INIT, with SM0/SM1 already holding the bootstrap mailbox.
+    transitionAll(report.slaves, active, SlaveState::Init, options, &FirmwareUpdateSlaveReport::bootstrapTime);
+    configureMailboxes(report.slaves, active, true);
+    transitionAll(report.slaves, active, SlaveState::Bootstrap, options, &FirmwareUpdateSlaveReport::bootstrapTime);
+
+    // All transfers share frames; each slave's transfer ends with its last acknowledged packet.
+    const auto transferStart = Clock::now();
+    std::vector<FoEWriteJob> writes;
+    std::vector<std::size_t> owners;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (!active[i]) {
+            continue;
+        }
+        FoEWriteJob write;
+        write.slavePosition = jobs[i].slavePosition;
+        write.request.fileName = jobs[i].fileName;
+        write.request.password = jobs[i].password;
+        write.request.maxChunkBytes = options.maxChunkBytes;
+        auto* slaveReport = &report.slaves[i];
+        write.request.onProgress = [slaveReport, transferStart, &options](const FoEProgress& progress) {
+            slaveReport->bytesWritten = progress.bytesTransferred;
+            slaveReport->transferTime = since(transferStart);
+            if (options.onProgress) {
+                options.onProgress(progress);
+            }
+        };
+        write.source = jobs[i].image;
+        writes.push_back(std::move(write));
+        owners.push_back(i);
+    }
+    if (!writes.empty()) {
+        std::string error;
+        (void)transport_.foeWriteStreams(writes, error);
+        for (std::size_t w = 0; w < writes.size(); ++w) {
+            auto& slaveReport = report.slaves[owners[w]];
+            if (slaveReport.transferTime.count() == 0) {
+                slaveReport.transferTime = since(transferStart);
+            }
+            if (!writes[w].success) {
+                slaveReport.error = writes[w].error.empty() ? error : writes[w].error;
+                active[owners[w]] = false;
+            }
+        }
+    }
+
+    // Read-back needs one FoE read per slave; only slaves with a verify image take part.
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (!active[i] || jobs[i].verifyImage == nullptr) {
+            continue;
+        }
+        const auto verifyStart = Clock::now();
+        FoERequest request;
+        request.fileName = jobs[i].fileName;
+        request.password = jobs[i].password;
+        request.maxChunkBytes = options.maxChunkBytes;
+        CompareSink sink(*jobs[i].verifyImage);
+        std::string error;
+        if (!transport_.foeReadStream(jobs[i].slavePosition, request, sink, error) || !sink.finish(error)) {
+            report.slaves[i].error = "verify failed: " + error;
+            active[i] = false;
+        } else {
+            report.slaves[i].verified = true;
+        }
+        report.slaves[i].verifyTime = since(verifyStart);
+    }
+
+    // BOOTSTRAP only leaves to INIT; slaves that failed above are still brought back.
+    std::vector<bool> restore(jobs.size(), false);
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        restore[i] = (jobs[i].image != nullptr);
+    }
+    const auto updated = active;
+    transitionAll(report.slaves, restore, SlaveState::Init, options, &FirmwareUpdateSlaveReport::restoreTime);
+    configureMailboxes(report.slaves, restore, false);
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        restore[i] = restore[i] && updated[i];
+    }
+    // INIT may not jump to SAFEOP or OP: climb the ladder one state at a time.
+    const bool climb = options.finalState == SlaveState::PreOp || options.finalState == SlaveState::SafeOp ||
+                       options.finalState == SlaveState::Op;
+    for (const auto step : {SlaveState::PreOp, SlaveState::SafeOp, SlaveState::Op}) {
+        if (!climb) {
+            break;
+        }
+        transitionAll(report.slaves, restore, step, options, &FirmwareUpdateSlaveReport::restoreTime);
+        if (step == options.finalState) {
+            break;
+        }
+    }
+
+    report.success = !jobs.empty();
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        auto& slaveReport = report.slaves[i];
+        slaveReport.success = updated[i] && restore[i];
+        slaveReport.totalTime = slaveReport.bootstrapTime + slaveReport.transferTime + slaveReport.verifyTime +
+                                slaveReport.restoreTime;
+        report.serialTime += slaveReport.totalTime;
+        report.success = report.success && slaveReport.success;
+    }
+    report.wallTime = since(start);
+    return report;
+}
+
+} // namespace oec
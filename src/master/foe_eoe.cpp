@@ -5,7 +5,166 @@
 
 #include "openethercat/master/foe_eoe.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace oec {
+namespace {
+
+// Sent pages of a mapped image are dropped in steps of this size.
+constexpr std::size_t kMappedReleaseStep = 1U << 20U;
+
+std::size_t regularFileSize(int fd) {
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        return 0U;
+    }
+    return static_cast<std::size_t>(st.st_size);
+}
+
+} // namespace
+
+FoEMemorySource::FoEMemorySource(const std::vector<std::uint8_t>& data) : data_(data) {}
+
+bool FoEMemorySource::read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string&) {
+    outBytes = std::min(capacity, data_.size() - cursor_);
+    std::copy_n(data_.data() + cursor_, outBytes, buffer);
+    cursor_ += outBytes;
+    return true;
+}
+
+std::size_t FoEMemorySource::sizeHint() const { return data_.size(); }
+
+FoEVectorSink::FoEVectorSink(std::vector<std::uint8_t>& out) : out_(out) {}
+
+bool FoEVectorSink::write(const std::uint8_t* data, std::size_t size, std::string&) {
+    out_.insert(out_.end(), data, data + size);
+    return true;
+}
+
+FoEFdSource::FoEFdSource(int fd) : fd_(fd) {}
+
+bool FoEFdSource::read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string& outError) {
+    outBytes = 0U;
+    while (outBytes < capacity) {
+        const auto rc = ::read(fd_, buffer + outBytes, capacity - outBytes);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            outError = std::string("FoE source read failed: ") + std::strerror(errno);
+            return false;
+        }
+        if (rc == 0) {
+            break;
+        }
+        outBytes += static_cast<std::size_t>(rc);
+    }
+    return true;
+}
+
+std::size_t FoEFdSource::sizeHint() const { return regularFileSize(fd_); }
+
+FoEFdSink::FoEFdSink(int fd) : fd_(fd) {}
+
+bool FoEFdSink::write(const std::uint8_t* data, std::size_t size, std::string& outError) {
+    std::size_t written = 0U;
+    while (written < size) {
+        const auto rc = ::write(fd_, data + written, size - written);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            outError = std::string("FoE sink write failed: ") + std::strerror(errno);
+            return false;
+        }
+        written += static_cast<std::size_t>(rc);
+    }
+    return true;
+}
+
+FoEMappedFileSource::~FoEMappedFileSource() { close(); }
+
+bool FoEMappedFileSource::open(const std::string& path, std::string& outError) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        outError = "Cannot open file: " + path;
+        return false;
+    }
+    size_ = regularFileSize(fd);
+    if (size_ > 0U) {
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0U;
+            outError = "Cannot map file: " + path;
+            return false;
+        }
+        base_ = static_cast<std::uint8_t*>(mapped);
+        ::madvise(base_, size_, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+    return true;
+}
+
+void FoEMappedFileSource::close() {
+    if (base_ != nullptr) {
+        ::munmap(base_, size_);
+    }
+    base_ = nullptr;
+    size_ = 0U;
+    cursor_ = 0U;
+    released_ = 0U;
+}
+
+bool FoEMappedFileSource::read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string&) {
+    outBytes = std::min(capacity, size_ - cursor_);
+    if (outBytes > 0U) {
+        std::copy_n(base_ + cursor_, outBytes, buffer);
+        cursor_ += outBytes;
+    }
+    if (cursor_ - released_ >= kMappedReleaseStep) {
+        const auto release = (cursor_ - released_) - ((cursor_ - released_) % kMappedReleaseStep);
+        ::madvise(base_ + released_, release, MADV_DONTNEED);
+        released_ += release;
+    }
+    return true;
+}
+
+std::size_t FoEMappedFileSource::sizeHint() const { return size_; }
+
+FoECallbackSource::FoECallbackSource(ReadFn read, std::size_t sizeHint)
+    : read_(std::move(read)), sizeHint_(sizeHint) {}
+
+bool FoECallbackSource::read(std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes,
+                             std::string& outError) {
+    outBytes = 0U;
+    if (!read_) {
+        outError = "FoE source callback not set";
+        return false;
+    }
+    return read_(buffer, capacity, outBytes, outError);
+}
+
+std::size_t FoECallbackSource::sizeHint() const { return sizeHint_; }
+
+FoECallbackSink::FoECallbackSink(WriteFn write) : write_(std::move(write)) {}
+
+bool FoECallbackSink::write(const std::uint8_t* data, std::size_t size, std::string& outError) {
+    if (!write_) {
+        outError = "FoE sink callback not set";
+        return false;
+    }
+    return write_(data, size, outError);
+}
 
 FoeEoeService::FoeEoeService(ITransport& transport) : transport_(transport) {}
 
@@ -26,6 +185,49 @@ bool FoeEoeService::writeFile(std::uint16_t slavePosition,
     return transport_.foeWrite(slavePosition, request, data, outError);
 }
 
+bool FoeEoeService::readFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                                   std::string& outError) const {
+    outError.clear();
+    if (transport_.foeReadStream(slavePosition, request, sink, outError)) {
+        return true;
+    }
+    if (outError.empty()) {
+        outError = "FoE streaming not supported by transport";
+    }
+    return false;
+}
+
+bool FoeEoeService::writeFileStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                                    std::string& outError) const {
+    outError.clear();
+    if (transport_.foeWriteStream(slavePosition, request, source, outError)) {
+        return true;
+    }
+    if (outError.empty()) {
+        outError = "FoE streaming not supported by transport";
+    }
+    return false;
+}
+
+bool FoeEoeService::writeFiles(std::vector<FoEWriteJob>& jobs, std::string& outError) const {
+    outError.clear();
+    for (auto& job : jobs) {
+        job.success = false;
+        job.error.clear();
+        if (job.source == nullptr) {
+            outError = "FoE write job without source";
+            return false;
+        }
+    }
+    if (transport_.foeWriteStreams(jobs, outError)) {
+        return true;
+    }
+    if (outError.empty()) {
+        outError = "FoE streaming not supported by transport";
+    }
+    return false;
+}
+
 bool FoeEoeService::sendEthernetOverEthercat(std::uint16_t slavePosition,
                                              const std::vector<std::uint8_t>& frame,
                                              std::string& outError) const {
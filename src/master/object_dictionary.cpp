@@ -0,0 +1,261 @@
+/**
+ * @file object_dictionary.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/master/object_dictionary.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+
+namespace oec {
+namespace {
+
+constexpr std::uint8_t kMagic[4] = {'O', 'E', 'C', 'D'};
+constexpr std::uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t kFnvPrime = 0x100000001b3ULL;
+constexpr std::uint16_t kAccessRxPdoMappable = 0x0040U;
+constexpr std::uint16_t kAccessTxPdoMappable = 0x0080U;
+
+std::uint64_t fnv1a(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t hash = kFnvOffset;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+void putLe(std::vector<std::uint8_t>& out, std::uint64_t value, std::size_t width) {
+    for (std::size_t i = 0; i < width; ++i) {
+        out.push_back(static_cast<std::uint8_t>((value >> (8U * i)) & 0xFFU));
+    }
+}
+
+void putString(std::vector<std::uint8_t>& out, const std::string& text) {
+    putLe(out, text.size(), 2U);
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+class Reader {
+public:
+    Reader(const std::vector<std::uint8_t>& bytes, std::size_t begin, std::size_t end)
+        : bytes_(bytes), offset_(begin), end_(end) {}
+
+    template <typename T>
+    bool get(T& out) {
+        if (end_ - offset_ < sizeof(T)) {
+            return false;
+        }
+        std::uint64_t value = 0U;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<std::uint64_t>(bytes_[offset_ + i]) << (8U * i);
+        }
+        offset_ += sizeof(T);
+        out = static_cast<T>(value);
+        return true;
+    }
+    bool getString(std::string& out) {
+        std::uint16_t size = 0U;
+        if (!get(size) || end_ - offset_ < size) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(bytes_.data() + offset_), size);
+        offset_ += size;
+        return true;
+    }
+    bool done() const { return offset_ == end_; }
+
+private:
+    const std::vector<std::uint8_t>& bytes_;
+    std::size_t offset_;
+    std::size_t end_;
+};
+
+} // namespace
+
+const CoeObjectDescription* ObjectDictionary::findObject(std::uint16_t index) const {
+    // Objects are kept in OD-list order, which slaves report ascending.
+    const auto it = std::lower_bound(objects.begin(), objects.end(), index,
+                                     [](const CoeObjectDescription& o, std::uint16_t i) { return o.index < i; });
+    if (it != objects.end() && it->index == index) {
+        return &*it;
+    }
+    const auto linear = std::find_if(objects.begin(), objects.end(),
+                                     [index](const CoeObjectDescription& o) { return o.index == index; });
+    return (linear != objects.end()) ? &*linear : nullptr;
+}
+
+const CoeEntryDescription* ObjectDictionary::findEntry(std::uint16_t index, std::uint8_t subIndex) const {
+    const auto* object = findObject(index);
+    if (object == nullptr) {
+        return nullptr;
+    }
+    for (const auto& entry : object->entries) {
+        if (entry.subIndex == subIndex) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ObjectDictionary::mappingEntry(std::uint16_t index, std::uint8_t subIndex, PdoMappingEntry& outEntry) const {
+    const auto* entry = findEntry(index, subIndex);
+    if (entry == nullptr || entry->bitLength == 0U || entry->bitLength > 0xFFU ||
+        (entry->objectAccess & (kAccessRxPdoMappable | kAccessTxPdoMappable)) == 0U) {
+        return false;
+    }
+    outEntry.index = index;
+    outEntry.subIndex = subIndex;
+    outEntry.bitLength = static_cast<std::uint8_t>(entry->bitLength);
+    return true;
+}
+
+bool ObjectDictionaryCache::Key::operator<(const Key& other) const {
+    return std::tie(vendorId, productCode, revision) < std::tie(other.vendorId, other.productCode, other.revision);
+}
+
+const ObjectDictionary* ObjectDictionaryCache::find(const Key& key) const {
+    const auto it = dictionaries_.find(key);
+    return (it != dictionaries_.end()) ? &it->second : nullptr;
+}
+
+void ObjectDictionaryCache::store(const Key& key, ObjectDictionary dictionary) {
+    dictionaries_[key] = std::move(dictionary);
+}
+
+std::size_t ObjectDictionaryCache::size() const {
+    return dictionaries_.size();
+}
+
+void ObjectDictionaryCache::clear() {
+    dictionaries_.clear();
+}
+
+std::vector<std::uint8_t> ObjectDictionaryCache::encode() const {
+    std::vector<std::uint8_t> out(std::begin(kMagic), std::end(kMagic));
+    putLe(out, kFormatVersion, 4U);
+    putLe(out, dictionaries_.size(), 4U);
+    for (const auto& [key, dictionary] : dictionaries_) {
+        putLe(out, key.vendorId, 4U);
+        putLe(out, key.productCode, 4U);
+        putLe(out, key.revision, 4U);
+        putLe(out, dictionary.objects.size(), 4U);
+        for (const auto& object : dictionary.objects) {
+            putLe(out, object.index, 2U);
+            putLe(out, object.dataType, 2U);
+            putLe(out, object.maxSubIndex, 1U);
+            putLe(out, object.objectCode, 1U);
+            putString(out, object.name);
+            putLe(out, object.entries.size(), 2U);
+            for (const auto& entry : object.entries) {
+                putLe(out, entry.subIndex, 1U);
+                putLe(out, entry.valueInfo, 1U);
+                putLe(out, entry.dataType, 2U);
+                putLe(out, entry.bitLength, 2U);
+                putLe(out, entry.objectAccess, 2U);
+                putString(out, entry.name);
+            }
+        }
+    }
+    putLe(out, fnv1a(out.data(), out.size()), 8U);
+    return out;
+}
+
+bool ObjectDictionaryCache::decode(const std::vector<std::uint8_t>& bytes, std::string& outError) {
+    if (bytes.size() < 20U || !std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin())) {
+        outError = "object dictionary cache has bad magic";
+        return false;
+    }
+    const auto payloadEnd = bytes.size() - 8U;
+    std::uint64_t checksum = 0U;
+    Reader trailer(bytes, payloadEnd, bytes.size());
+    trailer.get(checksum);
+    if (checksum != fnv1a(bytes.data(), payloadEnd)) {
+        outError = "object dictionary cache checksum mismatch";
+        return false;
+    }
+
+    Reader in(bytes, 4U, payloadEnd);
+    std::uint32_t version = 0U;
+    std::uint32_t count = 0U;
+    if (!in.get(version) || version != kFormatVersion || !in.get(count)) {
+        outError = "object dictionary cache version mismatch";
+        return false;
+    }
+    std::map<Key, ObjectDictionary> loaded;
+    for (std::uint32_t d = 0; d < count; ++d) {
+        Key key;
+        std::uint32_t objectCount = 0U;
+        if (!in.get(key.vendorId) || !in.get(key.productCode) || !in.get(key.revision) || !in.get(objectCount)) {
+            outError = "object dictionary cache truncated";
+            return false;
+        }
+        ObjectDictionary dictionary;
+        for (std::uint32_t o = 0; o < objectCount; ++o) {
+            CoeObjectDescription object;
+            std::uint16_t entryCount = 0U;
+            if (!in.get(object.index) || !in.get(object.dataType) || !in.get(object.maxSubIndex) ||
+                !in.get(object.objectCode) || !in.getString(object.name) || !in.get(entryCount)) {
+                outError = "object dictionary cache truncated";
+                return false;
+            }
+            for (std::uint16_t e = 0; e < entryCount; ++e) {
+                CoeEntryDescription entry;
+                if (!in.get(entry.subIndex) || !in.get(entry.valueInfo) || !in.get(entry.dataType) ||
+                    !in.get(entry.bitLength) || !in.get(entry.objectAccess) || !in.getString(entry.name)) {
+                    outError = "object dictionary cache truncated";
+                    return false;
+                }
+                object.entries.push_back(std::move(entry));
+            }
+            dictionary.objects.push_back(std::move(object));
+        }
+        loaded[key] = std::move(dictionary);
+    }
+    if (!in.done()) {
+        outError = "object dictionary cache truncated";
+        return false;
+    }
+    dictionaries_ = std::move(loaded);
+    return true;
+}
+
+bool ObjectDictionaryCache::saveToFile(const std::string& path, std::string& outError) const {
+    outError.clear();
+    const auto bytes = encode();
+    const auto tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            outError = "Cannot open file: " + tmpPath;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            outError = "Failed writing file: " + tmpPath;
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        outError = "Failed to replace file: " + path;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ObjectDictionaryCache::loadFromFile(const std::string& path, std::string& outError) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        outError = "Cannot open file: " + path;
+        return false;
+    }
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decode(bytes, outError);
+}
+
+} // namespace oec
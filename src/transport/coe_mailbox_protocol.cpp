@@ -13,18 +13,41 @@ namespace {
 constexpr std::uint16_t kCoeServiceSdoReq = 0x0002;
 constexpr std::uint16_t kCoeServiceSdoRes = 0x0003;
 constexpr std::uint16_t kCoeServiceEmergency = 0x0001;
+constexpr std::uint16_t kCoeServiceSdoInfo = 0x0008;
 constexpr std::uint8_t kSdoCmdUploadInitiateReq = 0x40;
 constexpr std::uint8_t kSdoCmdUploadInitiateRes = 0x40;
 constexpr std::uint8_t kSdoCmdUploadSegmentReqBase = 0x60;
 constexpr std::uint8_t kSdoCmdUploadSegmentResBase = 0x00;
 constexpr std::uint8_t kSdoCmdDownloadInitiateReq = 0x21; // size indicated, segmented
+constexpr std::uint8_t kSdoCmdDownloadExpeditedReq = 0x23; // size indicated, expedited
 constexpr std::uint8_t kSdoCmdDownloadInitiateRes = 0x60;
 constexpr std::uint8_t kSdoCmdDownloadSegmentReqBase = 0x00;
 constexpr std::uint8_t kSdoCmdDownloadSegmentResBase = 0x20;
 constexpr std::uint8_t kSdoCmdAbort = 0x80;
 
+// CoE header (2) + SDO command (1).
+constexpr std::size_t kSegmentHeaderBytes = 3U;
+// CoE header (2) + command (1) + index (2) + sub-index (1) + size/data (4).
+constexpr std::size_t kInitiateHeaderBytes = 10U;
+// CoE header (2) + op-code (1) + reserved (1) + fragments left (2).
+constexpr std::size_t kSdoInfoHeaderBytes = 6U;
+
 } // namespace
 
+std::size_t CoeMailboxProtocol::maxSegmentDataBytes(std::size_t mailboxBytes) {
+    if (mailboxBytes <= kMailboxHeaderBytes + kSegmentHeaderBytes + kMinSegmentBytes) {
+        return kMinSegmentBytes;
+    }
+    return mailboxBytes - kMailboxHeaderBytes - kSegmentHeaderBytes;
+}
+
+std::size_t CoeMailboxProtocol::maxInitiateDownloadDataBytes(std::size_t mailboxBytes) {
+    if (mailboxBytes <= kMailboxHeaderBytes + kInitiateHeaderBytes) {
+        return 0U;
+    }
+    return mailboxBytes - kMailboxHeaderBytes - kInitiateHeaderBytes;
+}
+
 std::vector<std::uint8_t> CoeMailboxProtocol::encodeEscMailbox(const EscMailboxFrame& frame) {
     std::vector<std::uint8_t> out;
     out.reserve(6U + frame.payload.size());
@@ -75,11 +98,12 @@ bool CoeMailboxProtocol::parseEmergency(const std::vector<std::uint8_t>& payload
     return true;
 }
 
-std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInitiateUploadRequest(SdoAddress address) {
+std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInitiateUploadRequest(SdoAddress address,
+                                                                             bool completeAccess) {
     std::vector<std::uint8_t> out;
     out.reserve(10U);
     putLe16(out, kCoeServiceSdoReq);
-    out.push_back(kSdoCmdUploadInitiateReq);
+    out.push_back(static_cast<std::uint8_t>(kSdoCmdUploadInitiateReq | (completeAccess ? kSdoCompleteAccessBit : 0U)));
     putLe16(out, address.index);
     out.push_back(address.subIndex);
     putLe32(out, 0U);
@@ -128,8 +152,18 @@ CoeSdoInitiateUploadResponse CoeMailboxProtocol::parseSdoInitiateUploadResponse(
         const auto used = 4U - std::min<std::size_t>(unusedBytes, 3U);
         response.data.assign(payload.begin() + 6, payload.begin() + static_cast<std::ptrdiff_t>(6U + used));
         response.completeSize = static_cast<std::uint32_t>(response.data.size());
-    } else if (response.sizeIndicated) {
-        response.completeSize = readLe32(payload, 6);
+    } else {
+        if (response.sizeIndicated) {
+            response.completeSize = readLe32(payload, 6);
+        }
+        // Slaves with a large mailbox may return the first data bytes inline.
+        if (payload.size() > kInitiateHeaderBytes) {
+            auto end = payload.end();
+            if (response.sizeIndicated && payload.size() - kInitiateHeaderBytes > response.completeSize) {
+                end = payload.begin() + static_cast<std::ptrdiff_t>(kInitiateHeaderBytes + response.completeSize);
+            }
+            response.data.assign(payload.begin() + static_cast<std::ptrdiff_t>(kInitiateHeaderBytes), end);
+        }
     }
 
     response.success = true;
@@ -160,8 +194,9 @@ CoeSdoSegmentUploadResponse CoeMailboxProtocol::parseSdoUploadSegmentResponse(
 
     const auto cmd = payload[2];
     if (cmd == kSdoCmdAbort) {
-        if (payload.size() >= 7U) {
-            response.abortCode = readLe32(payload, 3);
+        // Abort transfer: index (3..4), sub-index (5), abort code (6..9).
+        if (payload.size() >= 10U) {
+            response.abortCode = readLe32(payload, 6);
         }
         response.error = "SDO abort";
         return response;
@@ -186,15 +221,35 @@ CoeSdoSegmentUploadResponse CoeMailboxProtocol::parseSdoUploadSegmentResponse(
     return response;
 }
 
-std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInitiateDownloadRequest(SdoAddress address,
-                                                                               std::uint32_t totalSize) {
+std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInitiateDownloadRequest(
+    SdoAddress address,
+    std::uint32_t totalSize,
+    const std::vector<std::uint8_t>& initialData,
+    bool completeAccess) {
     std::vector<std::uint8_t> out;
-    out.reserve(10U);
+    out.reserve(kInitiateHeaderBytes + initialData.size());
     putLe16(out, kCoeServiceSdoReq);
-    out.push_back(kSdoCmdDownloadInitiateReq);
+    out.push_back(static_cast<std::uint8_t>(kSdoCmdDownloadInitiateReq | (completeAccess ? kSdoCompleteAccessBit : 0U)));
     putLe16(out, address.index);
     out.push_back(address.subIndex);
     putLe32(out, totalSize);
+    out.insert(out.end(), initialData.begin(), initialData.end());
+    return out;
+}
+
+std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoExpeditedDownloadRequest(
+    SdoAddress address,
+    const std::vector<std::uint8_t>& data) {
+    const auto used = std::min<std::size_t>(std::max<std::size_t>(data.size(), 1U), 4U);
+    std::vector<std::uint8_t> out;
+    out.reserve(10U);
+    putLe16(out, kCoeServiceSdoReq);
+    out.push_back(static_cast<std::uint8_t>(kSdoCmdDownloadExpeditedReq | (((4U - used) & 0x03U) << 2U)));
+    putLe16(out, address.index);
+    out.push_back(address.subIndex);
+    for (std::size_t i = 0; i < 4U; ++i) {
+        out.push_back(i < data.size() ? data[i] : 0U);
+    }
     return out;
 }
 
@@ -215,14 +270,16 @@ CoeSdoAckResponse CoeMailboxProtocol::parseSdoInitiateDownloadResponse(
 
     const auto cmd = payload[2];
     if (cmd == kSdoCmdAbort) {
-        if (payload.size() >= 7U) {
-            response.abortCode = readLe32(payload, 3);
+        // Abort transfer: index (3..4), sub-index (5), abort code (6..9).
+        if (payload.size() >= 10U) {
+            response.abortCode = readLe32(payload, 6);
         }
         response.error = "SDO abort";
         return response;
     }
 
-    if (cmd != kSdoCmdDownloadInitiateRes) {
+    // Some slaves echo the Complete Access bit in the response.
+    if ((cmd & static_cast<std::uint8_t>(~kSdoCompleteAccessBit)) != kSdoCmdDownloadInitiateRes) {
         response.error = "Unexpected SDO command for initiate download response";
         return response;
     }
@@ -244,7 +301,9 @@ std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoDownloadSegmentRequest(std
                                                                               const std::vector<std::uint8_t>& segmentData,
                                                                               std::size_t maxSegmentBytes) {
     const auto clampedBytes = std::min(segmentData.size(), maxSegmentBytes);
-    const auto unused = static_cast<std::uint8_t>(maxSegmentBytes - clampedBytes);
+    // Unused-byte count only describes segments shorter than the classic 7 bytes.
+    const auto unused = static_cast<std::uint8_t>(
+        (clampedBytes < kMinSegmentBytes) ? (kMinSegmentBytes - clampedBytes) : 0U);
 
     std::vector<std::uint8_t> out;
     out.reserve(3U + clampedBytes);
@@ -274,8 +333,9 @@ CoeSdoAckResponse CoeMailboxProtocol::parseSdoDownloadSegmentResponse(
 
     const auto cmd = payload[2];
     if (cmd == kSdoCmdAbort) {
-        if (payload.size() >= 7U) {
-            response.abortCode = readLe32(payload, 3);
+        // Abort transfer: index (3..4), sub-index (5), abort code (6..9).
+        if (payload.size() >= 10U) {
+            response.abortCode = readLe32(payload, 6);
         }
         response.error = "SDO abort";
         return response;
@@ -295,6 +355,111 @@ CoeSdoAckResponse CoeMailboxProtocol::parseSdoDownloadSegmentResponse(
     return response;
 }
 
+std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInfoGetOdListRequest(std::uint16_t listType) {
+    std::vector<std::uint8_t> out;
+    out.reserve(kSdoInfoHeaderBytes + 2U);
+    putLe16(out, kCoeServiceSdoInfo);
+    out.push_back(kSdoInfoGetOdListReq);
+    out.push_back(0U);
+    putLe16(out, 0U);
+    putLe16(out, listType);
+    return out;
+}
+
+std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInfoGetObjectDescriptionRequest(std::uint16_t index) {
+    std::vector<std::uint8_t> out;
+    out.reserve(kSdoInfoHeaderBytes + 2U);
+    putLe16(out, kCoeServiceSdoInfo);
+    out.push_back(kSdoInfoGetObjectDescReq);
+    out.push_back(0U);
+    putLe16(out, 0U);
+    putLe16(out, index);
+    return out;
+}
+
+std::vector<std::uint8_t> CoeMailboxProtocol::buildSdoInfoGetEntryDescriptionRequest(std::uint16_t index,
+                                                                                     std::uint8_t subIndex,
+                                                                                     std::uint8_t valueInfo) {
+    std::vector<std::uint8_t> out;
+    out.reserve(kSdoInfoHeaderBytes + 4U);
+    putLe16(out, kCoeServiceSdoInfo);
+    out.push_back(kSdoInfoGetEntryDescReq);
+    out.push_back(0U);
+    putLe16(out, 0U);
+    putLe16(out, index);
+    out.push_back(subIndex);
+    out.push_back(valueInfo);
+    return out;
+}
+
+CoeSdoInfoFragment CoeMailboxProtocol::parseSdoInfoFragment(const std::vector<std::uint8_t>& payload) {
+    CoeSdoInfoFragment fragment;
+    if (payload.size() < kSdoInfoHeaderBytes) {
+        fragment.error = "SDO information response too short";
+        return fragment;
+    }
+    if (readLe16(payload, 0) != kCoeServiceSdoInfo) {
+        fragment.error = "Unexpected CoE service in SDO information response";
+        return fragment;
+    }
+
+    fragment.opCode = static_cast<std::uint8_t>(payload[2] & 0x7FU);
+    fragment.incomplete = (payload[2] & 0x80U) != 0U;
+    fragment.fragmentsLeft = readLe16(payload, 4);
+    if (fragment.opCode == kSdoInfoError) {
+        if (payload.size() >= kSdoInfoHeaderBytes + 4U) {
+            fragment.abortCode = readLe32(payload, kSdoInfoHeaderBytes);
+        }
+        fragment.error = "SDO information error";
+        return fragment;
+    }
+    fragment.data.assign(payload.begin() + static_cast<std::ptrdiff_t>(kSdoInfoHeaderBytes), payload.end());
+    fragment.success = true;
+    return fragment;
+}
+
+bool CoeMailboxProtocol::parseSdoInfoOdList(const std::vector<std::uint8_t>& data,
+                                            std::vector<std::uint16_t>& outIndices) {
+    if (data.size() < 2U || (data.size() % 2U) != 0U) {
+        return false;
+    }
+    outIndices.clear();
+    outIndices.reserve((data.size() - 2U) / 2U);
+    for (std::size_t offset = 2U; offset < data.size(); offset += 2U) {
+        outIndices.push_back(readLe16(data, offset));
+    }
+    return true;
+}
+
+bool CoeMailboxProtocol::parseSdoInfoObjectDescription(const std::vector<std::uint8_t>& data,
+                                                       CoeObjectDescription& outObject) {
+    // index (2), data type (2), max sub-index (1), object code (1), name.
+    if (data.size() < 6U) {
+        return false;
+    }
+    outObject.index = readLe16(data, 0);
+    outObject.dataType = readLe16(data, 2);
+    outObject.maxSubIndex = data[4];
+    outObject.objectCode = data[5];
+    outObject.name.assign(data.begin() + 6, data.end());
+    return true;
+}
+
+bool CoeMailboxProtocol::parseSdoInfoEntryDescription(const std::vector<std::uint8_t>& data,
+                                                      CoeEntryDescription& outEntry) {
+    // index (2), sub-index (1), value info (1), data type (2), bit length (2), access (2), name.
+    if (data.size() < 10U) {
+        return false;
+    }
+    outEntry.subIndex = data[2];
+    outEntry.valueInfo = data[3];
+    outEntry.dataType = readLe16(data, 4);
+    outEntry.bitLength = readLe16(data, 6);
+    outEntry.objectAccess = readLe16(data, 8);
+    outEntry.name.assign(data.begin() + 10, data.end());
+    return true;
+}
+
 std::uint16_t CoeMailboxProtocol::readLe16(const std::vector<std::uint8_t>& in, std::size_t offset) {
     return static_cast<std::uint16_t>(static_cast<std::uint16_t>(in[offset]) |
                                       (static_cast<std::uint16_t>(in[offset + 1]) << 8U));
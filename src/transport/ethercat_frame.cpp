@@ -14,6 +14,9 @@ constexpr std::size_t kEthernetHeaderBytes = 14;
 constexpr std::size_t kEthercatHeaderBytes = 2;
 constexpr std::size_t kDatagramHeaderBytes = 10;
 constexpr std::size_t kFrameMinBytes = kEthernetHeaderBytes + kEthercatHeaderBytes + kDatagramHeaderBytes + 2;
+constexpr std::size_t kWkcBytes = 2;
+constexpr std::uint16_t kDatagramLengthMask = 0x07FFU;
+constexpr std::uint16_t kDatagramMoreFollows = 0x8000U;
 
 void put16be(std::vector<std::uint8_t>& out, std::uint16_t value) {
     out.push_back(static_cast<std::uint8_t>((value >> 8U) & 0xFFU));
@@ -67,6 +70,87 @@ std::optional<EthercatLrwResponse> EthercatFrameCodec::parseLrwFrame(
     return response;
 }
 
+std::size_t EthercatFrameCodec::datagramWireBytes(const EthercatDatagramRequest& request) {
+    return kDatagramHeaderBytes + request.payload.size() + kWkcBytes;
+}
+
+std::vector<std::uint8_t> EthercatFrameCodec::buildMultiDatagramFrame(
+    const std::uint8_t destinationMac[6],
+    const std::uint8_t sourceMac[6],
+    const std::vector<EthercatDatagramRequest>& requests) {
+    std::size_t datagramBytes = 0U;
+    for (const auto& request : requests) {
+        datagramBytes += datagramWireBytes(request);
+    }
+
+    std::vector<std::uint8_t> frame;
+    frame.reserve(kEthernetHeaderBytes + kEthercatHeaderBytes + datagramBytes);
+    frame.insert(frame.end(), destinationMac, destinationMac + 6);
+    frame.insert(frame.end(), sourceMac, sourceMac + 6);
+    put16be(frame, kEtherTypeEthercat);
+    put16le(frame, static_cast<std::uint16_t>((datagramBytes & kDatagramLengthMask) | 0x1000U));
+
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        frame.push_back(request.command);
+        frame.push_back(request.datagramIndex);
+        put16le(frame, request.adp);
+        put16le(frame, request.ado);
+        auto lenField = static_cast<std::uint16_t>(request.payload.size() & kDatagramLengthMask);
+        if (i + 1U < requests.size()) {
+            lenField = static_cast<std::uint16_t>(lenField | kDatagramMoreFollows);
+        }
+        put16le(frame, lenField);
+        put16le(frame, 0U); // IRQ
+        frame.insert(frame.end(), request.payload.begin(), request.payload.end());
+        put16le(frame, 0U); // Placeholder WKC in request.
+    }
+    return frame;
+}
+
+bool EthercatFrameCodec::parseMultiDatagramFrame(const std::vector<std::uint8_t>& ethernetFrame,
+                                                 std::vector<EthercatDatagramResponse>& outResponses) {
+    outResponses.clear();
+    if (ethernetFrame.size() < kFrameMinBytes) {
+        return false;
+    }
+    if (get16be(ethernetFrame, 12) != kEtherTypeEthercat) {
+        return false;
+    }
+    const auto ethercatLength = static_cast<std::size_t>(get16le(ethernetFrame, 14) & kDatagramLengthMask);
+    const auto end = kEthernetHeaderBytes + kEthercatHeaderBytes + ethercatLength;
+    if (end > ethernetFrame.size()) {
+        return false;
+    }
+
+    std::size_t offset = kEthernetHeaderBytes + kEthercatHeaderBytes;
+    while (true) {
+        if (offset + kDatagramHeaderBytes + kWkcBytes > end) {
+            return false;
+        }
+        const auto lenField = get16le(ethernetFrame, offset + 6U);
+        const auto payloadSize = static_cast<std::size_t>(lenField & kDatagramLengthMask);
+        const auto payloadOffset = offset + kDatagramHeaderBytes;
+        const auto wkcOffset = payloadOffset + payloadSize;
+        if (wkcOffset + kWkcBytes > end) {
+            return false;
+        }
+
+        EthercatDatagramResponse response;
+        response.command = ethernetFrame[offset];
+        response.datagramIndex = ethernetFrame[offset + 1U];
+        response.payload.assign(ethernetFrame.begin() + static_cast<std::ptrdiff_t>(payloadOffset),
+                                ethernetFrame.begin() + static_cast<std::ptrdiff_t>(wkcOffset));
+        response.workingCounter = get16le(ethernetFrame, wkcOffset);
+        outResponses.push_back(std::move(response));
+
+        if ((lenField & kDatagramMoreFollows) == 0U) {
+            return true;
+        }
+        offset = wkcOffset + kWkcBytes;
+    }
+}
+
 std::vector<std::uint8_t> EthercatFrameCodec::buildDatagramFrame(
     const std::uint8_t destinationMac[6],
     const std::uint8_t sourceMac[6],
@@ -0,0 +1,242 @@
+/**
+ * @file frame_timestamping.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/transport/frame_timestamping.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <linux/ethtool.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace oec {
+namespace {
+
+std::int64_t toNs(const timespec& ts) {
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + static_cast<std::int64_t>(ts.tv_nsec);
+}
+
+// scm_timestamping: ts[0] software (CLOCK_REALTIME), ts[2] raw hardware (PHC time).
+bool extractStamp(msghdr& message, FrameTimestampMode mode, std::int64_t& outNs) {
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+            continue;
+        }
+        scm_timestamping stamps {};
+        std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+        const auto& ts = (mode == FrameTimestampMode::Hardware) ? stamps.ts[2] : stamps.ts[0];
+        if (ts.tv_sec == 0 && ts.tv_nsec == 0) {
+            return false;
+        }
+        outNs = toNs(ts);
+        return true;
+    }
+    return false;
+}
+
+std::uint32_t txRequestFlags(FrameTimestampMode mode) {
+    return (mode == FrameTimestampMode::Hardware) ? SOF_TIMESTAMPING_TX_HARDWARE : SOF_TIMESTAMPING_TX_SOFTWARE;
+}
+
+} // namespace
+
+bool parseFrameTimestampMode(const std::string& text, FrameTimestampMode& outMode) {
+    std::string value = text;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (value == "off" || value == "0") {
+        outMode = FrameTimestampMode::Off;
+    } else if (value == "software" || value == "sw" || value == "1") {
+        outMode = FrameTimestampMode::Software;
+    } else if (value == "hardware" || value == "hw") {
+        outMode = FrameTimestampMode::Hardware;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* toString(FrameTimestampMode mode) {
+    switch (mode) {
+    case FrameTimestampMode::Off:
+        return "off";
+    case FrameTimestampMode::Software:
+        return "software";
+    case FrameTimestampMode::Hardware:
+        return "hardware";
+    }
+    return "unknown";
+}
+
+bool enableFrameTimestamping(int fd, const std::string& ifname, FrameTimestampMode mode, std::string& outError) {
+    if (mode == FrameTimestampMode::Off) {
+        const int off = 0;
+        (void)::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &off, sizeof(off));
+        return true;
+    }
+    std::uint32_t flags = SOF_TIMESTAMPING_OPT_TSONLY;
+    if (mode == FrameTimestampMode::Hardware) {
+        hwtstamp_config config {};
+        config.tx_type = HWTSTAMP_TX_ON;
+        config.rx_filter = HWTSTAMP_FILTER_ALL;
+        ifreq ifr {};
+        std::strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ - 1);
+        ifr.ifr_data = reinterpret_cast<char*>(&config);
+        if (::ioctl(fd, SIOCSHWTSTAMP, &ifr) < 0) {
+            outError = "ioctl(SIOCSHWTSTAMP) failed: " + std::string(std::strerror(errno));
+            return false;
+        }
+        flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    } else {
+        flags |= SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    }
+    if (::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+        outError = "setsockopt(SO_TIMESTAMPING) failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool sendTimestamped(int fd, const void* data, std::size_t size, const sockaddr* target, socklen_t targetLength,
+                     FrameTimestampMode mode, std::string& outError) {
+    iovec iov {};
+    iov.iov_base = const_cast<void*>(data);
+    iov.iov_len = size;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint32_t))] = {};
+    msghdr message {};
+    message.msg_name = const_cast<sockaddr*>(target);
+    message.msg_namelen = targetLength;
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    if (mode != FrameTimestampMode::Off) {
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SO_TIMESTAMPING;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint32_t));
+        const auto flags = txRequestFlags(mode);
+        std::memcpy(CMSG_DATA(cmsg), &flags, sizeof(flags));
+    }
+    const auto sent = ::sendmsg(fd, &message, 0);
+    if (sent < 0 || static_cast<std::size_t>(sent) != size) {
+        outError = "sendto() failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+ssize_t receiveTimestamped(int fd, void* buffer, std::size_t size, int flags, FrameTimestampMode mode,
+                           FrameWireSample& outSample) {
+    iovec iov {};
+    iov.iov_base = buffer;
+    iov.iov_len = size;
+    alignas(cmsghdr) char control[256] = {};
+    msghdr message {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    const auto received = ::recvmsg(fd, &message, flags);
+    if (received >= 0 && mode != FrameTimestampMode::Off) {
+        outSample.rxValid = extractStamp(message, mode, outSample.rxNs);
+    }
+    return received;
+}
+
+bool readTxTimestamp(int fd, FrameTimestampMode mode, FrameWireSample& outSample) {
+    alignas(cmsghdr) char control[256] = {};
+    std::uint8_t data[64];
+    iovec iov {};
+    iov.iov_base = data;
+    iov.iov_len = sizeof(data);
+    msghdr message {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (::recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+        return false;
+    }
+    outSample.txValid = extractStamp(message, mode, outSample.txNs);
+    return outSample.txValid;
+}
+
+void discardTxTimestamps(int fd) {
+    alignas(cmsghdr) char control[256];
+    std::uint8_t data[64];
+    for (int i = 0; i < 16; ++i) {
+        iovec iov {};
+        iov.iov_base = data;
+        iov.iov_len = sizeof(data);
+        msghdr message {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
+        }
+    }
+}
+
+std::chrono::steady_clock::time_point realtimeStampToSteady(std::int64_t realtimeNs) {
+    // Age of the stamp on the realtime clock, read back to back with the steady clock.
+    timespec realtime {};
+    ::clock_gettime(CLOCK_REALTIME, &realtime);
+    const auto steadyNow = std::chrono::steady_clock::now();
+    return steadyNow - std::chrono::nanoseconds(toNs(realtime) - realtimeNs);
+}
+
+int openPhc(int fd, const std::string& ifname, std::string& outError) {
+    ethtool_ts_info info {};
+    info.cmd = ETHTOOL_GET_TS_INFO;
+    ifreq ifr {};
+    std::strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ - 1);
+    ifr.ifr_data = reinterpret_cast<char*>(&info);
+    if (::ioctl(fd, SIOCETHTOOL, &ifr) < 0) {
+        outError = "ioctl(ETHTOOL_GET_TS_INFO) failed: " + std::string(std::strerror(errno));
+        return -1;
+    }
+    if (info.phc_index < 0) {
+        outError = ifname + " has no PTP hardware clock";
+        return -1;
+    }
+    const auto path = "/dev/ptp" + std::to_string(info.phc_index);
+    const int phcFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (phcFd < 0) {
+        outError = "open(" + path + ") failed: " + std::string(std::strerror(errno));
+    }
+    return phcFd;
+}
+
+bool phcRealtimeOffset(int phcFd, std::int64_t& outOffsetNs) {
+    if (phcFd < 0) {
+        return false;
+    }
+    // FD_TO_CLOCKID() from the kernel's posix-timers: dynamic clock ids encode the fd.
+    const auto phcClock = static_cast<clockid_t>((~static_cast<unsigned int>(phcFd) << 3U) | 3U);
+    timespec before {};
+    timespec phc {};
+    timespec after {};
+    ::clock_gettime(CLOCK_REALTIME, &before);
+    if (::clock_gettime(phcClock, &phc) != 0) {
+        return false;
+    }
+    ::clock_gettime(CLOCK_REALTIME, &after);
+    outOffsetNs = toNs(before) + (toNs(after) - toNs(before)) / 2 - toNs(phc);
+    return true;
+}
+
+} // namespace oec
@@ -19,11 +19,11 @@
 #include <net/if.h>
 #include <netinet/in.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include "openethercat/transport/ethercat_frame.hpp"
+#include "openethercat/transport/frame_timestamping.hpp"
 #include "openethercat/master/coe_mailbox.hpp"
 #include "openethercat/transport/coe_mailbox_protocol.hpp"
 
@@ -36,7 +36,11 @@ constexpr std::uint8_t kCommandLrd = 0x0A;
 constexpr std::uint8_t kCommandLwr = 0x0B;
 constexpr std::uint8_t kCommandAprd = 0x01;
 constexpr std::uint8_t kCommandApwr = 0x02;
+constexpr std::uint8_t kCommandArmw = 0x0D;
 constexpr std::uint16_t kRegisterSmBase = 0x0800;
+constexpr std::uint16_t kRegisterDcSystemTime = 0x0910;
+constexpr std::uint16_t kRegisterDcSystemTimeOffset = 0x0920;
+constexpr std::uint16_t kRegisterDcSystemTimeDifference = 0x092C;
 
 bool sendAndReceiveDatagram(
     int socketFd,
@@ -68,6 +72,8 @@ const char* commandName(std::uint8_t cmd) {
         return "APRD";
     case kCommandApwr:
         return "APWR";
+    case kCommandArmw:
+        return "ARMW";
     default:
         return "CMD";
     }
@@ -111,7 +117,7 @@ bool isIgnorableSdoParseError(const std::string& error) {
 bool isTransientMailboxTransportError(const std::string& error) {
     return (error.find("timeout") != std::string::npos) ||
            (error.find("response frame not found") != std::string::npos) ||
-           (error.find("select() failed") != std::string::npos) ||
+           (error.find("poll() failed") != std::string::npos) ||
            (error.find("recv() failed") != std::string::npos);
 }
 
@@ -231,10 +237,28 @@ bool mailboxAprd(int socketFd,
     return true;
 }
 
-bool sendAndReceiveDatagram(
+/**
+ * @brief Launch socket and CLOCK_TAI launch time of one scheduled frame.
+ */
+struct FrameLaunch {
+    int fd = -1;
+    std::uint64_t launchTaiNs = 0;
+};
+
+// Send one datagram and wait for its response until the absolute @p deadline.
+// With a timestamp mode, @p outWire receives the frame's TX and RX stamps; with
+// @p launch the frame leaves through the launch socket at the scheduled time.
+// With @p xdp the response is taken from the AF_XDP socket, which also sends
+// unless the frame is launched.
+bool sendAndReceiveDatagramUntil(
     int socketFd,
     int ifIndex,
-    int timeoutMs,
+    std::chrono::steady_clock::time_point deadline,
+    ReceiveWaitMode waitMode,
+    FrameTimestampMode timestampMode,
+    FrameWireSample* outWire,
+    const FrameLaunch* launch,
+    XdpSocket* xdp,
     std::size_t maxFramesPerCycle,
     std::uint16_t expectedWorkingCounter,
     std::array<std::uint8_t, 6>& destinationMac,
@@ -253,45 +277,47 @@ bool sendAndReceiveDatagram(
     target.sll_halen = 6;
     std::copy(destinationMac.begin(), destinationMac.end(), target.sll_addr);
 
-    const auto sent = ::sendto(socketFd, frame.data(), frame.size(), 0,
-                               reinterpret_cast<const sockaddr*>(&target), sizeof(target));
-    if (sent < 0 || static_cast<std::size_t>(sent) != frame.size()) {
-        outError = "sendto() failed: " + std::string(std::strerror(errno));
+    bool sent = false;
+    if (launch != nullptr) {
+        sent = sendAtLaunchTime(launch->fd, frame.data(), frame.size(), reinterpret_cast<const sockaddr*>(&target),
+                                sizeof(target), launch->launchTaiNs, outError);
+    } else if (xdp != nullptr) {
+        sent = xdp->send(frame, outError);
+    } else {
+        sent = sendTimestamped(socketFd, frame.data(), frame.size(), reinterpret_cast<const sockaddr*>(&target),
+                               sizeof(target), timestampMode, outError);
+    }
+    if (!sent) {
         return false;
     }
+    const int rxFd = (xdp != nullptr) ? xdp->fd() : socketFd;
 
-    const auto start = std::chrono::steady_clock::now();
+    FrameWireSample wire;
     std::size_t scannedFrames = 0U;
     std::vector<std::uint8_t> rxFrame(1518U, 0U);
     while (scannedFrames < maxFramesPerCycle) {
-        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start);
-        const auto remainingMs = timeoutMs - static_cast<int>(elapsed.count());
-        if (remainingMs <= 0) {
+        const int ready = waitReadable(&rxFd, 1U, deadline, waitMode, outError);
+        if (ready == 0) {
             outError = "receive timeout";
             return false;
         }
-
-        fd_set readSet;
-        FD_ZERO(&readSet);
-        FD_SET(socketFd, &readSet);
-
-        timeval timeout {};
-        timeout.tv_sec = remainingMs / 1000;
-        timeout.tv_usec = (remainingMs % 1000) * 1000;
-
-        const int selectResult = ::select(socketFd + 1, &readSet, nullptr, nullptr, &timeout);
-        if (selectResult == 0) {
-            outError = "receive timeout";
-            return false;
-        }
-        if (selectResult < 0) {
-            outError = "select() failed: " + std::string(std::strerror(errno));
+        if (ready < 0) {
             return false;
         }
 
-        const auto received = ::recv(socketFd, rxFrame.data(), rxFrame.size(), 0);
+        // The socket also turns readable when a TX stamp lands in its error queue.
+        FrameWireSample rxWire;
+        const auto received =
+            (xdp != nullptr)
+                ? xdp->receive(rxFrame.data(), rxFrame.size())
+                : receiveTimestamped(socketFd, rxFrame.data(), rxFrame.size(), MSG_DONTWAIT, timestampMode, rxWire);
         if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (timestampMode == FrameTimestampMode::Off || !readTxTimestamp(socketFd, timestampMode, wire)) {
+                    discardTxTimestamps(socketFd);
+                }
+                continue;
+            }
             outError = "recv() failed: " + std::string(std::strerror(errno));
             return false;
         }
@@ -303,6 +329,14 @@ bool sendAndReceiveDatagram(
         if (!parsed) {
             continue;
         }
+        if (outWire != nullptr && timestampMode != FrameTimestampMode::Off) {
+            if (!wire.txValid) {
+                (void)readTxTimestamp(socketFd, timestampMode, wire);
+            }
+            wire.rxValid = rxWire.rxValid;
+            wire.rxNs = rxWire.rxNs;
+            *outWire = wire;
+        }
         if (parsed->workingCounter < expectedWorkingCounter) {
             outError = "working counter too low (got=" + std::to_string(parsed->workingCounter) +
                        ", expected>=" + std::to_string(expectedWorkingCounter) + ")";
@@ -318,6 +352,127 @@ bool sendAndReceiveDatagram(
     return false;
 }
 
+bool sendAndReceiveDatagram(
+    int socketFd,
+    int ifIndex,
+    int timeoutMs,
+    std::size_t maxFramesPerCycle,
+    std::uint16_t expectedWorkingCounter,
+    std::array<std::uint8_t, 6>& destinationMac,
+    std::array<std::uint8_t, 6>& sourceMac,
+    const EthercatDatagramRequest& request,
+    std::uint16_t& outWkc,
+    std::vector<std::uint8_t>& outPayload,
+    std::string& outError) {
+    return sendAndReceiveDatagramUntil(socketFd, ifIndex,
+                                       std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs),
+                                       ReceiveWaitMode::Block, FrameTimestampMode::Off, nullptr, nullptr, nullptr,
+                                       maxFramesPerCycle, expectedWorkingCounter,
+                                       destinationMac, sourceMac, request, outWkc, outPayload, outError);
+}
+
+/**
+ * @brief One copy of a datagram sent on both redundancy ports.
+ */
+struct RedundantCopy {
+    bool received = false;
+    /// Came back on the port it was sent from (ring open somewhere).
+    bool returnedOnOwnPort = false;
+    std::uint16_t workingCounter = 0;
+    std::vector<std::uint8_t> payload;
+};
+
+// ESCs set the locally-administered bit in the first source MAC byte, so copies
+// are told apart by the remaining bytes.
+bool sameSourceMac(const std::vector<std::uint8_t>& frame, const std::array<std::uint8_t, 6>& mac) {
+    return frame.size() >= 12U && std::equal(mac.begin() + 1, mac.end(), frame.begin() + 7);
+}
+
+// Send @p request on both ports at once and collect both copies until they are
+// in or the deadline passes. False only when neither copy came back.
+bool sendAndReceiveRedundant(int primaryFd, int primaryIfIndex, int secondaryFd, int secondaryIfIndex,
+                             std::chrono::steady_clock::time_point deadline, ReceiveWaitMode waitMode,
+                             std::size_t maxFramesPerCycle,
+                             const std::array<std::uint8_t, 6>& destinationMac,
+                             const std::array<std::uint8_t, 6>& primaryMac,
+                             const std::array<std::uint8_t, 6>& secondaryMac,
+                             const EthercatDatagramRequest& request,
+                             RedundantCopy& outPrimary, RedundantCopy& outSecondary, std::string& outError) {
+    outPrimary = RedundantCopy{};
+    outSecondary = RedundantCopy{};
+    const int fds[2] = {primaryFd, secondaryFd};
+    const int ifIndices[2] = {primaryIfIndex, secondaryIfIndex};
+    const std::array<std::uint8_t, 6>* macs[2] = {&primaryMac, &secondaryMac};
+    for (std::size_t port = 0; port < 2U; ++port) {
+        const auto frame = EthercatFrameCodec::buildDatagramFrame(destinationMac.data(), macs[port]->data(), request);
+        sockaddr_ll target {};
+        target.sll_family = AF_PACKET;
+        target.sll_protocol = htons(kEtherTypeEthercat);
+        target.sll_ifindex = ifIndices[port];
+        target.sll_halen = 6;
+        std::copy(destinationMac.begin(), destinationMac.end(), target.sll_addr);
+        // A dead link must not keep the other copy from going out.
+        (void)::sendto(fds[port], frame.data(), frame.size(), 0, reinterpret_cast<const sockaddr*>(&target),
+                       sizeof(target));
+    }
+
+    std::size_t scannedFrames = 0U;
+    std::vector<std::uint8_t> rxFrame(1518U, 0U);
+    while ((!outPrimary.received || !outSecondary.received) && scannedFrames < maxFramesPerCycle) {
+        const int ready = waitReadable(fds, 2U, deadline, waitMode, outError);
+        if (ready == 0) {
+            break;
+        }
+        if (ready < 0) {
+            return false;
+        }
+        for (std::size_t port = 0; port < 2U; ++port) {
+            if ((ready & (1 << port)) == 0) {
+                continue;
+            }
+            sockaddr_ll from {};
+            socklen_t fromLength = sizeof(from);
+            rxFrame.resize(1518U);
+            const auto received = ::recvfrom(fds[port], rxFrame.data(), rxFrame.size(), MSG_DONTWAIT,
+                                             reinterpret_cast<sockaddr*>(&from), &fromLength);
+            if (received < 0) {
+                continue;
+            }
+            ++scannedFrames;
+            if (from.sll_pkttype == PACKET_OUTGOING) {
+                continue;
+            }
+            rxFrame.resize(static_cast<std::size_t>(received));
+            RedundantCopy* copy = nullptr;
+            bool ownPort = false;
+            if (sameSourceMac(rxFrame, primaryMac)) {
+                copy = &outPrimary;
+                ownPort = (port == 0U);
+            } else if (sameSourceMac(rxFrame, secondaryMac)) {
+                copy = &outSecondary;
+                ownPort = (port == 1U);
+            }
+            if (copy == nullptr || copy->received) {
+                continue;
+            }
+            const auto parsed = EthercatFrameCodec::parseDatagramFrame(rxFrame, request.command,
+                                                                       request.datagramIndex, request.payload.size());
+            if (!parsed) {
+                continue;
+            }
+            copy->received = true;
+            copy->returnedOnOwnPort = ownPort;
+            copy->workingCounter = parsed->workingCounter;
+            copy->payload = parsed->payload;
+        }
+    }
+    if (!outPrimary.received && !outSecondary.received) {
+        outError = "receive timeout on both redundancy ports";
+        return false;
+    }
+    return true;
+}
+
 } // namespace
 
 LinuxRawSocketTransport::LinuxRawSocketTransport(std::string ifname) : ifname_(std::move(ifname)) {}
@@ -325,10 +480,78 @@ LinuxRawSocketTransport::LinuxRawSocketTransport(std::string primaryIfname, std:
     : ifname_(std::move(primaryIfname)), secondaryIfname_(std::move(secondaryIfname)),
       redundancyEnabled_(true) {}
 
-LinuxRawSocketTransport::~LinuxRawSocketTransport() { close(); }
+LinuxRawSocketTransport::~LinuxRawSocketTransport() {
+    close();
+    if (adoptedSocketFd_ >= 0) {
+        ::close(adoptedSocketFd_);
+    }
+}
 
 void LinuxRawSocketTransport::setCycleTimeoutMs(int timeoutMs) {
     timeoutMs_ = (timeoutMs <= 0) ? 1 : timeoutMs;
+    receiveTimeout_ = std::chrono::milliseconds(timeoutMs_);
+}
+
+void LinuxRawSocketTransport::setReceiveTimeout(std::chrono::nanoseconds timeout) {
+    receiveTimeout_ = (timeout.count() <= 0) ? std::chrono::nanoseconds(std::chrono::microseconds(1)) : timeout;
+}
+
+std::chrono::nanoseconds LinuxRawSocketTransport::receiveTimeout() const { return receiveTimeout_; }
+
+void LinuxRawSocketTransport::setNextReceiveDeadline(std::chrono::steady_clock::time_point deadline) {
+    nextReceiveDeadline_ = deadline;
+}
+
+void LinuxRawSocketTransport::setReceiveWaitMode(ReceiveWaitMode mode) { receiveWaitMode_ = mode; }
+
+ReceiveWaitMode LinuxRawSocketTransport::receiveWaitMode() const { return receiveWaitMode_; }
+
+void LinuxRawSocketTransport::setSocketBusyPoll(std::chrono::microseconds budget) {
+    socketBusyPoll_ = (budget.count() < 0) ? std::chrono::microseconds(0) : budget;
+}
+
+void LinuxRawSocketTransport::setScheduledTransmit(const ScheduledTransmitOptions& options) {
+    scheduledTransmit_ = options;
+}
+
+bool LinuxRawSocketTransport::scheduledTransmitActive() const { return launchSocketFd_ >= 0; }
+
+ScheduledTransmitDiagnostics LinuxRawSocketTransport::scheduledTransmitDiagnostics() const {
+    return scheduledTransmitDiagnostics_;
+}
+
+void LinuxRawSocketTransport::setNextLaunchTime(std::chrono::steady_clock::time_point launchTime) {
+    nextLaunchTime_ = launchTime;
+}
+
+void LinuxRawSocketTransport::setXdp(const XdpSocketOptions& options) { xdpOptions_ = options; }
+
+bool LinuxRawSocketTransport::xdpActive() const { return xdp_.isOpen(); }
+
+bool LinuxRawSocketTransport::xdpZeroCopy() const { return xdp_.zeroCopy(); }
+
+XdpSocketStats LinuxRawSocketTransport::xdpStats() const { return xdp_.stats(); }
+
+void LinuxRawSocketTransport::setFrameTimestamping(FrameTimestampMode mode) { requestedTimestampMode_ = mode; }
+
+FrameTimestampMode LinuxRawSocketTransport::frameTimestampMode() const { return activeTimestampMode_; }
+
+CycleWireTiming LinuxRawSocketTransport::lastCycleWireTiming() const { return lastWireTiming_; }
+
+bool LinuxRawSocketTransport::lastWireRoundTrip(std::chrono::nanoseconds& outRoundTrip) {
+    if (lastWireTiming_.frames == 0U || lastWireTiming_.stampedFrames != lastWireTiming_.frames) {
+        return false;
+    }
+    outRoundTrip = lastWireTiming_.wireRoundTrip;
+    return true;
+}
+
+bool LinuxRawSocketTransport::lastDcReferenceTxTime(std::chrono::steady_clock::time_point& outTime) const {
+    if (!dcReferenceTimeValid_ || !lastWireTiming_.dcFrameTxValid) {
+        return false;
+    }
+    outTime = lastWireTiming_.dcFrameTx;
+    return true;
 }
 
 void LinuxRawSocketTransport::setLogicalAddress(std::uint32_t logicalAddress) {
@@ -345,6 +568,22 @@ void LinuxRawSocketTransport::setMaxFramesPerCycle(std::size_t maxFramesPerCycle
 
 void LinuxRawSocketTransport::enableRedundancy(bool enabled) { redundancyEnabled_ = enabled; }
 
+void LinuxRawSocketTransport::setParallelRedundancy(bool enabled) { parallelRedundancy_ = enabled; }
+
+bool LinuxRawSocketTransport::parallelRedundancyActive() const {
+    return parallelRedundancy_ && redundancyEnabled_ && secondarySocketFd_ >= 0;
+}
+
+RedundancyDiagnostics LinuxRawSocketTransport::redundancyDiagnostics() const { return redundancyDiagnostics_; }
+
+bool LinuxRawSocketTransport::redundancyObservation(bool& outRingIntact) {
+    if (!redundancyObserved_) {
+        return false;
+    }
+    outRingIntact = lastRingIntact_;
+    return true;
+}
+
 void LinuxRawSocketTransport::setMailboxConfiguration(std::uint16_t writeOffset, std::uint16_t writeSize,
                                                       std::uint16_t readOffset, std::uint16_t readSize) {
     mailboxWriteOffset_ = writeOffset;
@@ -353,8 +592,45 @@ void LinuxRawSocketTransport::setMailboxConfiguration(std::uint16_t writeOffset,
     mailboxReadSize_ = readSize;
 }
 
+void LinuxRawSocketTransport::setProcessImagePlanPath(std::string path) {
+    processImagePlanPath_ = std::move(path);
+}
+
 bool LinuxRawSocketTransport::exchange(const std::vector<std::uint8_t>& txProcessData,
                                        std::vector<std::uint8_t>& rxProcessData) {
+    // A cycle deadline bounds every frame of this exchange; without one each frame gets receiveTimeout_.
+    const auto cycleDeadline = nextReceiveDeadline_;
+    nextReceiveDeadline_.reset();
+    const auto launchTime = nextLaunchTime_;
+    nextLaunchTime_.reset();
+    auto frameDeadline = [&]() {
+        return cycleDeadline.has_value() ? *cycleDeadline : std::chrono::steady_clock::now() + receiveTimeout_;
+    };
+
+    lastWireTiming_ = CycleWireTiming{};
+    lastWireTiming_.mode = activeTimestampMode_;
+    auto recordWire = [&](const FrameWireSample& wire, bool carriesDcReference) {
+        if (activeTimestampMode_ == FrameTimestampMode::Off) {
+            return;
+        }
+        ++lastWireTiming_.frames;
+        if (!wire.complete()) {
+            return;
+        }
+        ++lastWireTiming_.stampedFrames;
+        lastWireTiming_.wireRoundTrip += wire.roundTrip();
+        lastWireTiming_.maxFrameRoundTrip = std::max(lastWireTiming_.maxFrameRoundTrip, wire.roundTrip());
+        if (carriesDcReference) {
+            // Hardware stamps are PHC time (often TAI), not CLOCK_REALTIME.
+            std::int64_t phcOffsetNs = 0;
+            if (activeTimestampMode_ == FrameTimestampMode::Hardware && !phcRealtimeOffset(phcFd_, phcOffsetNs)) {
+                return;
+            }
+            lastWireTiming_.dcFrameTxValid = true;
+            lastWireTiming_.dcFrameTx = realtimeStampToSteady(wire.txNs + phcOffsetNs);
+        }
+    };
+
     if (socketFd_ < 0) {
         error_ = "transport not open";
         return false;
@@ -363,28 +639,117 @@ bool LinuxRawSocketTransport::exchange(const std::vector<std::uint8_t>& txProces
         error_ = "TX/RX process image size mismatch";
         return false;
     }
+    if (launchSocketFd_ >= 0) {
+        // Drops of the previous cycle's launched frame are reported asynchronously.
+        collectLaunchTimeErrors(launchSocketFd_, scheduledTransmitDiagnostics_);
+    }
+    if (activeTimestampMode_ != FrameTimestampMode::Off) {
+        // Stamps of a previous failed exchange would pair with this cycle's frames.
+        discardTxTimestamps(socketFd_);
+        if (secondarySocketFd_ >= 0) {
+            discardTxTimestamps(secondarySocketFd_);
+        }
+    }
 
     const auto logicalLo = static_cast<std::uint16_t>(logicalAddress_ & 0xFFFFU);
     const auto logicalHi = static_cast<std::uint16_t>((logicalAddress_ >> 16U) & 0xFFFFU);
 
+    const bool parallel = parallelRedundancyActive();
+    bool ringIntact = true;
+    redundancyObserved_ = false;
+    auto sendParallel = [&](const EthercatDatagramRequest& req,
+                            std::uint16_t& outWkc,
+                            std::vector<std::uint8_t>& outPayload) -> bool {
+        ++redundancyDiagnostics_.parallelFrames;
+        RedundantCopy primary;
+        RedundantCopy secondary;
+        if (!sendAndReceiveRedundant(socketFd_, ifIndex_, secondarySocketFd_, secondaryIfIndex_, frameDeadline(),
+                                     receiveWaitMode_, maxFramesPerCycle_, destinationMac_, sourceMac_, secondarySourceMac_, req,
+                                     primary, secondary, error_)) {
+            ++redundancyDiagnostics_.lostFrames;
+            ringIntact = false;
+            return false;
+        }
+        // Each slave processes exactly one copy: in an intact ring the secondary
+        // copy passes through unprocessed, in a broken one each segment fills its
+        // part. Logical reads go out zeroed, so OR-ing the copies merges the image.
+        outWkc = static_cast<std::uint16_t>(primary.workingCounter + secondary.workingCounter);
+        outPayload = primary.received ? primary.payload : secondary.payload;
+        if (primary.received && secondary.received) {
+            for (std::size_t i = 0; i < outPayload.size() && i < secondary.payload.size(); ++i) {
+                outPayload[i] = static_cast<std::uint8_t>(outPayload[i] | secondary.payload[i]);
+            }
+            if (!primary.returnedOnOwnPort && !secondary.returnedOnOwnPort) {
+                ++redundancyDiagnostics_.ringIntactFrames;
+            } else {
+                ++redundancyDiagnostics_.ringBrokenFrames;
+                ringIntact = false;
+            }
+        } else {
+            ++redundancyDiagnostics_.singleCopyFrames;
+            ringIntact = false;
+        }
+        redundancyObserved_ = true;
+        lastRingIntact_ = ringIntact;
+        lastFrameUsedSecondary_ = !primary.received;
+        if (outWkc < expectedWorkingCounter_) {
+            error_ = "working counter too low (got=" + std::to_string(outWkc) +
+                     ", expected>=" + std::to_string(expectedWorkingCounter_) + ")";
+            return false;
+        }
+        return true;
+    };
+
+    const bool secondaryRetry = redundancyEnabled_ && secondarySocketFd_ >= 0;
+    auto sendSecondary = [&](const EthercatDatagramRequest& req,
+                             std::uint16_t& outWkc,
+                             std::vector<std::uint8_t>& outPayload,
+                             std::optional<std::chrono::steady_clock::time_point> deadline) -> bool {
+        FrameWireSample wire;
+        if (!sendAndReceiveDatagramUntil(secondarySocketFd_, secondaryIfIndex_, deadline.value_or(frameDeadline()),
+                                         receiveWaitMode_, activeTimestampMode_, &wire, nullptr, nullptr,
+                                         maxFramesPerCycle_, expectedWorkingCounter_, destinationMac_, sourceMac_,
+                                         req, outWkc, outPayload, error_)) {
+            return false;
+        }
+        recordWire(wire, false);
+        lastFrameUsedSecondary_ = true;
+        return true;
+    };
+
     auto sendPrimaryOrSecondary = [&](const EthercatDatagramRequest& req,
                                       std::uint16_t& outWkc,
-                                      std::vector<std::uint8_t>& outPayload) -> bool {
-        if (sendAndReceiveDatagram(socketFd_, ifIndex_, timeoutMs_, maxFramesPerCycle_,
-                                   expectedWorkingCounter_, destinationMac_, sourceMac_,
-                                   req, outWkc, outPayload, error_)) {
-            lastFrameUsedSecondary_ = false;
-            return true;
+                                      std::vector<std::uint8_t>& outPayload,
+                                      const FrameLaunch* launch = nullptr) -> bool {
+        if (parallel) {
+            return sendParallel(req, outWkc, outPayload);
         }
-        if (redundancyEnabled_ && secondarySocketFd_ >= 0) {
-            if (sendAndReceiveDatagram(secondarySocketFd_, secondaryIfIndex_, timeoutMs_, maxFramesPerCycle_,
-                                       expectedWorkingCounter_, destinationMac_, sourceMac_,
-                                       req, outWkc, outPayload, error_)) {
-                lastFrameUsedSecondary_ = true;
-                return true;
+        FrameWireSample wire;
+        const auto timestampMode = (launch != nullptr) ? FrameTimestampMode::Off : activeTimestampMode_;
+        // A launched frame's receive budget starts when it leaves, not when it is queued.
+        auto deadline = (launch != nullptr && !cycleDeadline.has_value()) ? *launchTime + receiveTimeout_
+                                                                          : frameDeadline();
+        std::optional<std::chrono::steady_clock::time_point> secondaryDeadline;
+        if (secondaryRetry && cycleDeadline.has_value()) {
+            // One cycle budget for both ports: the retry must not start at an expired deadline.
+            const auto now = std::chrono::steady_clock::now();
+            const auto split = splitRedundantDeadline(launch != nullptr ? std::max(now, *launchTime) : now,
+                                                      *cycleDeadline);
+            deadline = split.primary;
+            secondaryDeadline = split.secondary;
+        }
+        if (sendAndReceiveDatagramUntil(socketFd_, ifIndex_, deadline, receiveWaitMode_,
+                                        timestampMode, &wire, launch, xdp_.isOpen() ? &xdp_ : nullptr,
+                                        maxFramesPerCycle_,
+                                        expectedWorkingCounter_, destinationMac_, sourceMac_,
+                                        req, outWkc, outPayload, error_)) {
+            if (launch == nullptr) {
+                recordWire(wire, false);
             }
+            lastFrameUsedSecondary_ = false;
+            return true;
         }
-        return false;
+        return secondaryRetry && sendSecondary(req, outWkc, outPayload, secondaryDeadline);
     };
 
     const bool traceWkc = (std::getenv("OEC_TRACE_WKC") != nullptr);
@@ -406,7 +771,23 @@ bool LinuxRawSocketTransport::exchange(const std::vector<std::uint8_t>& txProces
     lwr.ado = logicalHi;
     lwr.payload = txProcessData;
 
-    if (!sendPrimaryOrSecondary(lwr, lwrWkc, lwrAck)) {
+    // Only the cycle's first frame waits for its launch time; the rest follow their responses.
+    FrameLaunch lwrLaunch;
+    bool launchLwr = false;
+    if (launchSocketFd_ >= 0) {
+        if (!launchTime.has_value() || parallel) {
+            ++scheduledTransmitDiagnostics_.unscheduledCycles;
+        } else if (*launchTime - std::chrono::steady_clock::now() < scheduledTransmit_.minLead) {
+            ++scheduledTransmitDiagnostics_.lateAtSend;
+        } else {
+            lwrLaunch.fd = launchSocketFd_;
+            lwrLaunch.launchTaiNs = steadyToTaiNs(*launchTime);
+            launchLwr = true;
+            ++scheduledTransmitDiagnostics_.scheduledFrames;
+        }
+    }
+
+    if (!sendPrimaryOrSecondary(lwr, lwrWkc, lwrAck, launchLwr ? &lwrLaunch : nullptr)) {
         if (traceWkc) {
             std::cerr << "[oec] " << commandName(lwr.command) << " failed: " << error_ << '\n';
         }
@@ -423,8 +804,133 @@ bool LinuxRawSocketTransport::exchange(const std::vector<std::uint8_t>& txProces
     lrd.adp = inputLogicalLo;
     lrd.ado = inputLogicalHi;
     lrd.payload.assign(rxProcessData.size(), 0U);
+    // Mailbox status bits sit directly after the input image; read them in the same datagram.
+    const bool readMailboxStatus = (mailboxStatusBytes_ > 0U) &&
+                                   (mailboxStatusLogical_ == inputLogicalAddress + rxProcessData.size());
+    if (readMailboxStatus) {
+        lrd.payload.resize(rxProcessData.size() + mailboxStatusBytes_, 0U);
+    }
 
-    if (!sendPrimaryOrSecondary(lrd, lrdWkc, lrdPayload)) {
+    // DC distribution shares the LRD frame: the ARMW returns the reference time
+    // and feeds every downstream clock; a queued reference offset goes along.
+    // Queued line-monitor reads of 0x092C ride in the same frame.
+    dcReferenceTimeValid_ = false;
+    dcLineSamplesValid_ = false;
+    std::vector<std::uint16_t> linePositions;
+    linePositions.swap(dcLineReadQueue_);
+    bool lrdDone = false;
+    if ((dcDistributionEnabled_ || !linePositions.empty()) && !parallel) {
+        const bool writeOffset = dcDistributionEnabled_ && dcOffsetPending_;
+        std::vector<EthercatDatagramRequest> cyclic;
+        if (dcDistributionEnabled_) {
+            cyclic = buildCyclicInputBatch(
+                dcDistributionReference_,
+                writeOffset ? std::optional<std::int64_t>(dcPendingOffsetNs_) : std::nullopt, lrd);
+        } else {
+            cyclic.push_back(lrd);
+        }
+        // Monitor reads go ahead of the LRD as far as the frame has room; the rest are left out.
+        const auto lineAt = cyclic.size() - 1U;
+        std::size_t frameBytes = 0U;
+        for (const auto& request : cyclic) {
+            frameBytes += EthercatFrameCodec::datagramWireBytes(request);
+        }
+        std::size_t lineCount = 0U;
+        for (const auto position : linePositions) {
+            EthercatDatagramRequest read;
+            read.command = kCommandAprd;
+            read.adp = toAutoIncrementAddress(position);
+            read.ado = kRegisterDcSystemTimeDifference;
+            read.payload.assign(4U, 0U);
+            const auto bytes = EthercatFrameCodec::datagramWireBytes(read);
+            if (frameBytes + bytes > EthercatFrameCodec::kMaxDatagramBytesPerFrame) {
+                break;
+            }
+            frameBytes += bytes;
+            cyclic.insert(cyclic.begin() + static_cast<std::ptrdiff_t>(lineAt + lineCount), std::move(read));
+            ++lineCount;
+        }
+        // Same split as a plain frame: a retry on the secondary keeps its own share of the cycle.
+        auto deadline = frameDeadline();
+        std::optional<std::chrono::steady_clock::time_point> secondaryDeadline;
+        if (secondaryRetry && cycleDeadline.has_value()) {
+            const auto split = splitRedundantDeadline(std::chrono::steady_clock::now(), *cycleDeadline);
+            deadline = split.primary;
+            secondaryDeadline = split.secondary;
+        }
+        std::vector<EthercatDatagramResponse> responses;
+        FrameWireSample wire;
+        CyclicInputResult cyclicResult;
+        bool decoded = false;
+        if (sendDatagramBatchUntil(cyclic, responses, deadline, error_, &wire) && responses.size() == cyclic.size()) {
+            recordWire(wire, dcDistributionEnabled_);
+            dcLineSamples_.assign(lineCount, DcSlaveSyncSample{});
+            for (std::size_t i = 0; i < lineCount; ++i) {
+                const auto& response = responses[lineAt + i];
+                auto& sample = dcLineSamples_[i];
+                sample.slavePosition = linePositions[i];
+                if (response.workingCounter == 1U && response.payload.size() >= 4U) {
+                    std::uint32_t raw = 0U;
+                    for (std::size_t b = 0; b < 4U; ++b) {
+                        raw |= static_cast<std::uint32_t>(response.payload[b]) << (8U * b);
+                    }
+                    sample.deviationNs = decodeDcSystemTimeDifference(raw);
+                    sample.valid = true;
+                }
+            }
+            dcLineSamplesValid_ = lineCount > 0U;
+            responses.erase(responses.begin() + static_cast<std::ptrdiff_t>(lineAt),
+                            responses.begin() + static_cast<std::ptrdiff_t>(lineAt + lineCount));
+            if (dcDistributionEnabled_) {
+                decoded = decodeCyclicInputBatch(responses, writeOffset, cyclicResult);
+            } else {
+                cyclicResult.inputWorkingCounter = responses.back().workingCounter;
+                cyclicResult.inputPayload = std::move(responses.back().payload);
+                decoded = true;
+            }
+        }
+        if (decoded && dcDistributionEnabled_) {
+            if (cyclicResult.referenceTimeValid) {
+                dcReferenceTimeNs_ = cyclicResult.referenceTimeNs;
+                dcReferenceTimeValid_ = true;
+                ++dcDiagnostics_.cyclicReferenceReads;
+            } else {
+                ++dcDiagnostics_.cyclicReferenceFailures;
+            }
+            if (writeOffset) {
+                dcOffsetPending_ = false;
+                if (cyclicResult.offsetWritten) {
+                    ++dcDiagnostics_.cyclicOffsetWrites;
+                } else {
+                    ++dcDiagnostics_.cyclicOffsetFailures;
+                }
+            }
+        } else if (dcDistributionEnabled_) {
+            ++dcDiagnostics_.cyclicReferenceFailures;
+        }
+        if (decoded) {
+            lrdWkc = cyclicResult.inputWorkingCounter;
+            lrdPayload = std::move(cyclicResult.inputPayload);
+            if (lrdWkc >= expectedWorkingCounter_) {
+                lastFrameUsedSecondary_ = false;
+                lrdDone = true;
+            } else {
+                error_ = "working counter too low (got=" + std::to_string(lrdWkc) +
+                         ", expected>=" + std::to_string(expectedWorkingCounter_) + ")";
+            }
+        }
+        // The primary port had its try inside the batch; a lost frame or a short
+        // working counter goes straight to the secondary instead of a second primary wait.
+        if (!lrdDone && (!secondaryRetry || !sendSecondary(lrd, lrdWkc, lrdPayload, secondaryDeadline))) {
+            if (traceWkc) {
+                std::cerr << "[oec] " << commandName(lrd.command) << " failed: " << error_ << '\n';
+            }
+            return false;
+        }
+        lrdDone = true;
+    }
+
+    if (!lrdDone && !sendPrimaryOrSecondary(lrd, lrdWkc, lrdPayload)) {
         if (traceWkc) {
             std::cerr << "[oec] " << commandName(lrd.command) << " failed: " << error_ << '\n';
         }
@@ -433,6 +939,14 @@ bool LinuxRawSocketTransport::exchange(const std::vector<std::uint8_t>& txProces
     if (traceWkc) {
         std::cerr << "[oec] " << commandName(lrd.command) << " wkc=" << lrdWkc << '\n';
     }
+    if (readMailboxStatus && lrdPayload.size() >= rxProcessData.size() + mailboxStatusBytes_) {
+        mailboxStatusImage_.assign(lrdPayload.begin() + static_cast<std::ptrdiff_t>(rxProcessData.size()),
+                                   lrdPayload.begin() +
+                                       static_cast<std::ptrdiff_t>(rxProcessData.size() + mailboxStatusBytes_));
+        lrdPayload.resize(rxProcessData.size());
+        lrdWkc = static_cast<std::uint16_t>(lrdWkc - std::min(lrdWkc, mailboxStatusWkcExtra_));
+        ++mailboxStatusCycle_;
+    }
     lastInputWorkingCounter_ = lrdWkc;
 
     // Optional field-debug path: confirm written outputs by reading mapped SM2 process RAM.
@@ -523,6 +1037,19 @@ bool LinuxRawSocketTransport::failoverSlave(std::uint16_t position) {
 bool LinuxRawSocketTransport::sdoUpload(std::uint16_t slavePosition, const SdoAddress& address,
                                         std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode,
                                         std::string& outError) {
+    return sdoUploadTransfer(slavePosition, address, false, outData, outAbortCode, outError);
+}
+
+bool LinuxRawSocketTransport::sdoUploadComplete(std::uint16_t slavePosition, std::uint16_t index,
+                                                bool includeSubIndex0, std::vector<std::uint8_t>& outData,
+                                                std::uint32_t& outAbortCode, std::string& outError) {
+    const SdoAddress address{index, static_cast<std::uint8_t>(includeSubIndex0 ? 0U : 1U)};
+    return sdoUploadTransfer(slavePosition, address, true, outData, outAbortCode, outError);
+}
+
+bool LinuxRawSocketTransport::sdoUploadTransfer(std::uint16_t slavePosition, const SdoAddress& address,
+                                                bool completeAccess, std::vector<std::uint8_t>& outData,
+                                                std::uint32_t& outAbortCode, std::string& outError) {
     ++mailboxDiagnostics_.transactionsStarted;
     outData.clear();
     outAbortCode = 0U;
@@ -590,7 +1117,7 @@ bool LinuxRawSocketTransport::sdoUpload(std::uint16_t slavePosition, const SdoAd
     };
 
     std::uint8_t expectedCounter = 0U;
-    if (!mailboxWrite(CoeMailboxProtocol::buildSdoInitiateUploadRequest(address), expectedCounter)) {
+    if (!mailboxWrite(CoeMailboxProtocol::buildSdoInitiateUploadRequest(address, completeAccess), expectedCounter)) {
         return fail();
     }
 
@@ -635,6 +1162,13 @@ bool LinuxRawSocketTransport::sdoUpload(std::uint16_t slavePosition, const SdoAd
         outData = init.data;
         return true;
     }
+    // Large-mailbox slaves may deliver the whole object in the initiate response.
+    outData = std::move(init.data);
+    if (init.sizeIndicated && outData.size() >= init.completeSize) {
+        outData.resize(init.completeSize);
+        lastMailboxErrorClass_ = MailboxErrorClass::None;
+        return true;
+    }
 
     std::uint8_t toggle = 0;
     while (true) {
@@ -695,6 +1229,19 @@ bool LinuxRawSocketTransport::sdoUpload(std::uint16_t slavePosition, const SdoAd
 bool LinuxRawSocketTransport::sdoDownload(std::uint16_t slavePosition, const SdoAddress& address,
                                           const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
                                           std::string& outError) {
+    return sdoDownloadTransfer(slavePosition, address, false, data, outAbortCode, outError);
+}
+
+bool LinuxRawSocketTransport::sdoDownloadComplete(std::uint16_t slavePosition, std::uint16_t index,
+                                                  bool includeSubIndex0, const std::vector<std::uint8_t>& data,
+                                                  std::uint32_t& outAbortCode, std::string& outError) {
+    const SdoAddress address{index, static_cast<std::uint8_t>(includeSubIndex0 ? 0U : 1U)};
+    return sdoDownloadTransfer(slavePosition, address, true, data, outAbortCode, outError);
+}
+
+bool LinuxRawSocketTransport::sdoDownloadTransfer(std::uint16_t slavePosition, const SdoAddress& address,
+                                                  bool completeAccess, const std::vector<std::uint8_t>& data,
+                                                  std::uint32_t& outAbortCode, std::string& outError) {
     ++mailboxDiagnostics_.transactionsStarted;
     outAbortCode = 0U;
     outError.clear();
@@ -760,9 +1307,20 @@ bool LinuxRawSocketTransport::sdoDownload(std::uint16_t slavePosition, const Sdo
         return ok;
     };
 
+    // Segments fill the resolved SM0 window; sdoSegmentBytesLimit_ can cap them (7 = legacy CAN-sized).
+    auto segmentBytes = CoeMailboxProtocol::maxSegmentDataBytes(writeSize);
+    if (sdoSegmentBytesLimit_ != 0U) {
+        segmentBytes = std::min(segmentBytes, std::max(sdoSegmentBytesLimit_, CoeMailboxProtocol::kMinSegmentBytes));
+    }
+    const auto inlineBytes = (segmentBytes > CoeMailboxProtocol::kMinSegmentBytes)
+                                 ? std::min({data.size(), segmentBytes,
+                                             CoeMailboxProtocol::maxInitiateDownloadDataBytes(writeSize)})
+                                 : std::size_t{0U};
+    const std::vector<std::uint8_t> initialData(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(inlineBytes));
+
     std::uint8_t expectedCounter = 0U;
     if (!mailboxWrite(CoeMailboxProtocol::buildSdoInitiateDownloadRequest(
-            address, static_cast<std::uint32_t>(data.size())), expectedCounter)) {
+            address, static_cast<std::uint32_t>(data.size()), initialData, completeAccess), expectedCounter)) {
         return fail();
     }
 
@@ -803,18 +1361,17 @@ bool LinuxRawSocketTransport::sdoDownload(std::uint16_t slavePosition, const Sdo
         return fail();
     }
 
-    constexpr std::size_t kSegmentPayloadMax = 7;
-    std::size_t offset = 0;
+    std::size_t offset = inlineBytes;
     std::uint8_t toggle = 0;
     while (offset < data.size()) {
         const auto remaining = data.size() - offset;
-        const auto chunk = std::min<std::size_t>(remaining, kSegmentPayloadMax);
+        const auto chunk = std::min<std::size_t>(remaining, segmentBytes);
         std::vector<std::uint8_t> segment(data.begin() + static_cast<std::ptrdiff_t>(offset),
                                           data.begin() + static_cast<std::ptrdiff_t>(offset + chunk));
         const bool lastSegment = (offset + chunk) >= data.size();
         expectedCounter = 0U;
         if (!mailboxWrite(CoeMailboxProtocol::buildSdoDownloadSegmentRequest(
-                toggle, lastSegment, segment, kSegmentPayloadMax), expectedCounter)) {
+                toggle, lastSegment, segment, segmentBytes), expectedCounter)) {
             return fail();
         }
         fatalParseError = false;
@@ -859,94 +1416,200 @@ bool LinuxRawSocketTransport::sdoDownload(std::uint16_t slavePosition, const Sdo
     return true;
 }
 
-bool LinuxRawSocketTransport::configurePdo(std::uint16_t slavePosition, std::uint16_t assignIndex,
-                                           const std::vector<PdoMappingEntry>& entries,
-                                           std::string& outError) {
+bool LinuxRawSocketTransport::sdoInfoExchange(std::uint16_t slavePosition, const std::vector<std::uint8_t>& request,
+                                              std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode,
+                                              std::string& outError) {
+    ++mailboxDiagnostics_.transactionsStarted;
+    outData.clear();
+    outAbortCode = 0U;
     outError.clear();
-
-    auto writeSdoU8 = [&](std::uint16_t index, std::uint8_t subIndex, std::uint8_t value) -> bool {
-        std::uint32_t abortCode = 0;
-        std::string sdoError;
-        const std::vector<std::uint8_t> data = {value};
-        SdoAddress address;
-        address.index = index;
-        address.subIndex = subIndex;
-        if (!sdoDownload(slavePosition, address, data, abortCode, sdoError)) {
-            outError = "SDO write 0x" + std::to_string(index) + ":" + std::to_string(subIndex) + " failed: " + sdoError;
-            return false;
+    MailboxErrorClass txErrorClass = MailboxErrorClass::None;
+    auto fail = [&]() -> bool {
+        if (txErrorClass == MailboxErrorClass::None) {
+            txErrorClass = classifyMailboxError(outError);
+            if (txErrorClass == MailboxErrorClass::None) {
+                txErrorClass = MailboxErrorClass::Unknown;
+            }
         }
-        return true;
+        lastMailboxErrorClass_ = txErrorClass;
+        incrementMailboxErrorClassCounter(mailboxDiagnostics_, txErrorClass);
+        ++mailboxDiagnostics_.transactionsFailed;
+        return false;
     };
+    if (request.size() < 3U) {
+        outError = "SDO information request too short";
+        return fail();
+    }
 
-    auto writeSdoU16 = [&](std::uint16_t index, std::uint8_t subIndex, std::uint16_t value) -> bool {
-        std::uint32_t abortCode = 0;
-        std::string sdoError;
-        const std::vector<std::uint8_t> data = {
+    const bool forceTimeoutTest = (std::getenv("OEC_MAILBOX_TEST_FORCE_TIMEOUT") != nullptr);
+    if (socketFd_ < 0 && !forceTimeoutTest) {
+        outError = "transport not open";
+        txErrorClass = MailboxErrorClass::TransportIo;
+        return fail();
+    }
+    const auto statusMode = mailboxStatusMode_;
+    const auto adp = toAutoIncrementAddress(slavePosition);
+    std::uint16_t writeOffset = mailboxWriteOffset_;
+    std::uint16_t writeSize = mailboxWriteSize_;
+    std::uint16_t readOffset = mailboxReadOffset_;
+    std::uint16_t readSize = mailboxReadSize_;
+    const auto retryConfig = mailboxRetryConfigFromEnv();
+
+    std::uint16_t sm0Start = 0U, sm0Len = 0U, sm1Start = 0U, sm1Len = 0U;
+    MailboxErrorClass ioClass = MailboxErrorClass::None;
+    if (readSmWindowWithRetry(adp, 0U, forceTimeoutTest, retryConfig.retries, retryConfig.backoffBaseMs,
+                              retryConfig.backoffMaxMs, ioClass, sm0Start, sm0Len, outError) &&
+        readSmWindowWithRetry(adp, 1U, forceTimeoutTest, retryConfig.retries, retryConfig.backoffBaseMs,
+                              retryConfig.backoffMaxMs, ioClass, sm1Start, sm1Len, outError) &&
+        sm0Len > 0U && sm1Len > 0U) {
+        writeOffset = sm0Start;
+        writeSize = sm0Len;
+        readOffset = sm1Start;
+        readSize = sm1Len;
+    }
+
+    std::uint8_t expectedCounter = 0U;
+    MailboxErrorClass localClass = MailboxErrorClass::None;
+    if (!mailboxWriteCoePayload(adp, writeOffset, writeSize, statusMode, forceTimeoutTest, retryConfig.retries,
+                                retryConfig.backoffBaseMs, retryConfig.backoffMaxMs, request, expectedCounter,
+                                localClass, outError)) {
+        txErrorClass = localClass;
+        return fail();
+    }
+
+    // Responses longer than the mailbox arrive as several fragments; only the
+    // first echoes the request counter, the rest carry the slave's own counter.
+    const auto expectedOpCode = static_cast<std::uint8_t>((request[2] & 0x7FU) + 1U);
+    bool firstFragment = true;
+    while (true) {
+        CoeSdoInfoFragment fragment;
+        EscMailboxFrame responseFrame;
+        MailboxErrorClass readClass = MailboxErrorClass::None;
+        if (!mailboxReadMatchingCoe(adp, slavePosition, readOffset, readSize, statusMode, forceTimeoutTest,
+                                    retryConfig.retries, retryConfig.backoffBaseMs, retryConfig.backoffMaxMs,
+                                    firstFragment ? expectedCounter : kAnyMailboxCounter,
+                                    [&](const EscMailboxFrame& frame) -> bool {
+                auto parsed = CoeMailboxProtocol::parseSdoInfoFragment(frame.payload);
+                if ((parsed.success && parsed.opCode == expectedOpCode) ||
+                    parsed.opCode == CoeMailboxProtocol::kSdoInfoError) {
+                    fragment = std::move(parsed);
+                    return true;
+                }
+                return false;
+            }, responseFrame, readClass, outError)) {
+            txErrorClass = readClass;
+            return fail();
+        }
+        if (!fragment.success) {
+            outAbortCode = fragment.abortCode;
+            outError = fragment.error;
+            txErrorClass = MailboxErrorClass::Abort;
+            return fail();
+        }
+        outData.insert(outData.end(), fragment.data.begin(), fragment.data.end());
+        if (fragment.fragmentsLeft == 0U) {
+            break;
+        }
+        firstFragment = false;
+    }
+
+    lastMailboxErrorClass_ = MailboxErrorClass::None;
+    return true;
+}
+
+std::vector<LinuxRawSocketTransport::SdoBatchWrite> LinuxRawSocketTransport::pdoConfigurationWrites(
+    std::uint16_t assignIndex,
+    const std::vector<PdoMappingEntry>& entries) {
+    auto u8 = [](std::uint8_t value) { return std::vector<std::uint8_t>{value}; };
+    auto u16 = [](std::uint16_t value) {
+        return std::vector<std::uint8_t>{
             static_cast<std::uint8_t>(value & 0xFFU),
             static_cast<std::uint8_t>((value >> 8U) & 0xFFU),
         };
-        SdoAddress address;
-        address.index = index;
-        address.subIndex = subIndex;
-        if (!sdoDownload(slavePosition, address, data, abortCode, sdoError)) {
-            outError = "SDO write 0x" + std::to_string(index) + ":" + std::to_string(subIndex) + " failed: " + sdoError;
-            return false;
-        }
-        return true;
     };
-
-    auto writeSdoU32 = [&](std::uint16_t index, std::uint8_t subIndex, std::uint32_t value) -> bool {
-        std::uint32_t abortCode = 0;
-        std::string sdoError;
-        const std::vector<std::uint8_t> data = {
+    auto u32 = [](std::uint32_t value) {
+        return std::vector<std::uint8_t>{
             static_cast<std::uint8_t>(value & 0xFFU),
             static_cast<std::uint8_t>((value >> 8U) & 0xFFU),
             static_cast<std::uint8_t>((value >> 16U) & 0xFFU),
             static_cast<std::uint8_t>((value >> 24U) & 0xFFU),
         };
-        SdoAddress address;
-        address.index = index;
-        address.subIndex = subIndex;
-        if (!sdoDownload(slavePosition, address, data, abortCode, sdoError)) {
-            outError = "SDO write 0x" + std::to_string(index) + ":" + std::to_string(subIndex) + " failed: " + sdoError;
-            return false;
-        }
-        return true;
     };
 
+    std::vector<SdoBatchWrite> writes;
+    writes.reserve(entries.size() + 5U);
     // Disable mapping object before editing entries.
-    if (!writeSdoU8(assignIndex, 0, 0)) {
-        return false;
-    }
-
+    writes.push_back({{assignIndex, 0U}, u8(0U)});
     std::uint8_t sub = 1;
     for (const auto& e : entries) {
         const auto mapEntry = static_cast<std::uint32_t>(e.index) |
                               (static_cast<std::uint32_t>(e.subIndex) << 16U) |
                               (static_cast<std::uint32_t>(e.bitLength) << 24U);
-        if (!writeSdoU32(assignIndex, sub, mapEntry)) {
-            return false;
-        }
+        writes.push_back({{assignIndex, sub}, u32(mapEntry)});
         ++sub;
     }
-
-    if (!writeSdoU8(assignIndex, 0, static_cast<std::uint8_t>(entries.size()))) {
-        return false;
-    }
+    writes.push_back({{assignIndex, 0U}, u8(static_cast<std::uint8_t>(entries.size()))});
 
     // Sync manager assignment: 0x1C12 for RxPDO (0x1600..0x17FF), 0x1C13 for TxPDO (0x1A00..0x1BFF).
     const bool isRx = (assignIndex >= 0x1600U && assignIndex < 0x1800U);
     const std::uint16_t smAssign = isRx ? 0x1C12U : 0x1C13U;
-    if (!writeSdoU8(smAssign, 0, 0)) {
-        return false;
+    writes.push_back({{smAssign, 0U}, u8(0U)});
+    writes.push_back({{smAssign, 1U}, u16(assignIndex)});
+    writes.push_back({{smAssign, 0U}, u8(1U)});
+    return writes;
+}
+
+std::vector<LinuxRawSocketTransport::SdoCompleteWrite> LinuxRawSocketTransport::pdoConfigurationCompleteWrites(
+    std::uint16_t assignIndex,
+    const std::vector<PdoMappingEntry>& entries) {
+    // Complete Access images: sub-index 0 as a padded 16-bit count, then the entries.
+    std::vector<std::uint8_t> mapping{static_cast<std::uint8_t>(entries.size()), 0U};
+    mapping.reserve(2U + (4U * entries.size()));
+    for (const auto& e : entries) {
+        mapping.push_back(e.bitLength);
+        mapping.push_back(e.subIndex);
+        mapping.push_back(static_cast<std::uint8_t>(e.index & 0xFFU));
+        mapping.push_back(static_cast<std::uint8_t>((e.index >> 8U) & 0xFFU));
     }
-    if (!writeSdoU16(smAssign, 1, assignIndex)) {
-        return false;
+    const bool isRx = (assignIndex >= 0x1600U && assignIndex < 0x1800U);
+    std::vector<std::uint8_t> assignment{1U, 0U, static_cast<std::uint8_t>(assignIndex & 0xFFU),
+                                         static_cast<std::uint8_t>((assignIndex >> 8U) & 0xFFU)};
+    return {{assignIndex, std::move(mapping)}, {isRx ? std::uint16_t{0x1C12U} : std::uint16_t{0x1C13U}, std::move(assignment)}};
+}
+
+bool LinuxRawSocketTransport::configurePdo(std::uint16_t slavePosition, std::uint16_t assignIndex,
+                                           const std::vector<PdoMappingEntry>& entries,
+                                           std::string& outError) {
+    outError.clear();
+    // Two Complete Access writes replace entries+5 single-entry writes; fall back once per slave if refused.
+    if (completeAccessUnsupported_.count(slavePosition) == 0U) {
+        bool completeOk = true;
+        for (const auto& write : pdoConfigurationCompleteWrites(assignIndex, entries)) {
+            std::uint32_t abortCode = 0;
+            std::string sdoError;
+            if (!sdoDownloadComplete(slavePosition, write.index, true, write.data, abortCode, sdoError)) {
+                if (abortCode == 0U) {
+                    outError = "SDO complete write 0x" + std::to_string(write.index) + " failed: " + sdoError;
+                    return false;
+                }
+                completeOk = false;
+                break;
+            }
+        }
+        if (completeOk) {
+            return true;
+        }
+        completeAccessUnsupported_.insert(slavePosition);
     }
-    if (!writeSdoU8(smAssign, 0, 1)) {
-        return false;
+    for (const auto& write : pdoConfigurationWrites(assignIndex, entries)) {
+        std::uint32_t abortCode = 0;
+        std::string sdoError;
+        if (!sdoDownload(slavePosition, write.address, write.data, abortCode, sdoError)) {
+            outError = "SDO write 0x" + std::to_string(write.address.index) + ":" +
+                       std::to_string(write.address.subIndex) + " failed: " + sdoError;
+            return false;
+        }
     }
-
     return true;
 }
 
@@ -955,7 +1618,7 @@ bool LinuxRawSocketTransport::pollEmergency(EmergencyMessage& outEmergency) {
         return false;
     }
     outEmergency = emergencies_.front();
-    emergencies_.pop();
+    emergencies_.pop_front();
     return true;
 }
 
@@ -1050,12 +1713,7 @@ bool LinuxRawSocketTransport::mailboxReadFrameExpected(std::uint16_t adp,
         if (drainCoeEmergency && decoded->type == CoeMailboxProtocol::kMailboxTypeCoe) {
             EmergencyMessage emergency {};
             if (CoeMailboxProtocol::parseEmergency(decoded->payload, slavePosition, emergency)) {
-                if (emergencies_.size() >= emergencyQueueLimit_) {
-                    emergencies_.pop();
-                    ++mailboxDiagnostics_.emergencyDropped;
-                }
-                emergencies_.push(emergency);
-                ++mailboxDiagnostics_.emergencyQueued;
+                enqueueEmergency(emergency);
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
             continue;
@@ -1153,14 +1811,56 @@ void LinuxRawSocketTransport::resetMailboxDiagnostics() {
 }
 void LinuxRawSocketTransport::setMailboxStatusMode(MailboxStatusMode mode) { mailboxStatusMode_ = mode; }
 MailboxStatusMode LinuxRawSocketTransport::mailboxStatusMode() const { return mailboxStatusMode_; }
+void LinuxRawSocketTransport::setMailboxStatusMapping(bool enabled) { mailboxStatusMappingEnabled_ = enabled; }
+bool LinuxRawSocketTransport::mailboxStatusMapping() const { return mailboxStatusMappingEnabled_; }
+
+std::vector<std::uint16_t> LinuxRawSocketTransport::mailboxStatusMappedSlaves() const {
+    std::vector<std::uint16_t> out;
+    out.reserve(mailboxStatusBitBySlave_.size());
+    for (const auto& kv : mailboxStatusBitBySlave_) {
+        out.push_back(kv.first);
+    }
+    return out;
+}
+
+std::vector<std::uint16_t> LinuxRawSocketTransport::slavesWithMailboxData() const {
+    std::vector<std::uint16_t> out;
+    for (const auto& [position, bit] : mailboxStatusBitBySlave_) {
+        if (bit / 8U < mailboxStatusImage_.size() && ((mailboxStatusImage_[bit / 8U] >> (bit % 8U)) & 0x01U) != 0U) {
+            out.push_back(position);
+        }
+    }
+    return out;
+}
+
+bool LinuxRawSocketTransport::takeMailboxStatusFromImage(std::uint16_t slavePosition, bool& outFull) {
+    const auto it = mailboxStatusBitBySlave_.find(slavePosition);
+    if (it == mailboxStatusBitBySlave_.end() || mailboxStatusCycle_ == 0U ||
+        it->second / 8U >= mailboxStatusImage_.size()) {
+        return false;
+    }
+    // Each cyclic sample answers one status query; afterwards SM1 may have changed.
+    auto& consumed = mailboxStatusConsumedCycle_[slavePosition];
+    if (consumed >= mailboxStatusCycle_) {
+        return false;
+    }
+    consumed = mailboxStatusCycle_;
+    outFull = ((mailboxStatusImage_[it->second / 8U] >> (it->second % 8U)) & 0x01U) != 0U;
+    return true;
+}
+
+void LinuxRawSocketTransport::setMailboxRepeatEnabled(bool enabled) { mailboxRepeatEnabled_ = enabled; }
+bool LinuxRawSocketTransport::mailboxRepeatEnabled() const { return mailboxRepeatEnabled_; }
 void LinuxRawSocketTransport::setEmergencyQueueLimit(std::size_t limit) {
     emergencyQueueLimit_ = std::max<std::size_t>(1U, limit);
     while (emergencies_.size() > emergencyQueueLimit_) {
-        emergencies_.pop();
+        emergencies_.pop_front();
         ++mailboxDiagnostics_.emergencyDropped;
     }
 }
 std::size_t LinuxRawSocketTransport::emergencyQueueLimit() const { return emergencyQueueLimit_; }
+void LinuxRawSocketTransport::setSdoSegmentBytesLimit(std::size_t limit) { sdoSegmentBytesLimit_ = limit; }
+std::size_t LinuxRawSocketTransport::sdoSegmentBytesLimit() const { return sdoSegmentBytesLimit_; }
 MailboxErrorClass LinuxRawSocketTransport::lastMailboxErrorClass() const { return lastMailboxErrorClass_; }
 MailboxErrorClass LinuxRawSocketTransport::classifyMailboxError(const std::string& errorText) {
     if (errorText.empty()) {
@@ -1192,7 +1892,7 @@ MailboxErrorClass LinuxRawSocketTransport::classifyMailboxError(const std::strin
     if (errorText.find("socket") != std::string::npos ||
         errorText.find("sendto") != std::string::npos ||
         errorText.find("recv") != std::string::npos ||
-        errorText.find("select()") != std::string::npos ||
+        errorText.find("poll()") != std::string::npos ||
         errorText.find("transport not open") != std::string::npos ||
         errorText.find("not open") != std::string::npos) {
         return MailboxErrorClass::TransportIo;
@@ -1200,6 +1900,85 @@ MailboxErrorClass LinuxRawSocketTransport::classifyMailboxError(const std::strin
     return MailboxErrorClass::Unknown;
 }
 DcDiagnostics LinuxRawSocketTransport::dcDiagnostics() const { return dcDiagnostics_; }
+std::vector<EthercatDatagramRequest> LinuxRawSocketTransport::buildCyclicInputBatch(
+    std::uint16_t referencePosition, std::optional<std::int64_t> offsetNs, const EthercatDatagramRequest& lrd) {
+    std::vector<EthercatDatagramRequest> batch;
+    batch.reserve(3U);
+    EthercatDatagramRequest armw;
+    armw.command = kCommandArmw;
+    armw.adp = toAutoIncrementAddress(referencePosition);
+    armw.ado = kRegisterDcSystemTime;
+    armw.payload.assign(8U, 0U);
+    batch.push_back(std::move(armw));
+    if (offsetNs.has_value()) {
+        EthercatDatagramRequest offset;
+        offset.command = kCommandApwr;
+        offset.adp = toAutoIncrementAddress(referencePosition);
+        offset.ado = kRegisterDcSystemTimeOffset;
+        const auto raw = static_cast<std::uint64_t>(*offsetNs);
+        for (std::size_t i = 0; i < 8U; ++i) {
+            offset.payload.push_back(static_cast<std::uint8_t>((raw >> (8U * i)) & 0xFFU));
+        }
+        batch.push_back(std::move(offset));
+    }
+    batch.push_back(lrd);
+    return batch;
+}
+bool LinuxRawSocketTransport::decodeCyclicInputBatch(std::vector<EthercatDatagramResponse>& responses,
+                                                     bool offsetQueued, CyclicInputResult& outResult) {
+    outResult = CyclicInputResult{};
+    if (responses.size() != (offsetQueued ? 3U : 2U)) {
+        return false;
+    }
+    const auto& armw = responses.front();
+    if (armw.workingCounter >= 1U && armw.payload.size() == 8U) {
+        std::uint64_t raw = 0U;
+        for (std::size_t i = 0; i < 8U; ++i) {
+            raw |= static_cast<std::uint64_t>(armw.payload[i]) << (8U * i);
+        }
+        outResult.referenceTimeNs = static_cast<std::int64_t>(raw);
+        outResult.referenceTimeValid = true;
+    }
+    outResult.offsetWritten = offsetQueued && responses[1].workingCounter == 1U;
+    outResult.inputWorkingCounter = responses.back().workingCounter;
+    outResult.inputPayload = std::move(responses.back().payload);
+    return true;
+}
+bool LinuxRawSocketTransport::setDcReferenceDistribution(bool enabled, std::uint16_t referencePosition) {
+    if (enabled && dcFirstSlave_.has_value() && *dcFirstSlave_ != referencePosition) {
+        error_ = "cyclic DC reference " + std::to_string(referencePosition) + " is not the first DC slave " +
+                 std::to_string(*dcFirstSlave_);
+        dcDistributionEnabled_ = false;
+        return false;
+    }
+    dcDistributionEnabled_ = enabled;
+    dcDistributionReference_ = referencePosition;
+    dcReferenceTimeValid_ = false;
+    dcOffsetPending_ = false;
+    return true;
+}
+bool LinuxRawSocketTransport::dcReferenceDistribution() const { return dcDistributionEnabled_; }
+bool LinuxRawSocketTransport::lastDcReferenceTime(std::int64_t& outTimeNs) const {
+    if (!dcReferenceTimeValid_) {
+        return false;
+    }
+    outTimeNs = dcReferenceTimeNs_;
+    return true;
+}
+void LinuxRawSocketTransport::queueDcSystemTimeDifferenceRead(std::vector<std::uint16_t> positions) {
+    dcLineReadQueue_ = std::move(positions);
+}
+bool LinuxRawSocketTransport::lastDcSystemTimeDifferences(std::vector<DcSlaveSyncSample>& outSamples) const {
+    if (!dcLineSamplesValid_) {
+        return false;
+    }
+    outSamples = dcLineSamples_;
+    return true;
+}
+void LinuxRawSocketTransport::queueDcReferenceOffset(std::int64_t offsetNs) {
+    dcPendingOffsetNs_ = offsetNs;
+    dcOffsetPending_ = true;
+}
 void LinuxRawSocketTransport::resetDcDiagnostics() { dcDiagnostics_ = DcDiagnostics{}; }
 
 } // namespace oec
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <chrono>
 
@@ -17,16 +18,18 @@
 #include <net/if.h>
 #include <netinet/in.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include "openethercat/transport/ethercat_frame.hpp"
+#include "openethercat/transport/frame_timestamping.hpp"
 
 namespace oec {
 namespace {
 
 constexpr std::uint16_t kEtherTypeEthercat = 0x88A4;
+// Bound in-flight datagrams per burst so 8-bit datagram indices stay unique.
+constexpr std::size_t kMaxInFlightDatagrams = 128U;
 
 MailboxStatusMode parseMailboxStatusMode(const char* value) {
     if (value == nullptr) {
@@ -87,6 +90,23 @@ bool openEthercatInterfaceSocket(const std::string& ifname,
     return true;
 }
 
+bool sendEthernetFrame(int socketFd,
+                       int ifIndex,
+                       const std::array<std::uint8_t, 6>& destinationMac,
+                       const std::vector<std::uint8_t>& frame,
+                       std::string& outError,
+                       FrameTimestampMode timestampMode = FrameTimestampMode::Off) {
+    sockaddr_ll target {};
+    target.sll_family = AF_PACKET;
+    target.sll_protocol = htons(kEtherTypeEthercat);
+    target.sll_ifindex = ifIndex;
+    target.sll_halen = 6;
+    std::copy(destinationMac.begin(), destinationMac.end(), target.sll_addr);
+
+    return sendTimestamped(socketFd, frame.data(), frame.size(), reinterpret_cast<const sockaddr*>(&target),
+                           sizeof(target), timestampMode, outError);
+}
+
 bool sendAndReceiveDatagram(int socketFd,
                             int ifIndex,
                             int timeoutMs,
@@ -100,53 +120,30 @@ bool sendAndReceiveDatagram(int socketFd,
                             std::string& outError) {
     const auto frame = EthercatFrameCodec::buildDatagramFrame(
         destinationMac.data(), sourceMac.data(), request);
-
-    sockaddr_ll target {};
-    target.sll_family = AF_PACKET;
-    target.sll_protocol = htons(kEtherTypeEthercat);
-    target.sll_ifindex = ifIndex;
-    target.sll_halen = 6;
-    std::copy(destinationMac.begin(), destinationMac.end(), target.sll_addr);
-
-    const auto sent = ::sendto(socketFd, frame.data(), frame.size(), 0,
-                               reinterpret_cast<const sockaddr*>(&target), sizeof(target));
-    if (sent < 0 || static_cast<std::size_t>(sent) != frame.size()) {
-        outError = "sendto() failed: " + std::string(std::strerror(errno));
+    if (!sendEthernetFrame(socketFd, ifIndex, destinationMac, frame, outError)) {
         return false;
     }
 
-    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
     std::size_t scannedFrames = 0U;
     std::vector<std::uint8_t> rxFrame(1518U, 0U);
     while (scannedFrames < maxFramesPerCycle) {
-        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start);
-        const auto remainingMs = timeoutMs - static_cast<int>(elapsed.count());
-        if (remainingMs <= 0) {
-            outError = "receive timeout";
-            return false;
-        }
-
-        fd_set readSet;
-        FD_ZERO(&readSet);
-        FD_SET(socketFd, &readSet);
-
-        timeval timeout {};
-        timeout.tv_sec = remainingMs / 1000;
-        timeout.tv_usec = (remainingMs % 1000) * 1000;
-
-        const int selectResult = ::select(socketFd + 1, &readSet, nullptr, nullptr, &timeout);
-        if (selectResult == 0) {
+        const int ready = waitReadable(&socketFd, 1U, deadline, ReceiveWaitMode::Block, outError);
+        if (ready == 0) {
             outError = "receive timeout";
             return false;
         }
-        if (selectResult < 0) {
-            outError = "select() failed: " + std::string(std::strerror(errno));
+        if (ready < 0) {
             return false;
         }
 
-        const auto received = ::recv(socketFd, rxFrame.data(), rxFrame.size(), 0);
+        const auto received = ::recv(socketFd, rxFrame.data(), rxFrame.size(), MSG_DONTWAIT);
         if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Readable only through a stray TX stamp of an earlier cyclic frame.
+                discardTxTimestamps(socketFd);
+                continue;
+            }
             outError = "recv() failed: " + std::string(std::strerror(errno));
             return false;
         }
@@ -175,8 +172,17 @@ bool sendAndReceiveDatagram(int socketFd,
 
 } // namespace
 
+void LinuxRawSocketTransport::adoptFrameSocket(int socketFd) {
+    if (adoptedSocketFd_ >= 0 && adoptedSocketFd_ != socketFd) {
+        ::close(adoptedSocketFd_);
+    }
+    adoptedSocketFd_ = socketFd;
+}
+
 bool LinuxRawSocketTransport::open() {
     close();
+    invalidateIdentityCache();
+    eoeMailboxWindows_.clear();
     mailboxStatusMode_ = parseMailboxStatusMode(std::getenv("OEC_MAILBOX_STATUS_MODE"));
     if (const char* env = std::getenv("OEC_MAILBOX_EMERGENCY_QUEUE_LIMIT")) {
         try {
@@ -185,23 +191,170 @@ bool LinuxRawSocketTransport::open() {
             // Keep default on parse failure.
         }
     }
+    if (const char* env = std::getenv("OEC_SDO_SEGMENT_BYTES")) {
+        try {
+            sdoSegmentBytesLimit_ = static_cast<std::size_t>(std::stoul(env, nullptr, 0));
+        } catch (...) {
+            // Keep default on parse failure.
+        }
+    }
+    if (const char* env = std::getenv("OEC_MAILBOX_STATUS_FMMU")) {
+        mailboxStatusMappingEnabled_ = (std::string(env) != "0");
+    }
+    if (const char* env = std::getenv("OEC_MAILBOX_REPEAT")) {
+        mailboxRepeatEnabled_ = (std::string(env) != "0");
+    }
+    if (const char* env = std::getenv("OEC_PROCESS_IMAGE_PLAN")) {
+        processImagePlanPath_ = env;
+    }
+    if (const char* env = std::getenv("OEC_REDUNDANCY_PARALLEL")) {
+        parallelRedundancy_ = (std::string(env) != "0");
+    }
+    if (const char* env = std::getenv("OEC_RX_TIMEOUT_US")) {
+        try {
+            setReceiveTimeout(std::chrono::microseconds(std::stoll(env, nullptr, 0)));
+        } catch (...) {
+            // Keep default on parse failure.
+        }
+    }
+    if (const char* env = std::getenv("OEC_RX_BUSY_POLL")) {
+        receiveWaitMode_ = (std::string(env) != "0") ? ReceiveWaitMode::BusyPoll : ReceiveWaitMode::Block;
+    }
+    if (const char* env = std::getenv("OEC_SO_BUSY_POLL_US")) {
+        try {
+            setSocketBusyPoll(std::chrono::microseconds(std::stoll(env, nullptr, 0)));
+        } catch (...) {
+            // Keep default on parse failure.
+        }
+    }
+    if (const char* env = std::getenv("OEC_TXTIME")) {
+        scheduledTransmit_.enabled = (std::string(env) != "0");
+    }
+    if (const char* env = std::getenv("OEC_TXTIME_PRIORITY")) {
+        try {
+            scheduledTransmit_.socketPriority = std::stoi(env, nullptr, 0);
+        } catch (...) {
+            // Keep default on parse failure.
+        }
+    }
+    if (const char* env = std::getenv("OEC_TXTIME_MIN_LEAD_US")) {
+        try {
+            scheduledTransmit_.minLead = std::chrono::microseconds(std::stoll(env, nullptr, 0));
+        } catch (...) {
+            // Keep default on parse failure.
+        }
+    }
+    if (const char* env = std::getenv("OEC_XDP")) {
+        xdpOptions_.enabled = (std::string(env) != "0");
+    }
+    if (const char* env = std::getenv("OEC_XDP_QUEUE")) {
+        try {
+            xdpOptions_.queueId = static_cast<std::uint32_t>(std::stoul(env, nullptr, 0));
+        } catch (...) {
+            // Keep default on parse failure.
+        }
+    }
+    if (const char* env = std::getenv("OEC_XDP_COPY")) {
+        xdpOptions_.zeroCopy = (std::string(env) == "0");
+    }
+    if (const char* env = std::getenv("OEC_XDP_GENERIC")) {
+        xdpOptions_.nativeMode = (std::string(env) == "0");
+    }
+    scheduledTransmitDiagnostics_ = ScheduledTransmitDiagnostics{};
+    nextLaunchTime_.reset();
+    if (const char* env = std::getenv("OEC_FRAME_TIMESTAMPING")) {
+        FrameTimestampMode mode = FrameTimestampMode::Off;
+        if (parseFrameTimestampMode(env, mode)) {
+            requestedTimestampMode_ = mode;
+        }
+    }
+    nextReceiveDeadline_.reset();
+    lastWireTiming_ = CycleWireTiming{};
+    redundancyDiagnostics_ = RedundancyDiagnostics{};
+    redundancyObserved_ = false;
     lastWorkingCounter_ = 0;
     lastOutputWorkingCounter_ = 0;
     lastInputWorkingCounter_ = 0;
     lastMailboxErrorClass_ = MailboxErrorClass::None;
     dcDiagnostics_ = DcDiagnostics{};
-    if (!openEthercatInterfaceSocket(ifname_, socketFd_, ifIndex_, sourceMac_, error_)) {
+    if (adoptedSocketFd_ >= 0) {
+        socketFd_ = adoptedSocketFd_;
+        adoptedSocketFd_ = -1;
+    } else if (!openEthercatInterfaceSocket(ifname_, socketFd_, ifIndex_, sourceMac_, error_)) {
         close();
         return false;
     }
 
     if (redundancyEnabled_ && !secondaryIfname_.empty()) {
-        std::array<std::uint8_t, 6> secondaryMac {};
         if (!openEthercatInterfaceSocket(secondaryIfname_, secondarySocketFd_, secondaryIfIndex_,
-                                         secondaryMac, error_)) {
+                                         secondarySourceMac_, error_)) {
+            close();
+            return false;
+        }
+    }
+
+    if (xdpOptions_.enabled) {
+        // Cyclic frames may come back on either port with redundancy; the XDP program sees only one.
+        if (secondarySocketFd_ >= 0) {
+            error_ = "AF_XDP transport does not support redundancy";
             close();
             return false;
         }
+        if (!xdp_.open(ifname_, xdpOptions_, error_)) {
+            error_ = "AF_XDP setup on " + ifname_ + " failed: " + error_;
+            close();
+            return false;
+        }
+    }
+
+    if (socketBusyPoll_.count() > 0) {
+        // Needs CAP_NET_ADMIN above net.core.busy_poll; falling back to interrupts is harmless.
+        std::string busyPollError;
+        (void)oec::setSocketBusyPoll(socketFd_, socketBusyPoll_, busyPollError);
+        if (secondarySocketFd_ >= 0) {
+            (void)oec::setSocketBusyPoll(secondarySocketFd_, socketBusyPoll_, busyPollError);
+        }
+        if (xdp_.isOpen()) {
+            (void)oec::setSocketBusyPoll(xdp_.fd(), socketBusyPoll_, busyPollError);
+        }
+    }
+
+    if (scheduledTransmit_.enabled) {
+        // Send-only socket (protocol 0 receives nothing) in the traffic class of the ETF queue.
+        launchSocketFd_ = ::socket(AF_PACKET, SOCK_RAW, 0);
+        sockaddr_ll sll {};
+        sll.sll_family = AF_PACKET;
+        sll.sll_ifindex = ifIndex_;
+        std::string launchError;
+        if (launchSocketFd_ >= 0 &&
+            (::bind(launchSocketFd_, reinterpret_cast<sockaddr*>(&sll), sizeof(sll)) < 0 ||
+             !enableScheduledTransmit(launchSocketFd_, scheduledTransmit_.socketPriority, launchError))) {
+            ::close(launchSocketFd_);
+            launchSocketFd_ = -1;
+        }
+    }
+
+    // AF_XDP frames bypass the stack that takes SO_TIMESTAMPING stamps.
+    activeTimestampMode_ = xdp_.isOpen() ? FrameTimestampMode::Off : requestedTimestampMode_;
+    if (activeTimestampMode_ != FrameTimestampMode::Off) {
+        std::string timestampError;
+        bool enabled = enableFrameTimestamping(socketFd_, ifname_, activeTimestampMode_, timestampError);
+        if (!enabled && activeTimestampMode_ == FrameTimestampMode::Hardware) {
+            // Many NICs (and all virtual ones) cannot stamp in hardware; the kernel can.
+            activeTimestampMode_ = FrameTimestampMode::Software;
+            enabled = enableFrameTimestamping(socketFd_, ifname_, activeTimestampMode_, timestampError);
+        }
+        if (enabled && secondarySocketFd_ >= 0) {
+            enabled = enableFrameTimestamping(secondarySocketFd_, secondaryIfname_, activeTimestampMode_,
+                                              timestampError);
+        }
+        if (!enabled) {
+            activeTimestampMode_ = FrameTimestampMode::Off;
+        }
+        if (activeTimestampMode_ == FrameTimestampMode::Hardware) {
+            // Without the PHC, round trips stay valid but DC frame stamps are not reported.
+            phcFd_ = openPhc(socketFd_, ifname_, timestampError);
+        }
     }
 
     error_.clear();
@@ -219,16 +372,31 @@ void LinuxRawSocketTransport::close() {
         secondarySocketFd_ = -1;
     }
     secondaryIfIndex_ = 0;
+    if (launchSocketFd_ >= 0) {
+        ::close(launchSocketFd_);
+        launchSocketFd_ = -1;
+    }
+    xdp_.close();
+    if (phcFd_ >= 0) {
+        ::close(phcFd_);
+        phcFd_ = -1;
+    }
+    activeTimestampMode_ = FrameTimestampMode::Off;
+    lastWireTiming_ = CycleWireTiming{};
     lastWorkingCounter_ = 0;
     lastOutputWorkingCounter_ = 0;
     lastInputWorkingCounter_ = 0;
     lastFrameUsedSecondary_ = false;
+    redundancyObserved_ = false;
     outputWindows_.clear();
-    while (!emergencies_.empty()) {
-        emergencies_.pop();
-    }
+    emergencies_.clear();
     lastMailboxErrorClass_ = MailboxErrorClass::None;
     dcDiagnostics_ = DcDiagnostics{};
+    dcReferenceTimeValid_ = false;
+    dcOffsetPending_ = false;
+    dcFirstSlave_.reset();
+    dcLineReadQueue_.clear();
+    dcLineSamplesValid_ = false;
 }
 
 bool LinuxRawSocketTransport::sendDatagramRequest(const EthercatDatagramRequest& request,
@@ -240,4 +408,148 @@ bool LinuxRawSocketTransport::sendDatagramRequest(const EthercatDatagramRequest&
                                   request, outWkc, outPayload, outError);
 }
 
+bool LinuxRawSocketTransport::sendDatagramBatch(std::vector<EthercatDatagramRequest>& requests,
+                                                std::vector<EthercatDatagramResponse>& outResponses,
+                                                std::string& outError) {
+    return sendDatagramBatchUntil(requests, outResponses, std::nullopt, outError);
+}
+
+bool LinuxRawSocketTransport::sendDatagramBatchUntil(std::vector<EthercatDatagramRequest>& requests,
+                                                     std::vector<EthercatDatagramResponse>& outResponses,
+                                                     std::optional<std::chrono::steady_clock::time_point> deadline,
+                                                     std::string& outError,
+                                                     FrameWireSample* outWire) {
+    // Only a caller-given deadline spins in busy-poll mode; mailbox batches always block.
+    const auto waitMode = deadline.has_value() ? receiveWaitMode_ : ReceiveWaitMode::Block;
+    const auto timestampMode = (outWire != nullptr) ? activeTimestampMode_ : FrameTimestampMode::Off;
+    FrameWireSample wire;
+    outResponses.assign(requests.size(), EthercatDatagramResponse{});
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        return false;
+    }
+
+    std::size_t burstBegin = 0U;
+    while (burstBegin < requests.size()) {
+        const auto burstEnd = std::min(requests.size(), burstBegin + kMaxInFlightDatagrams);
+
+        // Pack the burst into as few frames as the frame capacity allows.
+        std::vector<std::vector<std::uint8_t>> frames;
+        std::vector<EthercatDatagramRequest> frameRequests;
+        std::size_t frameBytes = 0U;
+        std::unordered_map<std::uint8_t, std::size_t> pending;
+        for (std::size_t i = burstBegin; i < burstEnd; ++i) {
+            auto& request = requests[i];
+            request.datagramIndex = datagramIndex_++;
+            const auto bytes = EthercatFrameCodec::datagramWireBytes(request);
+            if (bytes > EthercatFrameCodec::kMaxDatagramBytesPerFrame) {
+                outError = "datagram exceeds frame capacity";
+                return false;
+            }
+            if (!frameRequests.empty() && frameBytes + bytes > EthercatFrameCodec::kMaxDatagramBytesPerFrame) {
+                frames.push_back(EthercatFrameCodec::buildMultiDatagramFrame(
+                    destinationMac_.data(), sourceMac_.data(), frameRequests));
+                frameRequests.clear();
+                frameBytes = 0U;
+            }
+            frameRequests.push_back(request);
+            frameBytes += bytes;
+            pending[request.datagramIndex] = i;
+        }
+        if (!frameRequests.empty()) {
+            frames.push_back(EthercatFrameCodec::buildMultiDatagramFrame(
+                destinationMac_.data(), sourceMac_.data(), frameRequests));
+        }
+
+        // Responses to frames the XDP program steers arrive on the AF_XDP socket; send them there too.
+        const bool useXdp = xdp_.isOpen() && std::all_of(frames.begin(), frames.end(), [](const auto& frame) {
+            return XdpSocket::isCyclicFrame(frame.data(), frame.size());
+        });
+        const int rxFd = useXdp ? xdp_.fd() : socketFd_;
+
+        // Pipeline: all frames leave before the first response is awaited.
+        for (const auto& frame : frames) {
+            const bool sent = useXdp ? xdp_.send(frame, outError)
+                                     : sendEthernetFrame(socketFd_, ifIndex_, destinationMac_, frame, outError,
+                                                         timestampMode);
+            if (!sent) {
+                return false;
+            }
+        }
+
+        const auto burstDeadline =
+            deadline.has_value() ? *deadline : std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs_);
+        const std::size_t maxScannedFrames = maxFramesPerCycle_ * frames.size();
+        std::size_t scannedFrames = 0U;
+        std::vector<std::uint8_t> rxFrame;
+        std::vector<EthercatDatagramResponse> parsed;
+        while (!pending.empty()) {
+            if (scannedFrames >= maxScannedFrames) {
+                outError = "response frame not found in cycle window";
+                return false;
+            }
+            const int ready = waitReadable(&rxFd, 1U, burstDeadline, waitMode, outError);
+            if (ready == 0) {
+                outError = "receive timeout (" + std::to_string(pending.size()) + " datagrams outstanding)";
+                return false;
+            }
+            if (ready < 0) {
+                return false;
+            }
+
+            rxFrame.assign(1518U, 0U);
+            FrameWireSample rxWire;
+            const auto received =
+                useXdp ? xdp_.receive(rxFrame.data(), rxFrame.size())
+                       : receiveTimestamped(socketFd_, rxFrame.data(), rxFrame.size(), MSG_DONTWAIT, timestampMode,
+                                            rxWire);
+            if (received < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    // Only the first TX stamp is kept: the batch round trip starts with its first frame.
+                    FrameWireSample stamp;
+                    if (timestampMode != FrameTimestampMode::Off && readTxTimestamp(socketFd_, timestampMode, stamp)) {
+                        if (!wire.txValid) {
+                            wire.txValid = true;
+                            wire.txNs = stamp.txNs;
+                        }
+                    } else {
+                        discardTxTimestamps(socketFd_);
+                    }
+                    continue;
+                }
+                outError = "recv() failed: " + std::string(std::strerror(errno));
+                return false;
+            }
+            rxFrame.resize(static_cast<std::size_t>(received));
+            ++scannedFrames;
+
+            if (!EthercatFrameCodec::parseMultiDatagramFrame(rxFrame, parsed)) {
+                continue;
+            }
+            for (auto& response : parsed) {
+                const auto it = pending.find(response.datagramIndex);
+                if (it == pending.end()) {
+                    continue;
+                }
+                const auto& request = requests[it->second];
+                if (response.command != request.command || response.payload.size() != request.payload.size()) {
+                    continue;
+                }
+                outResponses[it->second] = std::move(response);
+                pending.erase(it);
+                wire.rxValid = rxWire.rxValid;
+                wire.rxNs = rxWire.rxNs;
+            }
+        }
+        burstBegin = burstEnd;
+    }
+    if (outWire != nullptr && timestampMode != FrameTimestampMode::Off) {
+        if (!wire.txValid) {
+            (void)readTxTimestamp(socketFd_, timestampMode, wire);
+        }
+        *outWire = wire;
+    }
+    return true;
+}
+
 } // namespace oec
@@ -4,9 +4,11 @@
  */
 
 #include "openethercat/transport/linux_raw_socket_transport.hpp"
+#include "openethercat/master/eoe_gateway.hpp"
 #include "openethercat/master/foe_eoe.hpp"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -17,6 +19,11 @@
 namespace oec {
 namespace {
 
+constexpr std::uint8_t kCommandAprd = 0x01;
+constexpr std::uint8_t kCommandApwr = 0x02;
+constexpr std::uint16_t kRegisterSmBase = 0x0800;
+constexpr std::uint16_t kRegisterSmStatusOffset = 0x0005;
+constexpr std::uint8_t kSmStatusMailboxFull = 0x08;
 constexpr std::uint8_t kMailboxTypeEoe = 0x02U;
 constexpr std::uint8_t kMailboxTypeFoe = 0x04U;
 constexpr std::uint16_t kFoeOpReadReq = 0x0001U;
@@ -55,12 +62,21 @@ void appendLe32Raw(std::vector<std::uint8_t>& out, std::uint32_t value) {
 bool LinuxRawSocketTransport::foeRead(std::uint16_t slavePosition, const FoERequest& request,
                                       FoEResponse& outResponse, std::string& outError) {
     outResponse = FoEResponse{};
+    FoEVectorSink sink(outResponse.data);
+    if (!foeReadStream(slavePosition, request, sink, outError)) {
+        outResponse.error = outError;
+        return false;
+    }
+    outResponse.success = true;
+    return true;
+}
+
+bool LinuxRawSocketTransport::foeReadStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                                            std::string& outError) {
     outError.clear();
     ++mailboxDiagnostics_.foeReadStarted;
     auto fail = [&](std::string message) -> bool {
         outError = std::move(message);
-        outResponse.success = false;
-        outResponse.error = outError;
         ++mailboxDiagnostics_.foeReadFailed;
         return false;
     };
@@ -92,6 +108,10 @@ bool LinuxRawSocketTransport::foeRead(std::uint16_t slavePosition, const FoERequ
 
     const std::size_t maxDataPerPacket =
         (readSize > 12U) ? (readSize - 12U) : std::max<std::size_t>(16U, request.maxChunkBytes);
+    FoEProgress progress;
+    progress.slavePosition = slavePosition;
+    std::vector<std::uint8_t> ack;
+    ack.reserve(6U);
     std::uint32_t expectedPacket = 1U;
     while (true) {
         EscMailboxFrame frame;
@@ -119,11 +139,13 @@ bool LinuxRawSocketTransport::foeRead(std::uint16_t slavePosition, const FoERequ
         if (packetNo != expectedPacket) {
             return fail("FoE packet sequence mismatch");
         }
-        const std::vector<std::uint8_t> chunk(frame.payload.begin() + 6, frame.payload.end());
-        outResponse.data.insert(outResponse.data.end(), chunk.begin(), chunk.end());
+        // Hand the packet straight to the sink; nothing of the file is retained here.
+        const std::size_t chunkBytes = frame.payload.size() - 6U;
+        if (!sink.write(frame.payload.data() + 6, chunkBytes, outError)) {
+            return fail(outError);
+        }
 
-        std::vector<std::uint8_t> ack;
-        ack.reserve(6U);
+        ack.clear();
         appendLe16Raw(ack, kFoeOpAck);
         appendLe32Raw(ack, packetNo);
         if (!mailboxWriteFrame(adp, writeOffset, writeSize, kMailboxTypeFoe, ack, expectedCounter, outError)) {
@@ -133,116 +155,423 @@ bool LinuxRawSocketTransport::foeRead(std::uint16_t slavePosition, const FoERequ
             return fail(outError);
         }
         ++expectedPacket;
+        progress.bytesTransferred += chunkBytes;
+        progress.packets = packetNo;
+        if (request.onProgress) {
+            request.onProgress(progress);
+        }
 
-        if (chunk.size() < maxDataPerPacket) {
-            outResponse.success = true;
-            outResponse.error.clear();
+        if (chunkBytes < maxDataPerPacket) {
             return true;
         }
     }
 }
 
+/**
+ * @brief State of one slave's FoE write while packets of many slaves share frames.
+ */
+struct LinuxRawSocketTransport::FoeWriteSession {
+    enum class Phase { Send, Await, Busy, Done, Failed };
+
+    FoEWriteJob* job = nullptr;
+    std::uint16_t adp = 0;
+    std::uint16_t writeOffset = 0;
+    std::uint16_t writeSize = 0;
+    std::uint16_t readOffset = 0;
+    std::uint16_t readSize = 0;
+    std::uint8_t counter = 0;
+    Phase phase = Phase::Send;
+    // True until the slave acknowledged the write request itself.
+    bool awaitingWrqAck = true;
+    int writeAttempts = 0;
+    std::chrono::steady_clock::time_point deadline{};
+    // One packet buffer reused for the whole transfer.
+    std::vector<std::uint8_t> packet;
+    std::size_t maxDataBytes = 0;
+    std::size_t chunkBytes = 0;
+    std::uint32_t packetNo = 0;
+    FoEProgress progress;
+
+    bool pending() const { return phase != Phase::Done && phase != Phase::Failed; }
+};
+
+bool LinuxRawSocketTransport::foeWriteNextPacket(FoeWriteSession& session) {
+    auto& packet = session.packet;
+    packet.resize(6U + session.maxDataBytes);
+    packet[0] = static_cast<std::uint8_t>(kFoeOpData & 0xFFU);
+    packet[1] = static_cast<std::uint8_t>((kFoeOpData >> 8U) & 0xFFU);
+    for (std::size_t i = 0; i < 4U; ++i) {
+        packet[2U + i] = static_cast<std::uint8_t>((session.packetNo >> (8U * i)) & 0xFFU);
+    }
+    // Pull the next chunk from the source directly behind the header.
+    session.chunkBytes = 0U;
+    while (session.chunkBytes < session.maxDataBytes) {
+        std::size_t got = 0U;
+        if (!session.job->source->read(packet.data() + 6U + session.chunkBytes,
+                                       session.maxDataBytes - session.chunkBytes, got, session.job->error)) {
+            return false;
+        }
+        if (got == 0U) {
+            break;
+        }
+        session.chunkBytes += got;
+    }
+    packet.resize(6U + session.chunkBytes);
+    return true;
+}
+
+bool LinuxRawSocketTransport::foeWriteHandleReply(FoeWriteSession& session, const EscMailboxFrame& frame) {
+    auto& error = session.job->error;
+    const bool afterWrq = session.awaitingWrqAck;
+    if (frame.payload.size() < 2U) {
+        error = afterWrq ? "FoE response payload too short" : "FoE ACK payload too short";
+        return false;
+    }
+    const auto op = readLe16Raw(frame.payload, 0U);
+    if (op == kFoeOpErr) {
+        error = afterWrq ? "FoE write request rejected" : "FoE data packet rejected";
+        return false;
+    }
+    if (afterWrq) {
+        if (op != kFoeOpAck) {
+            error = "Expected FoE ACK after WRQ";
+            return false;
+        }
+        session.awaitingWrqAck = false;
+        session.packetNo = 1U;
+        if (!foeWriteNextPacket(session)) {
+            return false;
+        }
+        session.phase = FoeWriteSession::Phase::Send;
+        return true;
+    }
+    if (op == kFoeOpBusy) {
+        // The slave is still processing (typically flashing); repeat the same packet shortly.
+        session.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+        session.phase = FoeWriteSession::Phase::Busy;
+        return true;
+    }
+    if (op != kFoeOpAck || frame.payload.size() < 6U) {
+        error = "Expected FoE ACK for data packet";
+        return false;
+    }
+    if (readLe32Raw(frame.payload, 2U) != session.packetNo) {
+        error = "FoE ACK packet mismatch";
+        return false;
+    }
+
+    session.progress.bytesTransferred += session.chunkBytes;
+    session.progress.packets = session.packetNo;
+    if (session.job->request.onProgress) {
+        session.job->request.onProgress(session.progress);
+    }
+    // A short (possibly empty) packet ends the file.
+    if (session.chunkBytes < session.maxDataBytes) {
+        session.phase = FoeWriteSession::Phase::Done;
+        return true;
+    }
+    ++session.packetNo;
+    if (!foeWriteNextPacket(session)) {
+        return false;
+    }
+    session.phase = FoeWriteSession::Phase::Send;
+    return true;
+}
+
 bool LinuxRawSocketTransport::foeWrite(std::uint16_t slavePosition, const FoERequest& request,
                                        const std::vector<std::uint8_t>& data, std::string& outError) {
+    FoEMemorySource source(data);
+    return foeWriteStream(slavePosition, request, source, outError);
+}
+
+bool LinuxRawSocketTransport::foeWriteStream(std::uint16_t slavePosition, const FoERequest& request,
+                                             FoESource& source, std::string& outError) {
+    std::vector<FoEWriteJob> jobs(1U);
+    jobs[0].slavePosition = slavePosition;
+    jobs[0].request = request;
+    jobs[0].source = &source;
+    const bool ok = foeWriteStreams(jobs, outError);
+    outError = jobs[0].error;
+    return ok;
+}
+
+bool LinuxRawSocketTransport::foeWriteStreams(std::vector<FoEWriteJob>& jobs, std::string& outError) {
     outError.clear();
-    ++mailboxDiagnostics_.foeWriteStarted;
-    auto fail = [&](std::string message) -> bool {
-        outError = std::move(message);
+    std::vector<FoeWriteSession> sessions(jobs.size());
+    auto failSession = [&](FoeWriteSession& session, std::string message, bool timeout) {
+        if (!message.empty()) {
+            session.job->error = std::move(message);
+        }
+        session.phase = FoeWriteSession::Phase::Failed;
         ++mailboxDiagnostics_.foeWriteFailed;
-        return false;
+        if (timeout) {
+            ++mailboxDiagnostics_.mailboxTimeouts;
+        }
     };
-    if (socketFd_ < 0) {
-        return fail("transport not open");
-    }
-
-    const auto adp = static_cast<std::uint16_t>(0U - slavePosition);
-    std::uint16_t writeOffset = 0U;
-    std::uint16_t writeSize = 0U;
-    std::uint16_t readOffset = 0U;
-    std::uint16_t readSize = 0U;
-    resolveMailboxWindow(adp, writeOffset, writeSize, readOffset, readSize, outError);
 
-    std::vector<std::uint8_t> wrq;
-    wrq.reserve(8U + request.fileName.size() + 1U);
-    appendLe16Raw(wrq, kFoeOpWriteReq);
-    appendLe32Raw(wrq, request.password);
-    wrq.insert(wrq.end(), request.fileName.begin(), request.fileName.end());
-    wrq.push_back('\0');
+    std::vector<EthercatDatagramRequest> requests;
+    std::vector<EthercatDatagramResponse> responses;
+    std::vector<FoeWriteSession*> owners;
+    std::string batchError;
 
-    std::uint8_t expectedCounter = 0U;
-    if (!mailboxWriteFrame(adp, writeOffset, writeSize, kMailboxTypeFoe, wrq, expectedCounter, outError)) {
-        if (outError == "Mailbox payload exceeds write window") {
-            outError = "FoE request exceeds mailbox write window";
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        auto& session = sessions[i];
+        session.job = &jobs[i];
+        jobs[i].success = false;
+        jobs[i].error.clear();
+        ++mailboxDiagnostics_.foeWriteStarted;
+        if (jobs[i].source == nullptr) {
+            failSession(session, "FoE write job without source", false);
+            continue;
+        }
+        if (socketFd_ < 0) {
+            failSession(session, "transport not open", false);
+            continue;
+        }
+        session.adp = static_cast<std::uint16_t>(0U - jobs[i].slavePosition);
+        session.writeOffset = mailboxWriteOffset_;
+        session.writeSize = mailboxWriteSize_;
+        session.readOffset = mailboxReadOffset_;
+        session.readSize = mailboxReadSize_;
+        for (std::uint8_t sm = 0U; sm < 2U; ++sm) {
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = session.adp;
+            req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (sm * 8U));
+            req.payload.assign(8U, 0U);
+            requests.push_back(std::move(req));
+            owners.push_back(&session);
         }
-        return fail(outError);
     }
 
-    EscMailboxFrame frame;
-    if (!mailboxReadFrameExpected(adp, slavePosition, readOffset, readSize, expectedCounter, kMailboxTypeFoe,
-                                  true, frame, false, "Timed out waiting for FoE mailbox response", outError)) {
-        return fail(outError);
+    // Resolve SM0/SM1 mailbox windows of every slave in one batch.
+    if (!requests.empty() && sendDatagramBatch(requests, responses, batchError)) {
+        for (std::size_t i = 0; i + 1U < responses.size(); i += 2U) {
+            const auto& sm0 = responses[i];
+            const auto& sm1 = responses[i + 1U];
+            if (sm0.workingCounter == 0U || sm1.workingCounter == 0U) {
+                continue;
+            }
+            const auto sm0Len = readLe16Raw(sm0.payload, 2U);
+            const auto sm1Len = readLe16Raw(sm1.payload, 2U);
+            if (sm0Len > 0U && sm1Len > 0U) {
+                owners[i]->writeOffset = readLe16Raw(sm0.payload, 0U);
+                owners[i]->writeSize = sm0Len;
+                owners[i]->readOffset = readLe16Raw(sm1.payload, 0U);
+                owners[i]->readSize = sm1Len;
+            }
+        }
     }
-    if (frame.payload.size() < 2U) {
-        return fail("FoE response payload too short");
+    for (auto& session : sessions) {
+        if (!session.pending()) {
+            continue;
+        }
+        const auto& request = session.job->request;
+        session.maxDataBytes = (session.writeSize > 12U)
+            ? std::min<std::size_t>(request.maxChunkBytes, session.writeSize - 12U)
+            : std::min<std::size_t>(request.maxChunkBytes, 256U);
+        session.progress.slavePosition = session.job->slavePosition;
+        session.progress.totalBytes = session.job->source->sizeHint();
+        auto& wrq = session.packet;
+        wrq.reserve(std::max<std::size_t>(8U + request.fileName.size() + 1U, 6U + session.maxDataBytes));
+        appendLe16Raw(wrq, kFoeOpWriteReq);
+        appendLe32Raw(wrq, request.password);
+        wrq.insert(wrq.end(), request.fileName.begin(), request.fileName.end());
+        wrq.push_back('\0');
     }
-    auto op = readLe16Raw(frame.payload, 0U);
-    if (op == kFoeOpErr) {
-        return fail("FoE write request rejected");
-    }
-    if (op != kFoeOpAck) {
-        return fail("Expected FoE ACK after WRQ");
-    }
-
-    const std::size_t maxDataBytes = (writeSize > 12U)
-        ? std::min<std::size_t>(request.maxChunkBytes, writeSize - 12U)
-        : std::min<std::size_t>(request.maxChunkBytes, 256U);
-    std::size_t cursor = 0U;
-    std::uint32_t packetNo = 1U;
-    while (cursor < data.size() || (data.empty() && packetNo == 1U)) {
-        const auto remaining = (cursor < data.size()) ? (data.size() - cursor) : 0U;
-        const auto chunkBytes = std::min<std::size_t>(maxDataBytes, remaining);
-        std::vector<std::uint8_t> payload;
-        payload.reserve(6U + chunkBytes);
-        appendLe16Raw(payload, kFoeOpData);
-        appendLe32Raw(payload, packetNo);
-        if (chunkBytes > 0U) {
-            payload.insert(payload.end(), data.begin() + static_cast<std::ptrdiff_t>(cursor),
-                           data.begin() + static_cast<std::ptrdiff_t>(cursor + chunkBytes));
-        }
-
-        if (!mailboxWriteFrame(adp, writeOffset, writeSize, kMailboxTypeFoe, payload, expectedCounter, outError)) {
-            if (outError == "Mailbox payload exceeds write window") {
-                outError = "FoE request exceeds mailbox write window";
+
+    const auto retryConfig = mailboxRetryConfigFromEnv();
+    const bool pollOnly = (mailboxStatusMode_ == MailboxStatusMode::Poll);
+    auto anyPending = [&]() {
+        return std::any_of(sessions.begin(), sessions.end(), [](const FoeWriteSession& s) { return s.pending(); });
+    };
+
+    // Every round shares frames across slaves: all due packets, then all SM1
+    // status reads, then all mailbox reads, so the slaves work concurrently.
+    while (anyPending()) {
+        bool progressed = false;
+        auto now = std::chrono::steady_clock::now();
+
+        // 1) Post the pending packet of every ready slave.
+        requests.clear();
+        owners.clear();
+        for (auto& session : sessions) {
+            const bool busyDue = (session.phase == FoeWriteSession::Phase::Busy) && (now >= session.deadline);
+            if (!busyDue && session.phase != FoeWriteSession::Phase::Send) {
+                continue;
+            }
+            EscMailboxFrame frame;
+            frame.type = kMailboxTypeFoe;
+            frame.counter = static_cast<std::uint8_t>(mailboxCounter_++ & 0x07U);
+            frame.payload = session.packet;
+            session.counter = frame.counter;
+            auto bytes = CoeMailboxProtocol::encodeEscMailbox(frame);
+            if (bytes.size() > session.writeSize) {
+                failSession(session, "FoE request exceeds mailbox write window", false);
+                continue;
+            }
+            bytes.resize(session.writeSize, 0U);
+            EthercatDatagramRequest req;
+            req.command = kCommandApwr;
+            req.adp = session.adp;
+            req.ado = session.writeOffset;
+            req.payload = std::move(bytes);
+            requests.push_back(std::move(req));
+            owners.push_back(&session);
+        }
+        if (!requests.empty()) {
+            if (!sendDatagramBatch(requests, responses, batchError)) {
+                for (auto* session : owners) {
+                    failSession(*session, batchError, true);
+                }
+                continue;
+            }
+            now = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < owners.size(); ++i) {
+                auto& session = *owners[i];
+                if (responses[i].workingCounter == 0U) {
+                    // SM0 still full: back off this slave only, doubling up to the configured cap.
+                    ++mailboxDiagnostics_.datagramRetries;
+                    if (++session.writeAttempts > retryConfig.retries) {
+                        failSession(session, "mailbox write not acknowledged by slave " +
+                                                 std::to_string(session.job->slavePosition), true);
+                        continue;
+                    }
+                    const int shift = std::min(session.writeAttempts - 1, 16);
+                    const int backoffMs = std::min(retryConfig.backoffMaxMs, retryConfig.backoffBaseMs << shift);
+                    session.phase = FoeWriteSession::Phase::Busy;
+                    session.deadline = now + std::chrono::milliseconds(backoffMs);
+                    continue;
+                }
+                ++mailboxDiagnostics_.mailboxWrites;
+                session.writeAttempts = 0;
+                session.phase = FoeWriteSession::Phase::Await;
+                session.deadline = now + std::chrono::milliseconds(timeoutMs_);
+                progressed = true;
             }
-            return fail(outError);
         }
 
-        frame = EscMailboxFrame{};
-        if (!mailboxReadFrameExpected(adp, slavePosition, readOffset, readSize, expectedCounter, kMailboxTypeFoe,
-                                      true, frame, false, "Timed out waiting for FoE mailbox response", outError)) {
-            return fail(outError);
+        // 2) Poll SM1 status of all waiting slaves in one frame.
+        std::vector<FoeWriteSession*> readable;
+        requests.clear();
+        owners.clear();
+        for (auto& session : sessions) {
+            if (session.phase != FoeWriteSession::Phase::Await) {
+                continue;
+            }
+            if (pollOnly) {
+                readable.push_back(&session);
+                continue;
+            }
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = session.adp;
+            req.ado = static_cast<std::uint16_t>(kRegisterSmBase + 8U + kRegisterSmStatusOffset);
+            req.payload.assign(1U, 0U);
+            requests.push_back(std::move(req));
+            owners.push_back(&session);
         }
-        if (frame.payload.size() < 2U) {
-            return fail("FoE ACK payload too short");
+        if (!requests.empty()) {
+            if (!sendDatagramBatch(requests, responses, batchError)) {
+                for (auto* session : owners) {
+                    failSession(*session, batchError, true);
+                }
+                continue;
+            }
+            for (std::size_t i = 0; i < owners.size(); ++i) {
+                if (responses[i].workingCounter != 0U && !responses[i].payload.empty() &&
+                    (responses[i].payload[0] & kSmStatusMailboxFull) != 0U) {
+                    readable.push_back(owners[i]);
+                }
+            }
         }
-        op = readLe16Raw(frame.payload, 0U);
-        if (op == kFoeOpErr) {
-            return fail("FoE data packet rejected");
+
+        // 3) Read every mailbox that reported data in one batch.
+        requests.clear();
+        for (auto* session : readable) {
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = session->adp;
+            req.ado = session->readOffset;
+            req.payload.assign(session->readSize, 0U);
+            requests.push_back(std::move(req));
+        }
+        if (!requests.empty()) {
+            if (!sendDatagramBatch(requests, responses, batchError)) {
+                for (auto* session : readable) {
+                    failSession(*session, batchError, true);
+                }
+                continue;
+            }
+            for (std::size_t i = 0; i < readable.size(); ++i) {
+                auto& session = *readable[i];
+                if (responses[i].workingCounter == 0U) {
+                    continue;
+                }
+                ++mailboxDiagnostics_.mailboxReads;
+                const auto decoded = CoeMailboxProtocol::decodeEscMailbox(responses[i].payload);
+                if (!decoded) {
+                    continue;
+                }
+                if (decoded->type == CoeMailboxProtocol::kMailboxTypeCoe) {
+                    EmergencyMessage emergency {};
+                    if (CoeMailboxProtocol::parseEmergency(decoded->payload, session.job->slavePosition,
+                                                           emergency)) {
+                        enqueueEmergency(emergency);
+                    }
+                    continue;
+                }
+                if (decoded->type != kMailboxTypeFoe) {
+                    continue;
+                }
+                if ((decoded->counter & 0x07U) != (session.counter & 0x07U)) {
+                    ++mailboxDiagnostics_.staleCounterDrops;
+                    continue;
+                }
+                ++mailboxDiagnostics_.matchedResponses;
+                progressed = true;
+                if (!foeWriteHandleReply(session, *decoded)) {
+                    failSession(session, std::string{}, false);
+                }
+            }
         }
-        if (op != kFoeOpAck || frame.payload.size() < 6U) {
-            return fail("Expected FoE ACK for data packet");
+
+        now = std::chrono::steady_clock::now();
+        for (auto& session : sessions) {
+            if (session.phase == FoeWriteSession::Phase::Await && now >= session.deadline) {
+                failSession(session, "Timed out waiting for FoE mailbox response", true);
+            }
         }
-        const auto ackPacket = readLe32Raw(frame.payload, 2U);
-        if (ackPacket != packetNo) {
-            return fail("FoE ACK packet mismatch");
+        if (!progressed) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
         }
+    }
 
-        cursor += chunkBytes;
-        ++packetNo;
-        if (chunkBytes < maxDataBytes) {
-            break;
+    bool ok = true;
+    for (auto& session : sessions) {
+        auto& job = *session.job;
+        job.success = (session.phase == FoeWriteSession::Phase::Done);
+        if (!job.success && ok) {
+            ok = false;
+            outError = "FoE write to slave " + std::to_string(job.slavePosition) + " failed: " + job.error;
         }
     }
+    return ok;
+}
+
+bool LinuxRawSocketTransport::mailboxWriteSize(std::uint16_t slavePosition, std::uint16_t& outBytes) {
+    if (socketFd_ < 0) {
+        return false;
+    }
+    auto it = eoeMailboxWindows_.find(slavePosition);
+    if (it == eoeMailboxWindows_.end()) {
+        std::array<std::uint16_t, 4> window{};
+        std::string error;
+        resolveMailboxWindow(static_cast<std::uint16_t>(0U - slavePosition), window[0], window[1], window[2],
+                             window[3], error);
+        it = eoeMailboxWindows_.emplace(slavePosition, window).first;
+    }
+    outBytes = it->second[1];
     return true;
 }
 
@@ -290,6 +619,11 @@ bool LinuxRawSocketTransport::eoeReceive(std::uint16_t slavePosition, std::vecto
     if (socketFd_ < 0) {
         return fail("transport not open");
     }
+    // With the SM1 status bit in the cyclic image, an empty mailbox costs no traffic.
+    bool mailboxFull = false;
+    if (takeMailboxStatusFromImage(slavePosition, mailboxFull) && !mailboxFull) {
+        return fail("No EoE frame pending");
+    }
     const auto adp = static_cast<std::uint16_t>(0U - slavePosition);
     std::uint16_t writeOffset = 0U;
     std::uint16_t writeSize = 0U;
@@ -307,4 +641,148 @@ bool LinuxRawSocketTransport::eoeReceive(std::uint16_t slavePosition, std::vecto
     return true;
 }
 
+bool LinuxRawSocketTransport::eoeExchangeBatch(std::vector<EoeBatchSlot>& slots, std::string& outError) {
+    outError.clear();
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        return false;
+    }
+    std::vector<EthercatDatagramRequest> requests;
+    std::vector<EthercatDatagramResponse> responses;
+
+    // Resolve mailbox windows of slaves seen for the first time (one batch).
+    std::vector<std::uint16_t> unresolved;
+    for (auto& slot : slots) {
+        slot.txAccepted = false;
+        slot.rxValid = false;
+        slot.rx.clear();
+        if (eoeMailboxWindows_.count(slot.slavePosition) == 0U &&
+            std::find(unresolved.begin(), unresolved.end(), slot.slavePosition) == unresolved.end()) {
+            unresolved.push_back(slot.slavePosition);
+        }
+    }
+    if (!unresolved.empty()) {
+        for (const auto position : unresolved) {
+            for (std::uint8_t sm = 0U; sm < 2U; ++sm) {
+                EthercatDatagramRequest req;
+                req.command = kCommandAprd;
+                req.adp = static_cast<std::uint16_t>(0U - position);
+                req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (sm * 8U));
+                req.payload.assign(8U, 0U);
+                requests.push_back(std::move(req));
+            }
+        }
+        if (!sendDatagramBatch(requests, responses, outError)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < unresolved.size(); ++i) {
+            std::array<std::uint16_t, 4> window{mailboxWriteOffset_, mailboxWriteSize_, mailboxReadOffset_,
+                                                mailboxReadSize_};
+            const auto& sm0 = responses[2U * i];
+            const auto& sm1 = responses[(2U * i) + 1U];
+            if (sm0.workingCounter != 0U && sm1.workingCounter != 0U && readLe16Raw(sm0.payload, 2U) > 0U &&
+                readLe16Raw(sm1.payload, 2U) > 0U) {
+                window = {readLe16Raw(sm0.payload, 0U), readLe16Raw(sm0.payload, 2U), readLe16Raw(sm1.payload, 0U),
+                          readLe16Raw(sm1.payload, 2U)};
+            }
+            eoeMailboxWindows_[unresolved[i]] = window;
+        }
+    }
+
+    // 1) Fragment writes and SM1 status reads of all slots share one frame.
+    requests.clear();
+    std::vector<std::size_t> writeIndex(slots.size(), SIZE_MAX);
+    std::vector<std::size_t> statusIndex(slots.size(), SIZE_MAX);
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        auto& slot = slots[i];
+        const auto& window = eoeMailboxWindows_[slot.slavePosition];
+        const auto adp = static_cast<std::uint16_t>(0U - slot.slavePosition);
+        if (!slot.tx.empty()) {
+            ++mailboxDiagnostics_.eoeSendStarted;
+            EscMailboxFrame frame;
+            frame.type = kMailboxTypeEoe;
+            frame.counter = static_cast<std::uint8_t>(mailboxCounter_++ & 0x07U);
+            frame.payload = slot.tx;
+            auto bytes = CoeMailboxProtocol::encodeEscMailbox(frame);
+            if (bytes.size() > window[1]) {
+                ++mailboxDiagnostics_.eoeSendFailed;
+            } else {
+                bytes.resize(window[1], 0U);
+                EthercatDatagramRequest req;
+                req.command = kCommandApwr;
+                req.adp = adp;
+                req.ado = window[0];
+                req.payload = std::move(bytes);
+                writeIndex[i] = requests.size();
+                requests.push_back(std::move(req));
+            }
+        }
+        EthercatDatagramRequest status;
+        status.command = kCommandAprd;
+        status.adp = adp;
+        status.ado = static_cast<std::uint16_t>(kRegisterSmBase + 8U + kRegisterSmStatusOffset);
+        status.payload.assign(1U, 0U);
+        statusIndex[i] = requests.size();
+        requests.push_back(std::move(status));
+    }
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return false;
+    }
+
+    // 2) Read every mailbox that reported data.
+    std::vector<std::size_t> readable;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        if (writeIndex[i] != SIZE_MAX) {
+            // WKC 0: SM0 still holds the previous fragment; the caller retries.
+            slots[i].txAccepted = responses[writeIndex[i]].workingCounter != 0U;
+            if (slots[i].txAccepted) {
+                ++mailboxDiagnostics_.mailboxWrites;
+            } else {
+                ++mailboxDiagnostics_.datagramRetries;
+            }
+        }
+        const auto& status = responses[statusIndex[i]];
+        if (status.workingCounter != 0U && !status.payload.empty() &&
+            (status.payload[0] & kSmStatusMailboxFull) != 0U) {
+            readable.push_back(i);
+        }
+    }
+    requests.clear();
+    for (const auto i : readable) {
+        const auto& window = eoeMailboxWindows_[slots[i].slavePosition];
+        EthercatDatagramRequest req;
+        req.command = kCommandAprd;
+        req.adp = static_cast<std::uint16_t>(0U - slots[i].slavePosition);
+        req.ado = window[2];
+        req.payload.assign(window[3], 0U);
+        requests.push_back(std::move(req));
+    }
+    if (!requests.empty() && !sendDatagramBatch(requests, responses, outError)) {
+        return false;
+    }
+    for (std::size_t r = 0; r < readable.size(); ++r) {
+        auto& slot = slots[readable[r]];
+        if (responses[r].workingCounter == 0U) {
+            continue;
+        }
+        ++mailboxDiagnostics_.mailboxReads;
+        auto decoded = CoeMailboxProtocol::decodeEscMailbox(responses[r].payload);
+        if (!decoded) {
+            continue;
+        }
+        if (decoded->type == CoeMailboxProtocol::kMailboxTypeCoe) {
+            EmergencyMessage emergency {};
+            if (CoeMailboxProtocol::parseEmergency(decoded->payload, slot.slavePosition, emergency)) {
+                enqueueEmergency(emergency);
+            }
+            continue;
+        }
+        if (decoded->type == kMailboxTypeEoe) {
+            slot.rx = std::move(decoded->payload);
+            slot.rxValid = true;
+        }
+    }
+    return true;
+}
+
 } // namespace oec
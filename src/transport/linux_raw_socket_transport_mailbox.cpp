@@ -19,6 +19,26 @@ constexpr std::uint8_t kCommandAprd = 0x01;
 constexpr std::uint8_t kCommandApwr = 0x02;
 constexpr std::uint16_t kRegisterSmBase = 0x0800;
 constexpr std::uint16_t kRegisterSmStatusOffset = 0x0005;
+constexpr std::uint8_t kSmStatusMailboxFull = 0x08;
+// SM activate (byte 6) carries the master's repeat request, PDI control (byte 7) the slave's ack.
+constexpr std::uint16_t kRegisterSmActivateOffset = 0x0006;
+constexpr std::uint8_t kSmRepeatBit = 0x02;
+constexpr int kRepeatAckPolls = 20;
+
+std::uint16_t toAutoIncrementAddress(std::uint16_t position) {
+    // EtherCAT auto-increment addresses are signed: 0, -1, -2, ...
+    return static_cast<std::uint16_t>(0U - position);
+}
+
+bool isLostResponse(const std::string& error) {
+    return (error.find("timeout") != std::string::npos) ||
+           (error.find("response frame not found") != std::string::npos);
+}
+
+std::uint16_t readLe16(const std::vector<std::uint8_t>& in, std::size_t offset) {
+    return static_cast<std::uint16_t>(static_cast<std::uint16_t>(in[offset]) |
+                                      (static_cast<std::uint16_t>(in[offset + 1]) << 8U));
+}
 
 } // namespace
 
@@ -208,10 +228,17 @@ bool LinuxRawSocketTransport::mailboxReadMatchingCoe(std::uint16_t adp,
             // Status-driven read gate with strict/hybrid policies.
             std::uint8_t status = 0U;
             MailboxErrorClass statusClass = MailboxErrorClass::None;
-            const bool haveStatus = readSmStatusWithRetry(adp, 1U, forceTimeoutTest, mailboxRetries,
-                                                          mailboxBackoffBaseMs, mailboxBackoffMaxMs,
-                                                          statusClass, status, outError);
-            const bool mailboxHasData = haveStatus && ((status & 0x08U) != 0U);
+            bool imageFull = false;
+            bool haveStatus = false;
+            if (takeMailboxStatusFromImage(slavePosition, imageFull)) {
+                // Fresh cyclic sample of the mapped SM1 status bit: no APRD needed.
+                haveStatus = true;
+                status = imageFull ? kSmStatusMailboxFull : 0U;
+            } else {
+                haveStatus = readSmStatusWithRetry(adp, 1U, forceTimeoutTest, mailboxRetries, mailboxBackoffBaseMs,
+                                                   mailboxBackoffMaxMs, statusClass, status, outError);
+            }
+            const bool mailboxHasData = haveStatus && ((status & kSmStatusMailboxFull) != 0U);
             if (statusMode == MailboxStatusMode::Strict) {
                 if (!haveStatus) {
                     outError = "SM1 status read failed in strict mode";
@@ -239,11 +266,28 @@ bool LinuxRawSocketTransport::mailboxReadMatchingCoe(std::uint16_t adp,
         std::uint16_t wkc = 0;
         std::vector<std::uint8_t> payload;
         MailboxErrorClass ioClass = MailboxErrorClass::None;
-        if (!mailboxDatagramWithRetry(req, wkc, payload, forceTimeoutTest, mailboxRetries,
-                                      mailboxBackoffBaseMs, mailboxBackoffMaxMs, ioClass, outError)) {
+        // Single direct attempt first: if the response frame was lost after the
+        // ESC released SM1, a plain re-read finds the mailbox empty and would
+        // wait out the whole timeout. A repeat request makes the slave resend.
+        bool readOk = false;
+        bool repeated = false;
+        if (!forceTimeoutTest) {
+            std::string readError;
+            readOk = sendDatagramRequest(req, wkc, payload, readError);
+            if (!readOk && mailboxRepeatEnabled_ && isLostResponse(readError)) {
+                mailboxRepeatRequest(adp);
+                repeated = true;
+            }
+            req.datagramIndex = datagramIndex_++;
+        }
+        if (!readOk && !mailboxDatagramWithRetry(req, wkc, payload, forceTimeoutTest, mailboxRetries,
+                                                 mailboxBackoffBaseMs, mailboxBackoffMaxMs, ioClass, outError)) {
             outErrorClass = ioClass;
             return false;
         }
+        if (repeated) {
+            ++mailboxDiagnostics_.mailboxRepeatRecoveries;
+        }
         ++mailboxDiagnostics_.mailboxReads;
         lastWorkingCounter_ = wkc;
 
@@ -258,16 +302,11 @@ bool LinuxRawSocketTransport::mailboxReadMatchingCoe(std::uint16_t adp,
         }
         EmergencyMessage emergency {};
         if (CoeMailboxProtocol::parseEmergency(decoded->payload, slavePosition, emergency)) {
-            if (emergencies_.size() >= emergencyQueueLimit_) {
-                emergencies_.pop();
-                ++mailboxDiagnostics_.emergencyDropped;
-            }
-            emergencies_.push(emergency);
-            ++mailboxDiagnostics_.emergencyQueued;
+            enqueueEmergency(emergency);
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
             continue;
         }
-        if ((decoded->counter & 0x07U) != (expectedCounter & 0x07U)) {
+        if (expectedCounter != kAnyMailboxCounter && (decoded->counter & 0x07U) != (expectedCounter & 0x07U)) {
             ++mailboxDiagnostics_.staleCounterDrops;
             outErrorClass = MailboxErrorClass::StaleCounter;
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -291,4 +330,323 @@ bool LinuxRawSocketTransport::mailboxReadMatchingCoe(std::uint16_t adp,
     return false;
 }
 
+bool LinuxRawSocketTransport::mailboxRepeatRequest(std::uint16_t adp) {
+    const auto activateAddress = static_cast<std::uint16_t>(kRegisterSmBase + 8U + kRegisterSmActivateOffset);
+    EthercatDatagramRequest req;
+    req.command = kCommandAprd;
+    req.datagramIndex = datagramIndex_++;
+    req.adp = adp;
+    req.ado = activateAddress;
+    req.payload.assign(2U, 0U);
+
+    std::uint16_t wkc = 0;
+    std::vector<std::uint8_t> payload;
+    std::string error;
+    if (!sendDatagramRequest(req, wkc, payload, error) || payload.size() < 2U) {
+        return false;
+    }
+    const auto request = static_cast<std::uint8_t>(payload[0] ^ kSmRepeatBit);
+    req.command = kCommandApwr;
+    req.datagramIndex = datagramIndex_++;
+    req.payload = {request};
+    if (!sendDatagramRequest(req, wkc, payload, error)) {
+        return false;
+    }
+    ++mailboxDiagnostics_.mailboxRepeatRequests;
+
+    // The slave mirrors the request bit into PDI control once SM1 holds the resent frame.
+    req.command = kCommandAprd;
+    req.ado = static_cast<std::uint16_t>(activateAddress + 1U);
+    req.payload.assign(1U, 0U);
+    for (int poll = 0; poll < kRepeatAckPolls; ++poll) {
+        req.datagramIndex = datagramIndex_++;
+        if (sendDatagramRequest(req, wkc, payload, error) && !payload.empty() &&
+            (payload[0] & kSmRepeatBit) == (request & kSmRepeatBit)) {
+            ++mailboxDiagnostics_.mailboxRepeatAcks;
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return false;
+}
+
+void LinuxRawSocketTransport::enqueueEmergency(const EmergencyMessage& emergency) {
+    if (emergencies_.size() >= emergencyQueueLimit_) {
+        // Evict from the sender's own backlog first so a flooding slave cannot push out others.
+        auto victim = std::find_if(emergencies_.begin(), emergencies_.end(), [&](const EmergencyMessage& queued) {
+            return queued.slavePosition == emergency.slavePosition;
+        });
+        emergencies_.erase(victim != emergencies_.end() ? victim : emergencies_.begin());
+        ++mailboxDiagnostics_.emergencyDropped;
+    }
+    emergencies_.push_back(emergency);
+    if (emergencies_.back().timestampNs == 0U) {
+        emergencies_.back().timestampNs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+    ++mailboxDiagnostics_.emergencyQueued;
+}
+
+bool LinuxRawSocketTransport::sdoDownloadExpeditedBatch(std::vector<SdoBatchJob>& jobs) {
+    // One lane per slave: requests of a lane stay ordered, lanes progress independently.
+    struct Lane {
+        SdoBatchJob* job = nullptr;
+        std::uint16_t adp = 0U;
+        std::uint16_t writeOffset = 0U;
+        std::uint16_t writeSize = 0U;
+        std::uint16_t readOffset = 0U;
+        std::uint16_t readSize = 0U;
+        bool waiting = false;
+        bool finished = false;
+        std::uint8_t counter = 0U;
+        int writeAttempts = 0;
+        std::chrono::steady_clock::time_point deadline{};
+    };
+
+    std::vector<Lane> lanes;
+    lanes.reserve(jobs.size());
+    for (auto& job : jobs) {
+        job.completedWrites = 0U;
+        job.success = false;
+        job.error.clear();
+        Lane lane;
+        lane.job = &job;
+        lane.adp = toAutoIncrementAddress(job.slavePosition);
+        lane.writeOffset = mailboxWriteOffset_;
+        lane.writeSize = mailboxWriteSize_;
+        lane.readOffset = mailboxReadOffset_;
+        lane.readSize = mailboxReadSize_;
+        if (job.writes.empty()) {
+            job.success = true;
+            lane.finished = true;
+        }
+        lanes.push_back(lane);
+    }
+
+    auto failLane = [&](Lane& lane, const std::string& error, bool timeout) {
+        lane.finished = true;
+        lane.job->success = false;
+        lane.job->error = error;
+        ++mailboxDiagnostics_.transactionsFailed;
+        if (timeout) {
+            ++mailboxDiagnostics_.mailboxTimeouts;
+            ++mailboxDiagnostics_.errorTimeout;
+            lastMailboxErrorClass_ = MailboxErrorClass::Timeout;
+        } else {
+            ++mailboxDiagnostics_.errorAbort;
+            lastMailboxErrorClass_ = MailboxErrorClass::Abort;
+        }
+    };
+
+    std::vector<EthercatDatagramRequest> requests;
+    std::vector<EthercatDatagramResponse> responses;
+    std::vector<Lane*> owners;
+    std::string batchError;
+
+    // Resolve SM0/SM1 mailbox windows of every lane in one batch.
+    for (auto& lane : lanes) {
+        if (lane.finished) {
+            continue;
+        }
+        for (std::uint8_t sm = 0U; sm < 2U; ++sm) {
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = lane.adp;
+            req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (sm * 8U));
+            req.payload.assign(8U, 0U);
+            requests.push_back(std::move(req));
+            owners.push_back(&lane);
+        }
+    }
+    if (!requests.empty() && !sendDatagramBatch(requests, responses, batchError)) {
+        for (auto& lane : lanes) {
+            if (!lane.finished) {
+                failLane(lane, "mailbox window read failed: " + batchError, false);
+            }
+        }
+        return false;
+    }
+    for (std::size_t i = 0; i + 1U < responses.size(); i += 2U) {
+        const auto& sm0 = responses[i];
+        const auto& sm1 = responses[i + 1U];
+        if (sm0.workingCounter == 0U || sm1.workingCounter == 0U) {
+            continue;
+        }
+        const auto sm0Len = readLe16(sm0.payload, 2U);
+        const auto sm1Len = readLe16(sm1.payload, 2U);
+        if (sm0Len > 0U && sm1Len > 0U) {
+            owners[i]->writeOffset = readLe16(sm0.payload, 0U);
+            owners[i]->writeSize = sm0Len;
+            owners[i]->readOffset = readLe16(sm1.payload, 0U);
+            owners[i]->readSize = sm1Len;
+        }
+    }
+
+    const auto retryConfig = mailboxRetryConfigFromEnv();
+    const bool pollOnly = (mailboxStatusMode_ == MailboxStatusMode::Poll);
+    auto anyActive = [&]() {
+        return std::any_of(lanes.begin(), lanes.end(), [](const Lane& lane) { return !lane.finished; });
+    };
+
+    while (anyActive()) {
+        bool progressed = false;
+
+        // 1) Post the next request of every idle lane.
+        requests.clear();
+        owners.clear();
+        for (auto& lane : lanes) {
+            if (lane.finished || lane.waiting) {
+                continue;
+            }
+            const auto& write = lane.job->writes[lane.job->completedWrites];
+            EscMailboxFrame frame;
+            frame.type = CoeMailboxProtocol::kMailboxTypeCoe;
+            frame.counter = static_cast<std::uint8_t>(mailboxCounter_++ & 0x07U);
+            frame.payload = CoeMailboxProtocol::buildSdoExpeditedDownloadRequest(write.address, write.data);
+            lane.counter = frame.counter;
+            auto bytes = CoeMailboxProtocol::encodeEscMailbox(frame);
+            if (bytes.size() > lane.writeSize) {
+                failLane(lane, "CoE mailbox payload too large for configured write mailbox", false);
+                continue;
+            }
+            bytes.resize(lane.writeSize, 0U);
+            EthercatDatagramRequest req;
+            req.command = kCommandApwr;
+            req.adp = lane.adp;
+            req.ado = lane.writeOffset;
+            req.payload = std::move(bytes);
+            requests.push_back(std::move(req));
+            owners.push_back(&lane);
+        }
+        if (!requests.empty()) {
+            if (!sendDatagramBatch(requests, responses, batchError)) {
+                for (auto* lane : owners) {
+                    failLane(*lane, batchError, true);
+                }
+                continue;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < owners.size(); ++i) {
+                auto& lane = *owners[i];
+                if (responses[i].workingCounter == 0U) {
+                    // SM0 still full or slave busy: retry on the next round.
+                    ++mailboxDiagnostics_.datagramRetries;
+                    if (++lane.writeAttempts > retryConfig.retries) {
+                        failLane(lane, "mailbox write not acknowledged by slave " +
+                                           std::to_string(lane.job->slavePosition), true);
+                    }
+                    continue;
+                }
+                ++mailboxDiagnostics_.transactionsStarted;
+                ++mailboxDiagnostics_.mailboxWrites;
+                lane.writeAttempts = 0;
+                lane.waiting = true;
+                lane.deadline = now + std::chrono::milliseconds(timeoutMs_);
+                progressed = true;
+            }
+        }
+
+        // 2) Poll SM1 status of all waiting lanes in one frame.
+        std::vector<Lane*> readable;
+        owners.clear();
+        requests.clear();
+        for (auto& lane : lanes) {
+            if (lane.finished || !lane.waiting) {
+                continue;
+            }
+            if (pollOnly) {
+                readable.push_back(&lane);
+                continue;
+            }
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = lane.adp;
+            req.ado = static_cast<std::uint16_t>(kRegisterSmBase + 8U + kRegisterSmStatusOffset);
+            req.payload.assign(1U, 0U);
+            requests.push_back(std::move(req));
+            owners.push_back(&lane);
+        }
+        if (!requests.empty()) {
+            if (!sendDatagramBatch(requests, responses, batchError)) {
+                for (auto* lane : owners) {
+                    failLane(*lane, batchError, true);
+                }
+                continue;
+            }
+            for (std::size_t i = 0; i < owners.size(); ++i) {
+                if (responses[i].workingCounter != 0U && !responses[i].payload.empty() &&
+                    (responses[i].payload[0] & kSmStatusMailboxFull) != 0U) {
+                    readable.push_back(owners[i]);
+                }
+            }
+        }
+
+        // 3) Read every mailbox that reported data in one batch.
+        requests.clear();
+        for (auto* lane : readable) {
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = lane->adp;
+            req.ado = lane->readOffset;
+            req.payload.assign(lane->readSize, 0U);
+            requests.push_back(std::move(req));
+        }
+        if (!requests.empty()) {
+            if (!sendDatagramBatch(requests, responses, batchError)) {
+                for (auto* lane : readable) {
+                    failLane(*lane, batchError, true);
+                }
+                continue;
+            }
+            for (std::size_t i = 0; i < readable.size(); ++i) {
+                auto& lane = *readable[i];
+                if (responses[i].workingCounter == 0U) {
+                    continue;
+                }
+                ++mailboxDiagnostics_.mailboxReads;
+                const auto decoded = CoeMailboxProtocol::decodeEscMailbox(responses[i].payload);
+                if (!decoded || decoded->type != CoeMailboxProtocol::kMailboxTypeCoe) {
+                    continue;
+                }
+                EmergencyMessage emergency {};
+                if (CoeMailboxProtocol::parseEmergency(decoded->payload, lane.job->slavePosition, emergency)) {
+                    enqueueEmergency(emergency);
+                    continue;
+                }
+                if ((decoded->counter & 0x07U) != (lane.counter & 0x07U)) {
+                    ++mailboxDiagnostics_.staleCounterDrops;
+                    continue;
+                }
+                const auto& write = lane.job->writes[lane.job->completedWrites];
+                const auto ack = CoeMailboxProtocol::parseSdoInitiateDownloadResponse(decoded->payload, write.address);
+                if (!ack.success) {
+                    ++mailboxDiagnostics_.parseRejects;
+                    failLane(lane, ack.error, false);
+                    continue;
+                }
+                ++mailboxDiagnostics_.matchedResponses;
+                lane.waiting = false;
+                progressed = true;
+                if (++lane.job->completedWrites >= lane.job->writes.size()) {
+                    lane.finished = true;
+                    lane.job->success = true;
+                }
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& lane : lanes) {
+            if (!lane.finished && lane.waiting && now >= lane.deadline) {
+                failLane(lane, "Timed out waiting for CoE mailbox response", true);
+            }
+        }
+        if (!progressed) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    return std::all_of(jobs.begin(), jobs.end(), [](const SdoBatchJob& job) { return job.success; });
+}
+
 } // namespace oec
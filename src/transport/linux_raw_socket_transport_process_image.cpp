@@ -13,7 +13,6 @@
 #include <map>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace oec {
@@ -23,6 +22,10 @@ constexpr std::uint8_t kCommandAprd = 0x01;
 constexpr std::uint8_t kCommandApwr = 0x02;
 constexpr std::uint16_t kRegisterSmBase = 0x0800;
 constexpr std::uint16_t kRegisterFmmuBase = 0x0600;
+constexpr std::uint16_t kRegisterFmmuCount = 0x0004;
+// SM1 status register and its "mailbox full" bit.
+constexpr std::uint16_t kRegisterSm1Status = 0x080D;
+constexpr std::uint8_t kSmStatusMailboxFullBit = 3U;
 
 std::uint16_t toAutoIncrementAddress(std::uint16_t position) {
     // EtherCAT auto-increment addresses are signed: 0, -1, -2, ...
@@ -40,106 +43,51 @@ bool LinuxRawSocketTransport::configureProcessImage(const NetworkConfiguration&
     const bool traceMap = (std::getenv("OEC_TRACE_MAP") != nullptr);
     outputWindows_.clear();
 
-    const auto readSm = [&](std::uint16_t position, std::uint8_t smIndex,
-                            std::uint16_t& outStart, std::uint16_t& outLen) -> bool {
-        const auto currentIndex = datagramIndex_++;
-        EthercatDatagramRequest req;
-        req.command = kCommandAprd;
-        req.datagramIndex = currentIndex;
-        req.adp = toAutoIncrementAddress(position);
-        req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (smIndex * 8U));
-        req.payload.assign(8U, 0U);
-
-        std::uint16_t wkc = 0;
-        std::vector<std::uint8_t> payload;
-        if (!sendDatagramRequest(req, wkc, payload, outError)) {
-            return false;
+    // Fast path: replay a persisted plan when bus topology and config are unchanged.
+    bool planEnabled = !processImagePlanPath_.empty();
+    ProcessImageLayoutPlan plan;
+    if (planEnabled) {
+        std::string planError;
+        if (!readTopologyFingerprint(plan.topologyHash, planError)) {
+            planEnabled = false;
+        } else {
+            plan.configHash = ProcessImagePlanCodec::hashConfiguration(config, logicalAddress_);
+            ProcessImageLayoutPlan cached;
+            if (ProcessImagePlanCodec::loadFromFile(processImagePlanPath_, cached, planError) &&
+                cached.topologyHash == plan.topologyHash && cached.configHash == plan.configHash) {
+                if (replayProcessImagePlan(cached, planError)) {
+                    if (traceMap) {
+                        std::cerr << "[oec-map] replayed layout plan " << processImagePlanPath_ << '\n';
+                    }
+                    configureMailboxStatusMapping(config, cached.registerWrites, traceMap);
+                    return true;
+                }
+                outputWindows_.clear();
+            } else if (planError.empty()) {
+                planError = "plan hash mismatch";
+            }
         }
-        if (payload.size() < 4U) {
-            outError = "SM read payload too short";
-            return false;
+        if (traceMap) {
+            std::cerr << "[oec-map] layout plan not used (" << planError << "), running discovery\n";
         }
-        outStart = static_cast<std::uint16_t>(payload[0]) |
-                   (static_cast<std::uint16_t>(payload[1]) << 8U);
-        outLen = static_cast<std::uint16_t>(payload[2]) |
-                 (static_cast<std::uint16_t>(payload[3]) << 8U);
-        return true;
-    };
-
-    const auto writeFmmu = [&](std::uint16_t position, std::uint8_t fmmuIndex,
-                               std::uint32_t logicalStart, std::uint16_t length,
-                               std::uint16_t physicalStart, bool writeDirection) -> bool {
-        std::vector<std::uint8_t> payload(16U, 0U);
-        payload[0] = static_cast<std::uint8_t>(logicalStart & 0xFFU);
-        payload[1] = static_cast<std::uint8_t>((logicalStart >> 8U) & 0xFFU);
-        payload[2] = static_cast<std::uint8_t>((logicalStart >> 16U) & 0xFFU);
-        payload[3] = static_cast<std::uint8_t>((logicalStart >> 24U) & 0xFFU);
-        payload[4] = static_cast<std::uint8_t>(length & 0xFFU);
-        payload[5] = static_cast<std::uint8_t>((length >> 8U) & 0xFFU);
-        payload[6] = 0U;   // logical start bit
-        payload[7] = 7U;   // logical end bit
-        payload[8] = static_cast<std::uint8_t>(physicalStart & 0xFFU);
-        payload[9] = static_cast<std::uint8_t>((physicalStart >> 8U) & 0xFFU);
-        payload[10] = 0U;  // physical start bit
-        payload[11] = writeDirection ? 0x02U : 0x01U; // write or read enable
-        payload[12] = 0x01U; // enable
-
-        const auto currentIndex = datagramIndex_++;
-        EthercatDatagramRequest req;
-        req.command = kCommandApwr;
-        req.datagramIndex = currentIndex;
-        req.adp = toAutoIncrementAddress(position);
-        req.ado = static_cast<std::uint16_t>(kRegisterFmmuBase + (fmmuIndex * 16U));
-        req.payload = std::move(payload);
-
-        std::uint16_t wkc = 0;
-        std::vector<std::uint8_t> ack;
-        return sendDatagramRequest(req, wkc, ack, outError);
-    };
-    const auto writeSm = [&](std::uint16_t position, std::uint8_t smIndex,
-                             std::uint16_t start, std::uint16_t len,
-                             std::uint8_t control, std::uint8_t activate) -> bool {
-        std::vector<std::uint8_t> payload(8U, 0U);
-        payload[0] = static_cast<std::uint8_t>(start & 0xFFU);
-        payload[1] = static_cast<std::uint8_t>((start >> 8U) & 0xFFU);
-        payload[2] = static_cast<std::uint8_t>(len & 0xFFU);
-        payload[3] = static_cast<std::uint8_t>((len >> 8U) & 0xFFU);
-        payload[4] = control;
-        payload[6] = activate;
-
-        const auto currentIndex = datagramIndex_++;
-        EthercatDatagramRequest req;
-        req.command = kCommandApwr;
-        req.datagramIndex = currentIndex;
-        req.adp = toAutoIncrementAddress(position);
-        req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (smIndex * 8U));
-        req.payload = std::move(payload);
-
-        std::uint16_t wkc = 0;
-        std::vector<std::uint8_t> ack;
-        return sendDatagramRequest(req, wkc, ack, outError);
-    };
+    }
 
     std::unordered_map<std::string, std::uint16_t> slaveByName;
     slaveByName.reserve(config.slaves.size());
     for (const auto& s : config.slaves) {
         slaveByName[s.name] = s.position;
     }
-    std::unordered_map<std::uint16_t, std::vector<SignalBinding>> outputSignalsBySlave;
-    std::unordered_map<std::uint16_t, std::vector<SignalBinding>> inputSignalsBySlave;
-
-    std::unordered_set<std::uint16_t> outputSlaves;
-    std::unordered_set<std::uint16_t> inputSlaves;
+    // Ordered by position so the logical layout is deterministic across runs.
+    std::map<std::uint16_t, std::vector<SignalBinding>> outputSignalsBySlave;
+    std::map<std::uint16_t, std::vector<SignalBinding>> inputSignalsBySlave;
     for (const auto& signal : config.signals) {
         const auto it = slaveByName.find(signal.slaveName);
         if (it == slaveByName.end()) {
             continue;
         }
         if (signal.direction == SignalDirection::Output) {
-            outputSlaves.insert(it->second);
             outputSignalsBySlave[it->second].push_back(signal);
         } else {
-            inputSlaves.insert(it->second);
             inputSignalsBySlave[it->second].push_back(signal);
         }
     }
@@ -173,148 +121,246 @@ bool LinuxRawSocketTransport::configureProcessImage(const NetworkConfiguration&
         return static_cast<std::uint16_t>(any ? (maxByte + 1U) : 0U);
     };
 
-    std::uint32_t outputLogical = logicalAddress_;
-    std::uint32_t inputLogical = logicalAddress_ + static_cast<std::uint32_t>(config.processImageOutputBytes);
-    std::uint8_t fmmuIndex = 0U;
-    std::size_t mappedOutputSlaves = 0U;
-    std::size_t mappedInputSlaves = 0U;
-
-    for (const auto position : outputSlaves) {
+    // One channel per (slave, direction): SM2 for outputs, SM3 for inputs.
+    struct Channel {
+        std::uint16_t position = 0U;
+        bool output = false;
+        const std::vector<SignalBinding>* signals = nullptr;
         std::uint16_t smStart = 0U;
         std::uint16_t smLen = 0U;
-        if (!readSm(position, 2U, smStart, smLen)) {
+        bool pdoConfigured = false;
+    };
+    std::vector<Channel> channels;
+    channels.reserve(outputSignalsBySlave.size() + inputSignalsBySlave.size());
+    for (const auto& kv : outputSignalsBySlave) {
+        channels.push_back(Channel{kv.first, true, &kv.second});
+    }
+    for (const auto& kv : inputSignalsBySlave) {
+        channels.push_back(Channel{kv.first, false, &kv.second});
+    }
+    auto smIndexOf = [](const Channel& c) -> std::uint8_t { return c.output ? 2U : 3U; };
+
+    std::vector<EthercatDatagramRequest> requests;
+    std::vector<EthercatDatagramResponse> responses;
+
+    // Phase helper: read SM start/length of several channels in one batch.
+    const auto readSmBatch = [&](const std::vector<Channel*>& targets, const char* stage) -> bool {
+        if (targets.empty()) {
+            return true;
+        }
+        requests.clear();
+        for (const auto* c : targets) {
+            EthercatDatagramRequest req;
+            req.command = kCommandAprd;
+            req.adp = toAutoIncrementAddress(c->position);
+            req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (smIndexOf(*c) * 8U));
+            req.payload.assign(8U, 0U);
+            requests.push_back(std::move(req));
+        }
+        if (!sendDatagramBatch(requests, responses, outError)) {
             return false;
         }
-        if (traceMap) {
-            std::cerr << "[oec-map] slave=" << position
-                      << " SM2(start=0x" << std::hex << smStart
-                      << ", len=" << std::dec << smLen << ")\n";
-        }
-        if (smLen == 0U) {
-            const auto sigIt = outputSignalsBySlave.find(position);
-            if (sigIt != outputSignalsBySlave.end() && !sigIt->second.empty()) {
-                std::string pdoError;
-                const auto entries = buildDefaultEntries(sigIt->second, true);
-                if (configurePdo(position, 0x1600U, entries, pdoError)) {
-                    if (!readSm(position, 2U, smStart, smLen)) {
-                        return false;
-                    }
-                    if (traceMap) {
-                        std::cerr << "[oec-map] slave=" << position
-                                  << " SM2 re-read after default RxPDO config (start=0x" << std::hex << smStart
-                                  << ", len=" << std::dec << smLen << ")\n";
-                    }
-                } else if (traceMap) {
-                    std::cerr << "[oec-map] slave=" << position
-                              << " default RxPDO config failed: " << pdoError << '\n';
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            auto& c = *targets[i];
+            if (responses[i].workingCounter < expectedWorkingCounter_) {
+                outError = "SM read not acknowledged by slave " + std::to_string(c.position);
+                return false;
+            }
+            if (responses[i].payload.size() < 4U) {
+                outError = "SM read payload too short";
+                return false;
+            }
+            const auto& payload = responses[i].payload;
+            c.smStart = static_cast<std::uint16_t>(payload[0]) |
+                        static_cast<std::uint16_t>(static_cast<std::uint16_t>(payload[1]) << 8U);
+            c.smLen = static_cast<std::uint16_t>(payload[2]) |
+                      static_cast<std::uint16_t>(static_cast<std::uint16_t>(payload[3]) << 8U);
+            if (traceMap) {
+                std::cerr << "[oec-map] slave=" << c.position << " SM" << static_cast<int>(smIndexOf(c))
+                          << stage << "(start=0x" << std::hex << c.smStart
+                          << ", len=" << std::dec << c.smLen << ")\n";
+            }
+        }
+        return true;
+    };
+    auto zeroLengthChannels = [&]() {
+        std::vector<Channel*> out;
+        for (auto& c : channels) {
+            if (c.smLen == 0U) {
+                out.push_back(&c);
+            }
+        }
+        return out;
+    };
+
+    // Phase 1: SM2/SM3 windows of every mapped slave in one batch.
+    std::vector<Channel*> all;
+    all.reserve(channels.size());
+    for (auto& c : channels) {
+        all.push_back(&c);
+    }
+    if (!readSmBatch(all, "")) {
+        return false;
+    }
+
+    // Phase 2: default PDO configuration, overlapped across slaves. RxPDO and TxPDO
+    // run as separate rounds so one slave's mailbox stays ordered and a failed
+    // direction neither blocks nor masks the other.
+    auto pending = zeroLengthChannels();
+    if (!pending.empty()) {
+        std::vector<Channel*> reread;
+        for (const bool output : {true, false}) {
+            std::vector<SdoBatchJob> jobs;
+            std::vector<Channel*> owners;
+            for (auto* c : pending) {
+                if (c->output != output) {
+                    continue;
                 }
-                if (smLen == 0U) {
-                    // Mailbox-less fallback (SOEM-style simple IO): write minimal SM2 defaults.
-                    const auto estLen = std::max<std::uint16_t>(1U, estimatedByteLength(sigIt->second));
-                    if (writeSm(position, 2U, 0x1100U, estLen, 0x24U, 0x01U)) {
-                        if (!readSm(position, 2U, smStart, smLen)) {
-                            return false;
-                        }
-                        if (traceMap) {
-                            std::cerr << "[oec-map] slave=" << position
-                                      << " SM2 re-read after direct SM fallback (start=0x" << std::hex << smStart
-                                      << ", len=" << std::dec << smLen << ")\n";
-                        }
-                    } else if (traceMap) {
-                        std::cerr << "[oec-map] slave=" << position
-                                  << " direct SM2 fallback failed: " << outError << '\n';
+                jobs.push_back(SdoBatchJob{});
+                jobs.back().slavePosition = c->position;
+                jobs.back().writes = pdoConfigurationWrites(output ? 0x1600U : 0x1A00U,
+                                                            buildDefaultEntries(*c->signals, output));
+                owners.push_back(c);
+            }
+            if (jobs.empty()) {
+                continue;
+            }
+            (void)sdoDownloadExpeditedBatch(jobs);
+
+            for (std::size_t i = 0; i < jobs.size(); ++i) {
+                auto* c = owners[i];
+                const auto& job = jobs[i];
+                c->pdoConfigured = job.success;
+                if (c->pdoConfigured) {
+                    reread.push_back(c);
+                    for (const auto& write : job.writes) {
+                        plan.sdoWrites.push_back(ProcessImagePlanSdoWrite{c->position, write.address, write.data});
                     }
+                } else if (traceMap) {
+                    std::cerr << "[oec-map] slave=" << c->position << " default "
+                              << (output ? "RxPDO" : "TxPDO") << " config failed: " << job.error << '\n';
                 }
             }
         }
-        if (smLen == 0U) {
-            continue;
-        }
-        if (!writeFmmu(position, fmmuIndex++, outputLogical, smLen, smStart, true)) {
+        if (!readSmBatch(reread, " re-read after default PDO config")) {
             return false;
         }
-        if (traceMap) {
-            std::cerr << "[oec-map] slave=" << position
-                      << " FMMU(write, logical=0x" << std::hex << outputLogical
-                      << ", len=" << std::dec << smLen
-                      << ", physical=0x" << std::hex << smStart << ")\n";
-        }
-        outputWindows_.push_back(ProcessDataWindow{
-            position, smStart, smLen, outputLogical
-        });
-        outputLogical += smLen;
-        ++mappedOutputSlaves;
     }
 
-    for (const auto position : inputSlaves) {
-        std::uint16_t smStart = 0U;
-        std::uint16_t smLen = 0U;
-        if (!readSm(position, 3U, smStart, smLen)) {
+    // Phase 3: mailbox-less fallback (SOEM-style simple IO): write minimal SM defaults.
+    pending = zeroLengthChannels();
+    if (!pending.empty()) {
+        requests.clear();
+        for (const auto* c : pending) {
+            const auto estLen = std::max<std::uint16_t>(1U, estimatedByteLength(*c->signals));
+            std::vector<std::uint8_t> payload(8U, 0U);
+            payload[0] = static_cast<std::uint8_t>(0x1100U & 0xFFU);
+            payload[1] = static_cast<std::uint8_t>((0x1100U >> 8U) & 0xFFU);
+            payload[2] = static_cast<std::uint8_t>(estLen & 0xFFU);
+            payload[3] = static_cast<std::uint8_t>((estLen >> 8U) & 0xFFU);
+            payload[4] = c->output ? 0x24U : 0x20U;
+            payload[6] = 0x01U;
+
+            EthercatDatagramRequest req;
+            req.command = kCommandApwr;
+            req.adp = toAutoIncrementAddress(c->position);
+            req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (smIndexOf(*c) * 8U));
+            req.payload = std::move(payload);
+            requests.push_back(std::move(req));
+        }
+        if (!sendDatagramBatch(requests, responses, outError)) {
             return false;
         }
-        if (traceMap) {
-            std::cerr << "[oec-map] slave=" << position
-                      << " SM3(start=0x" << std::hex << smStart
-                      << ", len=" << std::dec << smLen << ")\n";
-        }
-        if (smLen == 0U) {
-            const auto sigIt = inputSignalsBySlave.find(position);
-            if (sigIt != inputSignalsBySlave.end() && !sigIt->second.empty()) {
-                std::string pdoError;
-                const auto entries = buildDefaultEntries(sigIt->second, false);
-                if (configurePdo(position, 0x1A00U, entries, pdoError)) {
-                    if (!readSm(position, 3U, smStart, smLen)) {
-                        return false;
-                    }
-                    if (traceMap) {
-                        std::cerr << "[oec-map] slave=" << position
-                                  << " SM3 re-read after default TxPDO config (start=0x" << std::hex << smStart
-                                  << ", len=" << std::dec << smLen << ")\n";
-                    }
-                } else if (traceMap) {
-                    std::cerr << "[oec-map] slave=" << position
-                              << " default TxPDO config failed: " << pdoError << '\n';
-                }
-                if (smLen == 0U) {
-                    // Mailbox-less fallback (SOEM-style simple IO): write minimal SM3 defaults.
-                    const auto estLen = std::max<std::uint16_t>(1U, estimatedByteLength(sigIt->second));
-                    if (writeSm(position, 3U, 0x1100U, estLen, 0x20U, 0x01U)) {
-                        if (!readSm(position, 3U, smStart, smLen)) {
-                            return false;
-                        }
-                        if (traceMap) {
-                            std::cerr << "[oec-map] slave=" << position
-                                      << " SM3 re-read after direct SM fallback (start=0x" << std::hex << smStart
-                                      << ", len=" << std::dec << smLen << ")\n";
-                        }
-                    } else if (traceMap) {
-                        std::cerr << "[oec-map] slave=" << position
-                                  << " direct SM3 fallback failed: " << outError << '\n';
-                    }
-                }
+        std::vector<Channel*> reread;
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            if (responses[i].workingCounter >= expectedWorkingCounter_) {
+                reread.push_back(pending[i]);
+                plan.registerWrites.push_back(
+                    ProcessImagePlanRegisterWrite{pending[i]->position, requests[i].ado, requests[i].payload});
+            } else if (traceMap) {
+                std::cerr << "[oec-map] slave=" << pending[i]->position << " direct SM"
+                          << static_cast<int>(smIndexOf(*pending[i])) << " fallback failed: not acknowledged\n";
             }
         }
-        if (smLen == 0U) {
+        if (!readSmBatch(reread, " re-read after direct SM fallback")) {
+            return false;
+        }
+    }
+
+    // Phase 4: lay out logical windows and program every FMMU in one batch.
+    // FMMU indices are allocated per slave (each ESC owns its FMMU bank).
+    std::uint32_t outputLogical = logicalAddress_;
+    std::uint32_t inputLogical = logicalAddress_ + static_cast<std::uint32_t>(config.processImageOutputBytes);
+    std::map<std::uint16_t, std::uint8_t> nextFmmuBySlave;
+    std::size_t mappedOutputSlaves = 0U;
+    std::size_t mappedInputSlaves = 0U;
+    requests.clear();
+    std::vector<const Channel*> mapped;
+    for (const auto& c : channels) {
+        if (c.smLen == 0U) {
             continue;
         }
-        if (!writeFmmu(position, fmmuIndex++, inputLogical, smLen, smStart, false)) {
+        auto& logical = c.output ? outputLogical : inputLogical;
+        const auto fmmuIndex = nextFmmuBySlave[c.position]++;
+        std::vector<std::uint8_t> payload(16U, 0U);
+        payload[0] = static_cast<std::uint8_t>(logical & 0xFFU);
+        payload[1] = static_cast<std::uint8_t>((logical >> 8U) & 0xFFU);
+        payload[2] = static_cast<std::uint8_t>((logical >> 16U) & 0xFFU);
+        payload[3] = static_cast<std::uint8_t>((logical >> 24U) & 0xFFU);
+        payload[4] = static_cast<std::uint8_t>(c.smLen & 0xFFU);
+        payload[5] = static_cast<std::uint8_t>((c.smLen >> 8U) & 0xFFU);
+        payload[6] = 0U;   // logical start bit
+        payload[7] = 7U;   // logical end bit
+        payload[8] = static_cast<std::uint8_t>(c.smStart & 0xFFU);
+        payload[9] = static_cast<std::uint8_t>((c.smStart >> 8U) & 0xFFU);
+        payload[10] = 0U;  // physical start bit
+        payload[11] = c.output ? 0x02U : 0x01U; // write or read enable
+        payload[12] = 0x01U; // enable
+
+        EthercatDatagramRequest req;
+        req.command = kCommandApwr;
+        req.adp = toAutoIncrementAddress(c.position);
+        req.ado = static_cast<std::uint16_t>(kRegisterFmmuBase + (fmmuIndex * 16U));
+        req.payload = std::move(payload);
+        plan.registerWrites.push_back(ProcessImagePlanRegisterWrite{c.position, req.ado, req.payload});
+        plan.smExpectations.push_back(ProcessImagePlanSmExpectation{c.position, smIndexOf(c), c.smStart, c.smLen});
+        requests.push_back(std::move(req));
+        mapped.push_back(&c);
+
+        if (traceMap) {
+            std::cerr << "[oec-map] slave=" << c.position
+                      << " FMMU" << static_cast<int>(fmmuIndex)
+                      << (c.output ? "(write" : "(read") << ", logical=0x" << std::hex << logical
+                      << ", len=" << std::dec << c.smLen
+                      << ", physical=0x" << std::hex << c.smStart << std::dec << ")\n";
+        }
+        if (c.output) {
+            outputWindows_.push_back(ProcessDataWindow{c.position, c.smStart, c.smLen, logical});
+            ++mappedOutputSlaves;
+        } else {
+            ++mappedInputSlaves;
+        }
+        logical += c.smLen;
+    }
+    if (!requests.empty()) {
+        if (!sendDatagramBatch(requests, responses, outError)) {
+            outputWindows_.clear();
             return false;
         }
-        if (traceMap) {
-            std::cerr << "[oec-map] slave=" << position
-                      << " FMMU(read, logical=0x" << std::hex << inputLogical
-                      << ", len=" << std::dec << smLen
-                      << ", physical=0x" << std::hex << smStart << ")\n";
+        for (std::size_t i = 0; i < mapped.size(); ++i) {
+            if (responses[i].workingCounter < expectedWorkingCounter_) {
+                outError = "FMMU write not acknowledged by slave " + std::to_string(mapped[i]->position);
+                outputWindows_.clear();
+                return false;
+            }
         }
-        inputLogical += smLen;
-        ++mappedInputSlaves;
     }
 
-    if (!outputSlaves.empty() && mappedOutputSlaves == 0U) {
+    if (!outputSignalsBySlave.empty() && mappedOutputSlaves == 0U) {
         outError = "No output slaves produced valid SM2 mapping (all SM2 lengths were zero)";
         return false;
     }
-    if (!inputSlaves.empty() && mappedInputSlaves == 0U) {
+    if (!inputSignalsBySlave.empty() && mappedInputSlaves == 0U) {
         outError = "No input slaves produced valid SM3 mapping (all SM3 lengths were zero)";
         return false;
     }
@@ -322,6 +368,224 @@ bool LinuxRawSocketTransport::configureProcessImage(const NetworkConfiguration&
         std::cerr << "[oec-map] mapped outputs=" << mappedOutputSlaves
                   << " mapped inputs=" << mappedInputSlaves << '\n';
     }
+    configureMailboxStatusMapping(config, plan.registerWrites, traceMap);
+    if (planEnabled) {
+        for (const auto& w : outputWindows_) {
+            plan.outputWindows.push_back(
+                ProcessImagePlanOutputWindow{w.slavePosition, w.physicalStart, w.length, w.logicalStart});
+        }
+        std::string planError;
+        // A plan that cannot be saved only costs the next start its fast path.
+        if (!ProcessImagePlanCodec::saveToFile(processImagePlanPath_, plan, planError) && traceMap) {
+            std::cerr << "[oec-map] layout plan not saved: " << planError << '\n';
+        }
+    }
+    return true;
+}
+
+void LinuxRawSocketTransport::configureMailboxStatusMapping(
+    const NetworkConfiguration& config,
+    const std::vector<ProcessImagePlanRegisterWrite>& registerWrites,
+    bool traceMap) {
+    mailboxStatusBitBySlave_.clear();
+    mailboxStatusConsumedCycle_.clear();
+    mailboxStatusImage_.clear();
+    mailboxStatusBytes_ = 0U;
+    mailboxStatusWkcExtra_ = 0U;
+    mailboxStatusCycle_ = 0U;
+    if (!mailboxStatusMappingEnabled_) {
+        return;
+    }
+    // The status area follows the input image, so the cyclic LRD can simply read further.
+    mailboxStatusLogical_ = logicalAddress_ + static_cast<std::uint32_t>(config.processImageOutputBytes) +
+                            static_cast<std::uint32_t>(config.processImageInputBytes);
+
+    std::map<std::uint16_t, std::uint8_t> usedFmmus;
+    std::map<std::uint16_t, bool> hasInputFmmu;
+    for (const auto& w : registerWrites) {
+        if (w.ado < kRegisterFmmuBase || w.ado >= kRegisterFmmuBase + 0x100U || w.data.size() < 12U) {
+            continue;
+        }
+        auto& used = usedFmmus[w.slavePosition];
+        used = std::max<std::uint8_t>(used, static_cast<std::uint8_t>(((w.ado - kRegisterFmmuBase) / 16U) + 1U));
+        hasInputFmmu[w.slavePosition] = hasInputFmmu[w.slavePosition] || (w.data[11] & 0x01U) != 0U;
+    }
+
+    std::vector<std::uint16_t> positions;
+    for (const auto& slave : config.slaves) {
+        positions.push_back(slave.position);
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    if (positions.empty()) {
+        return;
+    }
+
+    // One batch: FMMU count and SM1 window of every configured slave.
+    std::vector<EthercatDatagramRequest> requests;
+    std::vector<EthercatDatagramResponse> responses;
+    for (const auto position : positions) {
+        EthercatDatagramRequest fmmuCount;
+        fmmuCount.command = kCommandAprd;
+        fmmuCount.adp = toAutoIncrementAddress(position);
+        fmmuCount.ado = kRegisterFmmuCount;
+        fmmuCount.payload.assign(1U, 0U);
+        requests.push_back(std::move(fmmuCount));
+        EthercatDatagramRequest sm1;
+        sm1.command = kCommandAprd;
+        sm1.adp = toAutoIncrementAddress(position);
+        sm1.ado = static_cast<std::uint16_t>(kRegisterSmBase + 8U);
+        sm1.payload.assign(8U, 0U);
+        requests.push_back(std::move(sm1));
+    }
+    std::string error;
+    if (!sendDatagramBatch(requests, responses, error)) {
+        if (traceMap) {
+            std::cerr << "[oec-map] mailbox status mapping skipped: " << error << '\n';
+        }
+        return;
+    }
+
+    std::vector<std::uint16_t> candidates;
+    std::vector<std::uint8_t> fmmuIndices;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const auto& count = responses[2U * i];
+        const auto& sm1 = responses[(2U * i) + 1U];
+        if (count.workingCounter < expectedWorkingCounter_ || sm1.workingCounter < expectedWorkingCounter_ ||
+            count.payload.empty() || sm1.payload.size() < 4U) {
+            continue;
+        }
+        const auto sm1Len = static_cast<std::uint16_t>(sm1.payload[2] | (sm1.payload[3] << 8U));
+        const auto nextFmmu = usedFmmus[positions[i]];
+        if (sm1Len == 0U || nextFmmu >= count.payload[0]) {
+            continue;
+        }
+        candidates.push_back(positions[i]);
+        fmmuIndices.push_back(nextFmmu);
+    }
+
+    requests.clear();
+    for (std::size_t bit = 0; bit < candidates.size(); ++bit) {
+        const auto logical = mailboxStatusLogical_ + static_cast<std::uint32_t>(bit / 8U);
+        std::vector<std::uint8_t> payload(16U, 0U);
+        payload[0] = static_cast<std::uint8_t>(logical & 0xFFU);
+        payload[1] = static_cast<std::uint8_t>((logical >> 8U) & 0xFFU);
+        payload[2] = static_cast<std::uint8_t>((logical >> 16U) & 0xFFU);
+        payload[3] = static_cast<std::uint8_t>((logical >> 24U) & 0xFFU);
+        payload[4] = 1U;                                      // length: one byte
+        payload[6] = static_cast<std::uint8_t>(bit % 8U);     // logical start bit
+        payload[7] = static_cast<std::uint8_t>(bit % 8U);     // logical end bit
+        payload[8] = static_cast<std::uint8_t>(kRegisterSm1Status & 0xFFU);
+        payload[9] = static_cast<std::uint8_t>((kRegisterSm1Status >> 8U) & 0xFFU);
+        payload[10] = kSmStatusMailboxFullBit;                // physical start bit
+        payload[11] = 0x01U;                                  // read enable
+        payload[12] = 0x01U;                                  // enable
+
+        EthercatDatagramRequest req;
+        req.command = kCommandApwr;
+        req.adp = toAutoIncrementAddress(candidates[bit]);
+        req.ado = static_cast<std::uint16_t>(kRegisterFmmuBase + (fmmuIndices[bit] * 16U));
+        req.payload = std::move(payload);
+        requests.push_back(std::move(req));
+    }
+    if (requests.empty() || !sendDatagramBatch(requests, responses, error)) {
+        return;
+    }
+    for (std::size_t bit = 0; bit < candidates.size(); ++bit) {
+        if (responses[bit].workingCounter < expectedWorkingCounter_) {
+            continue;
+        }
+        mailboxStatusBitBySlave_[candidates[bit]] = bit;
+        if (!hasInputFmmu[candidates[bit]]) {
+            ++mailboxStatusWkcExtra_;
+        }
+        if (traceMap) {
+            std::cerr << "[oec-map] slave=" << candidates[bit] << " FMMU" << static_cast<int>(fmmuIndices[bit])
+                      << "(mailbox status, logical=0x" << std::hex << (mailboxStatusLogical_ + (bit / 8U))
+                      << std::dec << "." << (bit % 8U) << ")\n";
+        }
+    }
+    if (!mailboxStatusBitBySlave_.empty()) {
+        mailboxStatusBytes_ = (candidates.size() + 7U) / 8U;
+    }
+}
+
+bool LinuxRawSocketTransport::replayProcessImagePlan(const ProcessImageLayoutPlan& plan, std::string& outError) {
+    if (!plan.sdoWrites.empty()) {
+        std::vector<SdoBatchJob> jobs;
+        std::map<std::uint16_t, std::size_t> jobBySlave;
+        for (const auto& w : plan.sdoWrites) {
+            auto [it, inserted] = jobBySlave.emplace(w.slavePosition, jobs.size());
+            if (inserted) {
+                jobs.push_back(SdoBatchJob{});
+                jobs.back().slavePosition = w.slavePosition;
+            }
+            jobs[it->second].writes.push_back(SdoBatchWrite{w.address, w.data});
+        }
+        (void)sdoDownloadExpeditedBatch(jobs);
+        for (const auto& job : jobs) {
+            if (job.completedWrites < job.writes.size()) {
+                outError = "PDO replay failed on slave " + std::to_string(job.slavePosition) + ": " + job.error;
+                return false;
+            }
+        }
+    }
+
+    std::vector<EthercatDatagramRequest> requests;
+    std::vector<EthercatDatagramResponse> responses;
+    requests.reserve(plan.registerWrites.size());
+    for (const auto& w : plan.registerWrites) {
+        EthercatDatagramRequest req;
+        req.command = kCommandApwr;
+        req.adp = toAutoIncrementAddress(w.slavePosition);
+        req.ado = w.ado;
+        req.payload = w.data;
+        requests.push_back(std::move(req));
+    }
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+        if (responses[i].workingCounter < expectedWorkingCounter_) {
+            outError = "register replay not acknowledged by slave " +
+                       std::to_string(plan.registerWrites[i].slavePosition);
+            return false;
+        }
+    }
+
+    // The plan is only trusted if every slave still reports the recorded SM windows.
+    requests.clear();
+    for (const auto& e : plan.smExpectations) {
+        EthercatDatagramRequest req;
+        req.command = kCommandAprd;
+        req.adp = toAutoIncrementAddress(e.slavePosition);
+        req.ado = static_cast<std::uint16_t>(kRegisterSmBase + (e.syncManager * 8U));
+        req.payload.assign(8U, 0U);
+        requests.push_back(std::move(req));
+    }
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+        const auto& e = plan.smExpectations[i];
+        const auto& p = responses[i].payload;
+        if (p.size() < 4U) {
+            outError = "SM read payload too short";
+            return false;
+        }
+        const auto start = static_cast<std::uint16_t>(p[0] | (p[1] << 8U));
+        const auto length = static_cast<std::uint16_t>(p[2] | (p[3] << 8U));
+        if (responses[i].workingCounter < expectedWorkingCounter_ || start != e.start || length != e.length) {
+            outError = "SM" + std::to_string(e.syncManager) + " window changed on slave " +
+                       std::to_string(e.slavePosition);
+            return false;
+        }
+    }
+
+    outputWindows_.clear();
+    for (const auto& w : plan.outputWindows) {
+        outputWindows_.push_back(ProcessDataWindow{w.slavePosition, w.physicalStart, w.length, w.logicalStart});
+    }
     return true;
 }
 
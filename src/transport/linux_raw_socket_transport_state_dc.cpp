@@ -5,6 +5,9 @@
 
 #include "openethercat/transport/linux_raw_socket_transport.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 namespace oec {
 namespace {
 
@@ -17,6 +20,17 @@ constexpr std::uint16_t kRegisterAlStatus = 0x0130;
 constexpr std::uint16_t kRegisterAlStatusCode = 0x0134;
 constexpr std::uint16_t kRegisterDcSystemTime = 0x0910;
 constexpr std::uint16_t kRegisterDcSystemTimeOffset = 0x0920;
+constexpr std::uint16_t kRegisterEscFeatures = 0x0008;
+constexpr std::uint16_t kRegisterDlStatus = 0x0110;
+constexpr std::uint16_t kRegisterDcPortReceiveTime = 0x0900;
+constexpr std::uint16_t kRegisterDcProcessingUnitReceiveTime = 0x0918;
+constexpr std::uint16_t kRegisterDcSystemTimeDelay = 0x0928;
+constexpr std::uint16_t kRegisterDcSystemTimeDifference = 0x092C;
+constexpr std::uint16_t kEscFeatureDc = 0x0004;
+// Seconds between the Unix epoch and the EtherCAT epoch (2000-01-01).
+constexpr std::int64_t kEthercatEpochOffsetS = 946684800;
+// Wire time of one byte at 100 Mbit/s.
+constexpr std::int64_t kWireNsPerByte = 80;
 constexpr std::uint16_t kAlStateMask = 0x000F;
 
 bool decodeAlState(std::uint16_t rawState, SlaveState& out) {
@@ -60,6 +74,39 @@ void writeLe64Signed(std::vector<std::uint8_t>& out, std::int64_t value) {
     }
 }
 
+std::uint32_t readLe32(const std::vector<std::uint8_t>& data, std::size_t offset) {
+    return static_cast<std::uint32_t>(data[offset]) | (static_cast<std::uint32_t>(data[offset + 1U]) << 8U) |
+           (static_cast<std::uint32_t>(data[offset + 2U]) << 16U) |
+           (static_cast<std::uint32_t>(data[offset + 3U]) << 24U);
+}
+
+std::uint16_t readLe16(const std::vector<std::uint8_t>& data, std::size_t offset) {
+    return static_cast<std::uint16_t>(static_cast<std::uint16_t>(data[offset]) |
+                                      (static_cast<std::uint16_t>(data[offset + 1U]) << 8U));
+}
+
+// DL status: per port a loop bit (closed when set) followed by a communication bit.
+std::uint8_t activePortsFromDlStatus(std::uint16_t dlStatus) {
+    std::uint8_t ports = 0U;
+    for (std::uint8_t port = 0; port < 4U; ++port) {
+        const auto bits = (dlStatus >> (8U + 2U * port)) & 0x03U;
+        if (bits == 0x02U) {
+            ports = static_cast<std::uint8_t>(ports | (1U << port));
+        }
+    }
+    return ports;
+}
+
+EthercatDatagramRequest slaveRequest(std::uint8_t command, std::uint16_t position, std::uint16_t ado,
+                                     std::vector<std::uint8_t> payload) {
+    EthercatDatagramRequest request;
+    request.command = command;
+    request.adp = toAutoIncrementAddress(position);
+    request.ado = ado;
+    request.payload = std::move(payload);
+    return request;
+}
+
 } // namespace
 
 bool LinuxRawSocketTransport::requestNetworkState(SlaveState state) {
@@ -111,9 +158,16 @@ bool LinuxRawSocketTransport::readNetworkState(SlaveState& outState) {
     const auto raw = static_cast<std::uint16_t>(
         static_cast<std::uint16_t>(payload[0]) |
         (static_cast<std::uint16_t>(payload[1]) << 8U));
+    const auto bits = static_cast<std::uint16_t>(raw & kAlStateMask);
     SlaveState decoded = SlaveState::Init;
-    if (!decodeAlState(raw, decoded)) {
-        error_ = "unknown AL state value";
+    // BRD ORs AL status across all slaves: only a single state bit is exact. Anything
+    // else (0x03 included, which may be INIT|PREOP rather than BOOT) is read per slave.
+    if (bits != 0U && (bits & (bits - 1U)) == 0U) {
+        if (!decodeAlState(raw, decoded)) {
+            error_ = "unknown AL state value";
+            return false;
+        }
+    } else if (!resolveMixedNetworkState(wkc, decoded)) {
         return false;
     }
 
@@ -122,6 +176,40 @@ bool LinuxRawSocketTransport::readNetworkState(SlaveState& outState) {
     return true;
 }
 
+bool LinuxRawSocketTransport::resolveMixedNetworkState(std::uint16_t slaveCount, SlaveState& outState) {
+    if (slaveCount == 0U) {
+        error_ = "no slave answered the AL status read";
+        return false;
+    }
+    std::vector<EthercatDatagramRequest> requests;
+    requests.reserve(slaveCount);
+    for (std::uint16_t position = 0; position < slaveCount; ++position) {
+        requests.push_back(slaveRequest(kCommandAprd, position, kRegisterAlStatus, {0x00U, 0x00U}));
+    }
+    std::vector<EthercatDatagramResponse> responses;
+    if (!sendDatagramBatch(requests, responses, error_)) {
+        return false;
+    }
+    // Report the lowest AL state code present, i.e. the slave furthest from OP.
+    bool found = false;
+    for (const auto& response : responses) {
+        SlaveState state = SlaveState::Init;
+        if (response.workingCounter == 0U || response.payload.size() < 2U ||
+            !decodeAlState(readLe16(response.payload, 0U), state)) {
+            continue;
+        }
+        if (!found || static_cast<int>(state) < static_cast<int>(outState)) {
+            outState = state;
+        }
+        found = true;
+    }
+    if (!found) {
+        error_ = "unknown AL state value";
+        return false;
+    }
+    return true;
+}
+
 bool LinuxRawSocketTransport::requestSlaveState(std::uint16_t position, SlaveState state) {
     if (socketFd_ < 0) {
         error_ = "transport not open";
@@ -281,4 +369,255 @@ bool LinuxRawSocketTransport::writeDcSystemTimeOffset(std::uint16_t slavePositio
     return true;
 }
 
+bool LinuxRawSocketTransport::initializeDistributedClocks(const DcInitOptions& options, DcInitReport& outReport,
+                                                          std::string& outError) {
+    outReport = DcInitReport{};
+    outError.clear();
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        outReport.error = outError;
+        return false;
+    }
+    auto fail = [&](const std::string& message) {
+        outError = message;
+        outReport.error = message;
+        return false;
+    };
+
+    // Broadcast read: WKC yields the slave count.
+    std::vector<EthercatDatagramRequest> requests(1U);
+    requests[0].command = kCommandBrd;
+    requests[0].ado = kRegisterAlStatus;
+    requests[0].payload.assign(2U, 0U);
+    std::vector<EthercatDatagramResponse> responses;
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return fail("DC init slave count failed: " + outError);
+    }
+    const std::uint16_t slaveCount = responses[0].workingCounter;
+    if (slaveCount == 0U) {
+        return fail("DC init found no slaves");
+    }
+
+    // Features and DL status of all slaves in one batch.
+    requests.clear();
+    for (std::uint16_t position = 0; position < slaveCount; ++position) {
+        requests.push_back(slaveRequest(kCommandAprd, position, kRegisterEscFeatures, {0U, 0U}));
+        requests.push_back(slaveRequest(kCommandAprd, position, kRegisterDlStatus, {0U, 0U}));
+    }
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return fail("DC init port scan failed: " + outError);
+    }
+    std::vector<DcPortLatch> latches(slaveCount);
+    for (std::uint16_t position = 0; position < slaveCount; ++position) {
+        const auto& features = responses[2U * position];
+        const auto& dlStatus = responses[2U * position + 1U];
+        if (features.workingCounter != 1U || dlStatus.workingCounter != 1U || features.payload.size() < 2U ||
+            dlStatus.payload.size() < 2U) {
+            return fail("DC init port scan: no answer from slave " + std::to_string(position));
+        }
+        latches[position].slavePosition = position;
+        latches[position].dcSupported = (readLe16(features.payload, 0U) & kEscFeatureDc) != 0U;
+        latches[position].activePorts = activePortsFromDlStatus(readLe16(dlStatus.payload, 0U));
+    }
+
+    // Any write to 0x0900 latches the receive time on every port the frame passes.
+    requests.assign(1U, EthercatDatagramRequest{});
+    requests[0].command = kCommandBwr;
+    requests[0].ado = kRegisterDcPortReceiveTime;
+    requests[0].payload.assign(4U, 0U);
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return fail("DC init receive-time latch failed: " + outError);
+    }
+    const auto hostNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count() -
+                        kEthercatEpochOffsetS * 1000000000LL;
+
+    requests.clear();
+    std::vector<std::uint16_t> dcSlaves;
+    for (const auto& latch : latches) {
+        if (!latch.dcSupported) {
+            continue;
+        }
+        dcSlaves.push_back(latch.slavePosition);
+        requests.push_back(slaveRequest(kCommandAprd, latch.slavePosition, kRegisterDcPortReceiveTime,
+                                        std::vector<std::uint8_t>(16U, 0U)));
+        requests.push_back(slaveRequest(kCommandAprd, latch.slavePosition, kRegisterDcProcessingUnitReceiveTime,
+                                        std::vector<std::uint8_t>(8U, 0U)));
+    }
+    if (dcSlaves.empty()) {
+        return fail("no DC-capable slave");
+    }
+    dcFirstSlave_ = dcSlaves.front();
+    if (dcDistributionEnabled_ && dcDistributionReference_ != dcSlaves.front()) {
+        // DC slaves ahead of the ARMW target would take the master's zero payload as system time.
+        dcDistributionEnabled_ = false;
+        return fail("cyclic DC reference " + std::to_string(dcDistributionReference_) +
+                    " is not the first DC slave " + std::to_string(dcSlaves.front()));
+    }
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return fail("DC init latch read failed: " + outError);
+    }
+    for (std::size_t i = 0; i < dcSlaves.size(); ++i) {
+        const auto& ports = responses[2U * i];
+        const auto& local = responses[2U * i + 1U];
+        if (ports.workingCounter != 1U || local.workingCounter != 1U || ports.payload.size() < 16U ||
+            local.payload.size() < 8U) {
+            return fail("DC init latch read: no answer from slave " + std::to_string(dcSlaves[i]));
+        }
+        auto& latch = latches[dcSlaves[i]];
+        for (std::size_t port = 0; port < 4U; ++port) {
+            latch.portReceiveTimeNs[port] = readLe32(ports.payload, 4U * port);
+        }
+        latch.processingUnitReceiveTimeNs = readLe64Signed(local.payload, 0U);
+    }
+
+    const auto referenceIt = std::find_if(latches.begin(), latches.end(),
+                                          [](const DcPortLatch& latch) { return latch.dcSupported; });
+    const auto referenceSystemTimeNs =
+        options.alignToHostClock ? hostNs : referenceIt->processingUnitReceiveTimeNs;
+    if (!computeDcTiming(latches, referenceSystemTimeNs, outReport)) {
+        outError = outReport.error;
+        return false;
+    }
+
+    // Offsets and delays of all DC slaves in one batch.
+    requests.clear();
+    for (const auto position : dcSlaves) {
+        const auto& timing = outReport.slaves[position];
+        std::vector<std::uint8_t> offset;
+        offset.reserve(8U);
+        writeLe64Signed(offset, timing.systemTimeOffsetNs);
+        requests.push_back(slaveRequest(kCommandApwr, position, kRegisterDcSystemTimeOffset, std::move(offset)));
+        const auto delay = static_cast<std::uint32_t>(timing.propagationDelayNs);
+        requests.push_back(slaveRequest(kCommandApwr, position, kRegisterDcSystemTimeDelay,
+                                        {static_cast<std::uint8_t>(delay & 0xFFU),
+                                         static_cast<std::uint8_t>((delay >> 8U) & 0xFFU),
+                                         static_cast<std::uint8_t>((delay >> 16U) & 0xFFU),
+                                         static_cast<std::uint8_t>((delay >> 24U) & 0xFFU)}));
+    }
+    dcDiagnostics_.writeAttempts += requests.size();
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        dcDiagnostics_.writeFailure += requests.size();
+        return fail("DC init offset write failed: " + outError);
+    }
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+        if (responses[i].workingCounter != 1U) {
+            ++dcDiagnostics_.writeFailure;
+            return fail("DC init offset write: no answer from slave " + std::to_string(dcSlaves[i / 2U]));
+        }
+        ++dcDiagnostics_.writeSuccess;
+    }
+
+    if (options.measureSpread) {
+        // Every slave samples 0x0910 as its datagram passes; datagram k passes
+        // later by the wire time of the datagrams ahead of it, so residuals are
+        // only comparable within one frame.
+        requests.clear();
+        std::vector<std::int64_t> wireOffsetNs;
+        std::size_t frameBytes = 0U;
+        for (const auto position : dcSlaves) {
+            auto request = slaveRequest(kCommandAprd, position, kRegisterDcSystemTime, std::vector<std::uint8_t>(8U, 0U));
+            const auto bytes = EthercatFrameCodec::datagramWireBytes(request);
+            if (frameBytes + bytes > EthercatFrameCodec::kMaxDatagramBytesPerFrame) {
+                break;
+            }
+            wireOffsetNs.push_back(static_cast<std::int64_t>(frameBytes) * kWireNsPerByte);
+            frameBytes += bytes;
+            requests.push_back(std::move(request));
+        }
+        if (!sendDatagramBatch(requests, responses, outError)) {
+            return fail("DC init spread read failed: " + outError);
+        }
+        std::int64_t minResidual = 0;
+        std::int64_t maxResidual = 0;
+        std::int64_t referenceSample = 0;
+        for (std::size_t i = 0; i < responses.size(); ++i) {
+            if (responses[i].workingCounter != 1U || responses[i].payload.size() < 8U) {
+                return fail("DC init spread read: no answer from slave " + std::to_string(dcSlaves[i]));
+            }
+            auto& timing = outReport.slaves[dcSlaves[i]];
+            const auto sample = readLe64Signed(responses[i].payload, 0U) - timing.propagationDelayNs - wireOffsetNs[i];
+            if (i == 0U) {
+                referenceSample = sample;
+            }
+            timing.residualNs = sample - referenceSample;
+            minResidual = (i == 0U) ? timing.residualNs : std::min(minResidual, timing.residualNs);
+            maxResidual = (i == 0U) ? timing.residualNs : std::max(maxResidual, timing.residualNs);
+        }
+        outReport.spreadNs = maxResidual - minResidual;
+        outReport.spreadMeasured = true;
+    }
+
+    outReport.success = true;
+    return true;
+}
+
+bool LinuxRawSocketTransport::readDcSystemTimeDifferences(const std::vector<std::uint16_t>& positions,
+                                                          std::vector<DcSlaveSyncSample>& outSamples,
+                                                          std::string& outError) {
+    outSamples.clear();
+    outError.clear();
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        return false;
+    }
+    std::vector<EthercatDatagramRequest> requests;
+    requests.reserve(positions.size());
+    for (const auto position : positions) {
+        requests.push_back(slaveRequest(kCommandAprd, position, kRegisterDcSystemTimeDifference,
+                                        std::vector<std::uint8_t>(4U, 0U)));
+    }
+    dcDiagnostics_.readAttempts += requests.size();
+    std::vector<EthercatDatagramResponse> responses;
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        dcDiagnostics_.readFailure += requests.size();
+        return false;
+    }
+    outSamples.resize(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        auto& sample = outSamples[i];
+        sample.slavePosition = positions[i];
+        if (responses[i].workingCounter != 1U) {
+            ++dcDiagnostics_.readFailure;
+            continue;
+        }
+        if (responses[i].payload.size() < 4U) {
+            ++dcDiagnostics_.readInvalidPayload;
+            ++dcDiagnostics_.readFailure;
+            continue;
+        }
+        sample.deviationNs = decodeDcSystemTimeDifference(readLe32(responses[i].payload, 0U));
+        sample.valid = true;
+        ++dcDiagnostics_.readSuccess;
+    }
+    return true;
+}
+
+bool LinuxRawSocketTransport::readDcCapableSlaves(const std::vector<std::uint16_t>& positions,
+                                                  std::vector<std::uint16_t>& outDcSlaves, std::string& outError) {
+    outDcSlaves.clear();
+    outError.clear();
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        return false;
+    }
+    std::vector<EthercatDatagramRequest> requests;
+    requests.reserve(positions.size());
+    for (const auto position : positions) {
+        requests.push_back(slaveRequest(kCommandAprd, position, kRegisterEscFeatures, {0U, 0U}));
+    }
+    std::vector<EthercatDatagramResponse> responses;
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        if (responses[i].workingCounter == 1U && responses[i].payload.size() >= 2U &&
+            (readLe16(responses[i].payload, 0U) & kEscFeatureDc) != 0U) {
+            outDcSlaves.push_back(positions[i]);
+        }
+    }
+    return true;
+}
+
 } // namespace oec
@@ -4,8 +4,10 @@
  */
 
 #include "openethercat/transport/linux_raw_socket_transport.hpp"
+#include "openethercat/transport/process_image_plan.hpp"
 #include "openethercat/master/topology_manager.hpp"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -28,6 +30,16 @@ constexpr std::uint16_t kEepBusy = 0x8000;
 constexpr std::uint16_t kEepErrorMask = 0x7800;
 constexpr std::uint16_t kSiiWordVendorId = 0x0008;
 constexpr std::uint16_t kSiiWordProductCode = 0x000A;
+constexpr std::uint16_t kSiiWordRevision = 0x000C;
+constexpr std::uint16_t kSiiWordBootstrapMailbox = 0x0014;
+constexpr std::uint16_t kSiiWordStandardMailbox = 0x0018;
+constexpr std::uint16_t kRegisterSmBase = 0x0800;
+constexpr std::uint8_t kSmControlMailboxWrite = 0x26;
+constexpr std::uint8_t kSmControlMailboxRead = 0x22;
+constexpr std::uint8_t kSmActivate = 0x01;
+constexpr std::uint8_t kCommandBrd = 0x07;
+constexpr std::uint16_t kRegisterEscInfo = 0x0000;
+constexpr std::size_t kEscInfoBytes = 12U;
 constexpr std::uint16_t kAlStateMask = 0x000F;
 
 bool decodeAlState(std::uint16_t rawState, SlaveState& out) {
@@ -54,6 +66,108 @@ bool decodeAlState(std::uint16_t rawState, SlaveState& out) {
 
 } // namespace
 
+bool LinuxRawSocketTransport::readSiiDword(std::uint16_t adp, std::uint16_t wordAddress, std::uint32_t& outValue) {
+    auto access = [&](std::uint8_t command, std::uint16_t ado, std::vector<std::uint8_t> value,
+                      std::vector<std::uint8_t>& out) -> bool {
+        EthercatDatagramRequest request;
+        request.command = command;
+        request.datagramIndex = datagramIndex_++;
+        request.adp = adp;
+        request.ado = ado;
+        request.payload = std::move(value);
+        const auto size = request.payload.size();
+        std::uint16_t wkc = 0;
+        return sendDatagramRequest(request, wkc, out, error_) && wkc != 0U && out.size() >= size;
+    };
+
+    std::vector<std::uint8_t> ignored;
+    if (!access(kCommandApwr, kRegisterEepAddress,
+                {static_cast<std::uint8_t>(wordAddress & 0xFFU), static_cast<std::uint8_t>((wordAddress >> 8U) & 0xFFU),
+                 0x00U, 0x00U},
+                ignored) ||
+        !access(kCommandApwr, kRegisterEepControlStatus,
+                {static_cast<std::uint8_t>(kEepCommandRead & 0xFFU),
+                 static_cast<std::uint8_t>((kEepCommandRead >> 8U) & 0xFFU)},
+                ignored)) {
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::vector<std::uint8_t> statusPayload;
+        if (!access(kCommandAprd, kRegisterEepControlStatus, std::vector<std::uint8_t>(2U, 0U), statusPayload)) {
+            return false;
+        }
+        const std::uint16_t status = static_cast<std::uint16_t>(statusPayload[0]) |
+                                     (static_cast<std::uint16_t>(statusPayload[1]) << 8U);
+        if ((status & kEepBusy) != 0U) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if ((status & kEepErrorMask) != 0U) {
+            return false;
+        }
+
+        std::vector<std::uint8_t> dataPayload;
+        if (!access(kCommandAprd, kRegisterEepData, std::vector<std::uint8_t>(4U, 0U), dataPayload)) {
+            return false;
+        }
+        outValue = static_cast<std::uint32_t>(dataPayload[0]) | (static_cast<std::uint32_t>(dataPayload[1]) << 8U) |
+                   (static_cast<std::uint32_t>(dataPayload[2]) << 16U) |
+                   (static_cast<std::uint32_t>(dataPayload[3]) << 24U);
+        return true;
+    }
+    return false;
+}
+
+bool LinuxRawSocketTransport::configureMailboxSyncManagers(std::uint16_t slavePosition, bool bootstrap,
+                                                           std::string& outError) {
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        return false;
+    }
+    const auto adp = static_cast<std::uint16_t>(0U - slavePosition);
+    const std::uint16_t firstWord = bootstrap ? kSiiWordBootstrapMailbox : kSiiWordStandardMailbox;
+    std::uint32_t rxWords = 0;
+    std::uint32_t txWords = 0;
+    if (!readSiiDword(adp, firstWord, rxWords) || !readSiiDword(adp, static_cast<std::uint16_t>(firstWord + 2U), txWords)) {
+        outError = "SII mailbox read failed for slave " + std::to_string(slavePosition);
+        return false;
+    }
+    // Each dword is offset (low word) and size (high word): SM0 master-to-slave, SM1 slave-to-master.
+    const std::array<std::uint32_t, 2> windows = {rxWords, txWords};
+    const std::array<std::uint8_t, 2> controls = {kSmControlMailboxWrite, kSmControlMailboxRead};
+    for (std::size_t sm = 0; sm < windows.size(); ++sm) {
+        const auto start = static_cast<std::uint16_t>(windows[sm] & 0xFFFFU);
+        const auto length = static_cast<std::uint16_t>(windows[sm] >> 16U);
+        if (length == 0U) {
+            outError = std::string("SII has no ") + (bootstrap ? "bootstrap" : "standard") +
+                       " mailbox for slave " + std::to_string(slavePosition);
+            return false;
+        }
+        EthercatDatagramRequest request;
+        request.command = kCommandApwr;
+        request.datagramIndex = datagramIndex_++;
+        request.adp = adp;
+        request.ado = static_cast<std::uint16_t>(kRegisterSmBase + (sm * 8U));
+        request.payload = {static_cast<std::uint8_t>(start & 0xFFU), static_cast<std::uint8_t>(start >> 8U),
+                           static_cast<std::uint8_t>(length & 0xFFU), static_cast<std::uint8_t>(length >> 8U),
+                           controls[sm], 0x00U, kSmActivate, 0x00U};
+        std::uint16_t wkc = 0;
+        std::vector<std::uint8_t> ignored;
+        if (!sendDatagramRequest(request, wkc, ignored, outError)) {
+            return false;
+        }
+        if (wkc == 0U) {
+            outError = "SM" + std::to_string(sm) + " write not acknowledged by slave " + std::to_string(slavePosition);
+            return false;
+        }
+    }
+    // The cached windows describe the previous layout.
+    eoeMailboxWindows_.erase(slavePosition);
+    return true;
+}
+
 bool LinuxRawSocketTransport::discoverTopology(TopologySnapshot& outSnapshot, std::string& outError) {
     outSnapshot = TopologySnapshot{};
     outError.clear();
@@ -87,65 +201,21 @@ bool LinuxRawSocketTransport::discoverTopology(TopologySnapshot& outSnapshot, st
         out = std::move(payload);
         return true;
     };
-    auto writeAt = [&](std::uint16_t adp, std::uint16_t ado, const std::vector<std::uint8_t>& value) -> bool {
-        const auto currentIndex = datagramIndex_++;
-        EthercatDatagramRequest request;
-        request.command = kCommandApwr;
-        request.datagramIndex = currentIndex;
-        request.adp = adp;
-        request.ado = ado;
-        request.payload = value;
-
-        std::uint16_t wkc = 0;
-        std::vector<std::uint8_t> payload;
-        return sendDatagramRequest(request, wkc, payload, error_);
-    };
-    auto readSiiWord32 = [&](std::uint16_t adp, std::uint16_t wordAddress, std::uint32_t& outValue) -> bool {
-        const std::vector<std::uint8_t> addrPayload = {
-            static_cast<std::uint8_t>(wordAddress & 0xFFU),
-            static_cast<std::uint8_t>((wordAddress >> 8U) & 0xFFU),
-            0x00U,
-            0x00U,
-        };
-        if (!writeAt(adp, kRegisterEepAddress, addrPayload)) {
-            return false;
-        }
-        const std::vector<std::uint8_t> cmdPayload = {
-            static_cast<std::uint8_t>(kEepCommandRead & 0xFFU),
-            static_cast<std::uint8_t>((kEepCommandRead >> 8U) & 0xFFU),
-        };
-        if (!writeAt(adp, kRegisterEepControlStatus, cmdPayload)) {
-            return false;
-        }
 
-        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
-        while (std::chrono::steady_clock::now() < deadline) {
-            std::vector<std::uint8_t> statusPayload;
-            if (!readAt(adp, kRegisterEepControlStatus, 2, statusPayload)) {
-                return false;
-            }
-            const std::uint16_t status = static_cast<std::uint16_t>(statusPayload[0]) |
-                                         (static_cast<std::uint16_t>(statusPayload[1]) << 8U);
-            if ((status & kEepBusy) != 0U) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                continue;
-            }
-            if ((status & kEepErrorMask) != 0U) {
-                return false;
-            }
-
-            std::vector<std::uint8_t> dataPayload;
-            if (!readAt(adp, kRegisterEepData, 4, dataPayload)) {
-                return false;
-            }
-            outValue = static_cast<std::uint32_t>(dataPayload[0]) |
-                       (static_cast<std::uint32_t>(dataPayload[1]) << 8U) |
-                       (static_cast<std::uint32_t>(dataPayload[2]) << 16U) |
-                       (static_cast<std::uint32_t>(dataPayload[3]) << 24U);
-            return true;
+    // A changed slave count means the chain was re-cabled: cached identities are void.
+    {
+        EthercatDatagramRequest count;
+        count.command = kCommandBrd;
+        count.datagramIndex = datagramIndex_++;
+        count.ado = kRegisterAlStatus;
+        count.payload.assign(2U, 0U);
+        std::uint16_t slaveCount = 0U;
+        std::vector<std::uint8_t> ignored;
+        if (!sendDatagramRequest(count, slaveCount, ignored, error_) || slaveCount != identityCacheSlaveCount_) {
+            identityCache_.clear();
+            identityCacheSlaveCount_ = slaveCount;
         }
-        return false;
-    };
+    }
 
     for (std::uint16_t position = 0; position < 256; ++position) {
         const std::uint16_t adp = autoIncAddress(position);
@@ -181,6 +251,26 @@ bool LinuxRawSocketTransport::discoverTopology(TopologySnapshot& outSnapshot, st
                                (static_cast<std::uint16_t>(escRevisionPayload[1]) << 8U);
         }
 
+        // The SII identity is cheap next to two CoE uploads and tells apart two
+        // devices built on the same ESC, so it guards the cached CoE identity.
+        std::uint32_t siiVendor = 0U;
+        std::uint32_t siiProduct = 0U;
+        const bool siiOk = readSiiDword(adp, kSiiWordVendorId, siiVendor) &&
+                           readSiiDword(adp, kSiiWordProductCode, siiProduct);
+
+        // Static identity objects are re-read only after an AL state, ESC or SII identity change.
+        const auto cached = identityCache_.find(position);
+        if (siiOk && cached != identityCache_.end() && cached->second.alStatus == alRaw &&
+            cached->second.escType == info.escType && cached->second.escRevision == info.escRevision &&
+            cached->second.siiVendorId == siiVendor && cached->second.siiProductCode == siiProduct) {
+            info.vendorId = cached->second.vendorId;
+            info.productCode = cached->second.productCode;
+            info.identityFromCoe = true;
+            outSnapshot.slaves.push_back(info);
+            continue;
+        }
+        identityCache_.erase(position);
+
         // Prefer standardized CoE identity object (0x1018) for real vendor/product identity.
         std::uint32_t abort = 0U;
         std::string sdoError;
@@ -209,16 +299,15 @@ bool LinuxRawSocketTransport::discoverTopology(TopologySnapshot& outSnapshot, st
                                (static_cast<std::uint32_t>(objectData[3]) << 24U);
         }
         info.identityFromCoe = hasVendor && hasProduct;
-        if (!info.identityFromCoe) {
-            std::uint32_t siiVendor = 0U;
-            std::uint32_t siiProduct = 0U;
-            const bool siiVendorOk = readSiiWord32(adp, kSiiWordVendorId, siiVendor);
-            const bool siiProductOk = readSiiWord32(adp, kSiiWordProductCode, siiProduct);
-            if (siiVendorOk && siiProductOk) {
-                info.vendorId = siiVendor;
-                info.productCode = siiProduct;
-                info.identityFromSii = true;
+        if (info.identityFromCoe) {
+            if (siiOk) {
+                identityCache_[position] = {static_cast<std::uint16_t>(alRaw), info.escType, info.escRevision,
+                                            siiVendor, siiProduct, info.vendorId, info.productCode};
             }
+        } else if (siiOk) {
+            info.vendorId = siiVendor;
+            info.productCode = siiProduct;
+            info.identityFromSii = true;
         }
 
         outSnapshot.slaves.push_back(info);
@@ -227,6 +316,11 @@ bool LinuxRawSocketTransport::discoverTopology(TopologySnapshot& outSnapshot, st
     return true;
 }
 
+void LinuxRawSocketTransport::invalidateIdentityCache() {
+    identityCache_.clear();
+    identityCacheSlaveCount_ = 0U;
+}
+
 bool LinuxRawSocketTransport::isRedundancyLinkHealthy(std::string& outError) {
     outError.clear();
     if (!redundancyEnabled_) {
@@ -236,7 +330,101 @@ bool LinuxRawSocketTransport::isRedundancyLinkHealthy(std::string& outError) {
         outError = "redundancy enabled but secondary interface not configured";
         return false;
     }
+    // An open secondary socket says nothing about the ring; the cyclic frames do.
+    if (parallelRedundancyActive() && redundancyObserved_) {
+        return lastRingIntact_;
+    }
     return secondarySocketFd_ >= 0;
 }
 
+bool LinuxRawSocketTransport::readTopologyFingerprint(std::uint64_t& outHash, std::string& outError) {
+    outHash = 0U;
+    outError.clear();
+    if (socketFd_ < 0) {
+        outError = "transport not open";
+        return false;
+    }
+
+    // Broadcast read: every slave increments WKC once, which yields the slave count.
+    std::vector<EthercatDatagramRequest> requests(1U);
+    requests[0].command = kCommandBrd;
+    requests[0].ado = kRegisterAlStatus;
+    requests[0].payload.assign(2U, 0U);
+    std::vector<EthercatDatagramResponse> responses;
+    if (!sendDatagramBatch(requests, responses, outError)) {
+        return false;
+    }
+    const std::uint16_t slaveCount = responses[0].workingCounter;
+    std::vector<std::uint8_t> canonical;
+    canonical.push_back(static_cast<std::uint8_t>(slaveCount & 0xFFU));
+    canonical.push_back(static_cast<std::uint8_t>((slaveCount >> 8U) & 0xFFU));
+
+    auto perSlave = [&](std::uint8_t command, std::uint16_t ado, const std::vector<std::uint8_t>& payload) {
+        requests.assign(slaveCount, EthercatDatagramRequest{});
+        for (std::uint16_t position = 0; position < slaveCount; ++position) {
+            requests[position].command = command;
+            requests[position].adp = static_cast<std::uint16_t>(0U - position);
+            requests[position].ado = ado;
+            requests[position].payload = payload;
+        }
+        return sendDatagramBatch(requests, responses, outError);
+    };
+
+    // ESC type/revision/build/FMMU+SM counts/RAM size/port descriptor/features.
+    if (!perSlave(kCommandAprd, kRegisterEscInfo, std::vector<std::uint8_t>(kEscInfoBytes, 0U))) {
+        return false;
+    }
+    for (const auto& r : responses) {
+        canonical.insert(canonical.end(), r.payload.begin(), r.payload.end());
+    }
+
+    // SII identity words, read on all slaves in lockstep: one command write, then
+    // batched status/data polls until every EEPROM interface has finished.
+    for (const auto word : {kSiiWordVendorId, kSiiWordProductCode, kSiiWordRevision}) {
+        const std::vector<std::uint8_t> command = {
+            static_cast<std::uint8_t>(kEepCommandRead & 0xFFU),
+            static_cast<std::uint8_t>((kEepCommandRead >> 8U) & 0xFFU),
+            static_cast<std::uint8_t>(word & 0xFFU),
+            static_cast<std::uint8_t>((word >> 8U) & 0xFFU),
+            0x00U,
+            0x00U,
+        };
+        if (!perSlave(kCommandApwr, kRegisterEepControlStatus, command)) {
+            return false;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+        const auto dataOffset = static_cast<std::size_t>(kRegisterEepData - kRegisterEepControlStatus);
+        while (true) {
+            if (!perSlave(kCommandAprd, kRegisterEepControlStatus, std::vector<std::uint8_t>(dataOffset + 4U, 0U))) {
+                return false;
+            }
+            bool busy = false;
+            for (const auto& r : responses) {
+                const auto status = static_cast<std::uint16_t>(r.payload[0]) |
+                                    static_cast<std::uint16_t>(static_cast<std::uint16_t>(r.payload[1]) << 8U);
+                if ((status & kEepErrorMask) != 0U) {
+                    outError = "SII read error during topology fingerprint";
+                    return false;
+                }
+                busy = busy || ((status & kEepBusy) != 0U);
+            }
+            if (!busy) {
+                break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                outError = "SII read timeout during topology fingerprint";
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        for (const auto& r : responses) {
+            canonical.insert(canonical.end(), r.payload.begin() + static_cast<std::ptrdiff_t>(dataOffset),
+                             r.payload.end());
+        }
+    }
+
+    outHash = ProcessImagePlanCodec::hashBytes(canonical);
+    return true;
+}
+
 } // namespace oec
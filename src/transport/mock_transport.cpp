@@ -6,6 +6,7 @@
 #include "openethercat/transport/mock_transport.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <stdexcept>
@@ -21,6 +22,7 @@ bool MockTransport::open() {
     state_ = SlaveState::Init;
     perSlaveState_.clear();
     perSlaveAlStatusCode_.clear();
+    bootstrapMailbox_.clear();
     pdoAssignments_.clear();
     while (!emergencies_.empty()) {
         emergencies_.pop();
@@ -30,6 +32,7 @@ bool MockTransport::open() {
     }
     remainingExchangeFailures_ = 0;
     redundancyHealthy_ = true;
+    linkHealthy_ = true;
     discoveredSlaves_.clear();
     error_.clear();
     return true;
@@ -85,6 +88,22 @@ bool MockTransport::requestSlaveState(std::uint16_t position, SlaveState state)
         error_ = "not opened";
         return false;
     }
+    if (enforceAlTransitions_) {
+        SlaveState current = state_;
+        (void)readSlaveState(position, current);
+        const bool bootstrapLayout = bootstrapMailbox_[position];
+        bool legal = (state == current) || (state == SlaveState::Init) ||
+                     (current != SlaveState::Bootstrap && state != SlaveState::Bootstrap &&
+                      static_cast<int>(state) < static_cast<int>(current));
+        legal = legal || (current == SlaveState::Init && state == SlaveState::Bootstrap && bootstrapLayout) ||
+                (current == SlaveState::Init && state == SlaveState::PreOp && !bootstrapLayout) ||
+                (current == SlaveState::PreOp && state == SlaveState::SafeOp) ||
+                (current == SlaveState::SafeOp && state == SlaveState::Op);
+        if (!legal) {
+            error_ = std::string("illegal AL transition ") + toString(current) + " -> " + toString(state);
+            return false;
+        }
+    }
     perSlaveState_[position] = state;
     if (state == SlaveState::Op) {
         perSlaveAlStatusCode_[position] = 0U;
@@ -204,6 +223,83 @@ bool MockTransport::sdoDownload(std::uint16_t slavePosition, const SdoAddress& a
     return true;
 }
 
+bool MockTransport::sdoUploadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0,
+                                      std::vector<std::uint8_t>& outData, std::uint32_t& outAbortCode,
+                                      std::string& outError) {
+    if (!opened_) {
+        outError = "not opened";
+        return false;
+    }
+    outAbortCode = 0U;
+    outData.clear();
+    const auto key = [&](std::uint8_t subIndex) {
+        return (static_cast<std::uint64_t>(slavePosition) << 32U) | (static_cast<std::uint64_t>(index) << 8U) |
+               static_cast<std::uint64_t>(subIndex);
+    };
+    const auto count = sdoObjects_.find(key(0U));
+    if (count == sdoObjects_.end() || count->second.empty()) {
+        outAbortCode = 0x06020000U;
+        return false;
+    }
+    const auto entries = count->second[0];
+    if (includeSubIndex0) {
+        outData = {entries, 0U};
+    }
+    for (std::uint8_t sub = 1U; sub <= entries && sub != 0U; ++sub) {
+        const auto it = sdoObjects_.find(key(sub));
+        if (it == sdoObjects_.end()) {
+            outAbortCode = 0x06090011U;
+            outData.clear();
+            return false;
+        }
+        outData.insert(outData.end(), it->second.begin(), it->second.end());
+    }
+    return true;
+}
+
+bool MockTransport::sdoDownloadComplete(std::uint16_t slavePosition, std::uint16_t index, bool includeSubIndex0,
+                                        const std::vector<std::uint8_t>& data, std::uint32_t& outAbortCode,
+                                        std::string& outError) {
+    if (!opened_) {
+        outError = "not opened";
+        return false;
+    }
+    outAbortCode = 0U;
+    const auto key = [&](std::uint8_t subIndex) {
+        return (static_cast<std::uint64_t>(slavePosition) << 32U) | (static_cast<std::uint64_t>(index) << 8U) |
+               static_cast<std::uint64_t>(subIndex);
+    };
+    std::size_t begin = 0U;
+    std::uint8_t entries = 0U;
+    if (includeSubIndex0) {
+        if (data.size() < 2U) {
+            outAbortCode = 0x06070010U;
+            return false;
+        }
+        entries = data[0];
+        begin = 2U;
+    } else {
+        const auto count = sdoObjects_.find(key(0U));
+        if (count == sdoObjects_.end() || count->second.empty()) {
+            outAbortCode = 0x06020000U;
+            return false;
+        }
+        entries = count->second[0];
+    }
+    const auto payloadBytes = data.size() - begin;
+    if ((entries == 0U && payloadBytes != 0U) || (entries != 0U && payloadBytes % entries != 0U)) {
+        outAbortCode = 0x06070010U;
+        return false;
+    }
+    const auto width = (entries == 0U) ? std::size_t{0U} : payloadBytes / entries;
+    for (std::size_t i = 0; i < entries; ++i) {
+        const auto from = data.begin() + static_cast<std::ptrdiff_t>(begin + (i * width));
+        sdoObjects_[key(static_cast<std::uint8_t>(i + 1U))] = std::vector<std::uint8_t>(from, from + static_cast<std::ptrdiff_t>(width));
+    }
+    sdoObjects_[key(0U)] = {entries};
+    return true;
+}
+
 bool MockTransport::configurePdo(std::uint16_t slavePosition, std::uint16_t assignIndex,
                                  const std::vector<PdoMappingEntry>& entries, std::string& outError) {
     if (!opened_) {
@@ -233,7 +329,7 @@ bool MockTransport::discoverTopology(TopologySnapshot& outSnapshot, std::string&
         return false;
     }
     outSnapshot.slaves = discoveredSlaves_;
-    outSnapshot.redundancyHealthy = redundancyHealthy_;
+    outSnapshot.redundancyHealthy = linkHealthy_;
     return true;
 }
 
@@ -242,7 +338,15 @@ bool MockTransport::isRedundancyLinkHealthy(std::string& outError) {
         outError = "not opened";
         return false;
     }
-    return redundancyHealthy_;
+    return linkHealthy_;
+}
+
+bool MockTransport::redundancyObservation(bool& outRingIntact) {
+    if (!opened_ || !cyclicRedundancyObservation_) {
+        return false;
+    }
+    outRingIntact = redundancyHealthy_;
+    return true;
 }
 
 bool MockTransport::foeRead(std::uint16_t slavePosition, const FoERequest& request,
@@ -277,12 +381,123 @@ bool MockTransport::foeWrite(std::uint16_t slavePosition, const FoERequest& requ
     return true;
 }
 
+bool MockTransport::foeReadStream(std::uint16_t slavePosition, const FoERequest& request, FoESink& sink,
+                                  std::string& outError) {
+    FoEResponse response;
+    if (!foeRead(slavePosition, request, response, outError)) {
+        outError = response.error.empty() ? outError : response.error;
+        return false;
+    }
+    const std::size_t chunk = std::max<std::size_t>(1U, request.maxChunkBytes);
+    FoEProgress progress;
+    progress.slavePosition = slavePosition;
+    progress.totalBytes = response.data.size();
+    std::size_t cursor = 0U;
+    do {
+        const auto n = std::min(chunk, response.data.size() - cursor);
+        if (!sink.write(response.data.data() + cursor, n, outError)) {
+            return false;
+        }
+        cursor += n;
+        progress.bytesTransferred = cursor;
+        ++progress.packets;
+        if (request.onProgress) {
+            request.onProgress(progress);
+        }
+    } while (cursor < response.data.size());
+    return true;
+}
+
+bool MockTransport::foeWriteStream(std::uint16_t slavePosition, const FoERequest& request, FoESource& source,
+                                   std::string& outError) {
+    if (!opened_) {
+        outError = "not opened";
+        return false;
+    }
+    const std::size_t chunk = std::max<std::size_t>(1U, request.maxChunkBytes);
+    FoEProgress progress;
+    progress.slavePosition = slavePosition;
+    progress.totalBytes = source.sizeHint();
+    // Like a slave, the write request opens the file empty and each data packet is appended on arrival.
+    const auto key = (static_cast<std::uint64_t>(slavePosition) << 32U) ^
+                     static_cast<std::uint64_t>(std::hash<std::string>{}(request.fileName));
+    auto& file = foeFiles_[key];
+    file.clear();
+    std::vector<std::uint8_t> packet(chunk);
+    while (true) {
+        std::size_t got = 0U;
+        if (!source.read(packet.data(), chunk, got, outError)) {
+            return false;
+        }
+        file.insert(file.end(), packet.begin(), packet.begin() + static_cast<std::ptrdiff_t>(got));
+        progress.bytesTransferred += got;
+        ++progress.packets;
+        if (request.onProgress) {
+            request.onProgress(progress);
+        }
+        if (got < chunk) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool MockTransport::foeWriteStreams(std::vector<FoEWriteJob>& jobs, std::string& outError) {
+    bool ok = true;
+    for (auto& job : jobs) {
+        if (job.source == nullptr) {
+            job.error = "FoE write job without source";
+        }
+        job.success = (job.source != nullptr) && foeWriteStream(job.slavePosition, job.request, *job.source, job.error);
+        if (!job.success && ok) {
+            ok = false;
+            outError = "FoE write to slave " + std::to_string(job.slavePosition) + " failed: " + job.error;
+        }
+    }
+    return ok;
+}
+
+bool MockTransport::mailboxWriteSize(std::uint16_t slavePosition, std::uint16_t& outBytes) {
+    const auto it = mailboxWriteSizes_.find(slavePosition);
+    if (it == mailboxWriteSizes_.end()) {
+        return false;
+    }
+    outBytes = it->second;
+    return true;
+}
+
+void MockTransport::setMailboxWriteSize(std::uint16_t position, std::uint16_t bytes) {
+    mailboxWriteSizes_[position] = bytes;
+}
+
+bool MockTransport::configureMailboxSyncManagers(std::uint16_t slavePosition, bool bootstrap,
+                                                 std::string& outError) {
+    SlaveState current = SlaveState::Init;
+    if (!readSlaveState(slavePosition, current)) {
+        outError = error_;
+        return false;
+    }
+    if (current != SlaveState::Init) {
+        outError = "mailbox SMs can only be configured in INIT";
+        return false;
+    }
+    bootstrapMailbox_[slavePosition] = bootstrap;
+    return true;
+}
+
+void MockTransport::setEnforceAlTransitions(bool enabled) { enforceAlTransitions_ = enabled; }
+
 bool MockTransport::eoeSend(std::uint16_t slavePosition, const std::vector<std::uint8_t>& frame,
                             std::string& outError) {
     if (!opened_) {
         outError = "not opened";
         return false;
     }
+    const auto window = mailboxWriteSizes_.find(slavePosition);
+    if (window != mailboxWriteSizes_.end() && frame.size() + 6U > window->second) {
+        outError = "EoE frame exceeds mailbox write window";
+        return false;
+    }
     eoeFrames_.push({slavePosition, frame});
     return true;
 }
@@ -307,9 +522,21 @@ bool MockTransport::eoeReceive(std::uint16_t slavePosition, std::vector<std::uin
 
 void MockTransport::enqueueEmergency(const EmergencyMessage& emergency) {
     emergencies_.push(emergency);
+    if (emergencies_.back().timestampNs == 0U) {
+        emergencies_.back().timestampNs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+}
+
+void MockTransport::setRedundancyHealthy(bool healthy) {
+    redundancyHealthy_ = healthy;
+    linkHealthy_ = healthy;
 }
 
-void MockTransport::setRedundancyHealthy(bool healthy) { redundancyHealthy_ = healthy; }
+void MockTransport::setRedundancyLinkHealthy(bool healthy) { linkHealthy_ = healthy; }
+
+void MockTransport::setCyclicRedundancyObservation(bool enabled) { cyclicRedundancyObservation_ = enabled; }
 
 void MockTransport::setDiscoveredSlaves(const std::vector<TopologySlaveInfo>& slaves) {
     discoveredSlaves_ = slaves;
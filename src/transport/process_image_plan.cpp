@@ -0,0 +1,287 @@
+/**
+ * @file process_image_plan.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/transport/process_image_plan.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace oec {
+namespace {
+
+constexpr std::uint8_t kMagic[4] = {'O', 'E', 'C', 'P'};
+constexpr std::uint64_t kFnvPrime = 0x100000001b3ULL;
+// Upper bound for any single record count; guards against corrupt files.
+constexpr std::uint32_t kMaxRecords = 65536U;
+
+void putLe16(std::vector<std::uint8_t>& out, std::uint16_t value) {
+    out.push_back(static_cast<std::uint8_t>(value & 0xFFU));
+    out.push_back(static_cast<std::uint8_t>((value >> 8U) & 0xFFU));
+}
+
+void putLe32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    for (std::size_t i = 0; i < 4U; ++i) {
+        out.push_back(static_cast<std::uint8_t>((value >> (8U * i)) & 0xFFU));
+    }
+}
+
+void putLe64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    for (std::size_t i = 0; i < 8U; ++i) {
+        out.push_back(static_cast<std::uint8_t>((value >> (8U * i)) & 0xFFU));
+    }
+}
+
+void putBytes(std::vector<std::uint8_t>& out, const std::vector<std::uint8_t>& bytes) {
+    putLe16(out, static_cast<std::uint16_t>(bytes.size()));
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+void putString(std::vector<std::uint8_t>& out, const std::string& text) {
+    putLe32(out, static_cast<std::uint32_t>(text.size()));
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+class Reader {
+public:
+    explicit Reader(const std::vector<std::uint8_t>& bytes, std::size_t end) : bytes_(bytes), end_(end) {}
+
+    bool u8(std::uint8_t& out) {
+        if (offset_ + 1U > end_) {
+            return false;
+        }
+        out = bytes_[offset_++];
+        return true;
+    }
+    bool u16(std::uint16_t& out) {
+        std::uint64_t v = 0;
+        if (!little(2U, v)) {
+            return false;
+        }
+        out = static_cast<std::uint16_t>(v);
+        return true;
+    }
+    bool u32(std::uint32_t& out) {
+        std::uint64_t v = 0;
+        if (!little(4U, v)) {
+            return false;
+        }
+        out = static_cast<std::uint32_t>(v);
+        return true;
+    }
+    bool u64(std::uint64_t& out) { return little(8U, out); }
+    bool bytes(std::vector<std::uint8_t>& out) {
+        std::uint16_t size = 0;
+        if (!u16(size) || offset_ + size > end_) {
+            return false;
+        }
+        out.assign(bytes_.begin() + static_cast<std::ptrdiff_t>(offset_),
+                   bytes_.begin() + static_cast<std::ptrdiff_t>(offset_ + size));
+        offset_ += size;
+        return true;
+    }
+    bool count(std::uint32_t& out) { return u32(out) && out <= kMaxRecords; }
+    bool done() const { return offset_ == end_; }
+
+private:
+    bool little(std::size_t width, std::uint64_t& out) {
+        if (offset_ + width > end_) {
+            return false;
+        }
+        out = 0U;
+        for (std::size_t i = 0; i < width; ++i) {
+            out |= static_cast<std::uint64_t>(bytes_[offset_ + i]) << (8U * i);
+        }
+        offset_ += width;
+        return true;
+    }
+
+    const std::vector<std::uint8_t>& bytes_;
+    std::size_t end_ = 0;
+    std::size_t offset_ = 0;
+};
+
+} // namespace
+
+std::uint64_t ProcessImagePlanCodec::hashBytes(const std::vector<std::uint8_t>& bytes, std::uint64_t seed) {
+    std::uint64_t hash = seed;
+    for (const auto b : bytes) {
+        hash ^= b;
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+std::uint64_t ProcessImagePlanCodec::hashConfiguration(const NetworkConfiguration& config,
+                                                       std::uint32_t logicalAddress) {
+    std::vector<std::uint8_t> canonical;
+    putLe32(canonical, kFormatVersion);
+    putLe32(canonical, logicalAddress);
+    putLe64(canonical, config.processImageInputBytes);
+    putLe64(canonical, config.processImageOutputBytes);
+    putLe32(canonical, static_cast<std::uint32_t>(config.slaves.size()));
+    for (const auto& s : config.slaves) {
+        putString(canonical, s.name);
+        putLe16(canonical, s.alias);
+        putLe16(canonical, s.position);
+        putLe32(canonical, s.vendorId);
+        putLe32(canonical, s.productCode);
+    }
+    putLe32(canonical, static_cast<std::uint32_t>(config.signals.size()));
+    for (const auto& sig : config.signals) {
+        putString(canonical, sig.logicalName);
+        canonical.push_back(sig.direction == SignalDirection::Output ? 1U : 0U);
+        putString(canonical, sig.slaveName);
+        putLe64(canonical, sig.byteOffset);
+        canonical.push_back(sig.bitOffset);
+    }
+    return hashBytes(canonical);
+}
+
+std::vector<std::uint8_t> ProcessImagePlanCodec::encode(const ProcessImageLayoutPlan& plan) {
+    std::vector<std::uint8_t> out(std::begin(kMagic), std::end(kMagic));
+    putLe32(out, kFormatVersion);
+    putLe64(out, plan.topologyHash);
+    putLe64(out, plan.configHash);
+
+    putLe32(out, static_cast<std::uint32_t>(plan.sdoWrites.size()));
+    for (const auto& w : plan.sdoWrites) {
+        putLe16(out, w.slavePosition);
+        putLe16(out, w.address.index);
+        out.push_back(w.address.subIndex);
+        putBytes(out, w.data);
+    }
+    putLe32(out, static_cast<std::uint32_t>(plan.registerWrites.size()));
+    for (const auto& w : plan.registerWrites) {
+        putLe16(out, w.slavePosition);
+        putLe16(out, w.ado);
+        putBytes(out, w.data);
+    }
+    putLe32(out, static_cast<std::uint32_t>(plan.smExpectations.size()));
+    for (const auto& e : plan.smExpectations) {
+        putLe16(out, e.slavePosition);
+        out.push_back(e.syncManager);
+        putLe16(out, e.start);
+        putLe16(out, e.length);
+    }
+    putLe32(out, static_cast<std::uint32_t>(plan.outputWindows.size()));
+    for (const auto& w : plan.outputWindows) {
+        putLe16(out, w.slavePosition);
+        putLe16(out, w.physicalStart);
+        putLe16(out, w.length);
+        putLe32(out, w.logicalStart);
+    }
+    // Trailing checksum over everything before it catches truncated/corrupt files.
+    putLe64(out, hashBytes(out));
+    return out;
+}
+
+bool ProcessImagePlanCodec::decode(const std::vector<std::uint8_t>& bytes, ProcessImageLayoutPlan& outPlan,
+                                   std::string& outError) {
+    outPlan = ProcessImageLayoutPlan{};
+    outError.clear();
+    if (bytes.size() < sizeof(kMagic) + 4U + 8U) {
+        outError = "plan too short";
+        return false;
+    }
+    if (!std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin())) {
+        outError = "plan magic mismatch";
+        return false;
+    }
+    const auto bodyEnd = bytes.size() - 8U;
+    std::uint64_t storedChecksum = 0;
+    for (std::size_t i = 0; i < 8U; ++i) {
+        storedChecksum |= static_cast<std::uint64_t>(bytes[bodyEnd + i]) << (8U * i);
+    }
+    if (hashBytes(std::vector<std::uint8_t>(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(bodyEnd))) !=
+        storedChecksum) {
+        outError = "plan checksum mismatch";
+        return false;
+    }
+
+    Reader in(bytes, bodyEnd);
+    std::uint8_t magic = 0;
+    for (std::size_t i = 0; i < sizeof(kMagic); ++i) {
+        (void)in.u8(magic);
+    }
+    std::uint32_t version = 0;
+    if (!in.u32(version) || version != kFormatVersion) {
+        outError = "unsupported plan format version";
+        return false;
+    }
+    bool ok = in.u64(outPlan.topologyHash) && in.u64(outPlan.configHash);
+
+    std::uint32_t count = 0;
+    ok = ok && in.count(count);
+    for (std::uint32_t i = 0; ok && i < count; ++i) {
+        ProcessImagePlanSdoWrite w;
+        ok = in.u16(w.slavePosition) && in.u16(w.address.index) && in.u8(w.address.subIndex) && in.bytes(w.data);
+        outPlan.sdoWrites.push_back(std::move(w));
+    }
+    ok = ok && in.count(count);
+    for (std::uint32_t i = 0; ok && i < count; ++i) {
+        ProcessImagePlanRegisterWrite w;
+        ok = in.u16(w.slavePosition) && in.u16(w.ado) && in.bytes(w.data);
+        outPlan.registerWrites.push_back(std::move(w));
+    }
+    ok = ok && in.count(count);
+    for (std::uint32_t i = 0; ok && i < count; ++i) {
+        ProcessImagePlanSmExpectation e;
+        ok = in.u16(e.slavePosition) && in.u8(e.syncManager) && in.u16(e.start) && in.u16(e.length);
+        outPlan.smExpectations.push_back(e);
+    }
+    ok = ok && in.count(count);
+    for (std::uint32_t i = 0; ok && i < count; ++i) {
+        ProcessImagePlanOutputWindow w;
+        ok = in.u16(w.slavePosition) && in.u16(w.physicalStart) && in.u16(w.length) && in.u32(w.logicalStart);
+        outPlan.outputWindows.push_back(w);
+    }
+    if (!ok || !in.done()) {
+        outPlan = ProcessImageLayoutPlan{};
+        outError = "plan truncated or malformed";
+        return false;
+    }
+    return true;
+}
+
+bool ProcessImagePlanCodec::saveToFile(const std::string& path, const ProcessImageLayoutPlan& plan,
+                                       std::string& outError) {
+    outError.clear();
+    const auto bytes = encode(plan);
+    // Write-then-rename so a crash mid-write never leaves a half plan behind.
+    const auto tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            outError = "Cannot open file: " + tmpPath;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            outError = "Failed writing file: " + tmpPath;
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        outError = "Failed to replace file: " + path;
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ProcessImagePlanCodec::loadFromFile(const std::string& path, ProcessImageLayoutPlan& outPlan,
+                                         std::string& outError) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        outError = "Cannot open file: " + path;
+        return false;
+    }
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decode(bytes, outPlan, outError);
+}
+
+} // namespace oec
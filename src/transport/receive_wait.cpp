@@ -0,0 +1,84 @@
+/**
+ * @file receive_wait.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/transport/receive_wait.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+namespace oec {
+
+int waitReadable(const int* fds, std::size_t count, std::chrono::steady_clock::time_point deadline,
+                 ReceiveWaitMode mode, std::string& outError) {
+    constexpr std::size_t kMaxFds = 4U;
+    count = std::min(count, kMaxFds);
+    pollfd pfds[kMaxFds] = {};
+    for (;;) {
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            return 0;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            pfds[i].fd = fds[i];
+            pfds[i].events = POLLIN;
+            pfds[i].revents = 0;
+        }
+        timespec timeout {};
+        if (mode == ReceiveWaitMode::Block) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            timeout.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+            timeout.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        }
+        const int ready = ::ppoll(pfds, static_cast<nfds_t>(count), &timeout, nullptr);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            outError = "ppoll() failed: " + std::string(std::strerror(errno));
+            return -1;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        // POLLERR/POLLHUP count as readable so the caller's recv() reports the error.
+        int mask = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (pfds[i].revents != 0) {
+                mask |= (1 << i);
+            }
+        }
+        return mask;
+    }
+}
+
+RedundantDeadlines splitRedundantDeadline(std::chrono::steady_clock::time_point start,
+                                          std::chrono::steady_clock::time_point deadline) {
+    if (deadline <= start) {
+        return RedundantDeadlines{deadline, deadline};
+    }
+    return RedundantDeadlines{start + (deadline - start) / 2, deadline};
+}
+
+bool setSocketBusyPoll(int fd, std::chrono::microseconds budget, std::string& outError) {
+#ifdef SO_BUSY_POLL
+    const int value = static_cast<int>(budget.count());
+    if (::setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) < 0) {
+        outError = "setsockopt(SO_BUSY_POLL) failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)budget;
+    outError = "SO_BUSY_POLL not supported";
+    return false;
+#endif
+}
+
+} // namespace oec
@@ -0,0 +1,101 @@
+/**
+ * @file scheduled_transmit.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/transport/scheduled_transmit.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+
+namespace oec {
+
+bool enableScheduledTransmit(int fd, int socketPriority, std::string& outError) {
+    sock_txtime config {};
+    config.clockid = CLOCK_TAI;
+    config.flags = SOF_TXTIME_REPORT_ERRORS;
+    if (::setsockopt(fd, SOL_SOCKET, SO_TXTIME, &config, sizeof(config)) < 0) {
+        outError = "setsockopt(SO_TXTIME) failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    if (::setsockopt(fd, SOL_SOCKET, SO_PRIORITY, &socketPriority, sizeof(socketPriority)) < 0) {
+        outError = "setsockopt(SO_PRIORITY) failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool sendAtLaunchTime(int fd, const void* data, std::size_t size, const sockaddr* target, socklen_t targetLength,
+                      std::uint64_t launchTaiNs, std::string& outError) {
+    iovec iov {};
+    iov.iov_base = const_cast<void*>(data);
+    iov.iov_len = size;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint64_t))] = {};
+    msghdr message {};
+    message.msg_name = const_cast<sockaddr*>(target);
+    message.msg_namelen = targetLength;
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_TXTIME;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint64_t));
+    std::memcpy(CMSG_DATA(cmsg), &launchTaiNs, sizeof(launchTaiNs));
+    const auto sent = ::sendmsg(fd, &message, 0);
+    if (sent < 0 || static_cast<std::size_t>(sent) != size) {
+        outError = "sendto() failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t steadyToTaiNs(std::chrono::steady_clock::time_point time) {
+    timespec tai {};
+    ::clock_gettime(CLOCK_TAI, &tai);
+    const auto steadyNow = std::chrono::steady_clock::now();
+    const auto taiNowNs = static_cast<std::int64_t>(tai.tv_sec) * 1000000000LL + tai.tv_nsec;
+    const auto aheadNs = std::chrono::duration_cast<std::chrono::nanoseconds>(time - steadyNow).count();
+    return static_cast<std::uint64_t>(taiNowNs + aheadNs);
+}
+
+void collectLaunchTimeErrors(int fd, ScheduledTransmitDiagnostics& diagnostics) {
+    alignas(cmsghdr) char control[256];
+    std::uint8_t data[64];
+    // Bounded: one report per dropped frame, at most a few per cycle.
+    for (int i = 0; i < 16; ++i) {
+        iovec iov {};
+        iov.iov_base = data;
+        iov.iov_len = sizeof(data);
+        msghdr message {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
+        }
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            sock_extended_err error {};
+            if (cmsg->cmsg_len < CMSG_LEN(sizeof(error))) {
+                continue;
+            }
+            std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+            if (error.ee_origin != SO_EE_ORIGIN_TXTIME) {
+                continue;
+            }
+            if (error.ee_code == SO_EE_CODE_TXTIME_MISSED) {
+                ++diagnostics.missedByQdisc;
+            } else if (error.ee_code == SO_EE_CODE_TXTIME_INVALID_PARAM) {
+                ++diagnostics.invalidLaunchTime;
+            }
+        }
+    }
+}
+
+} // namespace oec
@@ -74,7 +74,25 @@ bool TransportFactory::parseTransportSpec(const std::string& spec,
         return true;
     }
 
-    outError = "unsupported transport spec '" + spec + "', expected 'mock' or 'linux:<ifname>[,<ifname2>]'";
+    constexpr const char* kXdpPrefix = "xdp:";
+    if (trimmed.rfind(kXdpPrefix, 0) == 0) {
+        outConfig.kind = TransportKind::LinuxXdp;
+        outConfig.primaryInterface = trimCopy(trimmed.substr(4));
+        outConfig.secondaryInterface.clear();
+        outConfig.enableRedundancy = false;
+        if (outConfig.primaryInterface.empty()) {
+            outError = "xdp transport requires interface name, e.g. xdp:eth0";
+            return false;
+        }
+        if (outConfig.primaryInterface.find(',') != std::string::npos) {
+            outError = "xdp transport does not support redundancy, expected xdp:<ifname>";
+            return false;
+        }
+        return true;
+    }
+
+    outError = "unsupported transport spec '" + spec +
+               "', expected 'mock', 'linux:<ifname>[,<ifname2>]' or 'xdp:<ifname>'";
     return false;
 }
 
@@ -86,7 +104,7 @@ std::unique_ptr<ITransport> TransportFactory::create(const TransportFactoryConfi
         return std::make_unique<MockTransport>(config.mockInputBytes, config.mockOutputBytes);
     }
 
-    if (config.kind != TransportKind::LinuxRawSocket) {
+    if (config.kind != TransportKind::LinuxRawSocket && config.kind != TransportKind::LinuxXdp) {
         outError = "unsupported transport kind";
         return nullptr;
     }
@@ -119,6 +137,11 @@ std::unique_ptr<ITransport> TransportFactory::create(const TransportFactoryConfi
     transport->setExpectedWorkingCounter(expectedWorkingCounter);
     transport->setMaxFramesPerCycle(config.maxFramesPerCycle);
     transport->enableRedundancy(config.enableRedundancy);
+    if (config.kind == TransportKind::LinuxXdp) {
+        XdpSocketOptions xdp;
+        xdp.enabled = true;
+        transport->setXdp(xdp);
+    }
     return transport;
 }
 
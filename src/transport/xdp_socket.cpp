@@ -0,0 +1,427 @@
+/**
+ * @file xdp_socket.cpp
+ * @brief openEtherCAT source file.
+ */
+
+#include "openethercat/transport/xdp_socket.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace oec {
+namespace {
+
+constexpr std::uint8_t kEtherTypeHigh = 0x88;
+constexpr std::uint8_t kEtherTypeLow = 0xA4;
+// Offset of the first datagram's command byte: Ethernet header + EtherCAT header.
+constexpr std::size_t kFirstCommandOffset = 16U;
+// LRD, LWR, LRW and ARMW are contiguous; no other frame starts with them.
+constexpr std::uint8_t kFirstCyclicCommand = 0x0A;
+constexpr std::uint8_t kLastCyclicCommand = 0x0D;
+
+std::string errnoText(const char* call) {
+    return std::string(call) + " failed: " + std::strerror(errno);
+}
+
+int bpfCall(int command, bpf_attr& attr) {
+    return static_cast<int>(::syscall(__NR_bpf, command, &attr, sizeof(attr)));
+}
+
+bpf_insn insn(std::uint8_t code, std::uint8_t dst, std::uint8_t src, std::int16_t off, std::int32_t imm) {
+    bpf_insn result {};
+    result.code = code;
+    result.dst_reg = dst & 0x0FU;
+    result.src_reg = src & 0x0FU;
+    result.off = off;
+    result.imm = imm;
+    return result;
+}
+
+// XDP program equivalent to XdpSocket::isCyclicFrame():
+//   if (data + 17 > data_end) return XDP_PASS;
+//   if (eth[12] != 0x88 || eth[13] != 0xA4) return XDP_PASS;
+//   if (eth[16] < 0x0A || eth[16] > 0x0D) return XDP_PASS;
+//   return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS);
+std::vector<bpf_insn> steeringProgram(int mapFd) {
+    constexpr std::int16_t kToPass = 18;
+    constexpr auto kMinLength = static_cast<std::int32_t>(kFirstCommandOffset + 1U);
+    return {
+        insn(BPF_LDX | BPF_W | BPF_MEM, 2, 1, offsetof(xdp_md, data), 0),
+        insn(BPF_LDX | BPF_W | BPF_MEM, 3, 1, offsetof(xdp_md, data_end), 0),
+        insn(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0),
+        insn(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, kMinLength),
+        insn(BPF_JMP | BPF_JGT | BPF_X, 4, 3, kToPass - 5, 0),
+        insn(BPF_LDX | BPF_B | BPF_MEM, 5, 2, 12, 0),
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, kToPass - 7, kEtherTypeHigh),
+        insn(BPF_LDX | BPF_B | BPF_MEM, 5, 2, 13, 0),
+        insn(BPF_JMP | BPF_JNE | BPF_K, 5, 0, kToPass - 9, kEtherTypeLow),
+        insn(BPF_LDX | BPF_B | BPF_MEM, 5, 2, static_cast<std::int16_t>(kFirstCommandOffset), 0),
+        insn(BPF_JMP | BPF_JLT | BPF_K, 5, 0, kToPass - 11, kFirstCyclicCommand),
+        insn(BPF_JMP | BPF_JGT | BPF_K, 5, 0, kToPass - 12, kLastCyclicCommand),
+        insn(BPF_LDX | BPF_W | BPF_MEM, 2, 1, offsetof(xdp_md, rx_queue_index), 0),
+        insn(BPF_LD | BPF_DW | BPF_IMM, 1, BPF_PSEUDO_MAP_FD, 0, mapFd),
+        insn(0, 0, 0, 0, 0),
+        // Low flag bits are the action when the queue has no socket in the map.
+        insn(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0, XDP_PASS),
+        insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+        insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        insn(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, XDP_PASS),
+        insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+    };
+}
+
+std::uint32_t loadAcquire(const std::uint32_t* index) { return __atomic_load_n(index, __ATOMIC_ACQUIRE); }
+
+void storeRelease(std::uint32_t* index, std::uint32_t value) { __atomic_store_n(index, value, __ATOMIC_RELEASE); }
+
+} // namespace
+
+XdpSocket::~XdpSocket() { close(); }
+
+bool XdpSocket::open(const std::string& ifname, const XdpSocketOptions& options, std::string& outError) {
+    close();
+    const auto ifIndex = ::if_nametoindex(ifname.c_str());
+    if (ifIndex == 0U) {
+        outError = errnoText("if_nametoindex()");
+        return false;
+    }
+    if (options.frameCount < 4U || (options.frameCount & (options.frameCount - 1U)) != 0U ||
+        (options.frameSize != 2048U && options.frameSize != 4096U)) {
+        outError = "invalid AF_XDP UMEM geometry (frameCount power of two >= 4, frameSize 2048 or 4096)";
+        return false;
+    }
+    options_ = options;
+
+    fd_ = ::socket(AF_XDP, SOCK_RAW, 0);
+    if (fd_ < 0) {
+        outError = errnoText("socket(AF_XDP)");
+        return false;
+    }
+    umemSize_ = static_cast<std::size_t>(options_.frameCount) * options_.frameSize;
+    void* umem = ::mmap(nullptr, umemSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (umem == MAP_FAILED) {
+        outError = errnoText("mmap(UMEM)");
+        close();
+        return false;
+    }
+    umem_ = static_cast<std::uint8_t*>(umem);
+    xdp_umem_reg reg {};
+    reg.addr = reinterpret_cast<std::uintptr_t>(umem_);
+    reg.len = umemSize_;
+    reg.chunk_size = options_.frameSize;
+    if (::setsockopt(fd_, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0) {
+        outError = errnoText("setsockopt(XDP_UMEM_REG)");
+        close();
+        return false;
+    }
+    if (!setupRings(outError)) {
+        close();
+        return false;
+    }
+
+    rings_.reset(umem_, options_.frameCount, options_.frameSize, fill_.ring, completion_.ring, rx_.ring, tx_.ring);
+
+    sockaddr_xdp address {};
+    address.sxdp_family = AF_XDP;
+    address.sxdp_ifindex = ifIndex;
+    address.sxdp_queue_id = options_.queueId;
+    bool bound = false;
+    if (options_.zeroCopy) {
+        address.sxdp_flags = XDP_ZEROCOPY;
+        bound = (::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    }
+    zeroCopy_ = bound;
+    if (!bound) {
+        address.sxdp_flags = XDP_COPY;
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            outError = errnoText("bind(AF_XDP)");
+            close();
+            return false;
+        }
+    }
+
+    if (!attachProgram(static_cast<int>(ifIndex), outError)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool XdpSocket::setupRings(std::string& outError) {
+    const std::uint32_t entries = options_.frameCount / 2U;
+    const int ringOptions[] = {XDP_UMEM_FILL_RING, XDP_UMEM_COMPLETION_RING, XDP_RX_RING, XDP_TX_RING};
+    for (const int option : ringOptions) {
+        if (::setsockopt(fd_, SOL_XDP, option, &entries, sizeof(entries)) < 0) {
+            outError = errnoText("setsockopt(XDP ring size)");
+            return false;
+        }
+    }
+    xdp_mmap_offsets offsets {};
+    socklen_t length = sizeof(offsets);
+    if (::getsockopt(fd_, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &length) < 0) {
+        outError = errnoText("getsockopt(XDP_MMAP_OFFSETS)");
+        return false;
+    }
+
+    auto mapRing = [&](MappedRing& mapped, const xdp_ring_offset& offset, std::size_t descSize, off_t pageOffset) {
+        mapped.mapSize = static_cast<std::size_t>(offset.desc) + entries * descSize;
+        void* map = ::mmap(nullptr, mapped.mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                           pageOffset);
+        if (map == MAP_FAILED) {
+            outError = errnoText("mmap(XDP ring)");
+            return false;
+        }
+        auto* base = static_cast<std::uint8_t*>(map);
+        mapped.map = map;
+        auto& ring = mapped.ring;
+        ring.producer = reinterpret_cast<std::uint32_t*>(base + offset.producer);
+        ring.consumer = reinterpret_cast<std::uint32_t*>(base + offset.consumer);
+        ring.descs = base + offset.desc;
+        ring.mask = entries - 1U;
+        return true;
+    };
+    return mapRing(fill_, offsets.fr, sizeof(std::uint64_t), static_cast<off_t>(XDP_UMEM_PGOFF_FILL_RING)) &&
+           mapRing(completion_, offsets.cr, sizeof(std::uint64_t),
+                   static_cast<off_t>(XDP_UMEM_PGOFF_COMPLETION_RING)) &&
+           mapRing(rx_, offsets.rx, sizeof(xdp_desc), XDP_PGOFF_RX_RING) &&
+           mapRing(tx_, offsets.tx, sizeof(xdp_desc), XDP_PGOFF_TX_RING);
+}
+
+bool XdpSocket::attachProgram(int ifIndex, std::string& outError) {
+    bpf_attr attr {};
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(std::uint32_t);
+    attr.value_size = sizeof(std::uint32_t);
+    attr.max_entries = options_.queueId + 1U;
+    mapFd_ = bpfCall(BPF_MAP_CREATE, attr);
+    if (mapFd_ < 0) {
+        outError = errnoText("bpf(BPF_MAP_CREATE)");
+        return false;
+    }
+
+    const auto program = steeringProgram(mapFd_);
+    static const char kLicense[] = "GPL";
+    attr = bpf_attr{};
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.expected_attach_type = BPF_XDP;
+    attr.insns = reinterpret_cast<std::uintptr_t>(program.data());
+    attr.insn_cnt = static_cast<std::uint32_t>(program.size());
+    attr.license = reinterpret_cast<std::uintptr_t>(kLicense);
+    progFd_ = bpfCall(BPF_PROG_LOAD, attr);
+    if (progFd_ < 0) {
+        outError = errnoText("bpf(BPF_PROG_LOAD)");
+        return false;
+    }
+
+    // Drivers without native XDP still run the program in the generic (SKB) hook.
+    const std::uint32_t modes[] = {XDP_FLAGS_DRV_MODE, XDP_FLAGS_SKB_MODE};
+    for (const auto mode : modes) {
+        if (mode == XDP_FLAGS_DRV_MODE && !options_.nativeMode) {
+            continue;
+        }
+        attr = bpf_attr{};
+        attr.link_create.prog_fd = static_cast<std::uint32_t>(progFd_);
+        attr.link_create.target_ifindex = static_cast<std::uint32_t>(ifIndex);
+        attr.link_create.attach_type = BPF_XDP;
+        attr.link_create.flags = mode;
+        linkFd_ = bpfCall(BPF_LINK_CREATE, attr);
+        if (linkFd_ >= 0) {
+            nativeMode_ = (mode == XDP_FLAGS_DRV_MODE);
+            break;
+        }
+    }
+    if (linkFd_ < 0) {
+        outError = errnoText("bpf(BPF_LINK_CREATE)");
+        return false;
+    }
+
+    const std::uint32_t key = options_.queueId;
+    const auto value = static_cast<std::uint32_t>(fd_);
+    attr = bpf_attr{};
+    attr.map_fd = static_cast<std::uint32_t>(mapFd_);
+    attr.key = reinterpret_cast<std::uintptr_t>(&key);
+    attr.value = reinterpret_cast<std::uintptr_t>(&value);
+    attr.flags = BPF_ANY;
+    if (bpfCall(BPF_MAP_UPDATE_ELEM, attr) < 0) {
+        outError = errnoText("bpf(BPF_MAP_UPDATE_ELEM)");
+        return false;
+    }
+    return true;
+}
+
+void XdpSocket::close() {
+    // Detach the program first so no frame is redirected to a closing socket.
+    for (int* fd : {&linkFd_, &progFd_, &mapFd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    rings_.clear();
+    for (MappedRing* ring : {&fill_, &completion_, &rx_, &tx_}) {
+        if (ring->map != nullptr) {
+            ::munmap(ring->map, ring->mapSize);
+        }
+        *ring = MappedRing{};
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (umem_ != nullptr) {
+        ::munmap(umem_, umemSize_);
+        umem_ = nullptr;
+        umemSize_ = 0;
+    }
+    zeroCopy_ = false;
+    nativeMode_ = false;
+}
+
+bool XdpSocket::send(const std::vector<std::uint8_t>& frame, std::string& outError) {
+    if (fd_ < 0) {
+        outError = "AF_XDP socket not open";
+        return false;
+    }
+    if (!rings_.queueTx(frame, outError)) {
+        return false;
+    }
+    // Copy mode and most zero-copy drivers transmit only when kicked.
+    if (::sendto(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, 0) < 0 && errno != EAGAIN && errno != EBUSY &&
+        errno != ENOBUFS) {
+        outError = errnoText("sendto(AF_XDP)");
+        return false;
+    }
+    return true;
+}
+
+ssize_t XdpSocket::receive(void* buffer, std::size_t size) {
+    if (fd_ < 0) {
+        errno = EBADF;
+        return -1;
+    }
+    return rings_.receive(buffer, size);
+}
+
+XdpSocketStats XdpSocket::stats() const {
+    XdpSocketStats result = rings_.stats();
+    xdp_statistics kernel {};
+    socklen_t length = sizeof(kernel);
+    if (fd_ >= 0 && ::getsockopt(fd_, SOL_XDP, XDP_STATISTICS, &kernel, &length) == 0) {
+        result.rxDropped = kernel.rx_dropped + kernel.rx_ring_full;
+    }
+    return result;
+}
+
+void XdpRings::reset(std::uint8_t* umem, std::uint32_t frameCount, std::uint32_t frameSize, const Ring& fill,
+                     const Ring& completion, const Ring& rx, const Ring& tx) {
+    umem_ = umem;
+    frameSize_ = frameSize;
+    fill_ = fill;
+    completion_ = completion;
+    rx_ = rx;
+    tx_ = tx;
+    stats_ = XdpSocketStats{};
+
+    // Lower half of the UMEM receives, upper half transmits.
+    const std::uint32_t half = frameCount / 2U;
+    const auto producer = *fill_.producer;
+    auto* fillDescs = static_cast<std::uint64_t*>(fill_.descs);
+    for (std::uint32_t i = 0; i < half; ++i) {
+        fillDescs[(producer + i) & fill_.mask] = static_cast<std::uint64_t>(i) * frameSize_;
+    }
+    storeRelease(fill_.producer, producer + half);
+    freeTxFrames_.clear();
+    for (std::uint32_t i = half; i < frameCount; ++i) {
+        freeTxFrames_.push_back(static_cast<std::uint64_t>(i) * frameSize_);
+    }
+}
+
+void XdpRings::clear() {
+    *this = XdpRings{};
+}
+
+void XdpRings::reclaimCompletions() {
+    auto consumer = *completion_.consumer;
+    const auto producer = loadAcquire(completion_.producer);
+    const auto* descs = static_cast<const std::uint64_t*>(completion_.descs);
+    while (consumer != producer) {
+        freeTxFrames_.push_back(descs[consumer & completion_.mask]);
+        ++consumer;
+    }
+    storeRelease(completion_.consumer, consumer);
+}
+
+bool XdpRings::queueTx(const std::vector<std::uint8_t>& frame, std::string& outError) {
+    if (umem_ == nullptr) {
+        outError = "AF_XDP rings not set up";
+        return false;
+    }
+    if (frame.size() > frameSize_) {
+        outError = "frame exceeds AF_XDP frame size";
+        return false;
+    }
+    reclaimCompletions();
+    const auto producer = *tx_.producer;
+    if (freeTxFrames_.empty() || producer - loadAcquire(tx_.consumer) > tx_.mask) {
+        ++stats_.txRingFull;
+        outError = "AF_XDP TX ring full";
+        return false;
+    }
+    const auto address = freeTxFrames_.back();
+    freeTxFrames_.pop_back();
+    std::memcpy(umem_ + address, frame.data(), frame.size());
+    auto& desc = static_cast<xdp_desc*>(tx_.descs)[producer & tx_.mask];
+    desc.addr = address;
+    desc.len = static_cast<std::uint32_t>(frame.size());
+    desc.options = 0U;
+    storeRelease(tx_.producer, producer + 1U);
+    ++stats_.framesSent;
+    return true;
+}
+
+ssize_t XdpRings::receive(void* buffer, std::size_t size) {
+    if (umem_ == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+    const auto consumer = *rx_.consumer;
+    if (consumer == loadAcquire(rx_.producer)) {
+        errno = EAGAIN;
+        return -1;
+    }
+    const auto desc = static_cast<const xdp_desc*>(rx_.descs)[consumer & rx_.mask];
+    const auto length = std::min<std::size_t>(desc.len, size);
+    std::memcpy(buffer, umem_ + desc.addr, length);
+    storeRelease(rx_.consumer, consumer + 1U);
+
+    // Hand the frame straight back; the fill ring holds every RX frame, so it never overflows.
+    const auto fillProducer = *fill_.producer;
+    static_cast<std::uint64_t*>(fill_.descs)[fillProducer & fill_.mask] =
+        desc.addr & ~static_cast<std::uint64_t>(frameSize_ - 1U);
+    storeRelease(fill_.producer, fillProducer + 1U);
+    ++stats_.framesReceived;
+    return static_cast<ssize_t>(length);
+}
+
+bool XdpSocket::isCyclicFrame(const std::uint8_t* data, std::size_t size) {
+    if (data == nullptr || size <= kFirstCommandOffset) {
+        return false;
+    }
+    if (data[12] != kEtherTypeHigh || data[13] != kEtherTypeLow) {
+        return false;
+    }
+    return data[kFirstCommandOffset] >= kFirstCyclicCommand && data[kFirstCommandOffset] <= kLastCyclicCommand;
+}
+
+} // namespace oec
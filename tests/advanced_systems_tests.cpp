@@ -3,21 +3,99 @@
  * @brief openEtherCAT source file.
  */
 
+#include <array>
 #include <cassert>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <thread>
+
+#include <linux/if_xdp.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "openethercat/config/recovery_profile_loader.hpp"
 #include "openethercat/master/coe_mailbox.hpp"
 #include "openethercat/master/distributed_clock.hpp"
+#include "openethercat/master/emergency_queue.hpp"
 #include "openethercat/master/ethercat_master.hpp"
 #include "openethercat/master/hil_campaign.hpp"
 #include "openethercat/master/topology_manager.hpp"
+#include "openethercat/transport/frame_timestamping.hpp"
 #include "openethercat/transport/linux_raw_socket_transport.hpp"
 #include "openethercat/transport/mock_transport.hpp"
+#include "openethercat/transport/receive_wait.hpp"
+#include "openethercat/transport/scheduled_transmit.hpp"
+#include "openethercat/transport/transport_factory.hpp"
+#include "openethercat/transport/xdp_socket.hpp"
+
+namespace {
+// Answers SDO Information requests for a two-object dictionary (0x1018, 0x6000).
+class SdoInfoTransport final : public oec::ITransport {
+public:
+    bool open() override { return true; }
+    void close() override {}
+    bool exchange(const std::vector<std::uint8_t>& tx, std::vector<std::uint8_t>& rx) override {
+        rx.assign(tx.size(), 0U);
+        return true;
+    }
+    std::string lastError() const override { return {}; }
+    bool sdoUpload(std::uint16_t, const oec::SdoAddress& address, std::vector<std::uint8_t>& outData,
+                   std::uint32_t& outAbortCode, std::string&) override {
+        ++uploads;
+        if (address.index != 0x1018U || address.subIndex != 3U) {
+            outAbortCode = 0x06020000U;
+            return false;
+        }
+        outData = {0x05, 0x00, 0x10, 0x00};
+        return true;
+    }
+    bool sdoInfoExchange(std::uint16_t, const std::vector<std::uint8_t>& request, std::vector<std::uint8_t>& outData,
+                         std::uint32_t& outAbortCode, std::string&) override {
+        ++infoRequests;
+        const auto index = static_cast<std::uint16_t>(request[6] | (request[7] << 8U));
+        switch (request[2]) {
+        case 0x01:
+            outData = {0x01, 0x00, 0x18, 0x10, 0x00, 0x60};
+            return true;
+        case 0x03:
+            outData = {request[6], request[7], 0x07, 0x00, static_cast<std::uint8_t>(index == 0x1018U ? 1U : 0U),
+                       static_cast<std::uint8_t>(index == 0x1018U ? 0x09U : 0x07U), 'O', 'b', 'j'};
+            return true;
+        case 0x05:
+            if (index == 0x6000U && request[8] == 0U) {
+                // 16-bit input, read-only and TxPDO mappable.
+                outData = {0x00, 0x60, 0x00, 0x00, 0x06, 0x00, 0x10, 0x00, 0x87, 0x00, 'I', 'n'};
+                return true;
+            }
+            if (index == 0x1018U && request[8] == 1U && entryFault != 0) {
+                // 1: slave refuses the entry, 2: mailbox transport failure.
+                outAbortCode = entryFault == 1 ? 0x08000000U : 0U;
+                return false;
+            }
+            if (index == 0x1018U && request[8] <= 1U) {
+                outData = {0x18, 0x10, request[8], 0x00, 0x07, 0x00,
+                           static_cast<std::uint8_t>(request[8] == 0U ? 8U : 32U), 0x00, 0x07, 0x00};
+                return true;
+            }
+            outAbortCode = 0x06090011U;
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    int infoRequests = 0;
+    int uploads = 0;
+    int entryFault = 0;
+};
+} // namespace
 
 int main() {
     // Mailbox SDO and emergency path via mock transport.
@@ -43,14 +121,45 @@ int main() {
         assert(rd.data.size() == 2);
         assert(rd.data[0] == 0x34);
 
+        // Complete Access writes the whole 0x1C12 assignment and reads it back in one transfer each.
+        const auto caWrite = master.sdoDownloadComplete(2, 0x1C12, {2, 0, 0x00, 0x16, 0x01, 0x16});
+        assert(caWrite.success);
+        const auto sub2 = master.sdoUpload(2, {.index = 0x1C12, .subIndex = 2});
+        assert(sub2.success && sub2.data.size() == 2U && sub2.data[0] == 0x01 && sub2.data[1] == 0x16);
+        const auto caRead = master.sdoUploadComplete(2, 0x1C12);
+        assert(caRead.success);
+        assert((caRead.data == std::vector<std::uint8_t>{2, 0, 0x00, 0x16, 0x01, 0x16}));
+        const auto entriesOnly = master.sdoUploadComplete(2, 0x1C12, false);
+        assert(entriesOnly.success && entriesOnly.data.size() == 4U);
+        const auto missing = master.sdoUploadComplete(2, 0x1C13);
+        assert(!missing.success && missing.abort.has_value() && missing.abort->code == 0x06020000U);
+        // A Complete Access write to a static object drops its cached sub-indices.
+        assert(master.sdoDownloadComplete(2, 0x1018, {1, 0, 0x11, 0x22, 0x33, 0x44}).success);
+        const auto vendorBefore = master.sdoUpload(2, {.index = 0x1018, .subIndex = 1});
+        assert(vendorBefore.success && vendorBefore.data[0] == 0x11);
+        assert(master.sdoDownloadComplete(2, 0x1018, {1, 0, 0x55, 0x66, 0x77, 0x88}).success);
+        const auto vendorAfter = master.sdoUpload(2, {.index = 0x1018, .subIndex = 1});
+        assert(vendorAfter.success && vendorAfter.data[0] == 0x55);
+
         transport.enqueueEmergency({.errorCode = 0x8130, .errorRegister = 0x10, .manufacturerData = {1,2,3,4,5}, .slavePosition = 2});
         const auto emergencies = master.drainEmergencies(4);
         assert(emergencies.size() == 1);
         assert(emergencies[0].errorCode == 0x8130);
+        assert(emergencies[0].timestampNs != 0U);
+
+        // Cyclic collection stamps the cycle index; consumers pop without the master lock.
+        transport.enqueueEmergency({.errorCode = 0x2310, .errorRegister = 0x02, .manufacturerData = {}, .slavePosition = 2});
+        const auto cycleBefore = master.statistics().cyclesTotal;
+        assert(master.runCycle());
+        oec::EmergencyMessage cyclic{};
+        assert(master.emergencyQueue().pop(cyclic));
+        assert(cyclic.errorCode == 0x2310 && cyclic.cycleIndex == cycleBefore);
+        assert(!master.emergencyQueue().pop(cyclic));
 
         std::string foeError;
-        assert(master.foeWriteFile(2, {.fileName = "firmware.bin", .password = 0}, {1, 2, 3, 4}, foeError));
-        const auto foeRead = master.foeReadFile(2, {.fileName = "firmware.bin", .password = 0});
+        assert(master.foeWriteFile(2, {.fileName = "firmware.bin", .password = 0, .maxChunkBytes = 1024, .onProgress = {}},
+                                  {1, 2, 3, 4}, foeError));
+        const auto foeRead = master.foeReadFile(2, {.fileName = "firmware.bin", .password = 0, .maxChunkBytes = 1024, .onProgress = {}});
         assert(foeRead.success);
         assert(foeRead.data.size() == 4);
 
@@ -63,6 +172,94 @@ int main() {
         master.stop();
     }
 
+    // Emergency queue: deduplication, per-slave token bucket, overflow and concurrent producers.
+    {
+        oec::EmergencyRateLimitOptions limits;
+        limits.tokensPerSecond = 10.0;
+        limits.burst = 2;
+        limits.dedupWindow = std::chrono::milliseconds(100);
+        oec::EmergencyQueue queue(8, limits);
+        const std::uint64_t t0 = 1'000'000'000ULL;
+        auto emcy = [](std::uint16_t slave, std::uint16_t code, std::uint64_t ts) {
+            oec::EmergencyMessage m{};
+            m.slavePosition = slave;
+            m.errorCode = code;
+            m.timestampNs = ts;
+            return m;
+        };
+
+        assert(queue.offer(emcy(1, 0x8130, t0)));
+        assert(!queue.offer(emcy(1, 0x8130, t0 + 1'000'000ULL)));
+        assert(!queue.offer(emcy(1, 0x8130, t0 + 2'000'000ULL)));
+        assert(queue.offer(emcy(1, 0x7500, t0 + 3'000'000ULL)));
+        // Bucket of slave 1 is empty; slave 2 still gets through.
+        assert(!queue.offer(emcy(1, 0x5000, t0 + 4'000'000ULL)));
+        assert(queue.offer(emcy(2, 0x8130, t0 + 4'000'000ULL)));
+        // After the window and one refilled token, the repeat reports what was folded.
+        assert(queue.offer(emcy(1, 0x8130, t0 + 200'000'000ULL)));
+        const auto stats = queue.stats();
+        assert(stats.accepted == 4U && stats.deduplicated == 2U && stats.rateLimited == 1U);
+        const auto drained = queue.drain(16);
+        assert(drained.size() == 4U);
+        assert(drained[0].repeatCount == 0U && drained[3].errorCode == 0x8130 && drained[3].repeatCount == 2U);
+
+        // A burst with no later message is flushed once its window closes, carrying the other repeats.
+        assert(!queue.offer(emcy(1, 0x8130, t0 + 250'000'000ULL)));
+        assert(!queue.offer(emcy(1, 0x8130, t0 + 260'000'000ULL)));
+        assert(!queue.offer(emcy(1, 0x8130, t0 + 270'000'000ULL)));
+        assert(queue.flushSuppressed(t0 + 280'000'000ULL) == 0U);
+        assert(queue.flushSuppressed(t0 + 300'000'000ULL) == 1U);
+        assert(queue.flushSuppressed(t0 + 900'000'000ULL) == 0U);
+        oec::EmergencyMessage flushed{};
+        assert(queue.pop(flushed) && !queue.pop(flushed));
+        assert(flushed.errorCode == 0x8130 && flushed.timestampNs == t0 + 270'000'000ULL && flushed.repeatCount == 2U);
+
+        // Neither stage is on unless asked for.
+        const oec::EmergencyRateLimitOptions defaults;
+        assert(defaults.tokensPerSecond == 0.0 && defaults.dedupWindow.count() == 0);
+
+        oec::EmergencyRateLimitOptions unlimited;
+        unlimited.tokensPerSecond = 0.0;
+        unlimited.dedupWindow = std::chrono::milliseconds(0);
+        oec::EmergencyQueue small(4, unlimited);
+        for (std::uint16_t i = 0; i < 6; ++i) {
+            (void)small.offer(emcy(3, i, t0));
+        }
+        assert(small.stats().overflowDropped == 2U);
+        const auto kept = small.drain(8);
+        assert(kept.size() == 4U && kept.front().errorCode == 0U && kept.back().errorCode == 3U);
+
+        oec::EmergencyRing ring(1024);
+        auto produce = [&ring](std::uint16_t slave) {
+            for (std::uint16_t i = 0; i < 400; ++i) {
+                oec::EmergencyMessage m{};
+                m.slavePosition = slave;
+                m.errorCode = i;
+                while (!ring.tryPush(m)) {
+                    std::this_thread::yield();
+                }
+            }
+        };
+        std::thread first(produce, 1);
+        std::thread second(produce, 2);
+        std::uint16_t nextCode[3] = {0, 0, 0};
+        std::size_t received = 0;
+        while (received < 800U) {
+            oec::EmergencyMessage m{};
+            if (!ring.tryPop(m)) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Per-producer order is preserved.
+            assert(m.errorCode == nextCode[m.slavePosition]);
+            ++nextCode[m.slavePosition];
+            ++received;
+        }
+        first.join();
+        second.join();
+        assert(ring.sizeApprox() == 0U);
+    }
+
     // FoE edge cases on mock transport: missing file and overwrite semantics.
     {
         oec::MockTransport transport(1, 1);
@@ -70,7 +267,7 @@ int main() {
 
         std::string error;
         oec::FoEResponse read{};
-        const oec::FoERequest req{.fileName = "missing.bin", .password = 0, .maxChunkBytes = 64};
+        const oec::FoERequest req{.fileName = "missing.bin", .password = 0, .maxChunkBytes = 64, .onProgress = {}};
         const bool missingOk = transport.foeRead(1, req, read, error);
         assert(!missingOk);
         assert(!read.success);
@@ -92,9 +289,214 @@ int main() {
         assert(read.data[0] == 0xAAU);
         assert(read.data[1] == 0xBBU);
 
+        // Streaming write/read with progress, and a multi-slave job list.
+        std::vector<std::uint8_t> image(200U);
+        for (std::size_t i = 0; i < image.size(); ++i) {
+            image[i] = static_cast<std::uint8_t>(i);
+        }
+        std::vector<oec::FoEProgress> progress;
+        oec::FoERequest streamReq = req;
+        streamReq.onProgress = [&progress](const oec::FoEProgress& p) { progress.push_back(p); };
+        oec::FoEMemorySource source(image);
+        assert(transport.foeWriteStream(1, streamReq, source, error));
+        assert(progress.size() == 4U);
+        assert(progress.back().bytesTransferred == 200U && progress.back().totalBytes == 200U);
+
+        // The source is pulled one packet at a time, each packet lands before its progress callback,
+        // and the next pull only follows that callback.
+        std::vector<std::string> events;
+        std::size_t pulled = 0U;
+        oec::FoECallbackSource pacedSource(
+            [&](std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string&) {
+                assert(capacity == 64U);
+                outBytes = std::min<std::size_t>(capacity, image.size() - pulled);
+                std::copy_n(image.begin() + static_cast<std::ptrdiff_t>(pulled), outBytes, buffer);
+                pulled += outBytes;
+                events.push_back("read " + std::to_string(outBytes));
+                return true;
+            });
+        oec::FoERequest pacedReq = req;
+        pacedReq.fileName = "paced.bin";
+        pacedReq.onProgress = [&](const oec::FoEProgress& p) {
+            oec::FoEResponse partial;
+            std::string partialError;
+            assert(transport.foeRead(1, pacedReq, partial, partialError));
+            assert(partial.data.size() == p.bytesTransferred && p.bytesTransferred == pulled);
+            events.push_back("progress " + std::to_string(p.packets));
+        };
+        assert(transport.foeWriteStream(1, pacedReq, pacedSource, error));
+        assert((events == std::vector<std::string>{"read 64", "progress 1", "read 64", "progress 2", "read 64",
+                                                   "progress 3", "read 8", "progress 4"}));
+
+        std::vector<std::uint8_t> streamed;
+        oec::FoEVectorSink sink(streamed);
+        assert(transport.foeReadStream(1, req, sink, error));
+        assert(streamed == image);
+
+        std::size_t callbackCursor = 0U;
+        oec::FoECallbackSource callbackSource(
+            [&](std::uint8_t* buffer, std::size_t capacity, std::size_t& outBytes, std::string&) {
+                outBytes = std::min<std::size_t>(capacity, 10U - callbackCursor);
+                std::fill_n(buffer, outBytes, 0x5AU);
+                callbackCursor += outBytes;
+                return true;
+            });
+        oec::FoEMemorySource second(image);
+        std::vector<oec::FoEWriteJob> jobs(3U);
+        jobs[0].slavePosition = 1;
+        jobs[0].request.fileName = "a.bin";
+        jobs[0].source = &callbackSource;
+        jobs[1].slavePosition = 2;
+        jobs[1].request.fileName = "b.bin";
+        jobs[1].source = &second;
+        jobs[2].slavePosition = 3;
+        assert(!transport.foeWriteStreams(jobs, error));
+        assert(jobs[0].success && jobs[1].success && !jobs[2].success);
+        assert(error.find("slave 3") != std::string::npos);
+        oec::FoEResponse a;
+        assert(transport.foeRead(1, {.fileName = "a.bin", .password = 0, .maxChunkBytes = 1024, .onProgress = {}}, a, error));
+        assert((a.data == std::vector<std::uint8_t>(10U, 0x5AU)));
+
+        const auto imagePath = (std::filesystem::temp_directory_path() / "oec_foe_stream_test.bin").string();
+        {
+            std::ofstream out(imagePath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        }
+        oec::FoEMappedFileSource mapped;
+        assert(mapped.open(imagePath, error) && mapped.sizeHint() == image.size());
+        assert(transport.foeWriteStream(2, req, mapped, error));
+        const auto readBack = (std::filesystem::temp_directory_path() / "oec_foe_stream_read.bin").string();
+        {
+            std::FILE* file = std::fopen(readBack.c_str(), "w+b");
+            assert(file != nullptr);
+            oec::FoEFdSink fdSink(fileno(file));
+            assert(transport.foeReadStream(2, req, fdSink, error));
+            std::fclose(file);
+        }
+        assert(std::filesystem::file_size(readBack) == image.size());
+        std::filesystem::remove(imagePath);
+        std::filesystem::remove(readBack);
+
+        // Whole-line update: BOOTSTRAP, interleaved writes, read-back verify, back to PRE-OP.
+        oec::FoEMemorySource fw1(image);
+        oec::FoEMemorySource fw1Verify(image);
+        oec::FoEMemorySource fw2(image);
+        std::vector<oec::FirmwareUpdateJob> update(3U);
+        update[0].slavePosition = 1;
+        update[0].fileName = "fw.efw";
+        update[0].image = &fw1;
+        update[0].verifyImage = &fw1Verify;
+        update[1].slavePosition = 2;
+        update[1].fileName = "fw.efw";
+        update[1].image = &fw2;
+        update[2].slavePosition = 3;
+        update[2].fileName = "fw.efw";
+        oec::FirmwareUpdateOptions updateOptions;
+        updateOptions.pollInterval = std::chrono::milliseconds(1);
+        updateOptions.maxChunkBytes = 64;
+        std::size_t progressCalls = 0U;
+        updateOptions.onProgress = [&progressCalls](const oec::FoEProgress&) { ++progressCalls; };
+        // The mock now refuses INIT -> BOOT without the bootstrap mailbox and INIT -> SAFEOP/OP jumps.
+        transport.setEnforceAlTransitions(true);
+        const auto fwReport = oec::FirmwareUpdateOrchestrator(transport).run(update, updateOptions);
+        assert(!fwReport.success);
+        assert(fwReport.slaves.size() == 3U);
+        assert(fwReport.slaves[0].success && fwReport.slaves[0].verified);
+        assert(fwReport.slaves[0].bytesWritten == image.size());
+        assert(fwReport.slaves[1].success && !fwReport.slaves[1].verified);
+        assert(!fwReport.slaves[2].success && fwReport.slaves[2].error == "no firmware image");
+        assert(progressCalls == 8U);
+        oec::SlaveState fwState = oec::SlaveState::Init;
+        assert(transport.readSlaveState(1, fwState) && fwState == oec::SlaveState::PreOp);
+        assert(transport.requestSlaveState(1, oec::SlaveState::Init));
+        assert(!transport.requestSlaveState(1, oec::SlaveState::Bootstrap));
+        assert(!transport.requestSlaveState(1, oec::SlaveState::Op));
+        oec::FoEMemorySource fwOp(image);
+        std::vector<oec::FirmwareUpdateJob> toOp(1U);
+        toOp[0].slavePosition = 1;
+        toOp[0].fileName = "fw.efw";
+        toOp[0].image = &fwOp;
+        updateOptions.finalState = oec::SlaveState::Op;
+        const auto opReport = oec::FirmwareUpdateOrchestrator(transport).run(toOp, updateOptions);
+        assert(opReport.success && opReport.slaves[0].error.empty());
+        assert(transport.readSlaveState(1, fwState) && fwState == oec::SlaveState::Op);
+
         transport.close();
     }
 
+    // EoE gateway over the mock's per-slave loopback: fragments out, reassembled frame back.
+    {
+        struct QueueEndpoint : oec::EoeEndpoint {
+            std::vector<std::vector<std::uint8_t>> toSlave;
+            std::vector<std::vector<std::uint8_t>> fromSlave;
+            bool readFrame(std::vector<std::uint8_t>& outFrame) override {
+                if (toSlave.empty()) {
+                    return false;
+                }
+                outFrame = toSlave.front();
+                toSlave.erase(toSlave.begin());
+                return true;
+            }
+            bool writeFrame(const std::vector<std::uint8_t>& frame) override {
+                fromSlave.push_back(frame);
+                return true;
+            }
+        };
+
+        oec::MockTransport transport(1, 1);
+        assert(transport.open());
+        oec::EoeGatewayOptions options;
+        options.maxQueuedFrames = 2U;
+        options.budget = std::chrono::microseconds(1000000);
+        oec::EoeGateway gateway(transport, options);
+        QueueEndpoint endpoint;
+        std::string error;
+        assert(gateway.addSlave(1, endpoint, error));
+        assert(!gateway.addSlave(1, endpoint, error));
+
+        std::vector<std::uint8_t> frame(300U, 0xA5U);
+        endpoint.toSlave = {frame, frame, frame};
+        assert(gateway.service(error) == 18U);
+        assert(endpoint.toSlave.empty());
+        assert(endpoint.fromSlave.size() == 3U && endpoint.fromSlave[2] == frame);
+        const auto stats = gateway.stats();
+        assert(stats.txFrames == 3U && stats.rxFrames == 3U && stats.txFragments == 9U);
+        assert(stats.fallbackRounds > 0U && stats.batchedRounds == 0U && stats.reassemblyDrops == 0U);
+        assert(gateway.queuedFrames(1) == 0U);
+
+        // A 70-byte SM0 leaves 64-byte EoE payloads: 32 data bytes per fragment but the last, 9 for 300 bytes.
+        transport.setMailboxWriteSize(2, 70U);
+        QueueEndpoint smallWindow;
+        assert(gateway.addSlave(2, smallWindow, error));
+        smallWindow.toSlave = {frame};
+        assert(gateway.service(error) == 18U);
+        assert(smallWindow.fromSlave.size() == 1U && smallWindow.fromSlave[0] == frame);
+        assert(gateway.stats().txFragments == 18U && gateway.stats().txFragmentRetries == 0U);
+        transport.close();
+
+        // A fragment the slave never accepts is dropped after maxFragmentRetries rounds.
+        struct RefusingTransport : oec::ITransport {
+            bool open() override { return true; }
+            void close() override {}
+            bool exchange(const std::vector<std::uint8_t>&, std::vector<std::uint8_t>&) override { return true; }
+            std::string lastError() const override { return {}; }
+        };
+        RefusingTransport refusing;
+        oec::EoeGatewayOptions refusingOptions;
+        refusingOptions.maxFragmentRetries = 3U;
+        oec::EoeGateway stuck(refusing, refusingOptions);
+        QueueEndpoint stuckEndpoint;
+        assert(stuck.addSlave(1, stuckEndpoint, error));
+        stuckEndpoint.toSlave = {frame};
+        for (int round = 0; round < 2; ++round) {
+            assert(stuck.service(error) == 0U);
+        }
+        assert(stuck.queuedFrames(1) == 1U && stuck.stats().txFramesDropped == 0U);
+        assert(stuck.service(error) == 0U);
+        assert(stuck.queuedFrames(1) == 0U);
+        assert(stuck.stats().txFramesDropped == 1U && stuck.stats().txFragmentRetries == 3U);
+    }
+
     // EoE edge cases on mock transport: per-slave queue filtering and ordering.
     {
         oec::MockTransport transport(1, 1);
@@ -126,7 +528,7 @@ int main() {
         oec::LinuxRawSocketTransport transport("eth0");
         std::string error;
         oec::FoEResponse foeReadRsp{};
-        const oec::FoERequest req{.fileName = "guard.bin", .password = 0, .maxChunkBytes = 128};
+        const oec::FoERequest req{.fileName = "guard.bin", .password = 0, .maxChunkBytes = 128, .onProgress = {}};
 
         assert(!transport.foeRead(1, req, foeReadRsp, error));
         assert(error.find("not open") != std::string::npos);
@@ -146,8 +548,19 @@ int main() {
         assert(!transport.eoeReceive(1, frame, error));
         assert(error.find("not open") != std::string::npos);
 
+        // Cyclic DC distribution: nothing read until an exchange carried the ARMW.
+        transport.setDcReferenceDistribution(true, 0U);
+        assert(transport.dcReferenceDistribution());
+        std::int64_t referenceTime = 0;
+        assert(!transport.lastDcReferenceTime(referenceTime));
+        transport.queueDcReferenceOffset(1234);
+        std::vector<std::uint8_t> rx(1U, 0U);
+        assert(!transport.exchange({0x00}, rx));
+        assert(transport.dcDiagnostics().schemaVersion == 2U && transport.dcDiagnostics().cyclicReferenceReads == 0U);
+        transport.setDcReferenceDistribution(false, 0U);
+
         const auto d = transport.mailboxDiagnostics();
-        assert(d.schemaVersion == 2U);
+        assert(d.schemaVersion == 3U);
         assert(d.foeReadStarted == 1U);
         assert(d.foeReadFailed == 1U);
         assert(d.foeWriteStarted == 1U);
@@ -172,6 +585,264 @@ int main() {
         assert(stats.jitterRmsNs > 0.0);
     }
 
+    // DC controllers compared on synthetic traces: PI versus fixed-point drift tracking.
+    {
+        // Plant: measured offset = disturbance - correction applied after the previous sample.
+        struct Run {
+            std::size_t lockSample;
+            double jitterRmsNs;
+            std::size_t recoverySamples;
+        };
+        auto simulate = [](oec::DistributedClockController::Options options, auto disturbance, std::size_t samples,
+                           std::size_t stepSample) {
+            oec::DistributedClockController dc(options);
+            std::int64_t applied = 0;
+            std::vector<std::int64_t> measured;
+            for (std::size_t k = 0; k < samples; ++k) {
+                const auto offset = disturbance(k) - applied;
+                measured.push_back(offset);
+                const auto correction = dc.update({.referenceTimeNs = 1'000'000 * static_cast<std::int64_t>(k) + offset,
+                                                   .localTimeNs = 1'000'000 * static_cast<std::int64_t>(k)});
+                applied = correction.value_or(applied);
+            }
+            // Locked: |offset| <= 200 ns for 50 consecutive samples.
+            auto settle = [&](std::size_t from) {
+                std::size_t run = 0;
+                for (std::size_t k = from; k < measured.size(); ++k) {
+                    run = (std::llabs(measured[k]) <= 200) ? run + 1U : 0U;
+                    if (run == 50U) {
+                        return k + 1U - 50U - from;
+                    }
+                }
+                return measured.size();
+            };
+            double sum = 0.0;
+            const std::size_t tail = 300U;
+            for (std::size_t k = measured.size() - tail; k < measured.size(); ++k) {
+                sum += static_cast<double>(measured[k]) * static_cast<double>(measured[k]);
+            }
+            return Run{settle(0), std::sqrt(sum / static_cast<double>(tail)), settle(stepSample)};
+        };
+        std::uint32_t lcg = 12345U;
+        std::vector<std::int64_t> noise(1000);
+        for (auto& n : noise) {
+            lcg = lcg * 1664525U + 1013904223U;
+            n = static_cast<std::int64_t>((lcg >> 16U) % 51U) - 25;
+        }
+        oec::DistributedClockController::Options pi{};
+        oec::DistributedClockController::Options tracking{};
+        tracking.algorithm = oec::DistributedClockController::Algorithm::DriftTracking;
+
+        // 40 ns/cycle drift (40 ppm at 1 ms) from a 5 us initial offset, +-25 ns measurement noise.
+        auto drift = [&](std::size_t k) { return 5000 + 40 * static_cast<std::int64_t>(k) + noise[k]; };
+        const auto piDrift = simulate(pi, drift, 1000U, 0U);
+        const auto trackDrift = simulate(tracking, drift, 1000U, 0U);
+        assert(trackDrift.lockSample < piDrift.lockSample);
+        assert(trackDrift.lockSample < 100U);
+        assert(trackDrift.jitterRmsNs < 60.0);
+        assert(trackDrift.jitterRmsNs < piDrift.jitterRmsNs);
+        oec::DistributedClockController probe(tracking);
+        for (std::size_t k = 0; k < 400U; ++k) {
+            const auto c = probe.update({.referenceTimeNs = 40 * static_cast<std::int64_t>(k), .localTimeNs = 0});
+            probe.notifyApplied(0);
+            (void)c;
+        }
+        assert(std::abs(probe.stats().estimatedDriftNs - 40.0) < 1.0);
+
+        // Windup: 20 us offset against a 2 us clamp for 300 samples, then back to zero.
+        pi.correctionClampNs = 2000;
+        tracking.correctionClampNs = 2000;
+        auto windup = [&](std::size_t k) { return ((k < 300U) ? 20'000 : 0) + noise[k]; };
+        const auto piWindup = simulate(pi, windup, 900U, 300U);
+        const auto trackWindup = simulate(tracking, windup, 900U, 300U);
+        assert(trackWindup.recoverySamples < 20U);
+        assert(trackWindup.recoverySamples < piWindup.recoverySamples);
+    }
+
+    // Line-wide DC monitor: 0x092C decoding, decimation, per-slave histograms and the worst slave.
+    {
+        assert(oec::decodeDcSystemTimeDifference(0x00000064U) == 100);
+        assert(oec::decodeDcSystemTimeDifference(0x80000064U) == -100);
+        assert(oec::decodeDcSystemTimeDifference(0xFFFFFFFFU) == -0x7FFFFFFFLL);
+
+        oec::DcLineMonitor monitor({.enabled = true, .decimation = 4, .bucketWidthNs = 10, .bucketCount = 8});
+        std::size_t due = 0;
+        for (int i = 0; i < 12; ++i) {
+            due += monitor.due() ? 1U : 0U;
+        }
+        assert(due == 3U);
+
+        for (std::int64_t round = 0; round < 100; ++round) {
+            // Slave 1 steady within 5 ns, slave 3 drifts away by 1 ns per round, slave 2 drops out every 10th round.
+            monitor.record({{.slavePosition = 3, .valid = true, .deviationNs = -round},
+                            {.slavePosition = 1, .valid = true, .deviationNs = (round % 2 == 0) ? 4 : -4},
+                            {.slavePosition = 2, .valid = (round % 10) != 0, .deviationNs = 15}});
+        }
+        monitor.recordFailure();
+        const auto line = monitor.snapshot();
+        assert(line.enabled && line.rounds == 101U && line.failedRounds == 1U && line.bucketWidthNs == 10);
+        assert(line.slaves.size() == 3U);
+        assert(line.slaves[0].slavePosition == 1U && line.slaves[1].slavePosition == 2U);
+        assert(line.slaves[0].samples == 100U && line.slaves[0].buckets[0] == 100U);
+        assert(line.slaves[0].p99AbsNs == 10 && !line.slaves[0].p99Saturated);
+        assert(line.slaves[1].missed == 10U && line.slaves[1].samples == 90U && line.slaves[1].buckets[1] == 90U);
+        const auto& drifting = line.slaves[2];
+        assert(drifting.minDeviationNs == -99 && drifting.maxDeviationNs == 0 && drifting.lastDeviationNs == -99);
+        // |deviation| 70..99 all land in the last (overflow) bucket: p99 is saturated and bounded by the largest sample.
+        assert(drifting.buckets[7] == 30U && drifting.p99Saturated && drifting.p99AbsNs == 99);
+        assert(line.worstSlavePosition == 3 && line.worstP99AbsNs == 99 && line.worstP99Saturated);
+        monitor.reset();
+        assert(monitor.snapshot().slaves.empty() && monitor.snapshot().rounds == 0U);
+    }
+
+    // DC bring-up: line into a junction with two 100 ns branches; local clocks skewed, one near 32-bit wrap.
+    {
+        const std::int64_t skew[4] = {5000, 0xFFFFFFC0LL, -300, 42};
+        auto latch = [&](std::uint16_t position, std::uint8_t ports, std::array<std::int64_t, 4> realTimes) {
+            oec::DcPortLatch l;
+            l.slavePosition = position;
+            l.dcSupported = true;
+            l.activePorts = ports;
+            for (std::size_t p = 0; p < 4U; ++p) {
+                l.portReceiveTimeNs[p] = static_cast<std::uint32_t>(realTimes[p] + skew[position]);
+            }
+            l.processingUnitReceiveTimeNs = realTimes[0] + skew[position];
+            return l;
+        };
+        // Frame: s0 p0 @0 -> s1 p0 @100 -> (p3) s2 @200 -> back s1 p3 @300 -> (p1) s3 @400
+        // -> back s1 p1 @500 -> back s0 p1 @600.
+        std::vector<oec::DcPortLatch> latches = {
+            latch(0, 0x03U, {0, 600, 0, 0}),
+            latch(1, 0x0BU, {100, 500, 0, 300}),
+            latch(2, 0x01U, {200, 0, 0, 0}),
+            latch(3, 0x01U, {400, 0, 0, 0}),
+        };
+        oec::DcInitReport report;
+        assert(oec::computeDcTiming(latches, 10'000, report));
+        assert(report.referenceSlavePosition == 0U && report.slaves.size() == 4U);
+        assert(report.slaves[1].parentPosition == 0 && report.slaves[1].parentPort == 1U);
+        assert(report.slaves[2].parentPosition == 1 && report.slaves[2].parentPort == 3U);
+        assert(report.slaves[3].parentPosition == 1 && report.slaves[3].parentPort == 1U);
+        assert(report.slaves[0].propagationDelayNs == 0 && report.slaves[1].propagationDelayNs == 100);
+        assert(report.slaves[2].propagationDelayNs == 200 && report.slaves[3].propagationDelayNs == 200);
+        assert(report.maxPropagationDelayNs == 200);
+        // Every clock lands on the same system time: offset cancels its skew.
+        for (std::size_t i = 0; i < 4U; ++i) {
+            assert(report.slaves[i].systemTimeOffsetNs == 10'000 - skew[i]);
+        }
+
+        latches[0].activePorts = 0x01U;
+        assert(!oec::computeDcTiming(latches, 0, report) && !report.error.empty());
+        for (auto& l : latches) {
+            l.dcSupported = false;
+        }
+        assert(!oec::computeDcTiming(latches, 0, report));
+    }
+
+    // Cyclic DC input frame (ARMW + offset APWR + LRD) through the codec and a simulated slave line.
+    {
+        oec::EthercatDatagramRequest lrd;
+        lrd.command = 0x0A;
+        lrd.adp = 0x1000;
+        lrd.payload.assign(3U, 0U);
+        const auto batch = oec::LinuxRawSocketTransport::buildCyclicInputBatch(0, std::int64_t{-2}, lrd);
+        assert(batch.size() == 3U);
+        assert(batch[0].command == 0x0D && batch[0].adp == 0U && batch[0].ado == 0x0910 && batch[0].payload.size() == 8U);
+        assert(batch[1].command == 0x02 && batch[1].adp == 0U && batch[1].ado == 0x0920);
+        assert(batch[1].payload == std::vector<std::uint8_t>({0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}));
+        assert(batch[2].command == 0x0A && batch[2].payload.size() == 3U);
+
+        // Three DC slaves on a line; each passes the frame on, handling every datagram on the fly.
+        struct SimSlave {
+            std::uint64_t localTime = 0;
+            std::uint64_t latchedSystemTime = 0;
+            std::uint64_t offset = 0;
+            std::uint8_t input = 0;
+        };
+        std::vector<SimSlave> line = {{.localTime = 1000, .input = 0x11},
+                                      {.localTime = 1005, .input = 0x22},
+                                      {.localTime = 990, .input = 0x33}};
+        auto passLine = [&](std::vector<std::uint8_t>& frame, std::size_t answering) {
+            for (std::size_t i = 0; i < answering; ++i) {
+                std::size_t at = 16U;
+                while (at + 12U <= frame.size()) {
+                    const std::uint8_t cmd = frame[at];
+                    const auto adp = static_cast<std::uint16_t>(frame[at + 2] | (frame[at + 3] << 8U));
+                    const std::size_t len = static_cast<std::size_t>(frame[at + 6] | ((frame[at + 7] & 0x07U) << 8U));
+                    const bool more = (frame[at + 7] & 0x80U) != 0U;
+                    std::uint8_t* payload = &frame[at + 10U];
+                    std::uint8_t* wkc = payload + len;
+                    auto readU64 = [&]() {
+                        std::uint64_t v = 0;
+                        for (std::size_t b = 0; b < 8U; ++b) {
+                            v |= static_cast<std::uint64_t>(payload[b]) << (8U * b);
+                        }
+                        return v;
+                    };
+                    if (cmd == 0x0D) {
+                        if (adp == 0U) {
+                            for (std::size_t b = 0; b < 8U; ++b) {
+                                payload[b] = static_cast<std::uint8_t>((line[i].localTime >> (8U * b)) & 0xFFU);
+                            }
+                            ++wkc[0];
+                        } else if (static_cast<std::int16_t>(adp) > 0) {
+                            line[i].latchedSystemTime = readU64();
+                            ++wkc[0];
+                        }
+                    } else if (cmd == 0x02 && adp == 0U) {
+                        line[i].offset = readU64();
+                        ++wkc[0];
+                    } else if (cmd == 0x0A && i < len) {
+                        payload[i] = line[i].input;
+                        ++wkc[0];
+                    }
+                    if (cmd == 0x0D || cmd == 0x02) {
+                        const auto next = static_cast<std::uint16_t>(adp + 1U);
+                        frame[at + 2] = static_cast<std::uint8_t>(next & 0xFFU);
+                        frame[at + 3] = static_cast<std::uint8_t>(next >> 8U);
+                    }
+                    at += 12U + len;
+                    if (!more) {
+                        break;
+                    }
+                }
+            }
+        };
+        const std::uint8_t mac[6] = {0x02, 0, 0, 0, 0, 0x01};
+        auto frame = oec::EthercatFrameCodec::buildMultiDatagramFrame(mac, mac, batch);
+        passLine(frame, line.size());
+        std::vector<oec::EthercatDatagramResponse> responses;
+        assert(oec::EthercatFrameCodec::parseMultiDatagramFrame(frame, responses));
+        oec::LinuxRawSocketTransport::CyclicInputResult result;
+        assert(oec::LinuxRawSocketTransport::decodeCyclicInputBatch(responses, true, result));
+        assert(result.referenceTimeValid && result.referenceTimeNs == 1000);
+        assert(result.offsetWritten && line[0].offset == static_cast<std::uint64_t>(-2));
+        // Every clock behind the reference compared itself with the reference time.
+        assert(line[1].latchedSystemTime == 1000U && line[2].latchedSystemTime == 1000U);
+        assert(result.inputWorkingCounter == 3U);
+        assert(result.inputPayload == std::vector<std::uint8_t>({0x11, 0x22, 0x33}));
+
+        // Line broken after the first slave: the short LRD working counter is reported for the secondary retry.
+        frame = oec::EthercatFrameCodec::buildMultiDatagramFrame(
+            mac, mac, oec::LinuxRawSocketTransport::buildCyclicInputBatch(0, std::nullopt, lrd));
+        passLine(frame, 1U);
+        assert(oec::EthercatFrameCodec::parseMultiDatagramFrame(frame, responses));
+        assert(oec::LinuxRawSocketTransport::decodeCyclicInputBatch(responses, false, result));
+        assert(result.referenceTimeValid && !result.offsetWritten && result.inputWorkingCounter == 1U);
+
+        // Reference missing: no time, and a response count that does not match the batch is rejected.
+        frame = oec::EthercatFrameCodec::buildMultiDatagramFrame(
+            mac, mac, oec::LinuxRawSocketTransport::buildCyclicInputBatch(0, std::nullopt, lrd));
+        assert(oec::EthercatFrameCodec::parseMultiDatagramFrame(frame, responses));
+        assert(oec::LinuxRawSocketTransport::decodeCyclicInputBatch(responses, false, result));
+        assert(!result.referenceTimeValid && result.inputWorkingCounter == 0U);
+        assert(!oec::LinuxRawSocketTransport::decodeCyclicInputBatch(responses, true, result));
+
+        // Before DC init the first DC slave is unknown, so any reference is accepted.
+        oec::LinuxRawSocketTransport transport("eth0");
+        assert(transport.setDcReferenceDistribution(true, 2U) && transport.dcReferenceDistribution());
+    }
+
     // Master DC sync quality monitor lock/loss and degrade policy.
     {
         ::setenv("OEC_DC_SYNC_MONITOR", "1", 1);
@@ -376,6 +1047,82 @@ int main() {
         master.stop();
     }
 
+    // Parallel redundancy: the ring state observed in each exchange drives the policy without topology scans.
+    {
+        oec::MockTransport transport(1, 1);
+        oec::EthercatMaster master(transport);
+
+        oec::NetworkConfiguration cfg;
+        cfg.processImageInputBytes = 1;
+        cfg.processImageOutputBytes = 1;
+        cfg.slaves = {
+            {.name = "EK1100", .alias = 0, .position = 0, .vendorId = 0x2, .productCode = 0x044c2c52},
+        };
+        cfg.signals = {
+            {.logicalName = "InputA", .direction = oec::SignalDirection::Input, .slaveName = "EK1100", .byteOffset = 0, .bitOffset = 0},
+        };
+        assert(master.configure(cfg));
+        auto stateOpts = oec::EthercatMaster::StateMachineOptions{};
+        stateOpts.enable = false;
+        master.setStateMachineOptions(stateOpts);
+        auto topoOpts = oec::EthercatMaster::TopologyRecoveryOptions{};
+        topoOpts.enable = true;
+        topoOpts.redundancyGraceCycles = 2U;
+        topoOpts.redundancyAction = oec::EthercatMaster::TopologyPolicyAction::Monitor;
+        master.setTopologyRecoveryOptions(topoOpts);
+        assert(master.start());
+        transport.setCyclicRedundancyObservation(true);
+
+        for (int i = 0; i < 5; ++i) {
+            assert(master.runCycle());
+        }
+        assert(master.redundancyKpis().degradeEvents == 0U);
+
+        // Cable break: the cycle itself still succeeds, the fault is seen in that same cycle.
+        transport.setRedundancyHealthy(false);
+        assert(master.runCycle());
+        auto kpi = master.redundancyKpis();
+        assert(kpi.degradeEvents == 1U);
+        assert(kpi.lastDetectionLatencyCycles == 1);
+        assert(master.redundancyStatus().state == oec::EthercatMaster::RedundancyState::RedundancyDegraded);
+        assert(kpi.lastPolicyTriggerLatencyMs < 0);
+        assert(master.runCycle());
+        assert(master.redundancyKpis().lastPolicyTriggerLatencyMs >= 0);
+        assert(master.runCycle());
+        std::size_t redundancyEvents = 0;
+        for (const auto& e : master.recoveryEvents()) {
+            redundancyEvents += (e.message.find("redundancy-down") != std::string::npos) ? 1U : 0U;
+        }
+        assert(redundancyEvents == 1U);
+
+        transport.setRedundancyHealthy(true);
+        assert(master.runCycle());
+        assert(master.redundancyStatus().state == oec::EthercatMaster::RedundancyState::RedundantHealthy);
+        kpi = master.redundancyKpis();
+        assert(kpi.recoverEvents == 1U && kpi.lastRecoveryLatencyMs >= 0);
+        assert(kpi.impactedCycles >= 3U);
+
+        // The scan's link check (secondary socket open) disagrees with the broken ring:
+        // topology refreshes must neither clear the fault nor reset the grace count.
+        transport.setRedundancyHealthy(false);
+        transport.setRedundancyLinkHealthy(true);
+        std::string topoError;
+        for (int i = 0; i < 4; ++i) {
+            assert(master.runCycle());
+            assert(master.refreshTopology(topoError));
+            assert(master.redundancyStatus().state == oec::EthercatMaster::RedundancyState::RedundancyDegraded);
+            assert(!master.redundancyStatus().redundancyHealthy);
+        }
+        kpi = master.redundancyKpis();
+        assert(kpi.degradeEvents == 2U && kpi.recoverEvents == 1U);
+        redundancyEvents = 0;
+        for (const auto& e : master.recoveryEvents()) {
+            redundancyEvents += (e.message.find("redundancy-down") != std::string::npos) ? 1U : 0U;
+        }
+        assert(redundancyEvents == 2U);
+        master.stop();
+    }
+
     // HIL conformance evaluator.
     {
         oec::HilKpi kpi;
@@ -413,6 +1160,379 @@ int main() {
         fs::remove(path);
     }
 
+    // Object dictionary scan via SDO Information, cached per device type and on disk.
+    {
+        SdoInfoTransport transport;
+        oec::EthercatMaster master(transport);
+        oec::NetworkConfiguration cfg;
+        cfg.processImageInputBytes = 2;
+        cfg.processImageOutputBytes = 1;
+        cfg.slaves = {{.name = "IO", .alias = 0, .position = 1, .vendorId = 0x2, .productCode = 0x1234},
+                      {.name = "IO2", .alias = 0, .position = 2, .vendorId = 0x2, .productCode = 0x1234}};
+        cfg.signals = {{.logicalName = "In", .direction = oec::SignalDirection::Input, .slaveName = "IO", .byteOffset = 0, .bitOffset = 0}};
+        assert(master.configure(cfg));
+
+        oec::ObjectDictionary od;
+        std::string error;
+        assert(master.objectDictionary(1, od, error));
+        assert(od.objects.size() == 2U && od.complete);
+        assert(od.findObject(0x1018) != nullptr && od.findObject(0x1018)->entries.size() == 2U);
+        assert(od.findEntry(0x1018, 1) != nullptr && od.findEntry(0x1018, 1)->bitLength == 32U);
+        oec::PdoMappingEntry mapping;
+        assert(od.mappingEntry(0x6000, 0, mapping) && mapping.bitLength == 16U);
+        assert(!od.mappingEntry(0x1018, 1, mapping));
+        const auto scanRequests = transport.infoRequests;
+        assert(scanRequests == 1 + 2 + 2 + 1);
+
+        // A second slave of the same type reuses the cached dictionary.
+        oec::ObjectDictionary second;
+        assert(master.objectDictionary(2, second, error));
+        assert(transport.infoRequests == scanRequests);
+        assert(second.objects.size() == 2U);
+
+        const auto path = (std::filesystem::temp_directory_path() / "oec_od_cache_test.bin").string();
+        assert(master.objectDictionaryCache().saveToFile(path, error));
+        oec::ObjectDictionaryCache reloaded;
+        assert(reloaded.loadFromFile(path, error));
+        const auto* entry = reloaded.find({0x2, 0x1234, 0x00100005});
+        assert(entry != nullptr && entry->findEntry(0x6000, 0) != nullptr);
+        assert(entry->findEntry(0x6000, 0)->name == "In");
+
+        auto bytes = reloaded.encode();
+        bytes[12] ^= 0xFFU;
+        assert(!reloaded.decode(bytes, error));
+        assert(error == "object dictionary cache checksum mismatch");
+        std::filesystem::remove(path);
+
+        // A refused entry yields an incomplete dictionary that is not cached; a transport error fails the scan.
+        master.objectDictionaryCache().clear();
+        transport.entryFault = 1;
+        oec::ObjectDictionary partial;
+        assert(master.objectDictionary(1, partial, error));
+        assert(!partial.complete && partial.findObject(0x1018)->entries.size() == 1U);
+        assert(master.objectDictionaryCache().size() == 0U);
+        transport.entryFault = 2;
+        assert(!master.objectDictionary(1, partial, error));
+        assert(error.find("entry description failed") != std::string::npos);
+        assert(master.objectDictionaryCache().size() == 0U);
+        transport.entryFault = 0;
+
+        // Static identity objects are read once per slave until invalidated.
+        const auto uploadsBefore = transport.uploads;
+        assert(master.sdoUpload(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(transport.uploads == uploadsBefore);
+        const auto hits = master.sdoCacheStats().hits;
+        assert(hits >= 1U);
+        assert(!master.sdoUpload(1, {.index = 0x2000, .subIndex = 1}).success);
+        assert(transport.uploads == uploadsBefore + 1);
+        assert(master.sdoCacheStats().hits == hits);
+        master.invalidateSdoCache();
+        assert(master.sdoUpload(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(transport.uploads == uploadsBefore + 2);
+        master.setSdoCachePolicy(0x1018, oec::SdoCachePolicy::Volatile);
+        assert(master.sdoUpload(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(transport.uploads == uploadsBefore + 3);
+    }
+
+    // AL state change drops a slave's cached static objects.
+    {
+        SdoInfoTransport transport;
+        oec::CoeMailboxService mailbox(transport);
+        mailbox.noteSlaveState(1, oec::SlaveState::PreOp);
+        assert(mailbox.uploadCached(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(mailbox.uploadCached(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(transport.uploads == 1);
+        mailbox.noteSlaveState(1, oec::SlaveState::PreOp);
+        assert(mailbox.uploadCached(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(transport.uploads == 1);
+        mailbox.noteSlaveState(1, oec::SlaveState::Init);
+        assert(mailbox.uploadCached(1, {.index = 0x1018, .subIndex = 3}).success);
+        assert(transport.uploads == 2);
+        const auto stats = mailbox.cacheStats();
+        assert(stats.hits == 2U && stats.misses == 2U && stats.invalidations == 1U);
+    }
+
+    // Receive waits honour sub-millisecond absolute deadlines.
+    {
+        int fds[2] = {-1, -1};
+        assert(::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) == 0);
+        std::string error;
+        using Clock = std::chrono::steady_clock;
+        const auto budget = std::chrono::microseconds(200);
+        auto fastest = std::chrono::nanoseconds::max();
+        for (int i = 0; i < 10; ++i) {
+            const auto start = Clock::now();
+            assert(oec::waitReadable(&fds[0], 1U, start + budget, oec::ReceiveWaitMode::Block, error) == 0);
+            const auto elapsed = Clock::now() - start;
+            assert(elapsed >= budget);
+            fastest = std::min<std::chrono::nanoseconds>(fastest, elapsed);
+        }
+        // select() with a millisecond timeval could not return before 1 ms.
+        assert(fastest < std::chrono::milliseconds(1));
+
+        const auto spinStart = Clock::now();
+        assert(oec::waitReadable(&fds[0], 1U, spinStart + budget, oec::ReceiveWaitMode::BusyPoll, error) == 0);
+        assert(Clock::now() - spinStart >= budget);
+        // An expired deadline returns at once.
+        assert(oec::waitReadable(&fds[0], 1U, spinStart, oec::ReceiveWaitMode::Block, error) == 0);
+
+        const std::uint8_t byte = 0x5AU;
+        assert(::write(fds[1], &byte, 1U) == 1);
+        const int watched[2] = {fds[1], fds[0]};
+        assert(oec::waitReadable(watched, 2U, Clock::now() + std::chrono::milliseconds(100),
+                                 oec::ReceiveWaitMode::BusyPoll, error) == 0x2);
+        assert(oec::waitReadable(watched, 2U, Clock::now() + std::chrono::milliseconds(100),
+                                 oec::ReceiveWaitMode::Block, error) == 0x2);
+        ::close(fds[0]);
+        ::close(fds[1]);
+
+        oec::LinuxRawSocketTransport transport("eth0");
+        transport.setReceiveTimeout(std::chrono::microseconds(250));
+        assert(transport.receiveTimeout() == std::chrono::microseconds(250));
+        transport.setCycleTimeoutMs(5);
+        assert(transport.receiveTimeout() == std::chrono::milliseconds(5));
+        transport.setReceiveWaitMode(oec::ReceiveWaitMode::BusyPoll);
+        assert(transport.receiveWaitMode() == oec::ReceiveWaitMode::BusyPoll);
+
+        // A primary frame lost under a cycle budget leaves the secondary retry the second half.
+        const auto cycleStart = Clock::now();
+        const auto split = oec::splitRedundantDeadline(cycleStart, cycleStart + std::chrono::microseconds(400));
+        assert(split.primary == cycleStart + std::chrono::microseconds(200));
+        assert(split.secondary == cycleStart + std::chrono::microseconds(400));
+        assert(split.secondary - split.primary >= std::chrono::microseconds(200));
+        const auto expired = oec::splitRedundantDeadline(cycleStart, cycleStart - std::chrono::microseconds(1));
+        assert(expired.primary == expired.secondary && expired.secondary < cycleStart);
+    }
+
+    // SO_TIMESTAMPING: per-frame TX/RX software stamps (UDP over loopback stands in for the raw socket).
+    {
+        oec::FrameTimestampMode mode = oec::FrameTimestampMode::Off;
+        assert(oec::parseFrameTimestampMode("hardware", mode) && mode == oec::FrameTimestampMode::Hardware);
+        assert(oec::parseFrameTimestampMode("SW", mode) && mode == oec::FrameTimestampMode::Software);
+        assert(!oec::parseFrameTimestampMode("ptp", mode));
+
+        const int tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+        const int rx = ::socket(AF_INET, SOCK_DGRAM, 0);
+        assert(tx >= 0 && rx >= 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        assert(::bind(rx, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        socklen_t length = sizeof(address);
+        assert(::getsockname(rx, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+
+        std::string error;
+        const auto software = oec::FrameTimestampMode::Software;
+        assert(oec::enableFrameTimestamping(tx, "lo", software, error));
+        assert(oec::enableFrameTimestamping(rx, "lo", software, error));
+        const std::uint8_t frame[4] = {0x88, 0xA4, 0x01, 0x02};
+
+        // The kernel enables software stamping through deferred work, so the first
+        // frames may go unstamped; send until one carries both stamps.
+        oec::FrameWireSample wire;
+        const auto stampDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        for (int attempt = 0; attempt < 50 && !wire.complete() && std::chrono::steady_clock::now() < stampDeadline;
+             ++attempt) {
+            wire = oec::FrameWireSample{};
+            assert(oec::sendTimestamped(tx, frame, sizeof(frame), reinterpret_cast<sockaddr*>(&address),
+                                        sizeof(address), software, error));
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+            assert(oec::waitReadable(&rx, 1U, deadline, oec::ReceiveWaitMode::Block, error) == 1);
+            std::uint8_t buffer[16] = {};
+            assert(oec::receiveTimestamped(rx, buffer, sizeof(buffer), 0, software, wire) == 4);
+            // The TX stamp arrives on the sender's error queue.
+            const auto txDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+            if (oec::waitReadable(&tx, 1U, txDeadline, oec::ReceiveWaitMode::Block, error) == 1) {
+                oec::readTxTimestamp(tx, software, wire);
+            }
+            if (!wire.complete()) {
+                oec::discardTxTimestamps(tx);
+            }
+        }
+        assert(wire.complete() && "no loopback frame carried both software timestamps");
+        assert(wire.roundTrip() >= std::chrono::nanoseconds(0));
+        assert(wire.roundTrip() < std::chrono::milliseconds(100));
+        oec::FrameWireSample drained;
+        assert(!oec::readTxTimestamp(tx, software, drained));
+
+        // Stamps map onto the steady clock the cycle code uses.
+        const auto mapped = oec::realtimeStampToSteady(wire.txNs);
+        const auto now = std::chrono::steady_clock::now();
+        assert(mapped <= now && now - mapped < std::chrono::milliseconds(100));
+        // Hardware stamps need the NIC's PHC; loopback has none, and no PHC means no offset.
+        std::string phcError;
+        assert(oec::openPhc(tx, "lo", phcError) == -1 && !phcError.empty());
+        std::int64_t phcOffsetNs = 0;
+        assert(!oec::phcRealtimeOffset(-1, phcOffsetNs));
+        ::close(tx);
+        ::close(rx);
+
+        oec::LinuxRawSocketTransport transport("eth0");
+        transport.setFrameTimestamping(oec::FrameTimestampMode::Hardware);
+        // Nothing active or measured until open() configured the sockets.
+        assert(transport.frameTimestampMode() == oec::FrameTimestampMode::Off);
+        std::chrono::nanoseconds roundTrip{0};
+        assert(!transport.lastWireRoundTrip(roundTrip));
+        std::chrono::steady_clock::time_point txTime;
+        assert(!transport.lastDcReferenceTxTime(txTime));
+    }
+
+    // SO_TXTIME scheduled transmit: clock mapping, launch-time send, transport guards.
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto spanNs = static_cast<std::int64_t>(oec::steadyToTaiNs(now + std::chrono::milliseconds(1)) -
+                                                      oec::steadyToTaiNs(now));
+        assert(std::llabs(spanNs - 1000000) < 100000);
+
+        const int tx = ::socket(AF_INET, SOCK_DGRAM, 0);
+        const int rx = ::socket(AF_INET, SOCK_DGRAM, 0);
+        assert(tx >= 0 && rx >= 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        assert(::bind(rx, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        socklen_t length = sizeof(address);
+        assert(::getsockname(rx, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+
+        std::string error;
+        // CLOCK_TAI launch times need CAP_NET_ADMIN; without it the transport sends immediately.
+        if (oec::enableScheduledTransmit(tx, 0, error)) {
+            const std::uint8_t frame[2] = {0x88, 0xA4};
+            const auto launch = oec::steadyToTaiNs(std::chrono::steady_clock::now() + std::chrono::microseconds(100));
+            assert(oec::sendAtLaunchTime(tx, frame, sizeof(frame), reinterpret_cast<sockaddr*>(&address),
+                                         sizeof(address), launch, error));
+            // Loopback has no ETF qdisc: the frame arrives and no launch error is queued.
+            assert(oec::waitReadable(&rx, 1U, std::chrono::steady_clock::now() + std::chrono::milliseconds(100),
+                                     oec::ReceiveWaitMode::Block, error) == 1);
+            oec::ScheduledTransmitDiagnostics diagnostics;
+            oec::collectLaunchTimeErrors(tx, diagnostics);
+            assert(diagnostics.missedByQdisc == 0U && diagnostics.invalidLaunchTime == 0U);
+        } else {
+            assert(error.find("SO_TXTIME") != std::string::npos);
+        }
+        ::close(tx);
+        ::close(rx);
+
+        oec::LinuxRawSocketTransport transport("eth0");
+        transport.setScheduledTransmit({true, 3, std::chrono::microseconds(20)});
+        transport.setNextLaunchTime(std::chrono::steady_clock::now());
+        assert(!transport.scheduledTransmitActive());
+        std::vector<std::uint8_t> rxImage(1U, 0U);
+        assert(!transport.exchange({0x00}, rxImage));
+        assert(transport.scheduledTransmitDiagnostics().scheduledFrames == 0U);
+    }
+
+    // xdp:<ifname> transport spec, the XDP program's steering rule and a failed AF_XDP open.
+    {
+        oec::TransportFactoryConfig config;
+        std::string error;
+        assert(oec::TransportFactory::parseTransportSpec(" xdp:eth1 ", config, error));
+        assert(config.kind == oec::TransportKind::LinuxXdp);
+        assert(config.primaryInterface == "eth1" && config.secondaryInterface.empty() && !config.enableRedundancy);
+        auto transport = oec::TransportFactory::create(config, error);
+        auto* xdpTransport = dynamic_cast<oec::LinuxRawSocketTransport*>(transport.get());
+        assert(xdpTransport != nullptr && !xdpTransport->xdpActive());
+        assert(!oec::TransportFactory::parseTransportSpec("xdp:", config, error));
+        assert(!oec::TransportFactory::parseTransportSpec("xdp:eth1,eth2", config, error));
+        assert(error.find("redundancy") != std::string::npos);
+
+        // The frame the XDP program steers is the frame the cyclic path sends through it.
+        const std::uint8_t dst[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        const std::uint8_t src[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+        oec::EthercatDatagramRequest datagram;
+        datagram.command = 0x0B;
+        datagram.payload.assign(4U, 0U);
+        const auto lwr = oec::EthercatFrameCodec::buildDatagramFrame(dst, src, datagram);
+        assert(oec::XdpSocket::isCyclicFrame(lwr.data(), lwr.size()));
+        datagram.command = 0x0D;
+        const auto armw = oec::EthercatFrameCodec::buildDatagramFrame(dst, src, datagram);
+        assert(oec::XdpSocket::isCyclicFrame(armw.data(), armw.size()));
+        datagram.command = 0x04;
+        const auto aprd = oec::EthercatFrameCodec::buildDatagramFrame(dst, src, datagram);
+        assert(!oec::XdpSocket::isCyclicFrame(aprd.data(), aprd.size()));
+        auto ipv4 = lwr;
+        ipv4[12] = 0x08;
+        ipv4[13] = 0x00;
+        assert(!oec::XdpSocket::isCyclicFrame(ipv4.data(), ipv4.size()));
+        assert(!oec::XdpSocket::isCyclicFrame(lwr.data(), 16U));
+
+        oec::XdpSocket socket;
+        assert(!socket.open("oec-no-such-if", oec::XdpSocketOptions{}, error));
+        assert(!socket.isOpen());
+        char buffer[64];
+        assert(socket.receive(buffer, sizeof(buffer)) < 0);
+    }
+
+    // AF_XDP ring bookkeeping on rings in plain memory, with the test playing the kernel.
+    {
+        constexpr std::uint32_t kFrames = 8U;
+        constexpr std::uint32_t kFrameSize = 2048U;
+        constexpr std::uint32_t kEntries = kFrames / 2U;
+        std::vector<std::uint8_t> umem(static_cast<std::size_t>(kFrames) * kFrameSize, 0U);
+        std::array<std::uint32_t, 8> indices{}; // producer/consumer of fill, completion, RX, TX
+        std::array<std::uint64_t, kEntries> fillDescs{};
+        std::array<std::uint64_t, kEntries> completionDescs{};
+        std::array<xdp_desc, kEntries> rxDescs{};
+        std::array<xdp_desc, kEntries> txDescs{};
+        auto ring = [&](std::size_t i, void* descs) {
+            return oec::XdpRings::Ring{&indices[2U * i], &indices[(2U * i) + 1U], descs, kEntries - 1U};
+        };
+        auto& [fillProducer, fillConsumer, completionProducer, completionConsumer, rxProducer, rxConsumer,
+               txProducer, txConsumer] = indices;
+
+        oec::XdpRings rings;
+        std::string error;
+        std::array<std::uint8_t, 16> buffer{};
+        assert(!rings.queueTx({0x01}, error));
+        assert(rings.receive(buffer.data(), buffer.size()) < 0);
+        rings.reset(umem.data(), kFrames, kFrameSize, ring(0, fillDescs.data()), ring(1, completionDescs.data()),
+                    ring(2, rxDescs.data()), ring(3, txDescs.data()));
+        // The RX half is posted to the fill ring, the TX half is free.
+        assert(fillProducer == kEntries && fillConsumer == 0U);
+        for (std::uint32_t i = 0; i < kEntries; ++i) {
+            assert(fillDescs[i] == static_cast<std::uint64_t>(i) * kFrameSize);
+        }
+        assert(rings.freeTxFrames() == kEntries);
+
+        std::vector<std::uint64_t> sent;
+        for (std::uint8_t i = 0; i < kEntries; ++i) {
+            assert(rings.queueTx({i, 0xA5}, error));
+            const auto& desc = txDescs[i];
+            assert(desc.addr >= kEntries * kFrameSize && desc.addr < kFrames * kFrameSize && desc.len == 2U);
+            assert(umem[desc.addr] == i && umem[desc.addr + 1U] == 0xA5U);
+            sent.push_back(desc.addr);
+        }
+        assert(txProducer == kEntries && rings.freeTxFrames() == 0U);
+        assert(!rings.queueTx({0x01}, error) && error.find("ring full") != std::string::npos);
+        assert(rings.stats().txRingFull == 1U);
+        assert(!rings.queueTx(std::vector<std::uint8_t>(kFrameSize + 1U, 0U), error));
+
+        // The kernel transmits two frames and completes them; the next send reuses one.
+        txConsumer = 2U;
+        completionDescs[0] = txDescs[0].addr;
+        completionDescs[1] = txDescs[1].addr;
+        completionProducer = 2U;
+        assert(rings.queueTx({0x42}, error));
+        assert(completionConsumer == 2U && rings.freeTxFrames() == 1U);
+        const auto reused = txDescs[kEntries & (kEntries - 1U)].addr;
+        assert(reused == sent[0] || reused == sent[1]);
+        assert(umem[reused] == 0x42U && txProducer == kEntries + 1U);
+        assert(rings.stats().framesSent == kEntries + 1U);
+
+        // A received frame is copied out, and its UMEM frame goes back to the fill ring.
+        const auto rxFrame = fillDescs[fillConsumer++ & (kEntries - 1U)] + 256U; // kernel headroom
+        umem[rxFrame] = 0x88;
+        umem[rxFrame + 1U] = 0xA4;
+        rxDescs[0] = xdp_desc{rxFrame, 60U, 0U};
+        rxProducer = 1U;
+        assert(rings.receive(buffer.data(), buffer.size()) == static_cast<ssize_t>(buffer.size()));
+        assert(buffer[0] == 0x88U && buffer[1] == 0xA4U);
+        assert(rxConsumer == 1U && fillProducer == kEntries + 1U);
+        assert(fillDescs[kEntries & (kEntries - 1U)] == rxFrame - 256U);
+        assert(rings.receive(buffer.data(), buffer.size()) < 0 && errno == EAGAIN);
+        assert(rings.stats().framesReceived == 1U);
+    }
+
     std::cout << "advanced_systems_tests passed\n";
     return 0;
 }
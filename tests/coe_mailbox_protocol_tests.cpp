@@ -3,16 +3,238 @@
  * @brief openEtherCAT source file.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "openethercat/config/eni_esi_models.hpp"
+#include "openethercat/master/eoe_gateway.hpp"
 #include "openethercat/transport/coe_mailbox_protocol.hpp"
 #include "openethercat/transport/linux_raw_socket_transport.hpp"
 
+namespace {
+// One ESC at position 0 behind the peer of a SOCK_SEQPACKET pair: register RAM,
+// FMMUs, SM0/SM1 mailboxes answering SDO uploads, and the SM1 repeat handshake.
+class SimulatedEsc {
+public:
+    static constexpr std::uint16_t kSm0Start = 0x1000;
+    static constexpr std::uint16_t kSm1Start = 0x1080;
+    static constexpr std::uint16_t kMailboxBytes = 0x0080;
+    static constexpr std::uint16_t kOutputStart = 0x1100;
+    static constexpr std::uint16_t kInputStart = 0x1180;
+
+    explicit SimulatedEsc(int fd) : fd_(fd), memory_(0x2000U, 0U) {
+        memory_[0x0004] = 3U; // FMMUs
+        setSm(0U, kSm0Start, kMailboxBytes);
+        setSm(1U, kSm1Start, kMailboxBytes);
+        setSm(2U, kOutputStart, 1U);
+        setSm(3U, kInputStart, 1U);
+        thread_ = std::thread([this]() { run(); });
+    }
+    ~SimulatedEsc() {
+        ::shutdown(fd_, SHUT_RDWR);
+        thread_.join();
+        ::close(fd_);
+    }
+
+    void dropSm1Reads(int count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropSm1Reads_ = count;
+    }
+    int repeatRequests() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return repeatRequests_;
+    }
+    // Data of the expedited upload response to every SDO upload request.
+    void setUploadValue(std::uint32_t value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uploadValue_ = value;
+    }
+    void setMailboxFull(bool full) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        setSm1Full(full);
+    }
+    void poke(std::uint16_t address, std::uint8_t value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        memory_[address] = value;
+    }
+    std::uint8_t peek(std::uint16_t address) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return memory_[address];
+    }
+
+private:
+    void setSm(std::uint8_t sm, std::uint16_t start, std::uint16_t length) {
+        const auto base = static_cast<std::size_t>(0x0800U + (sm * 8U));
+        memory_[base] = static_cast<std::uint8_t>(start & 0xFFU);
+        memory_[base + 1U] = static_cast<std::uint8_t>(start >> 8U);
+        memory_[base + 2U] = static_cast<std::uint8_t>(length & 0xFFU);
+        memory_[base + 3U] = static_cast<std::uint8_t>(length >> 8U);
+    }
+    void setSm1Full(bool full) {
+        memory_[0x080D] = static_cast<std::uint8_t>(full ? (memory_[0x080D] | 0x08U) : (memory_[0x080D] & ~0x08U));
+    }
+    bool sm1Full() const { return (memory_[0x080D] & 0x08U) != 0U; }
+
+    void run() {
+        std::vector<std::uint8_t> frame(1518U);
+        while (true) {
+            const auto received = ::recv(fd_, frame.data(), frame.size(), 0);
+            if (received <= 0) {
+                return;
+            }
+            bool drop = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                drop = processFrame(frame.data(), static_cast<std::size_t>(received));
+            }
+            if (!drop) {
+                (void)::send(fd_, frame.data(), static_cast<std::size_t>(received), 0);
+            }
+        }
+    }
+
+    // Returns true when the response frame is lost on the way back.
+    bool processFrame(std::uint8_t* frame, std::size_t size) {
+        bool drop = false;
+        std::size_t offset = 16U; // Ethernet + EtherCAT header
+        while (offset + 12U <= size) {
+            const auto command = frame[offset];
+            const auto adp = static_cast<std::uint16_t>(frame[offset + 2U] | (frame[offset + 3U] << 8U));
+            const auto ado = static_cast<std::uint16_t>(frame[offset + 4U] | (frame[offset + 5U] << 8U));
+            const auto lenField = static_cast<std::uint16_t>(frame[offset + 6U] | (frame[offset + 7U] << 8U));
+            const std::size_t length = lenField & 0x07FFU;
+            if (offset + 12U + length > size) {
+                break;
+            }
+            std::uint8_t* data = frame + offset + 10U;
+            std::uint16_t wkc = 0U;
+            if ((command == 0x01U || command == 0x02U) && adp == 0U && ado + length <= memory_.size()) {
+                wkc = (command == 0x01U) ? physicalRead(ado, data, length, drop) : physicalWrite(ado, data, length);
+            } else if (command == 0x0AU || command == 0x0BU) {
+                wkc = logicalAccess(command == 0x0AU, static_cast<std::uint32_t>(adp | (ado << 16U)), data, length);
+            }
+            if (command == 0x01U || command == 0x02U) {
+                // Auto-increment addressing: every ESC passed increments ADP.
+                frame[offset + 2U] = static_cast<std::uint8_t>((adp + 1U) & 0xFFU);
+                frame[offset + 3U] = static_cast<std::uint8_t>(((adp + 1U) >> 8U) & 0xFFU);
+            }
+            frame[offset + 10U + length] = static_cast<std::uint8_t>(wkc & 0xFFU);
+            frame[offset + 11U + length] = static_cast<std::uint8_t>(wkc >> 8U);
+            offset += 12U + length;
+            if ((lenField & 0x8000U) == 0U) {
+                break;
+            }
+        }
+        return drop;
+    }
+
+    std::uint16_t physicalRead(std::uint16_t ado, std::uint8_t* data, std::size_t length, bool& drop) {
+        const bool readsSm1 = ado >= kSm1Start && ado < kSm1Start + kMailboxBytes;
+        if (readsSm1 && !sm1Full()) {
+            return 0U; // An empty mailbox is not readable.
+        }
+        std::copy_n(memory_.begin() + ado, length, data);
+        if (readsSm1 && ado + length >= kSm1Start + kMailboxBytes) {
+            // Reading the last byte hands the buffer back to the slave.
+            setSm1Full(false);
+            if (dropSm1Reads_ > 0) {
+                --dropSm1Reads_;
+                drop = true;
+            }
+        }
+        return 1U;
+    }
+
+    std::uint16_t physicalWrite(std::uint16_t ado, const std::uint8_t* data, std::size_t length) {
+        const auto previousActivate = memory_[0x080E];
+        std::copy_n(data, length, memory_.begin() + ado);
+        if (ado <= 0x080EU && ado + length > 0x080EU && ((memory_[0x080E] ^ previousActivate) & 0x02U) != 0U) {
+            // Repeat request: put the last mailbox back and mirror the bit as the ack.
+            ++repeatRequests_;
+            std::copy(lastMailbox_.begin(), lastMailbox_.end(), memory_.begin() + kSm1Start);
+            setSm1Full(true);
+            memory_[0x080F] = static_cast<std::uint8_t>((memory_[0x080F] & ~0x02U) | (memory_[0x080E] & 0x02U));
+        }
+        if (ado == kSm0Start && length == kMailboxBytes) {
+            answerMailbox();
+        }
+        return 1U;
+    }
+
+    void answerMailbox() {
+        const std::vector<std::uint8_t> request(memory_.begin() + kSm0Start, memory_.begin() + kSm0Start + kMailboxBytes);
+        const auto decoded = oec::CoeMailboxProtocol::decodeEscMailbox(request);
+        if (!decoded || decoded->payload.size() < 6U || decoded->payload[2] != 0x40U) {
+            return;
+        }
+        oec::EscMailboxFrame response;
+        response.type = oec::CoeMailboxProtocol::kMailboxTypeCoe;
+        response.counter = decoded->counter;
+        // Expedited, size indicated, four bytes.
+        response.payload = {0x03, 0x00, 0x43, decoded->payload[3], decoded->payload[4], decoded->payload[5],
+                            static_cast<std::uint8_t>(uploadValue_ & 0xFFU),
+                            static_cast<std::uint8_t>((uploadValue_ >> 8U) & 0xFFU),
+                            static_cast<std::uint8_t>((uploadValue_ >> 16U) & 0xFFU),
+                            static_cast<std::uint8_t>(uploadValue_ >> 24U)};
+        lastMailbox_ = oec::CoeMailboxProtocol::encodeEscMailbox(response);
+        lastMailbox_.resize(kMailboxBytes, 0U);
+        std::copy(lastMailbox_.begin(), lastMailbox_.end(), memory_.begin() + kSm1Start);
+        setSm1Full(true);
+    }
+
+    // Bit-wise FMMU translation; one working counter per ESC that maps any byte of the datagram.
+    std::uint16_t logicalAccess(bool read, std::uint32_t logical, std::uint8_t* data, std::size_t length) {
+        bool mapped = false;
+        for (std::size_t fmmu = 0; fmmu < memory_[0x0004]; ++fmmu) {
+            const auto* f = &memory_[0x0600U + (fmmu * 16U)];
+            if ((f[12] & 0x01U) == 0U || (f[11] & (read ? 0x01U : 0x02U)) == 0U) {
+                continue;
+            }
+            const auto start = static_cast<std::uint32_t>(f[0] | (f[1] << 8U) | (f[2] << 16U) | (f[3] << 24U));
+            const auto bytes = static_cast<std::uint32_t>(f[4] | (f[5] << 8U));
+            const auto firstBit = (start * 8U) + f[6];
+            const auto lastBit = ((start + bytes - 1U) * 8U) + f[7];
+            const auto physicalBit = (static_cast<std::uint32_t>(f[8] | (f[9] << 8U)) * 8U) + f[10];
+            for (auto bit = firstBit; bytes > 0U && bit <= lastBit; ++bit) {
+                if (bit / 8U < logical || bit / 8U >= logical + length) {
+                    continue;
+                }
+                mapped = true;
+                auto& logicalByte = data[(bit / 8U) - logical];
+                auto& physicalByte = memory_[(physicalBit + bit - firstBit) / 8U];
+                const auto logicalMask = static_cast<std::uint8_t>(1U << (bit % 8U));
+                const auto physicalMask = static_cast<std::uint8_t>(1U << ((physicalBit + bit - firstBit) % 8U));
+                auto& to = read ? logicalByte : physicalByte;
+                const bool set = ((read ? physicalByte : logicalByte) & (read ? physicalMask : logicalMask)) != 0U;
+                const auto toMask = read ? logicalMask : physicalMask;
+                to = static_cast<std::uint8_t>(set ? (to | toMask) : (to & ~toMask));
+            }
+        }
+        return mapped ? 1U : 0U;
+    }
+
+    int fd_;
+    std::vector<std::uint8_t> memory_;
+    std::vector<std::uint8_t> lastMailbox_;
+    std::uint32_t uploadValue_ = 0U;
+    int dropSm1Reads_ = 0;
+    int repeatRequests_ = 0;
+    std::mutex mutex_;
+    std::thread thread_;
+};
+} // namespace
+
 int main() {
     // ESC mailbox encode/decode round-trip.
     {
@@ -64,6 +286,68 @@ int main() {
         assert((req[2] & 0x01U) == 0x01U); // last segment bit
     }
 
+    // Full-mailbox segments: size derives from the SM window, unused bits only below 7 bytes.
+    {
+        assert(oec::CoeMailboxProtocol::maxSegmentDataBytes(128U) == 119U);
+        assert(oec::CoeMailboxProtocol::maxSegmentDataBytes(12U) == 7U);
+        assert(oec::CoeMailboxProtocol::maxInitiateDownloadDataBytes(128U) == 112U);
+        assert(oec::CoeMailboxProtocol::maxInitiateDownloadDataBytes(16U) == 0U);
+
+        const std::vector<std::uint8_t> big(119U, 0x5A);
+        const auto req = oec::CoeMailboxProtocol::buildSdoDownloadSegmentRequest(1, false, big, 119U);
+        assert(req.size() == 3U + 119U);
+        assert(req[2] == 0x10U); // toggle=1, unused=0, not last
+        const std::vector<std::uint8_t> tail = {1, 2};
+        const auto last = oec::CoeMailboxProtocol::buildSdoDownloadSegmentRequest(0, true, tail, 119U);
+        assert(last[2] == static_cast<std::uint8_t>((5U << 1U) | 0x01U));
+
+        const auto init = oec::CoeMailboxProtocol::buildSdoInitiateDownloadRequest(
+            {.index = 0x8000, .subIndex = 0x00}, 300U, std::vector<std::uint8_t>(112U, 0x11));
+        assert(init.size() == 10U + 112U);
+        assert(init[2] == 0x21U && init[6] == 0x2CU && init[7] == 0x01U);
+    }
+
+    // Complete Access sets the CA bit; download acks may echo it.
+    {
+        const auto upload = oec::CoeMailboxProtocol::buildSdoInitiateUploadRequest({.index = 0x1A00, .subIndex = 0},
+                                                                                   true);
+        assert(upload[2] == 0x50U);
+        const auto download = oec::CoeMailboxProtocol::buildSdoInitiateDownloadRequest(
+            {.index = 0x1C12, .subIndex = 0}, 4U, {1, 0, 0x00, 0x16}, true);
+        assert(download[2] == 0x31U && download.size() == 14U);
+        std::vector<std::uint8_t> ack = {0x03, 0x00, 0x70, 0x12, 0x1C, 0x00};
+        assert(oec::CoeMailboxProtocol::parseSdoInitiateDownloadResponse(ack, {.index = 0x1C12, .subIndex = 0}).success);
+    }
+
+    // Normal upload response carrying the object inline after the complete size.
+    {
+        std::vector<std::uint8_t> payload = {0x03, 0x00, 0x41, 0x00, 0x80, 0x00, 0x05, 0x00, 0x00, 0x00,
+                                             1, 2, 3, 4, 5, 0, 0};
+        const auto parsed = oec::CoeMailboxProtocol::parseSdoInitiateUploadResponse(
+            payload, {.index = 0x8000, .subIndex = 0x00});
+        assert(parsed.success && !parsed.expedited);
+        assert(parsed.completeSize == 5U);
+        assert(parsed.data.size() == 5U && parsed.data[4] == 5U);
+    }
+
+    // Abort transfers carry index/sub-index before the abort code.
+    {
+        std::vector<std::uint8_t> payload = {0x03, 0x00, 0x80, 0x00, 0x80, 0x00, 0x00, 0x00, 0x02, 0x06};
+        const auto ack = oec::CoeMailboxProtocol::parseSdoDownloadSegmentResponse(payload, 0);
+        assert(!ack.success && ack.error == "SDO abort");
+        assert(ack.abortCode == 0x06020000U);
+    }
+
+    // Expedited download carries data inline and encodes unused bytes in the command.
+    {
+        const auto req = oec::CoeMailboxProtocol::buildSdoExpeditedDownloadRequest(
+            {.index = 0x1C12, .subIndex = 0x01}, {0x00, 0x16});
+        assert(req.size() == 10U);
+        assert(req[2] == 0x2BU); // 0x23 | (2 unused bytes << 2)
+        assert(req[3] == 0x12U && req[4] == 0x1CU && req[5] == 0x01U);
+        assert(req[6] == 0x00U && req[7] == 0x16U && req[8] == 0x00U && req[9] == 0x00U);
+    }
+
     // Initiate download ack parsing with strict address matching.
     {
         // service=0x0003, cmd=0x60, index=0x2000, sub=0x01
@@ -161,6 +445,35 @@ int main() {
         assert(matchedData[0] == 0x44);
     }
 
+    // SDO Information codec: request layout, fragments, error and descriptions.
+    {
+        const auto req = oec::CoeMailboxProtocol::buildSdoInfoGetEntryDescriptionRequest(0x6000, 2, 0);
+        assert((req == std::vector<std::uint8_t>{0x08, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x60, 0x02, 0x00}));
+
+        const auto fragment = oec::CoeMailboxProtocol::parseSdoInfoFragment(
+            {0x08, 0x00, 0x82, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x10});
+        assert(fragment.success && fragment.opCode == 0x02 && fragment.incomplete);
+        assert(fragment.fragmentsLeft == 1U && fragment.data.size() == 4U);
+        std::vector<std::uint16_t> indices;
+        assert(oec::CoeMailboxProtocol::parseSdoInfoOdList(fragment.data, indices));
+        assert(indices.size() == 1U && indices[0] == 0x1000);
+
+        const auto error = oec::CoeMailboxProtocol::parseSdoInfoFragment(
+            {0x08, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x06});
+        assert(!error.success && error.abortCode == 0x06020000U);
+
+        oec::CoeObjectDescription object;
+        assert(oec::CoeMailboxProtocol::parseSdoInfoObjectDescription(
+            {0x00, 0x60, 0x00, 0x00, 0x03, 0x09, 'I', 'n'}, object));
+        assert(object.index == 0x6000 && object.maxSubIndex == 3 && object.objectCode == 0x09 && object.name == "In");
+        oec::CoeEntryDescription entry;
+        assert(oec::CoeMailboxProtocol::parseSdoInfoEntryDescription(
+            {0x00, 0x60, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x47, 0x00, 'B'}, entry));
+        assert(entry.subIndex == 1 && entry.dataType == 0x0001 && entry.bitLength == 1U);
+        assert(entry.objectAccess == 0x47 && entry.name == "B");
+        assert(!oec::CoeMailboxProtocol::parseSdoInfoEntryDescription({0x00, 0x60}, entry));
+    }
+
     // Mailbox status mode API should be configurable without opening transport.
     {
         oec::LinuxRawSocketTransport transport("eth0");
@@ -169,6 +482,55 @@ int main() {
         assert(transport.mailboxStatusMode() == oec::MailboxStatusMode::Poll);
         transport.setMailboxStatusMode(oec::MailboxStatusMode::Strict);
         assert(transport.mailboxStatusMode() == oec::MailboxStatusMode::Strict);
+
+        assert(transport.mailboxRepeatEnabled());
+        transport.setMailboxRepeatEnabled(false);
+        assert(!transport.mailboxRepeatEnabled());
+        const auto d = transport.mailboxDiagnostics();
+        assert(d.mailboxRepeatRequests == 0U && d.mailboxRepeatAcks == 0U && d.mailboxRepeatRecoveries == 0U);
+
+        assert(!transport.mailboxStatusMapping());
+        transport.setMailboxStatusMapping(true);
+        assert(transport.mailboxStatusMapping());
+        assert(transport.mailboxStatusMappedSlaves().empty());
+        assert(transport.slavesWithMailboxData().empty());
+    }
+
+    // EoE fragmentation: 32-byte aligned fragments, offsets in blocks, reassembly and sequence checks.
+    {
+        std::vector<std::uint8_t> frame(300U);
+        for (std::size_t i = 0; i < frame.size(); ++i) {
+            frame[i] = static_cast<std::uint8_t>(i * 7U);
+        }
+        const auto fragments = oec::EoeCodec::fragment(frame, 122U, 5U);
+        assert(fragments.size() == 3U);
+        oec::EoeFragmentHeader h{};
+        assert(oec::EoeCodec::parseHeader(fragments[0], h));
+        assert(h.fragmentNumber == 0U && h.offsetBlocks == 10U && h.frameNumber == 5U && !h.lastFragment);
+        assert(fragments[0].size() == 4U + 96U);
+        assert(oec::EoeCodec::parseHeader(fragments[1], h));
+        assert(h.fragmentNumber == 1U && h.offsetBlocks == 3U && !h.lastFragment);
+        assert(oec::EoeCodec::parseHeader(fragments[2], h));
+        assert(h.lastFragment && h.offsetBlocks == 6U && fragments[2].size() == 4U + 108U);
+
+        oec::EoeReassembler reassembler;
+        std::vector<std::uint8_t> out;
+        for (std::size_t i = 0; i + 1U < fragments.size(); ++i) {
+            assert(reassembler.push(fragments[i], out) == oec::EoeReassembler::Result::Incomplete);
+        }
+        assert(reassembler.push(fragments[2], out) == oec::EoeReassembler::Result::Complete);
+        assert(out == frame);
+
+        // A skipped fragment drops the frame; a new fragment 0 abandons an unfinished one.
+        assert(reassembler.push(fragments[0], out) == oec::EoeReassembler::Result::Incomplete);
+        assert(reassembler.push(fragments[2], out) == oec::EoeReassembler::Result::Dropped);
+        assert(reassembler.push(fragments[0], out) == oec::EoeReassembler::Result::Incomplete);
+        assert(reassembler.push(fragments[0], out) == oec::EoeReassembler::Result::Incomplete);
+        assert(reassembler.abandonedFrames() == 1U);
+
+        const auto small = oec::EoeCodec::fragment({1, 2, 3}, 122U, 0U);
+        assert(small.size() == 1U && small[0].size() == 7U);
+        assert(oec::EoeCodec::parseHeader(small[0], h) && h.lastFragment && h.offsetBlocks == 1U);
     }
 
     // Mailbox error classification API.
@@ -203,7 +565,7 @@ int main() {
         assert(!ok);
         assert(transport.lastMailboxErrorClass() == oec::MailboxErrorClass::Timeout);
         const auto d = transport.mailboxDiagnostics();
-        assert(d.schemaVersion == 2U);
+        assert(d.schemaVersion == 3U);
         assert(d.transactionsStarted == 1U);
         assert(d.transactionsFailed == 1U);
         assert(d.errorTimeout >= 1U);
@@ -214,6 +576,89 @@ int main() {
         ::unsetenv("OEC_MAILBOX_RETRIES");
     }
 
+    // A lost SM1 read is recovered through the repeat request instead of a mailbox timeout.
+    {
+        int fds[2];
+        assert(::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+        SimulatedEsc esc(fds[1]);
+        oec::LinuxRawSocketTransport transport("sim0");
+        transport.adoptFrameSocket(fds[0]);
+        transport.setCycleTimeoutMs(20);
+        assert(transport.open());
+        esc.setUploadValue(0x00000002U);
+
+        std::vector<std::uint8_t> data;
+        std::uint32_t abortCode = 0U;
+        std::string error;
+        assert(transport.sdoUpload(0, {.index = 0x1018, .subIndex = 0x01}, data, abortCode, error));
+        assert((data == std::vector<std::uint8_t>{0x02, 0x00, 0x00, 0x00}));
+        assert(transport.mailboxDiagnostics().mailboxRepeatRequests == 0U);
+
+        // The response frame is lost after the ESC released SM1; the repeat makes it resend.
+        esc.setUploadValue(0x12345678U);
+        esc.dropSm1Reads(1);
+        assert(transport.sdoUpload(0, {.index = 0x1018, .subIndex = 0x02}, data, abortCode, error));
+        assert((data == std::vector<std::uint8_t>{0x78, 0x56, 0x34, 0x12}));
+        auto d = transport.mailboxDiagnostics();
+        assert(d.mailboxRepeatRequests == 1U && d.mailboxRepeatAcks == 1U && d.mailboxRepeatRecoveries == 1U);
+        assert(esc.repeatRequests() == 1);
+
+        // Without the handshake the re-read finds SM1 empty and the upload fails.
+        ::setenv("OEC_MAILBOX_RETRIES", "1", 1);
+        transport.setMailboxRepeatEnabled(false);
+        esc.dropSm1Reads(1);
+        assert(!transport.sdoUpload(0, {.index = 0x1018, .subIndex = 0x02}, data, abortCode, error));
+        assert(transport.mailboxDiagnostics().mailboxRepeatRequests == 1U);
+        assert(esc.repeatRequests() == 1);
+        ::unsetenv("OEC_MAILBOX_RETRIES");
+    }
+
+    // The SM1 "mailbox full" bit is mapped behind the input image and read by the cyclic LRD.
+    {
+        int fds[2];
+        assert(::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+        SimulatedEsc esc(fds[1]);
+        oec::LinuxRawSocketTransport transport("sim0");
+        transport.adoptFrameSocket(fds[0]);
+        transport.setCycleTimeoutMs(20);
+        transport.setMailboxStatusMapping(true);
+        assert(transport.open());
+
+        oec::NetworkConfiguration config;
+        config.slaves.push_back({.name = "sim", .alias = 0, .position = 0, .vendorId = 0, .productCode = 0});
+        config.signals.push_back({.logicalName = "Out", .direction = oec::SignalDirection::Output,
+                                  .slaveName = "sim", .byteOffset = 0, .bitOffset = 0});
+        config.signals.push_back({.logicalName = "In", .direction = oec::SignalDirection::Input,
+                                  .slaveName = "sim", .byteOffset = 0, .bitOffset = 0});
+        config.processImageOutputBytes = 1U;
+        config.processImageInputBytes = 1U;
+        std::string error;
+        assert(transport.configureProcessImage(config, error));
+        assert((transport.mailboxStatusMappedSlaves() == std::vector<std::uint16_t>{0}));
+        // Third FMMU: one bit at logical 0x2.0 from 0x080D bit 3.
+        assert(esc.peek(0x0620) == 0x02U && esc.peek(0x0624) == 1U && esc.peek(0x0628) == 0x0DU &&
+               esc.peek(0x0629) == 0x08U && esc.peek(0x062A) == 3U && esc.peek(0x062C) == 0x01U);
+
+        esc.poke(SimulatedEsc::kInputStart, 0x5AU);
+        const std::vector<std::uint8_t> tx{0x01};
+        std::vector<std::uint8_t> rx(1U, 0U);
+        assert(transport.exchange(tx, rx));
+        assert(rx.size() == 1U && rx[0] == 0x5AU);
+        assert(esc.peek(SimulatedEsc::kOutputStart) == 0x01U);
+        assert(transport.slavesWithMailboxData().empty());
+
+        esc.setMailboxFull(true);
+        assert(transport.exchange(tx, rx));
+        assert(rx.size() == 1U && rx[0] == 0x5AU);
+        assert((transport.slavesWithMailboxData() == std::vector<std::uint16_t>{0}));
+        // The slave already counts for its input FMMU; the status FMMU adds nothing.
+        assert(transport.lastInputWorkingCounter() == 1U);
+
+        esc.setMailboxFull(false);
+        assert(transport.exchange(tx, rx));
+        assert(transport.slavesWithMailboxData().empty());
+    }
+
     std::cout << "coe_mailbox_protocol_tests passed\n";
     return 0;
 }
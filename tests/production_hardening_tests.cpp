@@ -3,13 +3,16 @@
  * @brief openEtherCAT source file.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "openethercat/config/recovery_profile_loader.hpp"
@@ -32,6 +35,27 @@ public:
     }
     std::string lastError() const override { return "unsupported"; }
 };
+
+// Records the launch time and receive deadline the cycle controller hands down each cycle.
+class ScheduleTransport final : public oec::ITransport {
+public:
+    bool open() override { return true; }
+    void close() override {}
+    bool exchange(const std::vector<std::uint8_t>& tx, std::vector<std::uint8_t>& rx) override {
+        rx.assign(tx.size(), 0U);
+        return true;
+    }
+    std::string lastError() const override { return {}; }
+    void setNextReceiveDeadline(std::chrono::steady_clock::time_point deadline) override { deadline_ = deadline; }
+    void setNextLaunchTime(std::chrono::steady_clock::time_point launchTime) override {
+        schedule.emplace_back(launchTime, deadline_);
+    }
+
+    std::vector<std::pair<std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point>> schedule;
+
+private:
+    std::chrono::steady_clock::time_point deadline_{};
+};
 } // namespace
 
 int main() {
@@ -70,6 +94,11 @@ int main() {
         oec::EthercatMaster master(transport);
         assert(master.configure(cfg));
         assert(master.start());
+        const auto startup = master.startupReport();
+        assert(startup.completed);
+        assert(startup.failedPhase.empty());
+        assert(startup.statePolls >= 4U);
+        assert(startup.total >= startup.initTransition + startup.opTransition);
 
         oec::CycleController controller;
         oec::CycleControllerOptions options;
@@ -94,6 +123,81 @@ int main() {
         assert(stats.lastWorkingCounter == 1U);
     }
 
+    // DC-follow PLL: host clock 50 ppm slow against the bus settles at the send lead before SYNC0.
+    {
+        const std::int64_t period = 1'000'000;
+        oec::DcFollowLoop loop(1ms, 0ns, 100us, 0.1, 0.01, 20us);
+        double hostNs = 0.0;
+        const double dcOffsetNs = 300'000.0;
+        std::int64_t maxLateError = 0;
+        for (int cycle = 0; cycle < 3000; ++cycle) {
+            const auto reference = static_cast<std::int64_t>(dcOffsetNs + hostNs * 1.00005);
+            const auto adjust = loop.update(reference);
+            assert(adjust >= -20'000 && adjust <= 20'000);
+            if (cycle >= 2000) {
+                maxLateError = std::max<std::int64_t>(maxLateError, std::llabs(loop.phaseErrorNs()));
+            }
+            hostNs += static_cast<double>(period - adjust);
+        }
+        assert(maxLateError < 100);
+        assert(loop.frequencyOffsetNs() > 40.0 && loop.frequencyOffsetNs() < 60.0);
+
+        // Worked through the controller with a provider standing in for the ARMW sample.
+        oec::MockTransport transport(1, 1);
+        oec::EthercatMaster master(transport);
+        oec::NetworkConfiguration cfg;
+        cfg.processImageInputBytes = 1;
+        cfg.processImageOutputBytes = 1;
+        cfg.slaves = {{.name = "EL2008", .alias = 0, .position = 1, .vendorId = 0x2, .productCode = 0x07d83052}};
+        cfg.signals = {{.logicalName = "OutputA", .direction = oec::SignalDirection::Output, .slaveName = "EL2008", .byteOffset = 0, .bitOffset = 0}};
+        assert(master.configure(cfg));
+        assert(master.start());
+        oec::CycleController controller;
+        oec::CycleControllerOptions options;
+        options.period = 1ms;
+        options.followDistributedClock = true;
+        options.dcReferenceTimeNsProvider = []() -> std::optional<std::int64_t> {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        };
+        std::atomic<std::uint64_t> following{0};
+        assert(controller.start(master, options, [&](const oec::CycleReport& report) {
+            if (report.dcFollowing) {
+                ++following;
+            }
+        }));
+        std::this_thread::sleep_for(20ms);
+        controller.stop();
+        master.stop();
+        assert(following.load() > 0U);
+        assert(!master.lastDcReferenceSample().has_value());
+    }
+
+    // Launch offset must fall inside the receive budget; every launched frame leaves before its deadline.
+    {
+        ScheduleTransport transport;
+        oec::EthercatMaster master(transport);
+        oec::CycleController controller;
+        oec::CycleControllerOptions options;
+        options.period = 1ms;
+        options.stopOnError = false;
+        options.receiveBudget = 400us;
+        options.launchOffset = 400us;
+        assert(!controller.start(master, options));
+        assert(!controller.isRunning());
+
+        options.launchOffset = 150us;
+        assert(controller.start(master, options));
+        std::this_thread::sleep_for(20ms);
+        controller.stop();
+        assert(!transport.schedule.empty());
+        for (const auto& [launch, deadline] : transport.schedule) {
+            assert(launch < deadline);
+            assert(deadline - launch >= options.receiveBudget - options.launchOffset);
+        }
+    }
+
     // Startup enforces state machine support when enabled.
     {
         oec::NetworkConfiguration cfg;
@@ -110,6 +214,9 @@ int main() {
         oec::EthercatMaster master(transport);
         assert(master.configure(cfg));
         assert(!master.start());
+        const auto failedReport = master.startupReport();
+        assert(!failedReport.completed);
+        assert(failedReport.failedPhase == "init");
 
         auto options = oec::EthercatMaster::StateMachineOptions{};
         options.enable = false;
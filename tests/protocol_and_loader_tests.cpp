@@ -8,11 +8,17 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "openethercat/config/binary_configuration.hpp"
 #include "openethercat/config/config_loader.hpp"
+#include "openethercat/config/esi_catalog_index.hpp"
+#include "openethercat/config/xml_stream_parser.hpp"
 #include "openethercat/transport/ethercat_frame.hpp"
+#include "openethercat/transport/process_image_plan.hpp"
 
 namespace {
 
@@ -59,6 +65,48 @@ void testEthercatCodec() {
     assert(parsedDatagram->payload[0] == 0x08);
 }
 
+void testMultiDatagramCodec() {
+    const std::uint8_t dst[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    const std::uint8_t src[6] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15};
+
+    std::vector<oec::EthercatDatagramRequest> requests(3);
+    requests[0].command = 0x01;
+    requests[0].datagramIndex = 0x20;
+    requests[0].ado = 0x0810;
+    requests[0].payload.assign(8U, 0U);
+    requests[1].command = 0x02;
+    requests[1].datagramIndex = 0x21;
+    requests[1].adp = 0xFFFF;
+    requests[1].ado = 0x0600;
+    requests[1].payload.assign(16U, 0xA5U);
+    requests[2].command = 0x07;
+    requests[2].datagramIndex = 0x22;
+    requests[2].ado = 0x0130;
+    requests[2].payload = {0x00, 0x00};
+
+    std::size_t wireBytes = 0U;
+    for (const auto& r : requests) {
+        wireBytes += oec::EthercatFrameCodec::datagramWireBytes(r);
+    }
+    assert(wireBytes == (10U + 8U + 2U) + (10U + 16U + 2U) + (10U + 2U + 2U));
+
+    auto frame = oec::EthercatFrameCodec::buildMultiDatagramFrame(dst, src, requests);
+    // Last datagram's WKC sits at the very end of the EtherCAT payload.
+    const std::size_t lastWkc = 14U + 2U + wireBytes - 2U;
+    frame[lastWkc] = 0x03;
+
+    std::vector<oec::EthercatDatagramResponse> responses;
+    assert(oec::EthercatFrameCodec::parseMultiDatagramFrame(frame, responses));
+    assert(responses.size() == 3U);
+    assert(responses[0].command == 0x01 && responses[0].datagramIndex == 0x20);
+    assert(responses[1].payload.size() == 16U && responses[1].payload[15] == 0xA5U);
+    assert(responses[2].datagramIndex == 0x22);
+    assert(responses[2].workingCounter == 3U);
+
+    frame.resize(lastWkc);
+    assert(!oec::EthercatFrameCodec::parseMultiDatagramFrame(frame, responses));
+}
+
 void testConfigLoader() {
     namespace fs = std::filesystem;
     const auto base = fs::temp_directory_path() / "oec_loader_test";
@@ -100,14 +148,284 @@ void testConfigLoader() {
     assert(config.slaves[1].productCode == 0x07d83052);
     assert(config.signals.size() == 2);
 
+    // Binary image round-trip matches the XML-loaded model field by field.
+    const auto imagePath = (base / "demo.oecbin").string();
+    assert(oec::BinaryConfiguration::compileToFile(config, imagePath, error));
+    oec::NetworkConfiguration fromImage;
+    assert(oec::ConfigurationLoader::loadFromBinaryFile(imagePath, fromImage, error));
+    assert(fromImage.processImageInputBytes == config.processImageInputBytes);
+    assert(fromImage.processImageOutputBytes == config.processImageOutputBytes);
+    assert(fromImage.slaves.size() == config.slaves.size());
+    for (std::size_t i = 0; i < config.slaves.size(); ++i) {
+        assert(fromImage.slaves[i].name == config.slaves[i].name);
+        assert(fromImage.slaves[i].position == config.slaves[i].position);
+        assert(fromImage.slaves[i].vendorId == config.slaves[i].vendorId);
+        assert(fromImage.slaves[i].productCode == config.slaves[i].productCode);
+    }
+    assert(fromImage.signals.size() == config.signals.size());
+    assert(fromImage.signals[1].logicalName == "LampGreen");
+    assert(fromImage.signals[1].direction == oec::SignalDirection::Output);
+    assert(fromImage.signals[1].slaveName == "EL2008");
+
+    auto image = oec::BinaryConfiguration::encode(config);
+    assert(image.size() % 8U == 0U);
+    image.back() ^= 0x01U;
+    assert(!oec::BinaryConfiguration::decode(image.data(), image.size(), fromImage, error));
+    assert(error == "Binary configuration checksum mismatch");
+    image.resize(oec::BinaryConfiguration::kHeaderBytes + 4U);
+    assert(!oec::BinaryConfiguration::decode(image.data(), image.size(), fromImage, error));
+
     fs::remove_all(base);
 }
 
+class RecordingHandler final : public oec::XmlStreamParser::Handler {
+public:
+    void onStartElement(const std::string& name, const std::vector<oec::XmlAttribute>& attributes) override {
+        events.push_back("<" + name);
+        for (const auto& a : attributes) {
+            events.push_back("@" + a.name + "=" + a.value);
+        }
+    }
+    void onEndElement(const std::string& name) override { events.push_back("/" + name); }
+    void onText(std::string_view text) override { text_ += text; }
+
+    std::vector<std::string> events;
+    std::string text_;
+};
+
+void testXmlStreamParser() {
+    const std::string xml =
+        "<?xml version=\"1.0\"?><!-- c --><!DOCTYPE x [<!ENTITY e \"v\">]>"
+        "<Root a='1 &amp; 2'><Leaf b=\"&#x41;\"/>t&lt;x<![CDATA[<raw>]]></Root>";
+
+    // Byte-at-a-time feeding must give the same events as one-shot parsing.
+    RecordingHandler whole;
+    std::string error;
+    assert(oec::XmlStreamParser::parseString(xml, whole, error));
+    RecordingHandler chunked;
+    oec::XmlStreamParser parser(chunked);
+    for (const char c : xml) {
+        assert(parser.feed(&c, 1U));
+    }
+    assert(parser.finish());
+    assert(chunked.events == whole.events);
+    assert(chunked.text_ == whole.text_);
+    const std::vector<std::string> expected = {"<Root", "@a=1 & 2", "<Leaf", "@b=A", "/Leaf", "/Root"};
+    assert(whole.events == expected);
+    assert(whole.text_ == "t<x<raw>");
+
+    RecordingHandler bad;
+    assert(!oec::XmlStreamParser::parseString("<a><b></a>", bad, error));
+    assert(error == "mismatched closing tag </a>");
+    assert(!oec::XmlStreamParser::parseString("<a>", bad, error));
+
+    // Carry-over buffer stays bounded by chunk + token size, not document size.
+    RecordingHandler big;
+    oec::XmlStreamParser bounded(big);
+    const std::string open = "<Catalog>";
+    assert(bounded.feed(open.data(), open.size()));
+    const std::string device = "<Device name=\"EL1008\" vendorId=\"0x2\" productCode=\"0x03f03052\"/>\n";
+    for (int i = 0; i < 20000; ++i) {
+        assert(bounded.feed(device.data(), device.size()));
+    }
+    const std::string close = "</Catalog>";
+    assert(bounded.feed(close.data(), close.size()));
+    assert(bounded.finish());
+    assert(bounded.peakBufferBytes() <= device.size() * 2U);
+
+    // ETG.2000-style ESI with vendor id, #x numbers and PDO entries.
+    namespace fs = std::filesystem;
+    const auto esiPath = fs::temp_directory_path() / "oec_stream_esi.xml";
+    {
+        std::ofstream esi(esiPath);
+        esi << "<EtherCATInfo><Vendor><Id>#x00000002</Id></Vendor><Descriptions><Devices>"
+            << "<Device Physics=\"YY\"><Type ProductCode=\"#x07d83052\" RevisionNo=\"#x00110000\">EL2008</Type>"
+            << "<Name LcId=\"1033\">EL2008 8Ch. Dig. Output</Name>"
+            << "<RxPdo Fixed=\"1\" Sm=\"0\"><Index>#x1600</Index><Name>Channel 1</Name>"
+            << "<Entry><Index>#x7000</Index><SubIndex>1</SubIndex><BitLen>1</BitLen><Name>Output</Name></Entry>"
+            << "<Entry><Index>#x0</Index><BitLen>7</BitLen></Entry></RxPdo>"
+            << "</Device></Devices></Descriptions></EtherCATInfo>";
+    }
+    std::vector<oec::EsiDeviceDescription> devices;
+    assert(oec::ConfigurationLoader::loadEsiFile(esiPath.string(), devices, error));
+    assert(devices.size() == 1U);
+    assert(devices[0].identity.name == "EL2008");
+    assert(devices[0].identity.vendorId == 0x00000002U);
+    assert(devices[0].identity.productCode == 0x07d83052U);
+    assert(devices[0].revision == 0x00110000U);
+    assert(devices[0].rxPdos.size() == 1U && devices[0].txPdos.empty());
+    assert(devices[0].rxPdos[0].index == 0x1600U);
+    assert(devices[0].rxPdos[0].entries.size() == 2U);
+    assert(devices[0].rxPdos[0].entries[0].index == 0x7000U);
+    assert(devices[0].rxPdos[0].entries[0].subIndex == 1U);
+    assert(devices[0].rxPdos[0].entries[0].name == "Output");
+    assert(devices[0].rxPdos[0].entries[1].bitLength == 7U);
+    fs::remove(esiPath);
+}
+
+void testEsiCatalogIndex() {
+    namespace fs = std::filesystem;
+    const auto dir = fs::temp_directory_path() / "oec_esi_index_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    for (int f = 0; f < 6; ++f) {
+        std::ofstream esi(dir / ("vendor" + std::to_string(f) + ".xml"));
+        esi << "<EtherCATInfo><Vendor><Id>" << (f + 1) << "</Id></Vendor><Descriptions><Devices>";
+        for (int d = 0; d < 3; ++d) {
+            esi << "<Device><Type ProductCode=\"" << (100 + d) << "\" RevisionNo=\"" << f << "\">Dev"
+                << f << "_" << d << "</Type><TxPdo><Index>#x1a00</Index><Entry><Index>#x6000</Index>"
+                << "<SubIndex>" << (d + 1) << "</SubIndex><BitLen>8</BitLen></Entry></TxPdo></Device>";
+        }
+        esi << "</Devices></Descriptions></EtherCATInfo>";
+    }
+    const auto cachePath = (dir / "index.cache").string();
+
+    oec::EsiCatalogIndex index;
+    std::string error;
+    assert(index.build(dir.string(), error, 4U));
+    assert(index.stats().filesParsed == 6U && index.stats().filesReused == 0U);
+    assert(index.stats().devices == 18U);
+    assert(index.entries().front().identity.name == "Dev0_0");
+    const auto* hit = index.find(3U, 101U, 2U);
+    assert(hit != nullptr && hit->identity.name == "Dev2_1");
+    assert(index.find(3U, 101U, 3U) == nullptr);
+    assert(index.findByName("Dev5_2") != nullptr);
+
+    // Offset lookup parses only the indexed device, PDOs included.
+    oec::EsiDeviceDescription device;
+    assert(oec::EsiCatalogIndex::loadDevice(*hit, device, error));
+    assert(device.identity.name == "Dev2_1" && device.identity.vendorId == 3U);
+    assert(device.txPdos.size() == 1U && device.txPdos[0].entries[0].subIndex == 2U);
+    assert(device.sourceOffset == hit->byteOffset);
+    assert(index.saveCache(cachePath, error));
+
+    // Touch one file: a cache-seeded rebuild reparses just that file.
+    {
+        std::ofstream esi(dir / "vendor1.xml");
+        esi << "<EtherCATInfo><Vendor><Id>2</Id></Vendor><Descriptions><Devices>"
+            << "<Device><Type ProductCode=\"100\" RevisionNo=\"7\">Dev1_new</Type></Device>"
+            << "</Devices></Descriptions></EtherCATInfo>";
+    }
+    oec::EsiCatalogIndex cached;
+    assert(cached.loadCache(cachePath, error));
+    assert(cached.build(dir.string(), error));
+    assert(cached.stats().filesParsed == 1U && cached.stats().filesReused == 5U);
+    assert(cached.stats().devices == 16U);
+    assert(cached.findLatest(2U, 100U) != nullptr && cached.findLatest(2U, 100U)->revision == 7U);
+    assert(cached.findByName("Dev1_0") == nullptr);
+
+    std::vector<std::uint8_t> bytes;
+    {
+        std::ifstream in(cachePath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bytes[12] ^= 0xFFU;
+    {
+        std::ofstream out(cachePath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    assert(!cached.loadCache(cachePath, error));
+    assert(error == "ESI index cache checksum mismatch");
+
+    // A malformed file is skipped and reported; the other files stay indexed.
+    {
+        std::ofstream esi(dir / "vendor3.xml", std::ios::trunc);
+        esi << "<EtherCATInfo><Vendor><Id>4</Id></Vendor><Descriptions><Devices><Device>";
+    }
+    oec::EsiCatalogIndex partial;
+    assert(partial.build(dir.string(), error, 4U));
+    assert(partial.stats().filesParsed == 6U && partial.stats().filesFailed == 1U);
+    assert(partial.stats().devices == 13U);
+    assert(partial.fileErrors().size() == 1U);
+    assert(partial.fileErrors()[0].filePath == (dir / "vendor3.xml").string());
+    assert(!partial.fileErrors()[0].error.empty());
+    assert(partial.findByName("Dev3_0") == nullptr && partial.findByName("Dev4_0") != nullptr);
+
+    {
+        std::ofstream eni(dir / "net.eni");
+        eni << "<Network><ProcessImage inputBytes=\"1\" outputBytes=\"0\"/>"
+            << "<Slave name=\"Dev4_1\" alias=\"0\" position=\"1\"/>"
+            << "<Signal logicalName=\"In\" direction=\"input\" slaveName=\"Dev4_1\" byteOffset=\"0\" bitOffset=\"0\"/>"
+            << "</Network>";
+    }
+    oec::NetworkConfiguration config;
+    std::vector<std::string> warnings;
+    assert(oec::ConfigurationLoader::loadFromEniAndEsiDirectory((dir / "net.eni").string(), dir.string(), config,
+                                                                error, &warnings));
+    assert(config.slaves.size() == 1U && config.slaves[0].vendorId == 5U && config.slaves[0].productCode == 101U);
+    assert(warnings.size() == 1U && warnings[0].find("vendor3.xml") != std::string::npos);
+
+    // A device-less file is cached by size/mtime and not reparsed; the malformed one is.
+    {
+        std::ofstream esi(dir / "empty.xml");
+        esi << "<EtherCATInfo><Vendor><Id>9</Id></Vendor><Descriptions><Devices></Devices></Descriptions>"
+            << "</EtherCATInfo>";
+    }
+    oec::EsiCatalogIndex withEmpty;
+    assert(withEmpty.build(dir.string(), error));
+    assert(withEmpty.stats().filesParsed == 7U && withEmpty.stats().filesFailed == 1U);
+    assert(withEmpty.stats().devices == 13U);
+    assert(withEmpty.saveCache(cachePath, error));
+    oec::EsiCatalogIndex reloaded;
+    assert(reloaded.loadCache(cachePath, error));
+    assert(reloaded.build(dir.string(), error));
+    assert(reloaded.stats().filesParsed == 1U && reloaded.stats().filesReused == 6U);
+    assert(reloaded.stats().filesFailed == 1U && reloaded.stats().devices == 13U);
+    fs::remove_all(dir);
+}
+
+void testProcessImagePlan() {
+    namespace fs = std::filesystem;
+    oec::NetworkConfiguration config;
+    config.processImageInputBytes = 1;
+    config.processImageOutputBytes = 1;
+    config.slaves = {{.name = "EL2008", .alias = 0, .position = 1, .vendorId = 2, .productCode = 0x07d83052}};
+    config.signals = {{.logicalName = "Lamp", .direction = oec::SignalDirection::Output,
+                       .slaveName = "EL2008", .byteOffset = 0, .bitOffset = 3}};
+
+    const auto baseHash = oec::ProcessImagePlanCodec::hashConfiguration(config, 0U);
+    assert(baseHash == oec::ProcessImagePlanCodec::hashConfiguration(config, 0U));
+    assert(baseHash != oec::ProcessImagePlanCodec::hashConfiguration(config, 0x100U));
+    config.signals[0].bitOffset = 4;
+    assert(baseHash != oec::ProcessImagePlanCodec::hashConfiguration(config, 0U));
+
+    oec::ProcessImageLayoutPlan plan;
+    plan.topologyHash = 0x1122334455667788ULL;
+    plan.configHash = baseHash;
+    plan.sdoWrites.push_back({1, {.index = 0x1C12, .subIndex = 1}, {0x00, 0x16}});
+    plan.registerWrites.push_back({1, 0x0600, std::vector<std::uint8_t>(16U, 0x5A)});
+    plan.smExpectations.push_back({1, 2, 0x0F00, 1});
+    plan.outputWindows.push_back({1, 0x0F00, 1, 0});
+
+    const auto path = (fs::temp_directory_path() / "oec_plan_test.bin").string();
+    std::string error;
+    assert(oec::ProcessImagePlanCodec::saveToFile(path, plan, error));
+    oec::ProcessImageLayoutPlan loaded;
+    assert(oec::ProcessImagePlanCodec::loadFromFile(path, loaded, error));
+    assert(loaded.topologyHash == plan.topologyHash);
+    assert(loaded.configHash == plan.configHash);
+    assert(loaded.sdoWrites.size() == 1U && loaded.sdoWrites[0].address.index == 0x1C12);
+    assert(loaded.sdoWrites[0].data == plan.sdoWrites[0].data);
+    assert(loaded.registerWrites.size() == 1U && loaded.registerWrites[0].data.size() == 16U);
+    assert(loaded.smExpectations.size() == 1U && loaded.smExpectations[0].start == 0x0F00);
+    assert(loaded.outputWindows.size() == 1U && loaded.outputWindows[0].length == 1U);
+    fs::remove(path);
+
+    auto corrupt = oec::ProcessImagePlanCodec::encode(plan);
+    corrupt[10] ^= 0xFFU;
+    assert(!oec::ProcessImagePlanCodec::decode(corrupt, loaded, error));
+    assert(error == "plan checksum mismatch");
+}
+
 } // namespace
 
 int main() {
     testEthercatCodec();
+    testMultiDatagramCodec();
     testConfigLoader();
+    testXmlStreamParser();
+    testEsiCatalogIndex();
+    testProcessImagePlan();
     std::cout << "protocol_and_loader_tests passed\n";
     return 0;
 }